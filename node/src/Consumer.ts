@@ -2,7 +2,13 @@ import { Logger } from './Logger';
 import { EnhancedEventEmitter } from './EnhancedEventEmitter';
 import { Channel } from './Channel';
 import { TransportInternal } from './Transport';
-import { ProducerStat } from './Producer';
+import {
+	ProducerStat,
+	TranslationEndPointLatency,
+	TranslationUplinkStats,
+	parseTranslationEndPointLatency,
+	parseTranslationUplinkStats,
+} from './Producer';
 import {
 	MediaKind,
 	RtpCapabilities,
@@ -188,9 +194,25 @@ export type ConsumerObserverEvents = {
 	trace: [ConsumerTraceEventData];
 };
 
+/**
+ * Play-out statistics of translated media injected into the Consumer.
+ */
+export type ConsumerTranslationStats = {
+	playedFrames: number;
+	lateFrames: number;
+	droppedFrames: number;
+	bufferedFrames: number;
+	jitterMs: number;
+	bufferDelayMs: number;
+	maxBufferDelayMs: number;
+	sentPackets: number;
+	uplinkStats?: TranslationUplinkStats;
+};
+
 export type SimpleConsumerDump = BaseConsumerDump & {
 	type: string;
 	rtpStream: RtpStreamDump;
+	translationStats?: ConsumerTranslationStats;
 };
 
 export type SimulcastConsumerDump = BaseConsumerDump & {
@@ -571,6 +593,33 @@ export class Consumer<
 		return parseConsumerStats(data);
 	}
 
+	/**
+	 * Get latencies of the translation service connection of the Consumer.
+	 */
+	async getTranslationLatencyStats(): Promise<
+		TranslationEndPointLatency | undefined
+	> {
+		logger.debug('getTranslationLatencyStats()');
+
+		const response = await this.#channel.request(
+			FbsRequest.Method.CONSUMER_GET_STATS,
+			undefined,
+			undefined,
+			this.#internal.consumerId
+		);
+
+		/* Decode Response. */
+		const data = new FbsConsumer.GetStatsResponse();
+
+		response.body(data);
+
+		const translationLatency = data.translationLatency();
+
+		return translationLatency
+			? parseTranslationEndPointLatency(translationLatency)
+			: undefined;
+	}
+
 	/**
 	 * Pause the Consumer.
 	 */
@@ -1097,11 +1146,33 @@ function parseSimpleConsumerDump(
 ): SimpleConsumerDump {
 	const base = parseBaseConsumerDump(data.base()!);
 	const rtpStream = parseRtpStream(data.rtpStreams(0)!);
+	const translationStats = data.translationStats();
 
 	return {
 		...base,
 		type: 'simple',
 		rtpStream,
+		translationStats: translationStats
+			? parseTranslationStats(translationStats)
+			: undefined,
+	};
+}
+
+function parseTranslationStats(
+	stats: FbsConsumer.TranslationStats
+): ConsumerTranslationStats {
+	return {
+		playedFrames: Number(stats.playedFrames()),
+		lateFrames: Number(stats.lateFrames()),
+		droppedFrames: Number(stats.droppedFrames()),
+		bufferedFrames: stats.bufferedFrames(),
+		jitterMs: stats.jitterMs(),
+		bufferDelayMs: stats.bufferDelayMs(),
+		maxBufferDelayMs: stats.maxBufferDelayMs(),
+		sentPackets: Number(stats.sentPackets()),
+		uplinkStats: stats.uplinkStats()
+			? parseTranslationUplinkStats(stats.uplinkStats()!)
+			: undefined,
 	};
 }
 
@@ -84,6 +84,38 @@ export type ProducerTraceEventData = {
 	info: any;
 };
 
+/**
+ * Recording of received media into local files.
+ */
+export type ProducerRecordingOptions = {
+	/**
+	 * Directory for recorded files.
+	 */
+	directory: string;
+
+	/**
+	 * Max interval between flushes of buffered data, in milliseconds.
+	 * Default 1000.
+	 */
+	flushIntervalMs?: number;
+
+	/**
+	 * Size of buffered data which triggers flush, in bytes. Default 262144.
+	 */
+	flushSize?: number;
+
+	/**
+	 * Max size of data not yet written to disk, newer data is dropped if
+	 * exceeded. Default 4194304.
+	 */
+	maxPendingSize?: number;
+
+	/**
+	 * When recorded data is synced to disk. Default 'close'.
+	 */
+	syncPolicy?: 'none' | 'flush' | 'close';
+};
+
 export type ProducerScore = {
 	/**
 	 * Index of the RTP stream in the rtpParameters.encodings array.
@@ -130,6 +162,21 @@ export type ProducerStat = RtpStreamRecvStats;
  */
 export type ProducerType = 'simple' | 'simulcast' | 'svc';
 
+/**
+ * Send queue statistics of the connection(s) to the translation service.
+ */
+export type TranslationUplinkStats = {
+	queuedMessages: number;
+	queuedBytes: number;
+	queueDelayMs: number;
+	droppedMessages: number;
+	droppedBytes: number;
+	writeLatencyMs: number;
+	maxWriteLatencyMs: number;
+	congestions: number;
+	congested: boolean;
+};
+
 export type ProducerEvents = {
 	transportclose: [];
 	score: [ProducerScore[]];
@@ -149,6 +196,67 @@ export type ProducerObserverEvents = {
 	trace: [ProducerTraceEventData];
 };
 
+/**
+ * Latencies in microseconds, counts has one more item than boundsUs: samples
+ * above the last bound.
+ */
+export type LatencyHistogram = {
+	boundsUs: number[];
+	counts: number[];
+	count: number;
+	sumUs: number;
+	maxUs: number;
+};
+
+/**
+ * Received media of one Producer stream on its way to the translation service.
+ */
+export type TranslationStreamLatency = {
+	mappedSsrc: number;
+	// RTP arrival to assembled frame.
+	assembly: LatencyHistogram;
+	// Assembled frame to serialized media written into connections.
+	serialization: LatencyHistogram;
+	frames: number;
+	bytes: number;
+	droppedPackets: number;
+	// Frames of silence which were not sent to the service.
+	gatedFrames: number;
+	gatedBytes: number;
+	speechSegments: number;
+	// Video frames lost in transit and frames waiting for a key frame.
+	incompleteFrames: number;
+	undecodableFrames: number;
+	keyFrameRequests: number;
+};
+
+/**
+ * Connection with the translation service.
+ */
+export type TranslationEndPointLatency = {
+	languageTo: string;
+	voice: string;
+	// Queued media to socket write.
+	socketWrite: LatencyHistogram;
+	// Oldest unanswered media to the first byte of translation.
+	firstResponse: LatencyHistogram;
+	sentMessages: number;
+	sentBytes: number;
+	droppedMessages: number;
+	receivedMessages: number;
+	receivedBytes: number;
+	reconnects: number;
+	// Opening to connected, near zero for warm connections of the pool.
+	connect: LatencyHistogram;
+	// Sessions migrated to another host of the service.
+	failovers: number;
+};
+
+export type ProducerTranslationLatencyStats = {
+	streams: TranslationStreamLatency[];
+	endPoints: TranslationEndPointLatency[];
+};
+
 type ProducerDump = {
 	id: string;
 	kind: string;
@@ -158,6 +266,7 @@ type ProducerDump = {
 	rtpStreams: any;
 	traceEventTypes: string[];
 	paused: boolean;
+	translationUplinkStats?: TranslationUplinkStats;
 };
 
 type ProducerInternal = TransportInternal & {
@@ -416,6 +525,38 @@ export class Producer<
 		return parseProducerStats(data);
 	}
 
+	/**
+	 * Get latencies of the translation pipeline of the Producer.
+	 */
+	async getTranslationLatencyStats(): Promise<ProducerTranslationLatencyStats> {
+		logger.debug('getTranslationLatencyStats()');
+
+		const response = await this.#channel.request(
+			FbsRequest.Method.PRODUCER_GET_STATS,
+			undefined,
+			undefined,
+			this.#internal.producerId
+		);
+
+		/* Decode Response. */
+		const data = new FbsProducer.GetStatsResponse();
+
+		response.body(data);
+
+		return {
+			streams: utils.parseVector(
+				data,
+				'translationStreams',
+				parseTranslationStreamLatency
+			),
+			endPoints: utils.parseVector(
+				data,
+				'translationEndPoints',
+				parseTranslationEndPointLatency
+			),
+		};
+	}
+
 	/**
 	 * Pause the Producer.
 	 */
@@ -499,6 +640,49 @@ export class Producer<
 		);
 	}
 
+	/**
+	 * Start or stop (if no options given) recording of received media.
+	 */
+	async setRecording(options?: ProducerRecordingOptions): Promise<void> {
+		logger.debug('setRecording()');
+
+		if (options && typeof options.directory !== 'string') {
+			throw new TypeError('missing directory');
+		}
+
+		let syncPolicy = FbsProducer.RecordingSyncPolicy.ON_CLOSE;
+
+		switch (options?.syncPolicy) {
+			case 'none': {
+				syncPolicy = FbsProducer.RecordingSyncPolicy.NONE;
+
+				break;
+			}
+
+			case 'flush': {
+				syncPolicy = FbsProducer.RecordingSyncPolicy.ON_FLUSH;
+
+				break;
+			}
+		}
+
+		/* Build Request. */
+		const requestOffset = new FbsProducer.SetRecordingRequestT(
+			options?.directory ?? null,
+			options?.flushIntervalMs ?? 1000,
+			options?.flushSize ?? 262144,
+			options?.maxPendingSize ?? 4194304,
+			syncPolicy
+		).pack(this.#channel.bufferBuilder);
+
+		await this.#channel.request(
+			FbsRequest.Method.PRODUCER_SET_RECORDING,
+			FbsRequest.Body.Producer_SetRecordingRequest,
+			requestOffset,
+			this.#internal.producerId
+		);
+	}
+
 	/**
 	 * Send RTP packet (just valid for Producers created on a DirectTransport).
 	 */
@@ -694,6 +878,8 @@ function producerTraceEventTypeFromFbs(
 export function parseProducerDump(
 	data: FbsProducer.DumpResponse
 ): ProducerDump {
+	const translationUplinkStats = data.translationUplinkStats();
+
 	return {
 		id: data.id()!,
 		kind: data.kind() === FbsRtpParameters.MediaKind.AUDIO ? 'audio' : 'video',
@@ -716,6 +902,77 @@ export function parseProducerDump(
 			producerTraceEventTypeFromFbs
 		),
 		paused: data.paused(),
+		translationUplinkStats: translationUplinkStats
+			? parseTranslationUplinkStats(translationUplinkStats)
+			: undefined,
+	};
+}
+
+export function parseTranslationUplinkStats(
+	stats: FbsProducer.TranslationUplinkStats
+): TranslationUplinkStats {
+	return {
+		queuedMessages: stats.queuedMessages(),
+		queuedBytes: stats.queuedBytes(),
+		queueDelayMs: stats.queueDelayMs(),
+		droppedMessages: Number(stats.droppedMessages()),
+		droppedBytes: Number(stats.droppedBytes()),
+		writeLatencyMs: stats.writeLatencyMs(),
+		maxWriteLatencyMs: stats.maxWriteLatencyMs(),
+		congestions: Number(stats.congestions()),
+		congested: stats.congested(),
+	};
+}
+
+function parseLatencyHistogram(
+	histogram: FbsProducer.LatencyHistogram
+): LatencyHistogram {
+	return {
+		boundsUs: utils.parseVector(histogram, 'boundsUs'),
+		counts: utils.parseVector(histogram, 'counts', (count: bigint) =>
+			Number(count)
+		),
+		count: Number(histogram.count()),
+		sumUs: Number(histogram.sumUs()),
+		maxUs: Number(histogram.maxUs()),
+	};
+}
+
+function parseTranslationStreamLatency(
+	stats: FbsProducer.TranslationStreamLatency
+): TranslationStreamLatency {
+	return {
+		mappedSsrc: stats.mappedSsrc(),
+		assembly: parseLatencyHistogram(stats.assembly()!),
+		serialization: parseLatencyHistogram(stats.serialization()!),
+		frames: Number(stats.frames()),
+		bytes: Number(stats.bytes()),
+		droppedPackets: Number(stats.droppedPackets()),
+		gatedFrames: Number(stats.gatedFrames()),
+		gatedBytes: Number(stats.gatedBytes()),
+		speechSegments: Number(stats.speechSegments()),
+		incompleteFrames: Number(stats.incompleteFrames()),
+		undecodableFrames: Number(stats.undecodableFrames()),
+		keyFrameRequests: Number(stats.keyFrameRequests()),
+	};
+}
+
+export function parseTranslationEndPointLatency(
+	stats: FbsProducer.TranslationEndPointLatency
+): TranslationEndPointLatency {
+	return {
+		languageTo: stats.languageTo()!,
+		voice: stats.voice()!,
+		socketWrite: parseLatencyHistogram(stats.socketWrite()!),
+		firstResponse: parseLatencyHistogram(stats.firstResponse()!),
+		sentMessages: Number(stats.sentMessages()),
+		sentBytes: Number(stats.sentBytes()),
+		droppedMessages: Number(stats.droppedMessages()),
+		receivedMessages: Number(stats.receivedMessages()),
+		receivedBytes: Number(stats.receivedBytes()),
+		reconnects: Number(stats.reconnects()),
+		connect: parseLatencyHistogram(stats.connect()!),
+		failovers: Number(stats.failovers()),
 	};
 }
 
@@ -266,6 +266,20 @@ export type BaseTransportStats = {
 	availableOutgoingBitrate?: number;
 	availableIncomingBitrate?: number;
 	maxIncomingBitrate?: number;
+	udpSocketStats?: UdpSocketStats;
+};
+
+/**
+ * Batching counters of the UDP sockets of the transport. Sockets of a
+ * WebRtcServer are shared by all its transports.
+ */
+export type UdpSocketStats = {
+	recvDatagramCount: number;
+	recvBatchCount: number;
+	sendGsoCount: number;
+	sendGsoSegmentCount: number;
+	sendMmsgCount: number;
+	sendMmsgDatagramCount: number;
 };
 
 type TransportData =
@@ -1454,6 +1468,7 @@ export function parseBaseTransportStats(
 		binary.sctpState() === null
 			? undefined
 			: parseSctpState(binary.sctpState()!);
+	const udpSocketStats = binary.udpSocketStats();
 
 	return {
 		transportId: binary.transportId()!,
@@ -1478,6 +1493,16 @@ export function parseBaseTransportStats(
 		maxIncomingBitrate: binary.maxIncomingBitrate()
 			? Number(binary.maxIncomingBitrate())
 			: undefined,
+		udpSocketStats: udpSocketStats
+			? {
+					recvDatagramCount: Number(udpSocketStats.recvDatagramCount()),
+					recvBatchCount: Number(udpSocketStats.recvBatchCount()),
+					sendGsoCount: Number(udpSocketStats.sendGsoCount()),
+					sendGsoSegmentCount: Number(udpSocketStats.sendGsoSegmentCount()),
+					sendMmsgCount: Number(udpSocketStats.sendMmsgCount()),
+					sendMmsgDatagramCount: Number(udpSocketStats.sendMmsgDatagramCount()),
+				}
+			: undefined,
 	};
 }
 
@@ -80,6 +80,25 @@ export type WorkerSettings<WorkerAppData extends AppData = AppData> = {
 	 */
 	libwebrtcFieldTrials?: string;
 
+	/**
+	 * Number of threads serving the websockets of translation services. Default
+	 * 0 (as many threads as CPU cores).
+	 */
+	translationThreads?: number;
+
+	/**
+	 * Max number of UDP datagrams received by a single syscall, from 1 to 20.
+	 * Default 16. 1 disables batched receiving.
+	 */
+	udpRecvBatchSize?: number;
+
+	/**
+	 * Receive UDP and TCP data over io_uring multishot requests when the worker
+	 * is built with liburing and the kernel supports them. Experimental, default
+	 * false (data is received via libuv).
+	 */
+	enableLiburingRecv?: boolean;
+
 	/**
 	 * Custom application data.
 	 */
@@ -195,6 +214,9 @@ export type WorkerDump = {
 		sqeProcessCount: number;
 		sqeMissCount: number;
 		userDataMissCount: number;
+		recvCount: number;
+		recvBufferMissCount: number;
+		recvTruncatedCount: number;
 	};
 };
 
@@ -285,6 +307,9 @@ export class Worker<
 		dtlsCertificateFile,
 		dtlsPrivateKeyFile,
 		libwebrtcFieldTrials,
+		translationThreads,
+		udpRecvBatchSize,
+		enableLiburingRecv,
 		appData,
 	}: WorkerSettings<WorkerAppData>) {
 		super();
@@ -336,6 +361,24 @@ export class Worker<
 			spawnArgs.push(`--libwebrtcFieldTrials=${libwebrtcFieldTrials}`);
 		}
 
+		if (
+			typeof translationThreads === 'number' &&
+			!Number.isNaN(translationThreads)
+		) {
+			spawnArgs.push(`--translationThreads=${translationThreads}`);
+		}
+
+		if (
+			typeof udpRecvBatchSize === 'number' &&
+			!Number.isNaN(udpRecvBatchSize)
+		) {
+			spawnArgs.push(`--udpRecvBatchSize=${udpRecvBatchSize}`);
+		}
+
+		if (enableLiburingRecv === true) {
+			spawnArgs.push('--liburingRecv');
+		}
+
 		logger.debug(
 			'spawning worker process: %s %s',
 			spawnBin,
@@ -847,6 +890,9 @@ export function parseWorkerDumpResponse(
 			sqeProcessCount: Number(binary.liburing()!.sqeProcessCount()),
 			sqeMissCount: Number(binary.liburing()!.sqeMissCount()),
 			userDataMissCount: Number(binary.liburing()!.userDataMissCount()),
+			recvCount: Number(binary.liburing()!.recvCount()),
+			recvBufferMissCount: Number(binary.liburing()!.recvBufferMissCount()),
+			recvTruncatedCount: Number(binary.liburing()!.recvTruncatedCount()),
 		};
 	}
 
@@ -53,6 +53,9 @@ export async function createWorker<
 	dtlsCertificateFile,
 	dtlsPrivateKeyFile,
 	libwebrtcFieldTrials,
+	translationThreads,
+	udpRecvBatchSize,
+	enableLiburingRecv,
 	appData,
 }: WorkerSettings<WorkerAppData> = {}): Promise<Worker<WorkerAppData>> {
 	logger.debug('createWorker()');
@@ -61,6 +64,26 @@ export async function createWorker<
 		throw new TypeError('if given, appData must be an object');
 	}
 
+	if (
+		translationThreads !== undefined &&
+		(!Number.isInteger(translationThreads) || translationThreads < 0)
+	) {
+		throw new TypeError(
+			'if given, translationThreads must be a non negative integer'
+		);
+	}
+
+	if (
+		udpRecvBatchSize !== undefined &&
+		(!Number.isInteger(udpRecvBatchSize) ||
+			udpRecvBatchSize < 1 ||
+			udpRecvBatchSize > 20)
+	) {
+		throw new TypeError(
+			'if given, udpRecvBatchSize must be an integer from 1 to 20'
+		);
+	}
+
 	const worker = new Worker<WorkerAppData>({
 		logLevel,
 		logTags,
@@ -69,6 +92,9 @@ export async function createWorker<
 		dtlsCertificateFile,
 		dtlsPrivateKeyFile,
 		libwebrtcFieldTrials,
+		translationThreads,
+		udpRecvBatchSize,
+		enableLiburingRecv,
 		appData,
 	});
 
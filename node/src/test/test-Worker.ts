@@ -61,6 +61,8 @@ test('createWorker() succeeds', async () => {
 		dtlsCertificateFile: path.join(__dirname, 'data', 'dtls-cert.pem'),
 		dtlsPrivateKeyFile: path.join(__dirname, 'data', 'dtls-key.pem'),
 		libwebrtcFieldTrials: 'WebRTC-Bwe-AlrLimitedBackoff/Disabled/',
+		udpRecvBatchSize: 20,
+		enableLiburingRecv: true,
 		appData: { foo: 456 },
 	});
 
@@ -101,6 +103,15 @@ test('createWorker() with wrong settings rejects with TypeError', async () => {
 		mediasoup.createWorker({ dtlsPrivateKeyFile: '/notfound/priv.pem' })
 	).rejects.toThrow(TypeError);
 
+	// UDP receive batch size is from 1 to 20.
+	await expect(
+		mediasoup.createWorker({ udpRecvBatchSize: 0 })
+	).rejects.toThrow(TypeError);
+
+	await expect(
+		mediasoup.createWorker({ udpRecvBatchSize: 21 })
+	).rejects.toThrow(TypeError);
+
 	await expect(
 		// @ts-ignore
 		mediasoup.createWorker({ appData: 'NOT-AN-OBJECT' })
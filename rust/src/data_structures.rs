@@ -448,6 +448,39 @@ impl SctpState {
     }
 }
 
+/// Batching counters of the UDP sockets of a transport.
+///
+/// Sockets of a WebRTC server are shared by all its transports.
+#[derive(Debug, Copy, Clone, Ord, PartialOrd, Eq, PartialEq, Deserialize, Serialize)]
+#[serde(rename_all = "camelCase")]
+pub struct UdpSocketStats {
+    /// Received datagrams.
+    pub recv_datagram_count: u64,
+    /// Receive syscalls which returned datagrams.
+    pub recv_batch_count: u64,
+    /// GSO sends, each with more than one datagram.
+    pub send_gso_count: u64,
+    /// Datagrams sent via GSO.
+    pub send_gso_segment_count: u64,
+    /// `sendmmsg()` calls, each with more than one datagram.
+    pub send_mmsg_count: u64,
+    /// Datagrams sent via `sendmmsg()`.
+    pub send_mmsg_datagram_count: u64,
+}
+
+impl UdpSocketStats {
+    pub(crate) fn from_fbs(stats: &transport::UdpSocketStats) -> Self {
+        Self {
+            recv_datagram_count: stats.recv_datagram_count,
+            recv_batch_count: stats.recv_batch_count,
+            send_gso_count: stats.send_gso_count,
+            send_gso_segment_count: stats.send_gso_segment_count,
+            send_mmsg_count: stats.send_mmsg_count,
+            send_mmsg_datagram_count: stats.send_mmsg_datagram_count,
+        }
+    }
+}
+
 /// DTLS role.
 #[derive(Debug, Copy, Clone, Ord, PartialOrd, Eq, PartialEq, Hash, Deserialize, Serialize)]
 #[serde(rename_all = "camelCase")]
@@ -169,6 +169,9 @@ impl Request for WorkerDumpRequest {
                 sqe_process_count: liburing.sqe_process_count,
                 sqe_miss_count: liburing.sqe_miss_count,
                 user_data_miss_count: liburing.user_data_miss_count,
+                recv_count: liburing.recv_count,
+                recv_buffer_miss_count: liburing.recv_buffer_miss_count,
+                recv_truncated_count: liburing.recv_truncated_count,
             }),
         })
     }
@@ -4,7 +4,7 @@ mod tests;
 use crate::consumer::{Consumer, ConsumerId, ConsumerOptions};
 use crate::data_consumer::{DataConsumer, DataConsumerId, DataConsumerOptions, DataConsumerType};
 use crate::data_producer::{DataProducer, DataProducerId, DataProducerOptions, DataProducerType};
-use crate::data_structures::{AppData, SctpState};
+use crate::data_structures::{AppData, SctpState, UdpSocketStats};
 use crate::messages::{TransportCloseRequest, TransportSendRtcpNotification};
 use crate::producer::{Producer, ProducerId, ProducerOptions};
 use crate::router::transport::{TransportImpl, TransportType};
@@ -179,6 +179,8 @@ pub struct DirectTransportStat {
     pub rtp_packet_loss_received: Option<f64>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub rtp_packet_loss_sent: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_socket_stats: Option<UdpSocketStats>,
 }
 
 impl DirectTransportStat {
@@ -210,6 +212,11 @@ impl DirectTransportStat {
             min_outgoing_bitrate: stats.base.min_outgoing_bitrate,
             rtp_packet_loss_received: stats.base.rtp_packet_loss_received,
             rtp_packet_loss_sent: stats.base.rtp_packet_loss_sent,
+            udp_socket_stats: stats
+                .base
+                .udp_socket_stats
+                .as_deref()
+                .map(UdpSocketStats::from_fbs),
         })
     }
 }
@@ -6,7 +6,7 @@ use crate::data_consumer::{DataConsumer, DataConsumerId, DataConsumerOptions, Da
 use crate::data_producer::{DataProducer, DataProducerId, DataProducerOptions, DataProducerType};
 use crate::data_structures::{
     AppData, DtlsParameters, DtlsState, IceCandidate, IceParameters, IceRole, IceState, ListenInfo,
-    SctpState, TransportTuple,
+    SctpState, TransportTuple, UdpSocketStats,
 };
 use crate::messages::{
     TransportCloseRequest, TransportRestartIceRequest, WebRtcTransportConnectRequest,
@@ -338,6 +338,8 @@ pub struct WebRtcTransportStat {
     pub rtp_packet_loss_received: Option<f64>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub rtp_packet_loss_sent: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_socket_stats: Option<UdpSocketStats>,
     // WebRtcTransport specific.
     pub ice_role: IceRole,
     pub ice_state: IceState,
@@ -375,6 +377,11 @@ impl WebRtcTransportStat {
             min_outgoing_bitrate: stats.base.min_outgoing_bitrate,
             rtp_packet_loss_received: stats.base.rtp_packet_loss_received,
             rtp_packet_loss_sent: stats.base.rtp_packet_loss_sent,
+            udp_socket_stats: stats
+                .base
+                .udp_socket_stats
+                .as_deref()
+                .map(UdpSocketStats::from_fbs),
             // WebRtcTransport specific.
             ice_role: IceRole::from_fbs(stats.ice_role),
             ice_state: IceState::from_fbs(stats.ice_state),
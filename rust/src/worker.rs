@@ -192,6 +192,19 @@ pub struct WorkerSettings {
     /// "WebRTC-Bwe-AlrLimitedBackoff/Enabled/".
     #[doc(hidden)]
     pub libwebrtc_field_trials: Option<String>,
+    /// Number of threads serving the websockets of translation services.
+    ///
+    /// Default `0` (as many threads as CPU cores).
+    pub translation_threads: u32,
+    /// Max number of UDP datagrams received by a single syscall, from `1` to `20`.
+    ///
+    /// Default `16`, `1` disables batched receiving.
+    pub udp_recv_batch_size: u32,
+    /// Receive UDP and TCP data over io_uring multishot requests when the worker is built with
+    /// liburing and the kernel supports them.
+    ///
+    /// Experimental, default `false` (data is received via libuv).
+    pub enable_liburing_recv: bool,
     /// Function that will be called under worker thread before worker starts, can be used for
     /// pinning worker threads to CPU cores.
     pub thread_initializer: Option<Arc<dyn Fn() + Send + Sync>>,
@@ -221,6 +234,9 @@ impl Default for WorkerSettings {
             rtc_ports_range: 10000..=59999,
             dtls_files: None,
             libwebrtc_field_trials: None,
+            translation_threads: 0,
+            udp_recv_batch_size: 16,
+            enable_liburing_recv: false,
             thread_initializer: None,
             app_data: AppData::default(),
         }
@@ -235,6 +251,9 @@ impl fmt::Debug for WorkerSettings {
             rtc_ports_range,
             dtls_files,
             libwebrtc_field_trials,
+            translation_threads,
+            udp_recv_batch_size,
+            enable_liburing_recv,
             thread_initializer,
             app_data,
         } = self;
@@ -245,6 +264,9 @@ impl fmt::Debug for WorkerSettings {
             .field("rtc_ports_range", &rtc_ports_range)
             .field("dtls_files", &dtls_files)
             .field("libwebrtc_field_trials", &libwebrtc_field_trials)
+            .field("translation_threads", &translation_threads)
+            .field("udp_recv_batch_size", &udp_recv_batch_size)
+            .field("enable_liburing_recv", &enable_liburing_recv)
             .field(
                 "thread_initializer",
                 &thread_initializer.as_ref().map(|_| "ThreadInitializer"),
@@ -284,6 +306,9 @@ pub struct LibUringDump {
     pub sqe_process_count: u64,
     pub sqe_miss_count: u64,
     pub user_data_miss_count: u64,
+    pub recv_count: u64,
+    pub recv_buffer_miss_count: u64,
+    pub recv_truncated_count: u64,
 }
 
 #[derive(Debug, Clone, Deserialize, Serialize)]
@@ -356,6 +381,9 @@ impl Inner {
             rtc_ports_range,
             dtls_files,
             libwebrtc_field_trials,
+            translation_threads,
+            udp_recv_batch_size,
+            enable_liburing_recv,
             thread_initializer,
             app_data,
         }: WorkerSettings,
@@ -404,6 +432,20 @@ impl Inner {
             ));
         }
 
+        spawn_args.push(format!("--translationThreads={translation_threads}"));
+
+        if !(1..=20).contains(&udp_recv_batch_size) {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "Invalid UDP receive batch size, must be from 1 to 20",
+            ));
+        }
+        spawn_args.push(format!("--udpRecvBatchSize={udp_recv_batch_size}"));
+
+        if enable_liburing_recv {
+            spawn_args.push("--liburingRecv".to_string());
+        }
+
         let id = WorkerId::new();
         debug!(
             "spawning worker with arguments [id:{}]: {}",
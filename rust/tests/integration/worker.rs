@@ -49,6 +49,7 @@ fn create_worker_succeeds() {
                 });
                 settings.libwebrtc_field_trials =
                     Some("WebRTC-Bwe-AlrLimitedBackoff/Disabled/".to_string());
+                settings.enable_liburing_recv = true;
                 settings.app_data = AppData::new(CustomAppData { bar: 456 });
 
                 settings
@@ -105,6 +106,20 @@ fn create_worker_wrong_settings() {
 
             assert!(matches!(worker_result, Err(io::Error { .. })));
         }
+
+        {
+            let worker_result = worker_manager
+                .create_worker({
+                    let mut settings = WorkerSettings::default();
+
+                    settings.udp_recv_batch_size = 21;
+
+                    settings
+                })
+                .await;
+
+            assert!(matches!(worker_result, Err(io::Error { .. })));
+        }
     });
 }
 
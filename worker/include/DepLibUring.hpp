@@ -3,14 +3,25 @@
 
 #include "DepLibUV.hpp"
 #include "FBS/liburing.h"
+#include <absl/container/flat_hash_map.h>
 #include <functional>
 #include <liburing.h>
 #include <queue>
+#include <vector>
 
 class DepLibUring
 {
 public:
 	using onSendCallback = const std::function<void(bool sent)>;
+	/**
+	 * Called for every datagram (addr is set) or TCP read (addr is nullptr).
+	 * Negative nread is a negated errno, 0 in TCP is EOF, and both mean that
+	 * reception has been stopped and the socket must fall back to libuv or be
+	 * closed. Returns the number of consumed bytes, the rest of TCP data is
+	 * given again unless 0 is returned or receiving is stopped meanwhile.
+	 */
+	using onRecvCallback =
+	  size_t (*)(void* data, const uint8_t* buf, ssize_t nread, const struct sockaddr* addr);
 
 	/* Struct for the user data field of SQE and CQE. */
 	struct UserData
@@ -27,9 +38,37 @@ public:
 		size_t idx{ 0 };
 	};
 
+	/* Struct for the user data field of multishot receive SQE and CQEs. */
+	struct RecvData
+	{
+		int sockfd{ -1 };
+		// Whether datagrams are received with recvmsg() instead of stream data with recv().
+		bool datagram{ false };
+		// Message template for recvmsg(), it must outlive the request.
+		struct msghdr msg;
+		// Receive callback and its data, unset once receiving is stopped.
+		onRecvCallback cb{ nullptr };
+		void* data{ nullptr };
+		// Whether the multishot receive is submitted and not terminated yet.
+		bool armed{ false };
+		// Index in recvDatas array.
+		size_t idx{ 0 };
+	};
+
 	/* Number of submission queue entries (SQE). */
 	static constexpr size_t QueueDepth{ 1024 * 4 };
 	static constexpr size_t SendBufferSize{ 1500 };
+	/* Number of sockets which can receive over io_uring at the same time. */
+	static constexpr size_t MaxRecvEntries{ 1024 * 4 };
+	/*
+	 * Number and size of the provided receive buffers (a power of 2). A
+	 * datagram shares its buffer with the recvmsg() header and source address,
+	 * sockets receiving a bigger one fall back to libuv.
+	 */
+	static constexpr size_t RecvBuffersCount{ 1024 * 2 };
+	static constexpr size_t RecvBufferSize{ 1024 * 4 };
+	/* Buffer group ID of the provided receive buffers ring. */
+	static constexpr uint16_t RecvBufferGroupId{ 0 };
 
 	using SendBuffer = uint8_t[SendBufferSize];
 
@@ -47,6 +86,10 @@ public:
 	static void Submit();
 	static void SetActive();
 	static bool IsActive();
+	static bool IsRecvEnabled();
+	static bool StartRecvMsg(int sockfd, onRecvCallback cb, void* data);
+	static bool StartRecv(int sockfd, onRecvCallback cb, void* data);
+	static void StopRecv(int sockfd);
 
 	class LibUring;
 
@@ -96,8 +139,26 @@ public:
 		{
 			this->availableUserDataEntries.push(idx);
 		}
+		bool IsRecvEnabled() const
+		{
+			return this->recvBufferRing != nullptr;
+		}
+		bool StartRecv(int sockfd, bool datagram, onRecvCallback cb, void* data);
+		void StopRecv(int sockfd);
+		bool IsRecvData(const void* userData) const
+		{
+			return userData >= this->recvDatas &&
+			       userData <= std::addressof(this->recvDatas[DepLibUring::MaxRecvEntries - 1]);
+		}
+		void ProcessRecvCqe(struct io_uring_cqe* cqe);
+		// Returns the consumed buffers to the ring and re-arms the stopped receives.
+		void CompleteRecvCqes();
 
 	private:
+		void SetupRecvBufferRing();
+		bool PrepareRecv(RecvData* recvData);
+		void SubmitRecv();
+		void RecycleRecvBuffer(uint16_t bid);
 		UserData* GetUserData();
 		bool IsDataInSendBuffers(const uint8_t* data) const
 		{
@@ -129,6 +190,26 @@ public:
 		uint64_t sqeMissCount{ 0u };
 		// User data miss count.
 		uint64_t userDataMissCount{ 0u };
+		// Provided receive buffers ring, nullptr if the kernel doesn't support it.
+		struct io_uring_buf_ring* recvBufferRing{ nullptr };
+		// Pre-allocated receive buffers provided to the kernel.
+		uint8_t* recvBuffers{ nullptr };
+		// Buffers consumed since the last advance of the ring.
+		uint16_t recvBuffersConsumed{ 0u };
+		// Pre-allocated RecvData's.
+		RecvData recvDatas[MaxRecvEntries]{};
+		// Indexes of available RecvData entries.
+		std::queue<size_t> availableRecvDataEntries;
+		// RecvData entries indexed by socket.
+		absl::flat_hash_map<int, RecvData*> mapSockFdRecvData;
+		// RecvData entries whose multishot receive must be submitted again.
+		std::vector<RecvData*> recvDatasToRearm;
+		// Receive CQE count.
+		uint64_t recvCount{ 0u };
+		// Multishot receives stopped due to no receive buffer available.
+		uint64_t recvBufferMissCount{ 0u };
+		// Datagrams truncated due to a too small receive buffer.
+		uint64_t recvTruncatedCount{ 0u };
 	};
 };
 
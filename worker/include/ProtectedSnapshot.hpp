@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace RTC
+{
+
+// Read-mostly object: readers take an immutable snapshot without exclusive lock,
+// writers are serialized and publish a modified copy (copy-on-write).
+// Writers never wait for readers: the replaced snapshot is destroyed by its last
+// reader, so an item removed by Update() may still be in use after return,
+// hold items by shared_ptr if their lifetime matters.
+template <typename T>
+class ProtectedSnapshot
+{
+public:
+    using Snapshot = std::shared_ptr<const T>;
+    ProtectedSnapshot();
+    explicit ProtectedSnapshot(T val);
+    ProtectedSnapshot(const ProtectedSnapshot&) = delete;
+    ProtectedSnapshot& operator=(const ProtectedSnapshot&) = delete;
+    Snapshot Get() const { return std::atomic_load_explicit(&_snapshot, std::memory_order_acquire); }
+    // [modifier] is called with mutable copy of current value and returns true
+    // if the copy was changed and should be published
+    template <class Modifier>
+    bool Update(Modifier&& modifier);
+    void Set(T val);
+private:
+    void Publish(Snapshot snapshot);
+private:
+    std::mutex _writerMtx;
+    Snapshot _snapshot;
+};
+
+template <typename T>
+ProtectedSnapshot<T>::ProtectedSnapshot()
+    : _snapshot(std::make_shared<const T>())
+{
+}
+
+template <typename T>
+ProtectedSnapshot<T>::ProtectedSnapshot(T val)
+    : _snapshot(std::make_shared<const T>(std::move(val)))
+{
+}
+
+template <typename T>
+template <class Modifier>
+bool ProtectedSnapshot<T>::Update(Modifier&& modifier)
+{
+    const std::lock_guard<std::mutex> lock(_writerMtx);
+    auto copy = std::make_shared<T>(*_snapshot);
+    if (modifier(*copy)) {
+        Publish(std::move(copy));
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+void ProtectedSnapshot<T>::Set(T val)
+{
+    const std::lock_guard<std::mutex> lock(_writerMtx);
+    Publish(std::make_shared<const T>(std::move(val)));
+}
+
+template <typename T>
+void ProtectedSnapshot<T>::Publish(Snapshot snapshot)
+{
+    std::atomic_store_explicit(&_snapshot, std::move(snapshot), std::memory_order_release);
+}
+
+} // namespace RTC
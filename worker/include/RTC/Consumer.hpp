@@ -5,6 +5,7 @@
 #include "Channel/ChannelRequest.hpp"
 #include "Channel/ChannelSocket.hpp"
 #include "FBS/consumer.h"
+#include "RTC/MediaTranslate/TranslationStats.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
 #include "RTC/RTCP/FeedbackPs.hpp"
 #include "RTC/RTCP/FeedbackPsFir.hpp"
@@ -19,6 +20,7 @@
 #include "RTC/RtpStreamSend.hpp"
 #include "RTC/Shared.hpp"
 #include <absl/container/flat_hash_set.h>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -39,6 +41,8 @@ namespace RTC
 			virtual void OnConsumerNeedBitrateChange(RTC::Consumer* consumer)                      = 0;
 			virtual void OnConsumerNeedZeroBitrate(RTC::Consumer* consumer)                        = 0;
 			virtual void OnConsumerProducerClosed(RTC::Consumer* consumer)                         = 0;
+			virtual void OnConsumerNeedTranslationStats(
+			  const RTC::Consumer* consumer, std::optional<RTC::TranslationStats>& stats) = 0;
 		};
 
 	public:
@@ -135,6 +139,13 @@ namespace RTC
 		void ProducerPaused();
 		void ProducerResumed();
         virtual bool IsTranslationRequired() const { return false; }
+		// Original media of the Producer is not forwarded while translated media
+		// is injected via SendRtpPacket().
+		void SetMediaReplaced(bool mediaReplaced);
+		bool IsMediaReplaced() const
+		{
+			return this->mediaReplaced;
+		}
 		virtual void ProducerRtpStream(RTC::RtpStreamRecv* rtpStream, uint32_t mappedSsrc)    = 0;
 		virtual void ProducerNewRtpStream(RTC::RtpStreamRecv* rtpStream, uint32_t mappedSsrc) = 0;
 		void ProducerRtpStreamScores(const std::vector<uint8_t>* scores);
@@ -179,6 +190,9 @@ namespace RTC
 		virtual void UserOnTransportDisconnected() = 0;
 		virtual void UserOnPaused()                = 0;
 		virtual void UserOnResumed()               = 0;
+		virtual void UserOnMediaReplaced()
+		{
+		}
 
 	public:
 		// Passed by argument.
@@ -213,6 +227,7 @@ namespace RTC
 		bool paused{ false };
 		bool producerPaused{ false };
 		bool producerClosed{ false };
+		bool mediaReplaced{ false };
 	};
 } // namespace RTC
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/RecordingSettings.hpp"
+#include <memory>
+#include <string>
+
+namespace RTC
+{
+
+// recording output device: media is appended into in-memory chunk on the caller thread,
+// complete chunks are written by the shared background thread, which also opens the file
+// and hands partially filled chunks after flush interval, so disk I/O never blocks
+// the media path; if the disk is slower than the media then the chunks above of
+// [RecordingSettings::_maxPendingSize] are dropped and counted
+class AsyncFileWriter : public OutputDevice
+{
+    class File;
+    class Flusher;
+public:
+    ~AsyncFileWriter() final;
+    // null if [fileNameUtf8] is empty, open error is logged by the writer thread
+    // and counted as failed write, data of such file is dropped
+    static std::unique_ptr<AsyncFileWriter> Create(std::string fileNameUtf8,
+                                                   const RecordingSettings& settings);
+    // hand remaining data to the writer thread, file will be closed after it
+    void Close();
+    bool IsOpen() const { return nullptr != _file; }
+    // back-pressure counters
+    uint64_t GetWrittenBytes() const;
+    uint64_t GetPendingBytes() const;
+    uint64_t GetDroppedBytes() const;
+    uint64_t GetFailedWrites() const;
+    // impl. of OutputDevice
+    void Write(const std::shared_ptr<const MemoryBuffer>& buffer) final;
+private:
+    explicit AsyncFileWriter(std::shared_ptr<File> file);
+    static size_t AlignChunkSize(uint32_t size);
+private:
+    std::shared_ptr<File> _file;
+};
+
+} // namespace RTC
@@ -2,6 +2,8 @@
 
 #include "RTC/MediaTranslate/ConsumerTranslatorSettings.hpp"
 #include "RTC/MediaTranslate/ConsumerObserver.hpp"
+#include "RTC/MediaTranslate/TranslationStats.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPointSink.hpp"
 #include <memory>
 #include <list>
 
@@ -9,24 +11,22 @@ namespace RTC
 {
 
 class Consumer;
+class RtpPacketizerOpus;
 class TranslatorEndPoint;
-class ProducerInputMediaStreamer;
+class TranslatorEndPointFactory;
 
-class ConsumerTranslator : public ConsumerTranslatorSettings
+class ConsumerTranslator : public ConsumerTranslatorSettings, public TranslatorEndPointSink
 {
 public:
     ConsumerTranslator(Consumer* consumer,
                        const std::string& producerId,
-                       const std::string& serviceUri,
-                       const std::string& serviceUser = std::string(),
-                       const std::string& servicePassword = std::string());
+                       TranslatorEndPointFactory* endPointsFactory);
     ~ConsumerTranslator() final;
     const std::string& GetProducerId() const { return _producerId; }
     void AddObserver(ConsumerObserver* observer);
     void RemoveObserver(ConsumerObserver* observer);
-    uint32_t GetProducerInputSsrc() const;
-    void SetProducerInput(const std::shared_ptr<ProducerInputMediaStreamer>& input);
-    void SetProducerLanguage(const std::optional<MediaLanguage>& language);
+    // play-out statistics of the current end-point and packets sent by this translator
+    TranslationStats GetStats() const;
     // impl. of TranslatorUnit
     const std::string& GetId() const final;
     // impl. of ConsumerTranslatorSettings
@@ -36,16 +36,31 @@ public:
     MediaVoice GetVoice() const final { return _voice; }
     void SetEnabled(bool enabled) final;
     bool IsEnabled() const final { return _enabled; }
+    // impl. of TranslatorEndPointSink, translated media from the shared end-point
+    void OnTranslatedFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                           bool newSequence, uint64_t nowMs) final;
 protected:
     void OnPauseChanged(bool pause) final;
 private:
+    // attach to the end-point matched to current translation settings,
+    // previous end-point remains alive while other consumers are using it
+    void UpdateEndPoint();
+    // original media of producer is suppressed while translated media is injected
+    void SetMediaReplaced(bool replaced);
+    // null if consumer doesn't support OPUS
+    std::unique_ptr<RtpPacketizerOpus> CreatePacketizer() const;
     template <class Method, typename... Args>
     void InvokeObserverMethod(const Method& method, Args&&... args) const;
 private:
     Consumer* const _consumer;
     const std::string _producerId;
-    const std::unique_ptr<TranslatorEndPoint> _endPoint;
+    TranslatorEndPointFactory* const _endPointsFactory;
+    std::shared_ptr<TranslatorEndPoint> _endPoint;
     std::list<ConsumerObserver*> _observers;
+    // survives end-point changes, so RTP stream remains continuous
+    std::unique_ptr<RtpPacketizerOpus> _packetizer;
+    bool _packetizerFailed = false;
+    uint64_t _sentPackets = 0ULL;
     // output language
     MediaLanguage _language = DefaultOutputMediaLanguage();
     // voice
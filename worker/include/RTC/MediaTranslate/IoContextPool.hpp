@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace asio {
+class io_context;
+}
+
+namespace RTC
+{
+
+// fixed set of ASIO contexts shared by all websockets and translation pipelines,
+// each context is served by own thread, users are pinned round-robin
+class IoContextPool
+{
+    class Guard;
+public:
+    ~IoContextPool();
+    static IoContextPool& GetInstance();
+    asio::io_context* NextContext();
+private:
+    IoContextPool(size_t size);
+private:
+    std::vector<std::unique_ptr<asio::io_context>> _contexts;
+    std::vector<std::unique_ptr<Guard>> _guards;
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _next = 0UL;
+};
+
+} // namespace RTC
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace RTC
+{
+
+// histogram of stage latencies with fixed exponential buckets, lock-free:
+// Add() may be called from the media threads concurrently with GetSnapshot()
+class LatencyHistogram
+{
+public:
+    // upper bounds of buckets in microseconds, the last bucket is unbounded
+    static inline constexpr std::array<uint32_t, 16U> _boundsUs = {
+        100U, 250U, 500U, 1000U, 2500U, 5000U, 10000U, 25000U, 50000U,
+        100000U, 250000U, 500000U, 1000000U, 2500000U, 5000000U, 10000000U
+    };
+    static inline constexpr size_t _bucketsCount = _boundsUs.size() + 1UL;
+    struct Snapshot
+    {
+        std::array<uint64_t, _bucketsCount> _buckets = {};
+        uint64_t _count = 0ULL;
+        uint64_t _sumUs = 0ULL;
+        uint64_t _maxUs = 0ULL;
+        void Merge(const Snapshot& other);
+        // upper bound of the bucket which contains given share of samples,
+        // [percentile] is in range 0..100, max latency for the unbounded bucket
+        uint64_t GetPercentileUs(double percentile) const;
+    };
+public:
+    void Add(uint64_t latencyUs);
+    // [startUs] is a time point of NowUs()
+    void AddSince(uint64_t startUs);
+    Snapshot GetSnapshot() const;
+    // microseconds of monotonic clock
+    static uint64_t NowUs();
+private:
+    std::array<std::atomic<uint64_t>, _bucketsCount> _buckets = {};
+    std::atomic<uint64_t> _count = 0ULL;
+    std::atomic<uint64_t> _sumUs = 0ULL;
+    std::atomic<uint64_t> _maxUs = 0ULL;
+};
+
+} // namespace RTC
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <optional>
+
+namespace RTC
+{
+
+// framing of media frames sent to the translation service
+enum class MediaFrameFormat
+{
+    WebM,
+    // length-prefixed records, see RtpRawFrameSerializer
+    Raw,
+    // Ogg pages of Opus audio, see RtpOggOpusSerializer
+    Ogg
+};
+
+inline constexpr MediaFrameFormat DefaultMediaFrameFormat() { return MediaFrameFormat::WebM; }
+
+std::string_view MediaFrameFormatToString(MediaFrameFormat format);
+
+std::optional<MediaFrameFormat> MediaFrameFormatFromString(const std::string_view& format);
+
+} // namespace RTC
@@ -30,6 +30,14 @@ struct TranslationPack
     TranslationPack();
     TranslationPack(MediaLanguage languageTo, MediaVoice voice,
                     const std::optional<MediaLanguage>& languageFrom = std::nullopt);
+    bool operator == (const TranslationPack& other) const;
+    bool operator != (const TranslationPack& other) const { return !(*this == other); }
+    template <typename H>
+    friend H AbslHashValue(H h, const TranslationPack& pack) {
+        return H::combine(std::move(h), pack._languageTo, pack._voice,
+                          pack._languageFrom.has_value(),
+                          pack._languageFrom.value_or(pack._languageTo));
+    }
 };
 
 // TODO: RU for tests only, remove it for production, should be auto (std::nullopt)
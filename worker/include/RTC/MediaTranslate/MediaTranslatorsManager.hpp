@@ -2,7 +2,15 @@
 
 #include "common.hpp"
 #include "RTC/TransportListener.hpp"
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
+#include "RTC/MediaTranslate/TranslationBalancingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationServiceHost.hpp"
+#include "RTC/MediaTranslate/VoiceActivitySettings.hpp"
+#include "RTC/MediaTranslate/WebsocketPoolSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueueSettings.hpp"
+#include "RTC/MediaTranslate/WriteCoalescingSettings.hpp"
 #include <string>
+#include <vector>
 
 namespace RTC
 {
@@ -16,10 +24,15 @@ class MediaTranslatorsManager : public TransportListener
 {
     class Impl;
 public:
+    // new sessions are balanced between [services] hosts, see TranslationServiceBalancer
     MediaTranslatorsManager(TransportListener* router,
-                            const std::string& serviceUri,
-                            const std::string& serviceUser = std::string(),
-                            const std::string& servicePassword = std::string());
+                            const std::vector<TranslationServiceHost>& services,
+                            MediaFrameFormat serviceMediaFormat = DefaultMediaFrameFormat(),
+                            const WriteCoalescingSettings& serviceCoalescing = WriteCoalescingSettings(),
+                            const WebsocketSendQueueSettings& serviceSendQueue = WebsocketSendQueueSettings(),
+                            const VoiceActivitySettings& voiceActivity = VoiceActivitySettings(),
+                            const WebsocketPoolSettings& servicePool = WebsocketPoolSettings(),
+                            const TranslationBalancingSettings& serviceBalancing = TranslationBalancingSettings());
     ~MediaTranslatorsManager();
     // producers API
     std::weak_ptr<ProducerTranslatorSettings> GetTranslatorSettings(const Producer* producer) const;
@@ -42,6 +55,14 @@ public:
     void OnTransportNeedWorstRemoteFractionLost(Transport* transport, Producer* producer,
                                                 uint32_t mappedSsrc,
                                                 uint8_t& worstRemoteFractionLost) final;
+    void OnTransportProducerRecordingChanged(Transport* transport, Producer* producer,
+                                             const std::optional<RecordingSettings>& settings) final;
+    void OnTransportProducerNeedTranslationUplinkStats(Transport* transport, const Producer* producer,
+                                                       std::optional<WebsocketSendStats>& stats) final;
+    void OnTransportProducerNeedTranslationLatencyStats(Transport* transport, const Producer* producer,
+                                                        ProducerTranslationLatencyStats& stats) final;
+    void OnTransportConsumerNeedTranslationStats(Transport* transport, const Consumer* consumer,
+                                                 std::optional<TranslationStats>& stats) final;
     void OnTransportNewConsumer(Transport* transport, Consumer* consumer,
                                 const std::string& producerId) final;
     void OnTransportConsumerClosed(Transport* transport, Consumer* consumer) final;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace RTC
+{
+
+class SimpleMemoryBuffer;
+
+// slab pool of payload buffers, grouped by power-of-two size classes,
+// buffer returns to the pool when the last external reference is dropped,
+// not thread-safe for allocations but buffers may be released on any thread
+class MemoryBufferPool
+{
+public:
+    MemoryBufferPool(size_t maxBuffersPerClass = 32UL);
+    ~MemoryBufferPool();
+    // return empty buffer with capacity at least [capacity] bytes
+    std::shared_ptr<SimpleMemoryBuffer> Allocate(size_t capacity);
+    // return buffer with copy of [data], null if input is empty
+    std::shared_ptr<SimpleMemoryBuffer> Allocate(const uint8_t* data, size_t len);
+    // number of heap allocations since creation, must be constant in steady state
+    uint64_t GetAllocationsCount() const { return _allocations.load(std::memory_order_relaxed); }
+    uint64_t GetReusesCount() const { return _reuses.load(std::memory_order_relaxed); }
+private:
+    static std::optional<size_t> GetSizeClass(size_t size);
+    static size_t GetSizeClassCapacity(size_t sizeClass);
+    std::shared_ptr<SimpleMemoryBuffer> CreateBuffer(size_t capacity);
+private:
+    // 256 bytes ... 256 kb
+    static inline constexpr size_t _minSizeClassLog2 = 8UL;
+    static inline constexpr size_t _sizeClassesCount = 11UL;
+    const size_t _maxBuffersPerClass;
+    std::array<std::vector<std::shared_ptr<SimpleMemoryBuffer>>, _sizeClassesCount> _buffers;
+    std::atomic<uint64_t> _allocations = 0ULL;
+    std::atomic<uint64_t> _reuses = 0ULL;
+};
+
+} // namespace RTC
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
 #include <cstdint>
+#include <memory>
 
 namespace RTC
 {
@@ -10,8 +12,12 @@ class OutputDevice;
 class ProducerInputMediaStreamer
 {
 public:
+    virtual ~ProducerInputMediaStreamer() = default;
     virtual uint32_t GetSsrc() const = 0;
-	virtual bool AddOutputDevice(OutputDevice* outputDevice) = 0;
+    // media is serialized into [format] for this device, the device is referenced
+    // until the media writes in progress are done, so it may outlive RemoveOutputDevice()
+    virtual bool AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice,
+                                 MediaFrameFormat format = DefaultMediaFrameFormat()) = 0;
     virtual bool RemoveOutputDevice(OutputDevice* outputDevice) = 0;
 };
 
@@ -4,11 +4,14 @@
 #include "RTC/RtpPacketsCollector.hpp"
 #include "RTC/MediaTranslate/ProducerTranslatorSettings.hpp"
 #include "RTC/MediaTranslate/ProducerObserver.hpp"
+#include "RTC/MediaTranslate/RecordingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationLatencyStats.hpp"
+#include "RTC/MediaTranslate/VoiceActivitySettings.hpp"
 #include "ProtectedObj.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <atomic>
 #include <list>
-
-#define WRITE_PRODUCER_RECV_TO_FILE
+#include <vector>
 
 namespace RTC
 {
@@ -24,9 +27,14 @@ class ProducerTranslator : public ProducerTranslatorSettings, public RtpPacketsC
 {
     class StreamInfo;
 public:
-    ProducerTranslator(Producer* producer);
+    // silence of audio streams isn't sent to the service according to [voiceActivity]
+    ProducerTranslator(Producer* producer,
+                       const VoiceActivitySettings& voiceActivity = VoiceActivitySettings());
     ~ProducerTranslator() final;
     bool IsAudio() const;
+    // true while at least one stream has translation pipeline, i.e. somebody consumes
+    // the translation, packets of idle producer are dropped before lookup of the stream
+    bool IsActive() const { return _activeStreams->load(std::memory_order_relaxed) > 0U; }
     void AddObserver(ProducerObserver* observer);
     void RemoveObserver(ProducerObserver* observer);
     bool RegisterStream(const RtpStream* stream, uint32_t mappedSsrc);
@@ -34,6 +42,12 @@ public:
     std::shared_ptr<ProducerInputMediaStreamer> GetMediaStreamer(uint32_t mappedSsrc) const;
     // list of ssrcs
     std::list<uint32_t> GetRegisteredSsrcs(bool mapped) const;
+    // packets dropped by overflow of translation queues
+    uint64_t GetDroppedPacketsCount() const;
+    // per stream, worker thread only
+    std::vector<TranslationStreamLatencyStats> GetLatencyStats() const;
+    // recording of received media into files, null settings disables it
+    void SetRecording(const std::optional<RecordingSettings>& settings);
     // impl. of TranslatorUnit
     const std::string& GetId() const final;
     // impl. of RtpPacketsCollector
@@ -48,13 +62,19 @@ protected:
                                     uint32_t mappedSsrc, bool registered);
     // impl. of
     void OnPauseChanged(bool pause) final;
+private:
+    std::string GetRecordingFileNamePrefix() const;
 private:
     Producer* const _producer;
+    const VoiceActivitySettings _voiceActivity;
+    // streams may outlive the translator in pending tasks of translation thread
+    const std::shared_ptr<std::atomic<uint32_t>> _activeStreams;
     std::list<ProducerObserver*> _observers;
     // key is mapped media SSRC
     absl::flat_hash_map<uint32_t, std::shared_ptr<StreamInfo>> _streams;
     // input language
     std::optional<MediaLanguage> _language = DefaultInputMediaLanguage();
+    std::optional<RecordingSettings> _recording;
 };
 
 } // namespace RTC
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace RTC
+{
+
+enum class RecordingSyncPolicy
+{
+    None,
+    // fdatasync after each flushed chunk
+    OnFlush,
+    // fdatasync once before closing of file
+    OnClose
+};
+
+struct RecordingSettings
+{
+    // output directory for recorded files
+    std::string _directory;
+    // max age of buffered data before it's handed to the writer thread
+    uint32_t _flushIntervalMs = 1000U;
+    // chunk size, rounded up to 4kb for aligned writes
+    uint32_t _flushSize = 256U * 1024U;
+    // back-pressure limit, data above it is dropped instead of blocking the media path
+    uint32_t _maxPendingSize = 4U * 1024U * 1024U;
+    RecordingSyncPolicy _syncPolicy = RecordingSyncPolicy::OnClose;
+};
+
+} // namespace RTC
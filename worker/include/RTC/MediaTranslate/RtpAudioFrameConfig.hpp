@@ -13,7 +13,8 @@ struct RtpAudioFrameConfig
 {
 	uint8_t _channelCount  = 1U;
     uint8_t _bitsPerSample = 16U;
-    std::unique_ptr<const MemoryBuffer> _codecSpecificData;
+    // shared between frames of the same stream
+    std::shared_ptr<const MemoryBuffer> _codecSpecificData;
 };
 
 std::string RtpAudioFrameConfigToString(const RtpAudioFrameConfig& config);
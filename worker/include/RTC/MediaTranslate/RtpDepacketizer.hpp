@@ -6,24 +6,47 @@
 namespace RTC
 {
 
+class MemoryBufferPool;
 class RtpMediaFrame;
 class RtpMediaFrameSerializer;
 class RtpPacket;
+class SimpleMemoryBuffer;
 
 class RtpDepacketizer
 {
 public:
     virtual ~RtpDepacketizer() = default;
     virtual std::shared_ptr<RtpMediaFrame> AddPacket(const RtpPacket* packet) = 0;
+    // frames completed by the last added packet in addition to the returned one,
+    // a late packet of reordered stream may complete several frames at once
+    virtual std::shared_ptr<RtpMediaFrame> NextFrame() { return nullptr; }
+    // true if a key frame is needed because the stream is not decodable anymore,
+    // flag is reset by the call, repeated requests are throttled by the depacketizer
+    virtual bool TakeKeyFrameRequest() { return false; }
+    // frames with lost packets & complete frames which were not decodable
+    virtual uint64_t GetIncompleteFramesCount() const { return 0ULL; }
+    virtual uint64_t GetUndecodableFramesCount() const { return 0ULL; }
     const RtpCodecMimeType& GetCodecMimeType() const { return _codecMimeType; }
+    // number of heap allocations made for frames & payloads since creation
+    uint64_t GetAllocationsCount() const;
+    // cheap check without creation of depacketizer
+    static bool IsSupported(const RtpCodecMimeType& mimeType);
     static std::unique_ptr<RtpDepacketizer> create(const RtpCodecMimeType& mimeType,
-                                                   uint32_t sampleRate);
+                                                   uint32_t sampleRate,
+                                                   const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
 protected:
-    RtpDepacketizer(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate);
+    RtpDepacketizer(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate,
+                    const std::shared_ptr<MemoryBufferPool>& buffersPool);
     uint32_t GetSampleRate() const { return _sampleRate; }
+    // pooled (if pool is available) buffers for payloads
+    std::shared_ptr<SimpleMemoryBuffer> AllocatePayload(size_t capacity);
+    std::shared_ptr<SimpleMemoryBuffer> CopyPayload(const uint8_t* data, size_t len);
+    void IncrementAllocationsCount() { ++_allocations; }
 private:
     const RtpCodecMimeType _codecMimeType;
     const uint32_t _sampleRate;
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    uint64_t _allocations = 0ULL;
 };
 
 } // namespace RTC
@@ -5,15 +5,24 @@
 namespace RTC
 {
 
+class MemoryBuffer;
+
 class RtpDepacketizerOpus : public RtpDepacketizer
 {
     class OpusHeadBuffer;
 public:
-    RtpDepacketizerOpus(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate);
+    RtpDepacketizerOpus(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate,
+                        const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
     // impl. of RtpDepacketizer
     std::shared_ptr<RtpMediaFrame> AddPacket(const RtpPacket* packet) final;
 private:
-    std::allocator<uint8_t> _payloadAllocator;
+    const std::shared_ptr<const MemoryBuffer>& GetOpusHead(uint8_t channelCount);
+private:
+    // cached per stream, rebuilt only if channels count was changed
+    std::shared_ptr<const MemoryBuffer> _opusHead;
+    uint8_t _opusHeadChannelCount = 0U;
+    // last produced frame, re-used if nobody else holds it
+    std::shared_ptr<RtpMediaFrame> _frame;
 };
 
 } // namespace RTC
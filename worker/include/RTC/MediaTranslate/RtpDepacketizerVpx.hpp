@@ -7,16 +7,30 @@
 namespace RTC
 {
 
+// frames are assembled per SSRC in order of sequence numbers, packets are held
+// in a small reorder window until the frame is complete (from start bit to marker),
+// frames with lost packets are dropped, and so are the following delta frames
+// until the next key frame, which is requested once the stream becomes undecodable
 class RtpDepacketizerVpx : public RtpDepacketizer
 {
     class RtpAssembly;
 public:
-    RtpDepacketizerVpx(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate);
+    RtpDepacketizerVpx(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate,
+                       const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
     ~RtpDepacketizerVpx() final;
     // impl. of RtpDepacketizer
     std::shared_ptr<RtpMediaFrame> AddPacket(const RtpPacket* packet) final;
+    std::shared_ptr<RtpMediaFrame> NextFrame() final;
+    bool TakeKeyFrameRequest() final;
+    uint64_t GetIncompleteFramesCount() const final { return _incompleteFrames; }
+    uint64_t GetUndecodableFramesCount() const final { return _undecodableFrames; }
 private:
     absl::flat_hash_map<uint32_t, std::unique_ptr<RtpAssembly>> _assemblies;
+    // assembly of the last added packet
+    RtpAssembly* _lastAssembly = nullptr;
+    bool _keyFrameRequested = false;
+    uint64_t _incompleteFrames = 0ULL;
+    uint64_t _undecodableFrames = 0ULL;
 };
 
 } // namespace RTC
@@ -22,26 +22,26 @@ public:
                   bool isKeyFrame, uint32_t timestamp, uint32_t ssrc,
                   uint16_t sequenceNumber, uint32_t sampleRate);
     virtual ~RtpMediaFrame() = default;
-    static std::shared_ptr<RtpMediaFrame> CreateAudio(const RtpPacket* packet,
-                                                      RtpCodecMimeType::Subtype codecType,
-                                                      uint32_t sampleRate,
-                                                      RtpAudioFrameConfig audioConfig,
-                                                      const std::allocator<uint8_t>& payloadAllocator = {});
     static std::shared_ptr<RtpMediaFrame> CreateAudio(const RtpPacket* packet,
                                                       const std::shared_ptr<const MemoryBuffer>& payload,
                                                       RtpCodecMimeType::Subtype codecType,
                                                       uint32_t sampleRate,
                                                       RtpAudioFrameConfig audioConfig);
     static std::shared_ptr<RtpMediaFrame> CreateVideo(const RtpPacket* packet,
+                                                      const std::shared_ptr<const MemoryBuffer>& payload,
                                                       RtpCodecMimeType::Subtype codecType,
                                                       uint32_t sampleRate,
-                                                      RtpVideoFrameConfig videoConfig,
-                                                      const std::allocator<uint8_t>& payloadAllocator = {});
-    static std::shared_ptr<RtpMediaFrame> CreateVideo(const RtpPacket* packet,
-                                                      const std::shared_ptr<const MemoryBuffer>& payload,
+                                                      RtpVideoFrameConfig videoConfig);
+    // for frames assembled from several packets
+    static std::shared_ptr<RtpMediaFrame> CreateVideo(const std::shared_ptr<const MemoryBuffer>& payload,
                                                       RtpCodecMimeType::Subtype codecType,
+                                                      bool isKeyFrame, uint32_t timestamp,
+                                                      uint32_t ssrc, uint16_t sequenceNumber,
                                                       uint32_t sampleRate,
                                                       RtpVideoFrameConfig videoConfig);
+    // re-initialize frame by the new packet & payload, codec and configuration remains the same,
+    // used by depacketizers for reusing of frames which are not retained by anyone
+    void Reset(const RtpPacket* packet, const std::shared_ptr<const MemoryBuffer>& payload);
     // common
     bool IsAudio() const;
     const RtpCodecMimeType& GetCodecMimeType() const { return _codecMimeType; }
@@ -57,16 +57,13 @@ public:
     virtual const RtpAudioFrameConfig* GetAudioConfig() const { return nullptr; }
     // video configuration
     virtual const RtpVideoFrameConfig* GetVideoConfig() const { return nullptr; }
-private:
-    static std::shared_ptr<const MemoryBuffer> CreatePayload(const RtpPacket* packet,
-                                                             const std::allocator<uint8_t>& payloadAllocator);
 private:
     const RtpCodecMimeType _codecMimeType;
-    const std::shared_ptr<const MemoryBuffer> _payload;
-    const bool _isKeyFrame;
-    const uint32_t _timestamp;
-    const uint32_t _ssrc;
-    const uint16_t _sequenceNumber;
+    std::shared_ptr<const MemoryBuffer> _payload;
+    bool _isKeyFrame;
+    uint32_t _timestamp;
+    uint32_t _ssrc;
+    uint16_t _sequenceNumber;
     const uint32_t _sampleRate;
     uint32_t _absSendtime = 0U;
 };
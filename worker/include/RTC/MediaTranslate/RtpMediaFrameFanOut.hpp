@@ -0,0 +1,65 @@
+#pragma once
+
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <memory>
+#include <optional>
+
+namespace RTC
+{
+
+class MemoryBufferPool;
+class OutputDevice;
+class RtpMediaFrame;
+class RtpMediaFrameSerializer;
+
+// serialization of media frames into a set of output devices, each device has own serializer,
+// so the device attached in the middle of stream receives a complete stream of its format
+// (WebM EBML header & tracks, raw configuration record, Ogg ID & comment headers);
+// serializer of detached device is finalized into this device before its release,
+// not thread-safe
+class RtpMediaFrameFanOut
+{
+public:
+    struct Output
+    {
+        std::shared_ptr<OutputDevice> _device;
+        // requested by device
+        MediaFrameFormat _format = DefaultMediaFrameFormat();
+        // false for recording devices, see RtpMediaFrameSerializer::SetLiveMode
+        bool _liveMode = true;
+    };
+    // key is the device of output
+    using Outputs = absl::flat_hash_map<OutputDevice*, Output>;
+public:
+    explicit RtpMediaFrameFanOut(const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
+    ~RtpMediaFrameFanOut();
+    // serializers of devices which are absent in [outputs] or changed the format or mode are finalized,
+    // new devices get serializers of [mime], all serializers are re-created if [mime] is changed
+    void Update(const RtpCodecMimeType& mime, const Outputs& outputs);
+    // finalize and release all serializers & devices
+    void Reset();
+    // return true if [mediaFrame] was passed to at least one serializer
+    bool Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame);
+    bool IsEmpty() const { return _serializers.empty(); }
+    size_t GetSize() const { return _serializers.size(); }
+private:
+    struct SerializerInfo
+    {
+        // referenced until the serializer is finalized
+        std::shared_ptr<OutputDevice> _device;
+        MediaFrameFormat _format;
+        bool _liveMode;
+        // null if format doesn't support the codec
+        std::unique_ptr<RtpMediaFrameSerializer> _serializer;
+    };
+private:
+    static void Finalize(SerializerInfo& info);
+private:
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    std::optional<RtpCodecMimeType> _mime;
+    absl::flat_hash_map<OutputDevice*, SerializerInfo> _serializers;
+};
+
+} // namespace RTC
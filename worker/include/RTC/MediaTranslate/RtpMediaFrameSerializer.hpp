@@ -1,5 +1,6 @@
 #pragma once
 
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
 #include <memory>
 #include <string>
 
@@ -7,6 +8,7 @@ namespace RTC
 {
 
 class RtpMediaFrame;
+class MemoryBufferPool;
 class OutputDevice;
 class RtpCodecMimeType;
 
@@ -21,7 +23,11 @@ public:
     virtual void SetOutputDevice(OutputDevice* outputDevice);
     virtual void SetLiveMode(bool /*liveMode*/ = true) {}
     OutputDevice* GetOutputDevice() const { return _outputDevice; }
-    static std::unique_ptr<RtpMediaFrameSerializer> create(const RtpCodecMimeType& mimeType);
+    // null if [format] doesn't support codec of [mimeType],
+    // [buffersPool] is used for output buffers if serializer supports that
+    static std::unique_ptr<RtpMediaFrameSerializer> create(const RtpCodecMimeType& mimeType,
+                                                           MediaFrameFormat format = DefaultMediaFrameFormat(),
+                                                           const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
 protected:
     RtpMediaFrameSerializer() = default;
 private:
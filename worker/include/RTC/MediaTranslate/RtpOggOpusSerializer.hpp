@@ -0,0 +1,78 @@
+#pragma once
+
+#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+class SimpleMemoryBuffer;
+
+// Ogg encapsulation of Opus (RFC 7845) for audio-only uplink, much cheaper than WebM per frame:
+// ID & comment header pages are written before the first frame of each output, then Opus
+// packets are collected into pages, each page is written as a single pooled buffer;
+// granule position is the 48 kHz sample position derived from RTP timestamps, so gaps of
+// DTX or gated silence are visible to the decoder as jumps of the position
+class RtpOggOpusSerializer : public RtpMediaFrameSerializer
+{
+public:
+    // [packetsPerPage] is used in live mode, one packet per page is default there because
+    // the last packets of speech would wait in the page until the next speech otherwise,
+    // pages of file mode are filled up to ~1 second
+    RtpOggOpusSerializer(const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr,
+                         size_t packetsPerPage = DefaultPacketsPerPage);
+    ~RtpOggOpusSerializer() final;
+    static bool IsSupported(const RtpCodecMimeType& mimeType);
+    // impl. of RtpMediaFrameSerializer
+    void SetOutputDevice(OutputDevice* outputDevice) final;
+    void SetLiveMode(bool liveMode) final;
+    std::string_view GetFileExtension(const RtpCodecMimeType& mimeType) const final;
+    void Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame) final;
+public:
+    static inline constexpr size_t DefaultPacketsPerPage = 1UL;
+    static inline constexpr size_t PageHeaderSize = 27UL;
+    static inline constexpr size_t MaxSegmentsPerPage = 255UL;
+    enum PageFlags : uint8_t
+    {
+        Continued = 0x01,
+        FirstPage = 0x02,
+        LastPage  = 0x04
+    };
+private:
+    bool WriteHeaders(const RtpMediaFrame& mediaFrame, OutputDevice* outputDevice);
+    std::shared_ptr<SimpleMemoryBuffer> CreateOpusHead(const RtpMediaFrame& mediaFrame) const;
+    std::shared_ptr<SimpleMemoryBuffer> CreateOpusTags() const;
+    // packet is added to the pending page, which is written if full
+    bool AddPacket(const RtpMediaFrame& mediaFrame, OutputDevice* outputDevice);
+    bool WritePage(uint8_t flags, OutputDevice* outputDevice);
+    // single packet page, for headers
+    bool WritePage(const std::shared_ptr<const MemoryBuffer>& packet, uint8_t flags,
+                   OutputDevice* outputDevice);
+    // pending packets are written into the last page of logical stream
+    void Finalize(OutputDevice* outputDevice);
+    size_t GetPacketsPerPage() const;
+    static void AddLacingValues(size_t packetSize, std::vector<uint8_t>& segments);
+private:
+    // one second of 20 ms packets, like opusenc does
+    static inline constexpr size_t _filePacketsPerPage = 50UL;
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    const size_t _packetsPerPage;
+    bool _liveMode = true;
+    // logical stream, reset for the new output
+    bool _headersWritten = false;
+    uint32_t _serialNumber = 0U;
+    uint32_t _pageSequenceNumber = 0U;
+    std::optional<uint32_t> _lastTimestamp;
+    // RTP clock since the first packet
+    uint64_t _position = 0ULL;
+    uint64_t _granulePosition = 0ULL;
+    // pending page, payloads are copied once into the page buffer
+    std::vector<std::shared_ptr<const MemoryBuffer>> _packets;
+    std::vector<uint8_t> _segments;
+    size_t _bodySize = 0UL;
+};
+
+} // namespace RTC
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RTC/RtpPacket.hpp"
+#include <array>
+#include <memory>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+
+// builds RTP packets of OPUS frames for one outgoing stream (RFC 7587),
+// sequence numbers and timestamps are continuous through the whole life of packetizer,
+// so the stream remains valid for the receiver when the source of frames is changed
+class RtpPacketizerOpus
+{
+public:
+    RtpPacketizerOpus(uint32_t ssrc, uint8_t payloadType);
+    RtpPacketizerOpus(uint32_t ssrc, uint8_t payloadType,
+                      uint16_t initialSequenceNumber, uint32_t initialTimestamp);
+    ~RtpPacketizerOpus();
+    // packet is owned by packetizer and valid until the next call, null if [frame] is malformed,
+    // [marker] is set for the first frame after silence, RTP timestamp is advanced by the
+    // wall-clock gap then (RFC 3551, section 4.1)
+    RtpPacket* Packetize(const std::shared_ptr<const MemoryBuffer>& frame, bool marker, uint64_t nowMs);
+    uint32_t GetSsrc() const { return _ssrc; }
+    uint8_t GetPayloadType() const { return _payloadType; }
+    // duration of OPUS packet in 48 kHz units (RFC 6716, section 3.1), zero if malformed
+    static uint32_t GetSamplesCount(const uint8_t* data, size_t len);
+private:
+    static inline constexpr uint32_t _clockRate = 48000U;
+    const uint32_t _ssrc;
+    const uint8_t _payloadType;
+    uint16_t _sequenceNumber;
+    uint32_t _timestamp;
+    // duration of the last packet, in RTP timestamp units
+    uint32_t _lastDuration = 0U;
+    uint64_t _lastPacketMs = 0ULL;
+    std::array<uint8_t, MtuSize> _buffer;
+    std::unique_ptr<RtpPacket> _packet;
+};
+
+} // namespace RTC
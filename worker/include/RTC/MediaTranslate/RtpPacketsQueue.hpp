@@ -0,0 +1,90 @@
+#pragma once
+
+#include "RTC/MediaTranslate/SpscQueue.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <atomic>
+#include <memory>
+
+namespace RTC
+{
+
+// copies of RTP packets passed from the worker thread to one translation thread,
+// processed items are given back by consumer and reused by producer, so packets are
+// copied into recycled buffers and the queue doesn't allocate memory in steady state
+// (only while warming up and after overflows); [TInfo] is metadata of packet
+template <class TInfo>
+class RtpPacketsQueue
+{
+public:
+    struct Item
+    {
+        std::unique_ptr<RtpPacket> _packet;
+        TInfo _info;
+    };
+public:
+    // size of buffers of queued packets, larger packets are not accepted
+    static inline constexpr size_t _maxPacketSize = MtuSize + 100UL;
+public:
+    explicit RtpPacketsQueue(size_t capacity);
+    // producer side, return false if a packet was dropped: the oldest one for this one,
+    // or this one if it is larger than [_maxPacketSize]
+    bool Push(const RtpPacket* packet, TInfo info);
+    // consumer side, return null if queue is empty
+    std::unique_ptr<Item> Pop() { return _items.Pop(); }
+    // consumer side, processed item is reused by producer
+    void Recycle(std::unique_ptr<Item> item);
+    bool IsEmpty() const { return _items.IsEmpty(); }
+    size_t GetCapacity() const { return _items.GetCapacity(); }
+    uint64_t GetDroppedCount() const { return _items.GetDroppedCount(); }
+    // number of packets allocated by producer
+    uint64_t GetAllocationsCount() const { return _allocations.load(std::memory_order_relaxed); }
+private:
+    SpscQueue<Item> _items;
+    // in reverse direction, from consumer to producer
+    SpscQueue<Item> _recycledItems;
+    std::atomic<uint64_t> _allocations = 0ULL;
+};
+
+template <class TInfo>
+RtpPacketsQueue<TInfo>::RtpPacketsQueue(size_t capacity)
+    : _items(capacity)
+    , _recycledItems(capacity)
+{
+}
+
+template <class TInfo>
+bool RtpPacketsQueue<TInfo>::Push(const RtpPacket* packet, TInfo info)
+{
+    if (packet) {
+        if (packet->GetSize() > _maxPacketSize) {
+            return false;
+        }
+        auto item = _recycledItems.Pop();
+        if (item) {
+            if (!packet->CloneInto(item->_packet.get())) {
+                _recycledItems.Push(std::move(item));
+                return false;
+            }
+        }
+        else {
+            item = std::make_unique<Item>();
+            item->_packet.reset(packet->Clone());
+            _allocations.fetch_add(1ULL, std::memory_order_relaxed);
+        }
+        item->_info = std::move(info);
+        return _items.Push(std::move(item));
+    }
+    return true;
+}
+
+template <class TInfo>
+void RtpPacketsQueue<TInfo>::Recycle(std::unique_ptr<Item> item)
+{
+    if (item && item->_packet) {
+        // keeps codec state of payload descriptor alive otherwise
+        item->_packet->SetPayloadDescriptorHandler(nullptr);
+        _recycledItems.Push(std::move(item));
+    }
+}
+
+} // namespace RTC
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include <cstdint>
+#include <optional>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+class SimpleMemoryBuffer;
+
+// compact alternative of WebM for the translation uplink: each frame is a single
+// length-prefixed record written into pooled buffer, no container state is kept
+// except of the last codec configuration, which is repeated when it's changed
+//
+// record layout, multi-byte fields are big-endian:
+//  0  uint32  size of record without this field
+//  4  uint8   record type, see RecordType
+//  5  uint8   codec, see CodecId
+//  6  uint8   flags, bit 0 - key frame
+//  7  uint8   reserved, zero
+//  8  uint16  RTP sequence number
+//  10 uint32  RTP timestamp
+//  14 ...     frame payload or configuration
+// configuration is uint32 clock rate, then uint8 channels count & uint8 bits per sample
+// for audio or uint16 width & uint16 height for video, then codec specific data
+class RtpRawFrameSerializer : public RtpMediaFrameSerializer
+{
+public:
+    enum class RecordType : uint8_t
+    {
+        Frame  = 0U,
+        Config = 1U
+    };
+    enum class CodecId : uint8_t
+    {
+        Opus = 1U,
+        Vp8  = 2U,
+        Vp9  = 3U
+    };
+public:
+    RtpRawFrameSerializer(const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
+    ~RtpRawFrameSerializer() final;
+    static bool IsSupported(const RtpCodecMimeType& mimeType);
+    static std::optional<CodecId> GetCodecId(const RtpCodecMimeType& mimeType);
+    // impl. of RtpMediaFrameSerializer
+    void SetOutputDevice(OutputDevice* outputDevice) final;
+    std::string_view GetFileExtension(const RtpCodecMimeType& mimeType) const final;
+    void Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame) final;
+public:
+    static inline constexpr size_t HeaderSize = 14UL;
+    static inline constexpr size_t AudioConfigSize = 6UL;
+    static inline constexpr size_t VideoConfigSize = 8UL;
+private:
+    // return true if configuration of [mediaFrame] differs from the last written one
+    bool IsConfigChanged(const RtpMediaFrame& mediaFrame, CodecId codec) const;
+    std::shared_ptr<SimpleMemoryBuffer> CreateConfig(const RtpMediaFrame& mediaFrame, CodecId codec);
+    std::shared_ptr<SimpleMemoryBuffer> CreateFrame(const RtpMediaFrame& mediaFrame, CodecId codec);
+    // allocate buffer for the record and write its header
+    std::shared_ptr<SimpleMemoryBuffer> CreateRecord(RecordType type, CodecId codec,
+                                                     const RtpMediaFrame& mediaFrame,
+                                                     size_t bodySize);
+private:
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    // last written configuration, reset for the new output
+    std::optional<CodecId> _codec;
+    std::shared_ptr<const MemoryBuffer> _codecSpecificData;
+    int32_t _width = 0;
+    int32_t _height = 0;
+};
+
+} // namespace RTC
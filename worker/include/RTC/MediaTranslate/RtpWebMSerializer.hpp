@@ -19,6 +19,7 @@ public:
     RtpWebMSerializer();
     ~RtpWebMSerializer() final;
     static bool IsSupported(const RtpCodecMimeType& mimeType);
+    static inline constexpr std::string_view _fileExtension = "webm";
     // impl. of RtpMediaFrameSerializer
     void SetOutputDevice(OutputDevice* outputDevice) final;
     void SetLiveMode(bool liveMode) final;
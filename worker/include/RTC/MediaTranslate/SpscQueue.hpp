@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace RTC
+{
+
+// bounded lock-free queue of owned items for one producer and one consumer thread,
+// if queue is full then producer drops the oldest item (drop-oldest policy):
+// both sides advance the read position by CAS, so the item is owned by the side
+// which has won the race, consumer never touches an item before its CAS succeeded
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity);
+    ~SpscQueue();
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    // producer side, return false if the oldest item was dropped for this one
+    bool Push(std::unique_ptr<T> item);
+    // consumer side, return null if queue is empty
+    std::unique_ptr<T> Pop();
+    bool IsEmpty() const;
+    // approximate if called concurrently with Push or Pop
+    size_t GetSize() const;
+    size_t GetCapacity() const { return _slots.size(); }
+    uint64_t GetDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+private:
+    std::vector<std::atomic<T*>> _slots;
+    // next write position, changed by producer only
+    alignas(64) std::atomic<uint64_t> _head = 0ULL;
+    // next read position, changed by consumer or by producer on overflow
+    alignas(64) std::atomic<uint64_t> _tail = 0ULL;
+    std::atomic<uint64_t> _dropped = 0ULL;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity)
+    : _slots(std::max<size_t>(1UL, capacity))
+{
+    for (auto& slot : _slots) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue()
+{
+    while (Pop()) {}
+}
+
+template <typename T>
+bool SpscQueue<T>::Push(std::unique_ptr<T> item)
+{
+    bool ok = true;
+    if (item) {
+        const auto head = _head.load(std::memory_order_relaxed);
+        auto tail = _tail.load(std::memory_order_acquire);
+        while (head - tail >= _slots.size()) {
+            // full, try to take ownership of the oldest item
+            const auto& slot = _slots[tail % _slots.size()];
+            if (_tail.compare_exchange_weak(tail, tail + 1ULL,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                delete slot.load(std::memory_order_relaxed);
+                _dropped.fetch_add(1ULL, std::memory_order_relaxed);
+                ok = false;
+                break;
+            }
+        }
+        _slots[head % _slots.size()].store(item.release(), std::memory_order_relaxed);
+        _head.store(head + 1ULL, std::memory_order_release);
+    }
+    return ok;
+}
+
+template <typename T>
+std::unique_ptr<T> SpscQueue<T>::Pop()
+{
+    auto tail = _tail.load(std::memory_order_acquire);
+    while (tail != _head.load(std::memory_order_acquire)) {
+        const auto item = _slots[tail % _slots.size()].load(std::memory_order_relaxed);
+        if (_tail.compare_exchange_weak(tail, tail + 1ULL,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            return std::unique_ptr<T>(item);
+        }
+    }
+    return nullptr;
+}
+
+template <typename T>
+bool SpscQueue<T>::IsEmpty() const
+{
+    return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+}
+
+template <typename T>
+size_t SpscQueue<T>::GetSize() const
+{
+    const auto tail = _tail.load(std::memory_order_acquire);
+    const auto head = _head.load(std::memory_order_acquire);
+    return head > tail ? static_cast<size_t>(head - tail) : 0UL;
+}
+
+} // namespace RTC
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "handles/TimerHandle.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <memory>
+#include <vector>
+
+namespace RTC
+{
+
+// single libuv timer which drives many periodic tasks of the worker thread,
+// tasks are bucketed into slots of [tickMs] granularity, timer is active only
+// while at least one task is scheduled, not thread-safe (worker thread only)
+class TimerWheel : private TimerHandle::Listener
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        // return delay before the next call in milliseconds, zero for unschedule
+        virtual uint64_t OnTimerWheelTick(uint64_t nowMs) = 0;
+    };
+public:
+    explicit TimerWheel(uint64_t tickMs = 5ULL, size_t slotsCount = 512UL);
+    ~TimerWheel() final;
+    // (re)schedule [listener], delays beyond the wheel horizon are clamped to it
+    void Schedule(Listener* listener, uint64_t delayMs);
+    void Cancel(Listener* listener);
+    bool IsScheduled(Listener* listener) const { return _positions.contains(listener); }
+    size_t GetScheduledCount() const { return _positions.size(); }
+    uint64_t GetTickMs() const { return _tickMs; }
+private:
+    void FireSlot(size_t slot, uint64_t nowMs);
+    // impl. of TimerHandle::Listener
+    void OnTimer(TimerHandle* timer) final;
+private:
+    const uint64_t _tickMs;
+    std::vector<std::vector<Listener*>> _slots;
+    // listener -> slot index
+    absl::flat_hash_map<Listener*, size_t> _positions;
+    const std::unique_ptr<TimerHandle> _timer;
+    size_t _currentSlot = 0UL;
+    uint64_t _lastTickMs = 0ULL;
+};
+
+} // namespace RTC
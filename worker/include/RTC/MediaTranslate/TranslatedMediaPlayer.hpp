@@ -0,0 +1,61 @@
+#pragma once
+
+#include "RTC/MediaTranslate/SpscQueue.hpp"
+#include "RTC/MediaTranslate/TimerWheel.hpp"
+#include "RTC/MediaTranslate/TranslationStats.hpp"
+#include <memory>
+#include <optional>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+
+// jitter buffer of translated OPUS frames: frames are pushed by the websocket thread
+// and played out on the worker thread in real-time cadence, driven by the shared timer wheel
+class TranslatedMediaPlayer : private TimerWheel::Listener
+{
+    struct Frame;
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        virtual void OnPlayFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                                 bool newSequence, uint64_t nowMs) = 0;
+    };
+public:
+    // [capacity] is max number of buffered frames, oldest are dropped on overflow
+    TranslatedMediaPlayer(Listener* listener, size_t capacity = 256UL);
+    ~TranslatedMediaPlayer() final;
+    // websocket thread, [timestampMs] is media time of the frame
+    void Push(const std::shared_ptr<const MemoryBuffer>& frame, uint64_t timestampMs);
+    // worker thread
+    void Start(TimerWheel* timerWheel);
+    void Stop();
+    bool IsStarted() const { return nullptr != _timerWheel; }
+    TranslationStats GetStats() const;
+private:
+    void Play(const Frame& frame, uint64_t nowMs);
+    // impl. of TimerWheel::Listener
+    uint64_t OnTimerWheelTick(uint64_t nowMs) final;
+private:
+    // poll interval while buffer is empty
+    static inline constexpr uint64_t _idleIntervalUs = 20000ULL;
+    // limit of catch-up if the loop was stalled
+    static inline constexpr size_t _maxFramesPerTick = 3UL;
+    Listener* const _listener;
+    SpscQueue<Frame> _frames;
+    TimerWheel* _timerWheel = nullptr;
+    uint64_t _nextPlayUs = 0ULL;
+    // media time expected for the next frame of the current sequence
+    std::optional<uint64_t> _expectedTimestampMs;
+    // arrival & media time of the previous frame of the current sequence, for jitter
+    uint64_t _lastArrivalMs = 0ULL;
+    uint64_t _lastTimestampMs = 0ULL;
+    // buffer was empty at play-out time after the last frame of the current sequence
+    bool _starved = false;
+    TranslationStats _stats;
+};
+
+} // namespace RTC
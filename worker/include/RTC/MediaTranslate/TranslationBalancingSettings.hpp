@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RTC
+{
+
+// choice of translation service host for new sessions and migration of active ones
+struct TranslationBalancingSettings
+{
+    // each host is connected with this period to measure its connect latency
+    // and to detect its recovery, zero disables probing
+    uint32_t _probeIntervalMs = 10000U;
+    // active session is migrated to another host if its smoothed write latency
+    // (or age of queued media) is above this limit, zero disables migration by latency
+    uint32_t _failoverWriteLatencyMs = 1500U;
+};
+
+} // namespace RTC
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "FBS/producer.h"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include "RTC/MediaTranslate/MediaLanguage.hpp"
+#include "RTC/MediaTranslate/MediaVoice.hpp"
+#include <vector>
+
+namespace RTC
+{
+
+// received media of one producer stream on its way to the translation service
+struct TranslationStreamLatencyStats
+{
+    uint32_t _mappedSsrc = 0U;
+    // RTP arrival -> frame assembled, includes the translation queue
+    LatencyHistogram::Snapshot _assembly;
+    // frame assembled -> serialized and written into connected end-points
+    LatencyHistogram::Snapshot _serialization;
+    // assembled frames and their payload
+    uint64_t _frames = 0ULL;
+    uint64_t _bytes = 0ULL;
+    // packets dropped by overflow of the translation queue
+    uint64_t _droppedPackets = 0ULL;
+    // assembled frames of silence which were not sent to the service, and the number
+    // of speech segments, see VoiceActivityGate
+    uint64_t _gatedFrames = 0ULL;
+    uint64_t _gatedBytes = 0ULL;
+    uint64_t _speechSegments = 0ULL;
+    // video frames with lost packets, complete frames dropped while waiting for a key frame,
+    // and key frames requested from the producer because of that, see RtpDepacketizerVpx
+    uint64_t _incompleteFrames = 0ULL;
+    uint64_t _undecodableFrames = 0ULL;
+    uint64_t _keyFrameRequests = 0ULL;
+    flatbuffers::Offset<FBS::Producer::TranslationStreamLatency> FillBuffer(flatbuffers::FlatBufferBuilder& builder) const;
+};
+
+// connection with the translation service
+struct TranslationEndPointLatencyStats
+{
+    MediaLanguage _languageTo = DefaultOutputMediaLanguage();
+    MediaVoice _voice = DefaultMediaVoice();
+    // serialized media queued -> written into the socket
+    LatencyHistogram::Snapshot _socketWrite;
+    // the oldest unanswered media -> the first byte of translation
+    LatencyHistogram::Snapshot _firstResponse;
+    uint64_t _sentMessages = 0ULL;
+    uint64_t _sentBytes = 0ULL;
+    uint64_t _droppedMessages = 0ULL;
+    uint64_t _receivedMessages = 0ULL;
+    uint64_t _receivedBytes = 0ULL;
+    uint64_t _reconnects = 0ULL;
+    // opening of the websocket -> connected, near zero for warm sessions of the pool
+    LatencyHistogram::Snapshot _connect;
+    // sessions migrated to another host of the service
+    uint64_t _failovers = 0ULL;
+    flatbuffers::Offset<FBS::Producer::TranslationEndPointLatency> FillBuffer(flatbuffers::FlatBufferBuilder& builder) const;
+};
+
+struct ProducerTranslationLatencyStats
+{
+    std::vector<TranslationStreamLatencyStats> _streams;
+    std::vector<TranslationEndPointLatencyStats> _endPoints;
+};
+
+} // namespace RTC
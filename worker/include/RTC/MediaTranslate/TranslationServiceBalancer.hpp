@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RTC/MediaTranslate/TranslationBalancingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationServiceHost.hpp"
+#include "RTC/MediaTranslate/Websocket.hpp"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RTC
+{
+
+// chooses a host of the translation service for each new session by measured
+// connect latency, sessions in flight and recent error rate, hosts are probed
+// periodically so failed ones are returned into rotation after recovery;
+// thread-safe
+class TranslationServiceBalancer : public std::enable_shared_from_this<TranslationServiceBalancer>
+{
+    struct Host;
+    class Probe;
+    class Timer;
+public:
+    // hosts with invalid URI are ignored, [poolSettings] enables warm sessions for each host,
+    // [headers] & [sendQueueSettings] are parameters of all websockets
+    TranslationServiceBalancer(const std::vector<TranslationServiceHost>& hosts,
+                               const TranslationBalancingSettings& settings,
+                               const WebsocketPoolSettings& poolSettings,
+                               std::unordered_map<std::string, std::string> headers,
+                               const WebsocketSendQueueSettings& sendQueueSettings,
+                               const std::string& userAgent = std::string());
+    ~TranslationServiceBalancer();
+    // null if there are no valid hosts, probing is started
+    static std::shared_ptr<TranslationServiceBalancer> Create(const std::vector<TranslationServiceHost>& hosts,
+                                                              const TranslationBalancingSettings& settings,
+                                                              const WebsocketPoolSettings& poolSettings,
+                                                              std::unordered_map<std::string, std::string> headers,
+                                                              const WebsocketSendQueueSettings& sendQueueSettings,
+                                                              const std::string& userAgent = std::string());
+    const TranslationBalancingSettings& GetSettings() const { return _settings; }
+    const std::string& GetUserAgent() const { return _userAgent; }
+    size_t GetHostsCount() const;
+    // websocket (not opened) to the best host, [excluded] host is chosen only if it's the single one,
+    // [host] is set to index of the chosen host, the session is counted until Release
+    std::shared_ptr<Websocket> Acquire(const std::optional<size_t>& excluded, size_t& host);
+    void Release(size_t host);
+    // outcome of session's connection or write latency
+    void OnSessionConnected(size_t host);
+    void OnSessionFailed(size_t host);
+    const std::string& GetHostUri(size_t host) const;
+private:
+    void StartProbing();
+    void ProbeHosts();
+    void OnProbeResult(size_t host, const std::optional<uint64_t>& latencyUs);
+    // under lock
+    double GetScore(const Host& host) const;
+    bool IsHealthy(const Host& host) const;
+    void UpdateErrorRate(Host& host, bool failed);
+private:
+    // weight of new sample in smoothed values
+    static inline constexpr double _smoothing = 0.25;
+    // host is out of rotation while the smoothed share of failures is above it
+    static inline constexpr double _maxErrorRate = 0.5;
+    // how much errors are worse than latency or load
+    static inline constexpr double _errorPenalty = 10.;
+    const TranslationBalancingSettings _settings;
+    const std::unordered_map<std::string, std::string> _headers;
+    const WebsocketSendQueueSettings _sendQueueSettings;
+    const std::string _userAgent;
+    mutable std::mutex _mutex;
+    std::vector<Host> _hosts;
+    std::unique_ptr<Timer> _probeTimer;
+};
+
+} // namespace RTC
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+namespace RTC
+{
+
+// one of interchangeable hosts of the translation service
+struct TranslationServiceHost
+{
+    std::string _uri;
+    std::string _user;
+    std::string _password;
+};
+
+} // namespace RTC
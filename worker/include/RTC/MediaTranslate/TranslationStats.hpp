@@ -0,0 +1,34 @@
+#pragma once
+
+#include "RTC/MediaTranslate/TranslationLatencyStats.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
+#include <cstdint>
+
+namespace RTC
+{
+
+// play-out statistics of translated media, used for tuning of end-to-end latency
+struct TranslationStats
+{
+    // frames played out into consumers
+    uint64_t _playedFrames = 0ULL;
+    // frames which arrived after their play-out time, the gap was not filled
+    uint64_t _lateFrames = 0ULL;
+    // frames dropped by overflow of the jitter buffer
+    uint64_t _droppedFrames = 0ULL;
+    // frames waiting for play-out
+    uint32_t _bufferedFrames = 0U;
+    // inter-arrival jitter of frames (RFC 3550, section 6.4.1)
+    double _jitterMs = 0.;
+    // time spent by frames in the jitter buffer, smoothed and maximal
+    double _bufferDelayMs = 0.;
+    uint32_t _maxBufferDelayMs = 0U;
+    // RTP packets sent to the consumer
+    uint64_t _sentPackets = 0ULL;
+    // media sent to the service
+    WebsocketSendStats _uplink;
+    // stages of the round trip through the service
+    TranslationEndPointLatencyStats _latency;
+};
+
+} // namespace RTC
@@ -1,16 +1,26 @@
 #pragma once
 
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
+#include "RTC/MediaTranslate/TranslationBalancingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationServiceHost.hpp"
+#include "RTC/MediaTranslate/TranslationStats.hpp"
+#include "RTC/MediaTranslate/Websocket.hpp"
+#include "RTC/MediaTranslate/WriteCoalescingSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketPoolSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueueSettings.hpp"
 #include <memory>
 #include <string>
 #include <optional>
+#include <vector>
 
 namespace RTC
 {
 
 class ProducerInputMediaStreamer;
 class ConsumerTranslatorSettings;
-class RtpPacketsCollector;
-class Websocket;
+class TimerWheel;
+class TranslationServiceBalancer;
+class TranslatorEndPointSink;
 enum class MediaLanguage;
 enum class MediaVoice;
 
@@ -18,21 +28,74 @@ class TranslatorEndPoint
 {
     class Impl;
 public:
-    TranslatorEndPoint(const std::string& serviceUri,
+    // [timerWheel] drives play-out of translated media, must outlive the end-point,
+    // [preferredFormat] is offered to the service, WebM is used if the service doesn't confirm it,
+    // [coalescing] defines batching of media into websocket messages, [sendQueue] limits
+    // the backlog of slow connection, input media is paused while the queue is congested
+    TranslatorEndPoint(TimerWheel* timerWheel,
+                       MediaFrameFormat preferredFormat,
+                       const WriteCoalescingSettings& coalescing,
+                       const WebsocketSendQueueSettings& sendQueue,
+                       const std::string& serviceUri,
                        const std::string& serviceUser = std::string(),
                        const std::string& servicePassword = std::string(),
                        const std::string& userAgent = std::string());
+    // connection is taken from warm sessions of [pool] if possible,
+    // [preferredFormat] & [sendQueue] must match parameters of the pool
+    TranslatorEndPoint(TimerWheel* timerWheel,
+                       MediaFrameFormat preferredFormat,
+                       const WriteCoalescingSettings& coalescing,
+                       const WebsocketSendQueueSettings& sendQueue,
+                       const std::shared_ptr<Websocket::Pool>& pool);
+    // host of the service is chosen by [balancer] when opening, the session is migrated
+    // to another host if the connection is lost or write latency exceeds the failover threshold,
+    // [preferredFormat] & [sendQueue] must match parameters of the balancer
+    TranslatorEndPoint(TimerWheel* timerWheel,
+                       MediaFrameFormat preferredFormat,
+                       const WriteCoalescingSettings& coalescing,
+                       const WebsocketSendQueueSettings& sendQueue,
+                       const std::shared_ptr<TranslationServiceBalancer>& balancer);
     ~TranslatorEndPoint();
+    // warm connections for end-points with the same parameters, null if [settings] disables the pool
+    static std::shared_ptr<Websocket::Pool> GetServicePool(const WebsocketPoolSettings& settings,
+                                                           MediaFrameFormat preferredFormat,
+                                                           const WebsocketSendQueueSettings& sendQueue,
+                                                           const std::string& serviceUri,
+                                                           const std::string& serviceUser = std::string(),
+                                                           const std::string& servicePassword = std::string(),
+                                                           const std::string& userAgent = std::string());
+    // balancer of [hosts] for end-points with the same parameters, null if there are no valid hosts
+    static std::shared_ptr<TranslationServiceBalancer> CreateServiceBalancer(const std::vector<TranslationServiceHost>& hosts,
+                                                                             const TranslationBalancingSettings& balancing,
+                                                                             const WebsocketPoolSettings& poolSettings,
+                                                                             MediaFrameFormat preferredFormat,
+                                                                             const WebsocketSendQueueSettings& sendQueue,
+                                                                             const std::string& userAgent = std::string());
     void Open();
     void Close();
     void SetProducerLanguage(const std::optional<MediaLanguage>& language);
     void SetConsumerLanguage(MediaLanguage language);
     void SetConsumerVoice(MediaVoice voice);
     void SetInput(const std::shared_ptr<ProducerInputMediaStreamer>& input);
-    void SetOutput(const std::weak_ptr<RtpPacketsCollector>& outputRef);
+    // translated media is fanned out to all outputs, worker thread only
+    void AddOutput(TranslatorEndPointSink* output);
+    void RemoveOutput(TranslatorEndPointSink* output);
     uint32_t GetProducerInputSsrc() const;
+    // format of media sent to the service over the current connection
+    MediaFrameFormat GetMediaFormat() const;
+    // play-out, uplink & latency statistics, worker thread only
+    TranslationStats GetStats() const;
+    WebsocketSendStats GetSendStats() const;
+    TranslationEndPointLatencyStats GetLatencyStats() const;
+private:
+    TranslatorEndPoint(TimerWheel* timerWheel,
+                       MediaFrameFormat preferredFormat,
+                       const WriteCoalescingSettings& coalescing,
+                       const WebsocketSendQueueSettings& sendQueue,
+                       std::shared_ptr<Websocket> websocket,
+                       std::shared_ptr<TranslationServiceBalancer> balancer,
+                       const std::string& userAgent);
 private:
-    const std::shared_ptr<Websocket> _websocket;
     const std::shared_ptr<Impl> _impl;
 };
 
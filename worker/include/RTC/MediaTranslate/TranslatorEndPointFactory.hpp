@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace RTC
+{
+
+class TranslatorEndPoint;
+enum class MediaLanguage;
+enum class MediaVoice;
+
+class TranslatorEndPointFactory
+{
+public:
+    virtual ~TranslatorEndPointFactory() = default;
+    // return end-point shared between all consumers of the same producer
+    // with identical translation settings, null if producer is not registered
+    virtual std::shared_ptr<TranslatorEndPoint> GetEndPoint(const std::string& producerId,
+                                                            MediaLanguage languageTo,
+                                                            MediaVoice voice) = 0;
+};
+
+} // namespace RTC
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+
+class TranslatorEndPointSink
+{
+public:
+    virtual ~TranslatorEndPointSink() = default;
+    // next OPUS frame of translated media, called on the worker thread in real-time cadence,
+    // [newSequence] is set for the first frame after silence
+    virtual void OnTranslatedFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                                   bool newSequence, uint64_t nowMs) = 0;
+};
+
+} // namespace RTC
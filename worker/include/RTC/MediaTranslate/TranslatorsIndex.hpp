@@ -0,0 +1,68 @@
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+namespace RTC
+{
+
+// per-packet dispatch of media to translators by address of producer (or consumer),
+// lookup is hashing of pointer only, without string keys & copies of shared pointers,
+// the last hit is cached because packets of the same producer come in bursts;
+// translators are owned elsewhere and must be removed from index before destruction
+template <class TObject, class TTranslator>
+class TranslatorsIndex
+{
+public:
+    TranslatorsIndex() = default;
+    void Add(const TObject* object, TTranslator* translator);
+    void Remove(const TObject* object);
+    TTranslator* Find(const TObject* object) const;
+    size_t GetSize() const { return _translators.size(); }
+    bool IsEmpty() const { return _translators.empty(); }
+private:
+    absl::flat_hash_map<const TObject*, TTranslator*> _translators;
+    mutable const TObject* _lastObject = nullptr;
+    mutable TTranslator* _lastTranslator = nullptr;
+};
+
+template <class TObject, class TTranslator>
+void TranslatorsIndex<TObject, TTranslator>::Add(const TObject* object, TTranslator* translator)
+{
+    if (object && translator) {
+        _translators[object] = translator;
+        if (object == _lastObject) {
+            _lastTranslator = translator;
+        }
+    }
+}
+
+template <class TObject, class TTranslator>
+void TranslatorsIndex<TObject, TTranslator>::Remove(const TObject* object)
+{
+    if (object) {
+        _translators.erase(object);
+        if (object == _lastObject) {
+            _lastObject = nullptr;
+            _lastTranslator = nullptr;
+        }
+    }
+}
+
+template <class TObject, class TTranslator>
+TTranslator* TranslatorsIndex<TObject, TTranslator>::Find(const TObject* object) const
+{
+    if (object) {
+        if (object == _lastObject) {
+            return _lastTranslator;
+        }
+        const auto it = _translators.find(object);
+        if (it != _translators.end()) {
+            _lastObject = object;
+            _lastTranslator = it->second;
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace RTC
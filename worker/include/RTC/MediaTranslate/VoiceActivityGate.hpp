@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RTC/MediaTranslate/VoiceActivitySettings.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace RTC
+{
+
+class RtpMediaFrame;
+
+// voice activity detection of one audio stream, based on ssrc-audio-level header extension
+// and sizes of OPUS frames, the gate opens on speech together with the pre-roll of buffered
+// silence and closes after hangover, frames keep their RTP timestamps so gaps of silence
+// are preserved by serializers, not thread-safe except of statistics
+class VoiceActivityGate
+{
+public:
+    struct AudioLevel
+    {
+        // -dBov, 0 is the loudest
+        uint8_t _level = 127U;
+        bool _voice = false;
+    };
+    using Frames = std::vector<std::shared_ptr<RtpMediaFrame>>;
+public:
+    explicit VoiceActivityGate(const VoiceActivitySettings& settings = VoiceActivitySettings());
+    // frames to be serialized in order are appended to [output]
+    void Push(const std::shared_ptr<RtpMediaFrame>& frame,
+              const std::optional<AudioLevel>& audioLevel, Frames& output);
+    // drops pre-roll and closes the gate, i.e. for the new media pipeline
+    void Reset();
+    bool IsOpen() const { return _open; }
+    uint64_t GetGatedFrames() const { return _gatedFrames.load(std::memory_order_relaxed); }
+    uint64_t GetGatedBytes() const { return _gatedBytes.load(std::memory_order_relaxed); }
+    uint64_t GetSpeechSegments() const { return _speechSegments.load(std::memory_order_relaxed); }
+private:
+    bool IsSpeech(const RtpMediaFrame& frame, const std::optional<AudioLevel>& audioLevel) const;
+    static uint64_t GetElapsedMs(uint32_t fromTimestamp, uint32_t toTimestamp, uint32_t sampleRate);
+    void Gate(const std::shared_ptr<RtpMediaFrame>& frame);
+private:
+    const VoiceActivitySettings _settings;
+    bool _open = false;
+    uint32_t _lastSpeechTimestamp = 0U;
+    std::deque<std::shared_ptr<RtpMediaFrame>> _preRoll;
+    std::atomic<uint64_t> _gatedFrames = 0ULL;
+    std::atomic<uint64_t> _gatedBytes = 0ULL;
+    std::atomic<uint64_t> _speechSegments = 0ULL;
+};
+
+} // namespace RTC
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RTC
+{
+
+// gating of the translation uplink by voice activity of producer audio,
+// silence is neither serialized nor sent to the service
+struct VoiceActivitySettings
+{
+    bool _enabled = true;
+    // audio level (RFC 6464) in -dBov, packets with this level or louder are speech
+    uint8_t _speechLevel = 50U;
+    // OPUS packets up to this size are DTX or comfort noise regardless of audio level
+    uint32_t _maxSilenceFrameSize = 10U;
+    // the gate remains open for this time after the last speech frame
+    uint32_t _hangoverMs = 400U;
+    // silence before the speech onset which is sent with it, so utterance starts aren't clipped
+    uint32_t _preRollMs = 200U;
+};
+
+} // namespace RTC
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+namespace webm {
+class WebmParser;
+}
+
+namespace RTC
+{
+
+class MemoryBuffer;
+class MemoryBufferPool;
+class RtpCodecMimeType;
+
+// streaming demuxer of live WebM (Matroska) stream, input may be split into
+// arbitrary chunks and frames are reported as soon as they are complete,
+// only the first OPUS audio track is extracted
+class WebMDeserializer
+{
+    class Reader;
+    class Callback;
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        // [timestampMs] is the block time relative to the beginning of the stream
+        virtual void OnMediaFrame(const RtpCodecMimeType& mime, uint64_t timestampMs,
+                                  const std::shared_ptr<const MemoryBuffer>& payload) = 0;
+    };
+public:
+    WebMDeserializer(Listener* listener,
+                     const std::shared_ptr<MemoryBufferPool>& buffersPool = nullptr);
+    ~WebMDeserializer();
+    // push next chunk of the stream, return false if stream is malformed,
+    // parser is reset then and expects the new stream from EBML header
+    bool AddBuffer(const std::shared_ptr<const MemoryBuffer>& buffer);
+    // drop buffered data and parsing state, used for the new stream
+    void Reset();
+private:
+    const std::unique_ptr<Reader> _reader;
+    const std::unique_ptr<Callback> _callback;
+    std::unique_ptr<webm::WebmParser> _parser;
+};
+
+} // namespace RTC
@@ -2,6 +2,10 @@
 
 #include "ProtectedObj.hpp"
 #include "RTC/MediaTranslate/WebsocketState.hpp"
+#include "RTC/MediaTranslate/WebsocketPoolSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueueSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
+#include <atomic>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -15,32 +19,58 @@ class MemoryBuffer;
 class Websocket
 {
     class Config;
+    class TlsContext;
     class Socket;
     template<class TConfig> class SocketImpl;
     class SocketTls;
     class SocketNoTls;
-    class SocketWrapper;
+public:
+    // warm connections of the service, see GetPool
+    class Pool;
 public:
     Websocket(const std::string& uri,
               const std::string& user = std::string(),
               const std::string& password = std::string(),
               std::unordered_map<std::string, std::string> headers = {},
+              const WebsocketSendQueueSettings& sendQueueSettings = WebsocketSendQueueSettings(),
               std::string tlsTrustStore = std::string(),
               std::string tlsKeyStore = std::string(),
               std::string tlsPrivateKey = std::string(),
               std::string tlsPrivateKeyPassword = std::string());
+    // connection parameters are taken from [pool], Open() takes a warm session
+    // if any is connected (user agent of the pool is used then) or falls back to the new connection
+    explicit Websocket(const std::shared_ptr<Pool>& pool);
     ~Websocket();
+    // pool is shared by all callers with identical connection parameters (first [settings] win)
+    // and lives while somebody holds it, null if [settings] disables the pool or [uri] is invalid,
+    // [userAgent] is applied to all connections of the pool
+    static std::shared_ptr<Pool> GetPool(const WebsocketPoolSettings& settings,
+                                         const std::string& uri,
+                                         const std::string& user = std::string(),
+                                         const std::string& password = std::string(),
+                                         std::unordered_map<std::string, std::string> headers = {},
+                                         const WebsocketSendQueueSettings& sendQueueSettings = WebsocketSendQueueSettings(),
+                                         const std::string& userAgent = std::string());
     bool Open(const std::string& userAgent = std::string());
     void Close();
     WebsocketState GetState() const;
     uint64_t GetId() const;
-    bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer);
+    // binary messages are queued, see WebsocketSendQueue, [isKeyFrame] protects
+    // the message from the drop policy
+    bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer, bool isKeyFrame = false);
     bool WriteText(const std::string& text);
+    // header of server handshake response, empty if not present or not connected
+    std::string GetResponseHeader(const std::string& name) const;
+    WebsocketSendStats GetSendStats() const;
+    // applied to the current and next connections
+    void SetDropPolicy(WebsocketDropPolicy policy);
     void SetListener(const std::shared_ptr<WebsocketListener>& listener);
 private:
+    const std::shared_ptr<Pool> _pool;
     const std::shared_ptr<const Config> _config;
     std::shared_ptr<WebsocketListener> _listener;
-    ProtectedUniquePtr<Socket> _socket;
+    std::atomic<WebsocketDropPolicy> _dropPolicy;
+    ProtectedSharedPtr<Socket> _socket;
 };
 
 } // namespace RTC
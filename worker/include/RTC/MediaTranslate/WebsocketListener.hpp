@@ -2,6 +2,7 @@
 
 #include "MemoryBuffer.hpp"
 #include "RTC/MediaTranslate/WebsocketState.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
 #include <string>
 #include <memory>
 
@@ -26,6 +27,9 @@ public:
     virtual void OnFailed(uint64_t socketId, FailureType type, std::string what);
     virtual void OnTextMessageReceived(uint64_t /*socketId*/, std::string /*message*/) {}
     virtual void OnBinaryMessageReceved(uint64_t /*socketId*/, const std::shared_ptr<MemoryBuffer>& /*message*/) {}
+    // limits of send queue were exceeded ([congested] is true) or the queue was drained after it,
+    // may be called from the writing thread
+    virtual void OnSendQueueCongestion(uint64_t socketId, bool congested, const WebsocketSendStats& stats);
 };
 
 } // namespace RTC
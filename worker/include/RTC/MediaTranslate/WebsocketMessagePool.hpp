@@ -0,0 +1,161 @@
+#pragma once
+
+#include "MemoryBuffer.hpp"
+#include <websocketpp/frame.hpp>
+#include <websocketpp/message_buffer/alloc.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace RTC
+{
+
+// websocketpp message which is also a view of its payload, so received binary messages
+// are handed to listeners without copying, message returns to the pool of connection
+// when the last external reference is dropped, API matches websocketpp::message_buffer::message
+class WebsocketPooledMessage : public MemoryBuffer
+{
+public:
+    using ptr = std::shared_ptr<WebsocketPooledMessage>;
+public:
+    WebsocketPooledMessage() = default;
+    // prepare for reuse, capacity of payload & header is kept
+    void Reset(websocketpp::frame::opcode::value op, size_t size);
+    // impl. of MemoryBuffer
+    size_t GetSize() const final { return _payload.size(); }
+    uint8_t* GetData() final { return reinterpret_cast<uint8_t*>(_payload.data()); }
+    const uint8_t* GetData() const final { return reinterpret_cast<const uint8_t*>(_payload.data()); }
+    // API of websocketpp::message_buffer::message
+    bool get_prepared() const { return _prepared; }
+    void set_prepared(bool value) { _prepared = value; }
+    bool get_compressed() const { return _compressed; }
+    void set_compressed(bool value) { _compressed = value; }
+    bool get_terminal() const { return _terminal; }
+    void set_terminal(bool value) { _terminal = value; }
+    bool get_fin() const { return _fin; }
+    void set_fin(bool value) { _fin = value; }
+    websocketpp::frame::opcode::value get_opcode() const { return _opcode; }
+    void set_opcode(websocketpp::frame::opcode::value op) { _opcode = op; }
+    const std::string& get_header() const { return _header; }
+    void set_header(const std::string& header) { _header = header; }
+    const std::string& get_extension_data() const { return _extensionData; }
+    const std::string& get_payload() const { return _payload; }
+    std::string& get_raw_payload() { return _payload; }
+    void set_payload(const std::string& payload) { _payload = payload; }
+    void set_payload(const void* payload, size_t len);
+    void append_payload(const std::string& payload) { _payload.append(payload); }
+    void append_payload(const void* payload, size_t len);
+    // pool reuses messages by itself
+    bool recycle() { return false; }
+private:
+    std::string _header;
+    std::string _extensionData;
+    std::string _payload;
+    websocketpp::frame::opcode::value _opcode = websocketpp::frame::opcode::text;
+    bool _prepared = false;
+    bool _fin = true;
+    bool _terminal = false;
+    bool _compressed = false;
+};
+
+// connection message manager of websocketpp, messages are allocated once and reused
+// while the connection lives, thread-safe because messages are sent from any thread
+template <typename TMessage>
+class WebsocketMessageManager : public std::enable_shared_from_this<WebsocketMessageManager<TMessage>>
+{
+public:
+    using type = WebsocketMessageManager<TMessage>;
+    using ptr = std::shared_ptr<type>;
+    using weak_ptr = std::weak_ptr<type>;
+    using message_ptr = typename TMessage::ptr;
+public:
+    explicit WebsocketMessageManager(size_t maxMessages = _defaultMaxMessages);
+    // API of websocketpp::message_buffer::alloc::con_msg_manager
+    message_ptr get_message();
+    message_ptr get_message(websocketpp::frame::opcode::value op, size_t size);
+    bool recycle(TMessage*) { return false; }
+    // number of heap allocations of messages, must be constant in steady state
+    uint64_t GetAllocationsCount() const { return _allocations.load(std::memory_order_relaxed); }
+    uint64_t GetReusesCount() const { return _reuses.load(std::memory_order_relaxed); }
+private:
+    // frames of translated media in flight & outgoing media with its framed copy
+    static inline constexpr size_t _defaultMaxMessages = 64UL;
+    const size_t _maxMessages;
+    std::mutex _mutex;
+    std::vector<message_ptr> _messages;
+    std::atomic<uint64_t> _allocations = 0ULL;
+    std::atomic<uint64_t> _reuses = 0ULL;
+};
+
+// replaces message types of websocketpp [TConfig] by pooled ones
+template <class TConfig>
+struct WebsocketPooledConfig : public TConfig
+{
+    using type = WebsocketPooledConfig<TConfig>;
+    using message_type = WebsocketPooledMessage;
+    using con_msg_manager_type = WebsocketMessageManager<message_type>;
+    using endpoint_msg_manager_type = websocketpp::message_buffer::alloc::endpoint_msg_manager<con_msg_manager_type>;
+};
+
+inline void WebsocketPooledMessage::Reset(websocketpp::frame::opcode::value op, size_t size)
+{
+    _header.clear();
+    _extensionData.clear();
+    _payload.clear();
+    _payload.reserve(size);
+    _opcode = op;
+    _prepared = false;
+    _fin = true;
+    _terminal = false;
+    _compressed = false;
+}
+
+inline void WebsocketPooledMessage::set_payload(const void* payload, size_t len)
+{
+    _payload.assign(reinterpret_cast<const char*>(payload), len);
+}
+
+inline void WebsocketPooledMessage::append_payload(const void* payload, size_t len)
+{
+    _payload.append(reinterpret_cast<const char*>(payload), len);
+}
+
+template <typename TMessage>
+WebsocketMessageManager<TMessage>::WebsocketMessageManager(size_t maxMessages)
+    : _maxMessages(maxMessages)
+{
+}
+
+template <typename TMessage>
+typename WebsocketMessageManager<TMessage>::message_ptr WebsocketMessageManager<TMessage>::get_message()
+{
+    return get_message(websocketpp::frame::opcode::text, 0UL);
+}
+
+template <typename TMessage>
+typename WebsocketMessageManager<TMessage>::message_ptr WebsocketMessageManager<TMessage>::
+    get_message(websocketpp::frame::opcode::value op, size_t size)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& message : _messages) {
+        // only the pool holds this message
+        if (1L == message.use_count()) {
+            // synchronize with release of last external reference on other thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+            message->Reset(op, size);
+            _reuses.fetch_add(1ULL, std::memory_order_relaxed);
+            return message;
+        }
+    }
+    auto message = std::make_shared<TMessage>();
+    message->Reset(op, size);
+    _allocations.fetch_add(1ULL, std::memory_order_relaxed);
+    if (_messages.size() < _maxMessages) {
+        _messages.push_back(message);
+    }
+    return message;
+}
+
+} // namespace RTC
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RTC
+{
+
+struct WebsocketPoolSettings
+{
+    // connected sessions kept ready for the next opening websocket, zero disables the pool
+    uint32_t _warmSessions = 2U;
+    // delay of reconnection of a warm session is doubled after each failure,
+    // actual delay is random in [delay / 2, delay]
+    uint32_t _minBackoffMs = 500U;
+    uint32_t _maxBackoffMs = 30000U;
+    bool IsEnabled() const { return _warmSessions > 0U; }
+};
+
+} // namespace RTC
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueueSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace RTC
+{
+
+class MemoryBuffer;
+
+// bounded queue of outgoing binary messages in front of the websocket transport,
+// the transport gets only [WebsocketSendQueueSettings::_maxInFlightBytes] at once,
+// so the backlog of slow connection stays here and is limited by the drop policy,
+// the queue is congested since the first overflow until it's drained completely;
+// thread-safe, time is passed by the caller in milliseconds of monotonic clock
+class WebsocketSendQueue
+{
+    struct Message;
+public:
+    enum class PushResult
+    {
+        Queued,
+        // limits are exceeded and the drop policy was applied, the queue was not congested before
+        Congested,
+        // limits are exceeded and the policy is Disconnect, the queue is cleared
+        Overflow
+    };
+public:
+    explicit WebsocketSendQueue(const WebsocketSendQueueSettings& settings = WebsocketSendQueueSettings());
+    ~WebsocketSendQueue();
+    PushResult Push(const std::shared_ptr<const MemoryBuffer>& buffer, bool isKeyFrame, uint64_t nowMs);
+    // return the next message if [inFlightBytes] of transport allows it, null otherwise,
+    // [drained] is set if the congested queue became empty
+    std::shared_ptr<const MemoryBuffer> Pop(size_t inFlightBytes, uint64_t nowMs, bool& drained);
+    void Clear();
+    bool IsEmpty() const;
+    WebsocketSendStats GetStats(uint64_t nowMs) const;
+    WebsocketDropPolicy GetDropPolicy() const { return _dropPolicy.load(std::memory_order_relaxed); }
+    void SetDropPolicy(WebsocketDropPolicy policy) { _dropPolicy = policy; }
+private:
+    // all are called under the lock
+    bool IsOverLimits(uint64_t nowMs) const;
+    // return false if nothing can be dropped by the policy
+    bool ApplyDropPolicy(WebsocketDropPolicy policy);
+    void Drop(std::deque<Message>::iterator it);
+private:
+    const WebsocketSendQueueSettings _settings;
+    std::atomic<WebsocketDropPolicy> _dropPolicy;
+    mutable std::mutex _mutex;
+    std::deque<Message> _messages;
+    size_t _queuedBytes = 0UL;
+    WebsocketSendStats _stats;
+    LatencyHistogram _writeLatency;
+};
+
+} // namespace RTC
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RTC
+{
+
+// action when limits of the send queue are exceeded
+enum class WebsocketDropPolicy
+{
+    // oldest messages without key frames are removed first,
+    // key frames are removed only if nothing else remains
+    DropOldestNonKeyFrame,
+    // the new message is rejected
+    DropNewest,
+    // the whole queue is dropped and the connection is closed,
+    // the only safe choice for container formats like WebM
+    Disconnect
+};
+
+struct WebsocketSendQueueSettings
+{
+    // limits of queued binary data: size and age of the oldest message,
+    // zero disables the limit
+    uint32_t _maxBytes = 1024U * 1024U;
+    uint32_t _maxDelayMs = 2000U;
+    // data handed to the transport but not written into the socket yet,
+    // the rest is kept in the queue where it can be dropped
+    uint32_t _maxInFlightBytes = 64U * 1024U;
+    WebsocketDropPolicy _dropPolicy = WebsocketDropPolicy::DropOldestNonKeyFrame;
+};
+
+} // namespace RTC
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include <cstdint>
+
+namespace RTC
+{
+
+// state of outgoing binary messages of websocket, see WebsocketSendQueue
+struct WebsocketSendStats
+{
+    // messages waiting for the transport
+    uint32_t _queuedMessages = 0U;
+    uint32_t _queuedBytes = 0U;
+    // age of the oldest queued message
+    uint32_t _queueDelayMs = 0U;
+    // messages handed to the transport
+    uint64_t _sentMessages = 0ULL;
+    uint64_t _sentBytes = 0ULL;
+    // messages removed by the drop policy
+    uint64_t _droppedMessages = 0ULL;
+    uint64_t _droppedBytes = 0ULL;
+    // time from write to the hand-off into the transport, smoothed and maximal
+    double _writeLatencyMs = 0.;
+    uint32_t _maxWriteLatencyMs = 0U;
+    LatencyHistogram::Snapshot _writeLatencyHistogram;
+    // number of transitions into the congested state
+    uint64_t _congestions = 0ULL;
+    bool _congested = false;
+};
+
+} // namespace RTC
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/WriteCoalescingSettings.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace RTC
+{
+
+class MemoryBufferPool;
+class SimpleMemoryBuffer;
+
+// batches serializer output into larger binary messages: pending media is emitted when
+// it reaches [WriteCoalescingSettings::_maxSize], when its age exceeds the latency budget,
+// after a key frame or by explicit Flush(), the deadline timer never splits a frame;
+// thread-safe, the listener is called under the internal lock, so messages are ordered,
+// the timer runs on the shared ASIO pool, so the instance must be owned by std::shared_ptr
+// for deadline flushes
+class WriteCoalescer : public OutputDevice,
+                       public std::enable_shared_from_this<WriteCoalescer>
+{
+    class Timer;
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        // [hasKeyFrame] is true if the message ends by key frame
+        virtual void OnCoalescedWrite(const std::shared_ptr<const MemoryBuffer>& buffer,
+                                      bool hasKeyFrame) = 0;
+    };
+public:
+    WriteCoalescer(Listener* listener, const WriteCoalescingSettings& settings);
+    ~WriteCoalescer() final;
+    const WriteCoalescingSettings& GetSettings() const { return _settings; }
+    // send pending media immediately, i.e. before closing of connection
+    void Flush();
+    // drop pending media, i.e. when connection is lost, applied by the next call
+    // of any other method, so it's safe for callbacks which hold locks of the listener
+    void Reset();
+    // listener will not be called after return
+    void Stop();
+    // impl. of OutputDevice
+    void BeginWriteMediaPayload(uint32_t ssrc, bool isKeyFrame,
+                                const RtpCodecMimeType& codecMimeType,
+                                uint16_t rtpSequenceNumber,
+                                uint32_t rtpTimestamp,
+                                uint32_t rtpAbsSendtime) final;
+    void EndWriteMediaPayload(uint32_t ssrc, bool ok) final;
+    void Write(const std::shared_ptr<const MemoryBuffer>& buffer) final;
+private:
+    // called under the lock
+    void ApplyReset();
+    bool IsExpired() const;
+    void FlushPending(bool hasKeyFrame = false);
+    // timer thread
+    void OnDeadline(uint64_t batch);
+private:
+    const WriteCoalescingSettings _settings;
+    const std::unique_ptr<Timer> _timer;
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    std::mutex _mutex;
+    Listener* _listener;
+    std::shared_ptr<SimpleMemoryBuffer> _pending;
+    std::chrono::steady_clock::time_point _pendingSince;
+    // serial number of pending batch, stale deadlines are ignored
+    uint64_t _batch = 0ULL;
+    std::atomic_bool _resetRequested = false;
+    bool _inFrame = false;
+    bool _keyFrame = false;
+};
+
+} // namespace RTC
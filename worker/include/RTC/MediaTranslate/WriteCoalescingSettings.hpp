@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RTC
+{
+
+struct WriteCoalescingSettings
+{
+    // latency budget: max age of buffered media before it's sent, zero disables coalescing
+    uint32_t _maxDelayMs = 60U;
+    // pending media is sent as soon as it reaches this size
+    uint32_t _maxSize = 16U * 1024U;
+    bool IsEnabled() const { return _maxDelayMs > 0U && _maxSize > 0U; }
+};
+
+} // namespace RTC
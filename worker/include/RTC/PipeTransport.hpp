@@ -41,6 +41,7 @@ namespace RTC
 
 	private:
 		bool IsConnected() const override;
+		std::vector<const UdpSocketHandle*> GetUdpSockets() const override;
 		bool HasSrtp() const;
 		void SendRtpPacket(
 		  RTC::Consumer* consumer,
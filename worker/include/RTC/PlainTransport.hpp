@@ -34,6 +34,7 @@ namespace RTC
 
 	private:
 		bool IsConnected() const override;
+		std::vector<const UdpSocketHandle*> GetUdpSockets() const override;
 		bool HasSrtp() const;
 		bool IsSrtpReady() const;
 		void SendRtpPacket(
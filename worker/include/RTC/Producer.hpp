@@ -5,6 +5,9 @@
 #include "Channel/ChannelRequest.hpp"
 #include "Channel/ChannelSocket.hpp"
 #include "RTC/KeyFrameRequestManager.hpp"
+#include "RTC/MediaTranslate/RecordingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationLatencyStats.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
 #include "RTC/RTCP/Packet.hpp"
 #include "RTC/RTCP/SenderReport.hpp"
@@ -14,6 +17,7 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpStreamRecv.hpp"
 #include "RTC/Shared.hpp"
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -49,6 +53,12 @@ namespace RTC
 			virtual void OnProducerSendRtcpPacket(RTC::Producer* producer, RTC::RTCP::Packet* packet) = 0;
 			virtual void OnProducerNeedWorstRemoteFractionLost(
 			  RTC::Producer* producer, uint32_t mappedSsrc, uint8_t& worstRemoteFractionLost) = 0;
+			virtual void OnProducerRecordingChanged(
+			  RTC::Producer* producer, const std::optional<RTC::RecordingSettings>& settings) = 0;
+			virtual void OnProducerNeedTranslationUplinkStats(
+			  const RTC::Producer* producer, std::optional<RTC::WebsocketSendStats>& stats) = 0;
+			virtual void OnProducerNeedTranslationLatencyStats(
+			  const RTC::Producer* producer, RTC::ProducerTranslationLatencyStats& stats) = 0;
 		};
 
 	private:
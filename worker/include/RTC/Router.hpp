@@ -7,6 +7,13 @@
 #include "RTC/Consumer.hpp"
 #include "RTC/DataConsumer.hpp"
 #include "RTC/DataProducer.hpp"
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
+#include "RTC/MediaTranslate/TranslationBalancingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationServiceHost.hpp"
+#include "RTC/MediaTranslate/VoiceActivitySettings.hpp"
+#include "RTC/MediaTranslate/WebsocketPoolSettings.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueueSettings.hpp"
+#include "RTC/MediaTranslate/WriteCoalescingSettings.hpp"
 #include "RTC/Producer.hpp"
 #include "RTC/RtpObserver.hpp"
 #include "RTC/RtpPacket.hpp"
@@ -85,6 +92,22 @@ namespace RTC
 		  RTC::Producer* producer,
 		  uint32_t mappedSsrc,
 		  uint8_t& worstRemoteFractionLost) override;
+		void OnTransportProducerRecordingChanged(
+		  RTC::Transport* transport,
+		  RTC::Producer* producer,
+		  const std::optional<RTC::RecordingSettings>& settings) override;
+		void OnTransportProducerNeedTranslationUplinkStats(
+		  RTC::Transport* transport,
+		  const RTC::Producer* producer,
+		  std::optional<RTC::WebsocketSendStats>& stats) override;
+		void OnTransportProducerNeedTranslationLatencyStats(
+		  RTC::Transport* transport,
+		  const RTC::Producer* producer,
+		  RTC::ProducerTranslationLatencyStats& stats) override;
+		void OnTransportConsumerNeedTranslationStats(
+		  RTC::Transport* transport,
+		  const RTC::Consumer* consumer,
+		  std::optional<RTC::TranslationStats>& stats) override;
 		void OnTransportNewConsumer(
 		  RTC::Transport* transport, RTC::Consumer* consumer, const std::string& producerId) override;
 		void OnTransportConsumerClosed(RTC::Transport* transport, RTC::Consumer* consumer) override;
@@ -122,9 +145,24 @@ namespace RTC
 		const std::string id;
 
 	private:
-        static inline const std::string _tsUri = "wss://speak-shift-poc.eastus.cloudapp.azure.com:8080/record";
-        static inline const std::string _tsUser = "test_user";
-        static inline const std::string _tsUserPassword = "Gvz29bn";
+        // new sessions are balanced between hosts
+        static inline const std::vector<TranslationServiceHost> _tsServices = {
+            {"wss://speak-shift-poc.eastus.cloudapp.azure.com:8080/record", "test_user", "Gvz29bn"}
+        };
+        // offered to the service, WebM is the fallback
+        static inline constexpr MediaFrameFormat _tsMediaFormat = MediaFrameFormat::Raw;
+        // batching of media into websocket messages: 60 ms latency budget or 16 kb
+        static inline constexpr WriteCoalescingSettings _tsWriteCoalescing = {60U, 16U * 1024U};
+        // uplink back-pressure: 1 Mb or 2 seconds of queued media, 64 kb in flight
+        static inline constexpr WebsocketSendQueueSettings _tsSendQueue = {1024U * 1024U, 2000U, 64U * 1024U,
+                                                                           WebsocketDropPolicy::DropOldestNonKeyFrame};
+        // silence isn't sent to the service: speech below -50 dBov or OPUS DTX,
+        // 400 ms of hangover and 200 ms of pre-roll
+        static inline constexpr VoiceActivitySettings _tsVoiceActivity = {true, 50U, 10U, 400U, 200U};
+        // 2 connected sessions are ready for new end-points, reconnection backoff from 0.5 to 30 seconds
+        static inline constexpr WebsocketPoolSettings _tsServicePool = {2U, 500U, 30000U};
+        // hosts are probed each 10 seconds, session is migrated if write latency exceeds 1.5 seconds
+        static inline constexpr TranslationBalancingSettings _tsServiceBalancing = {10000U, 1500U};
 		// Passed by argument.
         RTC::Shared* const shared;
         Listener* const listener;
@@ -114,6 +114,17 @@ namespace RTC
 			uint8_t tl0picidx;
 		};
 
+		/*
+		 * Struct for per-consumer header values applied by Write(). SSRC, sequence
+		 * number and timestamp are still set in the packet by the consumer, since
+		 * its send stream and the transport read them from there.
+		 */
+		struct HeaderRewrite
+		{
+			// Not written if null or empty.
+			const std::string* mid{ nullptr };
+		};
+
 	public:
 		static const size_t HeaderSize{ 12 };
 		static bool IsRtp(const uint8_t* data, size_t len)
@@ -631,6 +642,10 @@ namespace RTC
 
 		RtpPacket* Clone() const;
 
+		bool CloneInto(RtpPacket* packet) const;
+
+		size_t Write(uint8_t* buffer, const HeaderRewrite& rewrite) const;
+
 		void RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq);
 
 		bool RtxDecode(uint8_t payloadType, uint32_t ssrc);
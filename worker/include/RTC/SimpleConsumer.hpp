@@ -71,6 +71,7 @@ namespace RTC
 		void UserOnTransportDisconnected() override;
 		void UserOnPaused() override;
 		void UserOnResumed() override;
+		void UserOnMediaReplaced() override;
 		void CreateRtpStream();
 		void RequestKeyFrame();
 		void EmitScore() const;
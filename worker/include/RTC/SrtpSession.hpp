@@ -3,6 +3,7 @@
 
 #include "common.hpp"
 #include "FBS/srtpParameters.h"
+#include "RTC/RtpPacket.hpp"
 #include <srtp.h>
 
 namespace RTC
@@ -39,6 +40,11 @@ namespace RTC
 
 	public:
 		bool EncryptRtp(const uint8_t** data, size_t* len);
+		bool EncryptRtp(
+		  const RTC::RtpPacket* packet,
+		  const RTC::RtpPacket::HeaderRewrite& rewrite,
+		  const uint8_t** data,
+		  size_t* len);
 		bool DecryptSrtp(uint8_t* data, size_t* len);
 		bool EncryptRtcp(const uint8_t** data, size_t* len);
 		bool DecryptSrtcp(uint8_t* data, size_t* len);
@@ -47,6 +53,10 @@ namespace RTC
 			srtp_stream_remove(this->session, uint32_t{ htonl(ssrc) });
 		}
 
+	private:
+		static uint8_t* GetEncryptBuffer();
+		bool ProtectRtp(uint8_t* encryptBuffer, const uint8_t** data, size_t* len);
+
 	private:
 		// Allocated by this.
 		srtp_t session{ nullptr };
@@ -28,6 +28,7 @@
 #include "RTC/TransportCongestionControlClient.hpp"
 #include "RTC/TransportCongestionControlServer.hpp"
 #include "handles/TimerHandle.hpp"
+#include "handles/UdpSocketHandle.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <string>
 #include <vector>
@@ -115,6 +116,20 @@ namespace RTC
 		{
 			this->sendTransmission.Update(len, DepLibUV::GetTimeMs());
 		}
+		// The MID of the consumer is not written into the packet (shared by all
+		// the consumers of the producer) but when copying it for sending.
+		static RTC::RtpPacket::HeaderRewrite GetHeaderRewrite(const RTC::Consumer* consumer)
+		{
+			return { consumer ? &consumer->GetRtpParameters().mid : nullptr };
+		}
+		// For sending without copy, the packet itself must be updated.
+		static void UpdateMid(const RTC::Consumer* consumer, RTC::RtpPacket* packet)
+		{
+			if (consumer && !consumer->GetRtpParameters().mid.empty())
+			{
+				packet->UpdateMid(consumer->GetRtpParameters().mid);
+			}
+		}
 		void ReceiveRtpPacket(RTC::RtpPacket* packet);
 		void ReceiveRtcpPacket(RTC::RTCP::Packet* packet);
 		void ReceiveSctpData(const uint8_t* data, size_t len);
@@ -127,6 +142,11 @@ namespace RTC
 
 	private:
 		virtual bool IsConnected() const = 0;
+		// UDP sockets of the transport, their batching counters are added to stats.
+		virtual std::vector<const UdpSocketHandle*> GetUdpSockets() const
+		{
+			return {};
+		}
 		virtual void SendRtpPacket(
 		  RTC::Consumer* consumer, RTC::RtpPacket* packet, onSendCallback* cb = nullptr) = 0;
 		void HandleRtcpPacket(RTC::RTCP::Packet* packet);
@@ -175,6 +195,12 @@ namespace RTC
 		void OnProducerSendRtcpPacket(RTC::Producer* producer, RTC::RTCP::Packet* packet) override;
 		void OnProducerNeedWorstRemoteFractionLost(
 		  RTC::Producer* producer, uint32_t mappedSsrc, uint8_t& worstRemoteFractionLost) override;
+		void OnProducerRecordingChanged(
+		  RTC::Producer* producer, const std::optional<RTC::RecordingSettings>& settings) override;
+		void OnProducerNeedTranslationUplinkStats(
+		  const RTC::Producer* producer, std::optional<RTC::WebsocketSendStats>& stats) override;
+		void OnProducerNeedTranslationLatencyStats(
+		  const RTC::Producer* producer, RTC::ProducerTranslationLatencyStats& stats) override;
 
 		/* Pure virtual methods inherited from RTC::Consumer::Listener. */
 	public:
@@ -184,6 +210,8 @@ namespace RTC
 		void OnConsumerNeedBitrateChange(RTC::Consumer* consumer) override;
 		void OnConsumerNeedZeroBitrate(RTC::Consumer* consumer) override;
 		void OnConsumerProducerClosed(RTC::Consumer* consumer) override;
+		void OnConsumerNeedTranslationStats(
+		  const RTC::Consumer* consumer, std::optional<RTC::TranslationStats>& stats) override;
 
 		/* Pure virtual methods inherited from RTC::DataProducer::Listener. */
 	public:
@@ -1,6 +1,11 @@
 #ifndef MS_RTC_TRANSPORT_LISTENER_HPP
 #define MS_RTC_TRANSPORT_LISTENER_HPP
 
+#include "RTC/MediaTranslate/RecordingSettings.hpp"
+#include "RTC/MediaTranslate/TranslationLatencyStats.hpp"
+#include "RTC/MediaTranslate/TranslationStats.hpp"
+#include "RTC/MediaTranslate/WebsocketSendStats.hpp"
+#include <optional>
 #include <string>
 
 
@@ -48,6 +53,22 @@ public:
       RTC::Producer* producer,
       uint32_t mappedSsrc,
       uint8_t& worstRemoteFractionLost) = 0;
+    virtual void OnTransportProducerRecordingChanged(
+      RTC::Transport* transport,
+      RTC::Producer* producer,
+      const std::optional<RTC::RecordingSettings>& settings) = 0;
+    virtual void OnTransportProducerNeedTranslationUplinkStats(
+      RTC::Transport* transport,
+      const RTC::Producer* producer,
+      std::optional<RTC::WebsocketSendStats>& stats) = 0;
+    virtual void OnTransportProducerNeedTranslationLatencyStats(
+      RTC::Transport* transport,
+      const RTC::Producer* producer,
+      RTC::ProducerTranslationLatencyStats& stats) = 0;
+    virtual void OnTransportConsumerNeedTranslationStats(
+      RTC::Transport* transport,
+      const RTC::Consumer* consumer,
+      std::optional<RTC::TranslationStats>& stats) = 0;
     virtual void OnTransportNewConsumer(
       RTC::Transport* transport, RTC::Consumer* consumer, const std::string& producerId) = 0;
     virtual void OnTransportConsumerClosed(RTC::Transport* transport, RTC::Consumer* consumer) = 0;
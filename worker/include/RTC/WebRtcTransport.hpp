@@ -77,6 +77,7 @@ namespace RTC
 
 	private:
 		bool IsConnected() const override;
+		std::vector<const UdpSocketHandle*> GetUdpSockets() const override;
 		void MayRunDtlsTransport();
 		void SendRtpPacket(
 		  RTC::Consumer* consumer,
@@ -39,6 +39,12 @@ public:
 		std::string dtlsCertificateFile;
 		std::string dtlsPrivateKeyFile;
 		std::string libwebrtcFieldTrials{ "WebRTC-Bwe-AlrLimitedBackoff/Enabled/" };
+		// Number of threads serving translation service websockets (0 means number of cores).
+		uint32_t translationThreads{ 0u };
+		// Max number of datagrams received by a single recvmmsg() call of UDP socket.
+		uint32_t udpRecvBatchSize{ 16u };
+		// Receive UDP and TCP over io_uring multishot requests (experimental, opt-in).
+		bool liburingRecv{ false };
 	};
 
 public:
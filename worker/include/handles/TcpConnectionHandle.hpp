@@ -111,12 +111,16 @@ public:
 
 private:
 	bool SetPeerAddress();
+	void StartReadLibUv();
 
 	/* Callbacks fired by UV events. */
 public:
 	void OnUvReadAlloc(size_t suggestedSize, uv_buf_t* buf);
 	void OnUvRead(ssize_t nread, const uv_buf_t* buf);
 	void OnUvWrite(int status, onSendCallback* cb);
+#ifdef MS_LIBURING_SUPPORTED
+	size_t OnUringRecv(const uint8_t* data, ssize_t nread);
+#endif
 
 	/* Pure virtual methods that must be implemented by the subclass. */
 protected:
@@ -147,6 +151,8 @@ private:
 #ifdef MS_LIBURING_SUPPORTED
 	// Local file descriptor for io_uring.
 	uv_os_fd_t fd{ 0u };
+	// Whether data is received by io_uring multishot recv().
+	bool uringRecv{ false };
 #endif
 	bool closed{ false };
 	size_t recvBytes{ 0u };
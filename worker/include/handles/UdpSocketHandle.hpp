@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include <uv.h>
 #include <string>
+#include <vector>
 
 class UdpSocketHandle
 {
@@ -32,9 +33,57 @@ public:
 		UdpSocketHandle::onSendCallback* cb{ nullptr };
 	};
 
+	/* Datagrams to the same destination gathered within a send batch. */
+	struct SendQueue
+	{
+		struct sockaddr_storage addr
+		{
+		};
+		// Datagrams one after another, as sent by GSO.
+		std::vector<uint8_t> data;
+		std::vector<size_t> lens;
+		std::vector<UdpSocketHandle::onSendCallback*> cbs;
+	};
+
+	/* Queued datagram to be sent with others by a single syscall. */
+	struct QueuedDatagram
+	{
+		const uint8_t* data{ nullptr };
+		size_t len{ 0u };
+		const struct sockaddr* addr{ nullptr };
+		UdpSocketHandle::onSendCallback* cb{ nullptr };
+	};
+
+public:
+	// Limit of libuv for datagrams received by a single recvmmsg() call.
+	static constexpr size_t MaxRecvBatchSize{ 20u };
+	// Limit of the kernel for segments of a single GSO send (UDP_MAX_SEGMENTS).
+	static constexpr size_t MaxSendSegments{ 64u };
+	// Largest UDP payload over IPv4, limit of a single GSO send.
+	static constexpr size_t MaxSendGsoSize{ 65507u };
+
+public:
+	/**
+	 * Datagrams sent while an instance is alive are copied into per destination
+	 * queues and sent with UDP GSO (as a single syscall) when sizes allow, the
+	 * rest with a single sendmmsg() per socket, or as SQEs if liburing is active.
+	 * Batches may be nested, datagrams are sent when the outermost one is
+	 * destroyed.
+	 */
+	class SendBatch
+	{
+	public:
+		SendBatch();
+		SendBatch& operator=(const SendBatch&) = delete;
+		SendBatch(const SendBatch&)            = delete;
+		~SendBatch();
+	};
+
 public:
 	/**
 	 * uvHandle must be an already initialized and binded uv_udp_t pointer.
+	 * Batched receive needs UV_UDP_RECVMMSG flag of the handle, the batch size
+	 * is taken from Settings.
 	 */
 	explicit UdpSocketHandle(uv_udp_t* uvHandle);
 	UdpSocketHandle& operator=(const UdpSocketHandle&) = delete;
@@ -74,6 +123,37 @@ public:
 	{
 		return this->sentBytes;
 	}
+	size_t GetRecvDatagrams() const
+	{
+		return this->recvDatagrams;
+	}
+	// Number of receive syscalls which returned datagrams.
+	size_t GetRecvBatches() const
+	{
+		return this->recvBatches;
+	}
+	size_t GetRecvBatchSize() const
+	{
+		return this->recvBatchSize;
+	}
+	// Number of GSO sends, each with more than one datagram.
+	size_t GetSendGsoCount() const
+	{
+		return this->sendGsoCount;
+	}
+	size_t GetSendGsoSegments() const
+	{
+		return this->sendGsoSegments;
+	}
+	// Number of sendmmsg() calls, each with more than one datagram.
+	size_t GetSendMmsgCount() const
+	{
+		return this->sendMmsgCount;
+	}
+	size_t GetSendMmsgDatagrams() const
+	{
+		return this->sendMmsgDatagrams;
+	}
 	uint32_t GetSendBufferSize() const;
 	void SetSendBufferSize(uint32_t size);
 	uint32_t GetRecvBufferSize() const;
@@ -81,12 +161,25 @@ public:
 
 private:
 	bool SetLocalAddress();
+	void StartRecvLibUv();
+	void SendDatagram(
+	  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandle::onSendCallback* cb);
+	// Whether datagrams of a send batch may be queued (sent later with GSO or sendmmsg()).
+	bool CanSendBatched() const;
+	void QueueDatagram(
+	  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandle::onSendCallback* cb);
+	void SendQueuedDatagrams();
+	void SendDatagrams(const std::vector<QueuedDatagram>& datagrams);
+	bool SendGso(const uint8_t* data, size_t len, size_t segmentSize, const struct sockaddr* addr);
 
 	/* Callbacks fired by UV events. */
 public:
 	void OnUvRecvAlloc(size_t suggestedSize, uv_buf_t* buf);
 	void OnUvRecv(ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned int flags);
 	void OnUvSend(int status, UdpSocketHandle::onSendCallback* cb);
+#ifdef MS_LIBURING_SUPPORTED
+	void OnUringRecv(const uint8_t* data, ssize_t nread, const struct sockaddr* addr);
+#endif
 
 	/* Pure virtual methods that must be implemented by the subclass. */
 protected:
@@ -107,10 +200,24 @@ private:
 #ifdef MS_LIBURING_SUPPORTED
 	// Local file descriptor for io_uring.
 	uv_os_fd_t fd{ 0u };
+	// Whether datagrams are received by io_uring multishot recvmsg().
+	bool uringRecv{ false };
 #endif
 	bool closed{ false };
+	size_t recvBatchSize{ 1u };
 	size_t recvBytes{ 0u };
 	size_t sentBytes{ 0u };
+	size_t recvDatagrams{ 0u };
+	size_t recvBatches{ 0u };
+	// Send queues of current batch, only the first sendQueuesCount are in use.
+	std::vector<SendQueue> sendQueues;
+	size_t sendQueuesCount{ 0u };
+	// Whether GSO works for this socket, unset if the kernel or device refuses it.
+	bool sendGsoEnabled{ true };
+	size_t sendGsoCount{ 0u };
+	size_t sendGsoSegments{ 0u };
+	size_t sendMmsgCount{ 0u };
+	size_t sendMmsgDatagrams{ 0u };
 };
 
 #endif
@@ -55,6 +55,7 @@ namespace Channel
 		{ FBS::Request::Method::PRODUCER_PAUSE,                                 "producer.pause"                             },
 		{ FBS::Request::Method::PRODUCER_RESUME,                                "producer.resume"                            },
 		{ FBS::Request::Method::PRODUCER_ENABLE_TRACE_EVENT,                    "producer.enableTraceEvent"                  },
+		{ FBS::Request::Method::PRODUCER_SET_RECORDING,                         "producer.setRecording"                      },
 		{ FBS::Request::Method::CONSUMER_DUMP,                                  "consumer.dump"                              },
 		{ FBS::Request::Method::CONSUMER_GET_STATS,                             "consumer.getStats"                          },
 		{ FBS::Request::Method::CONSUMER_PAUSE,                                 "consumer.pause"                             },
@@ -4,9 +4,12 @@
 #include "DepLibUring.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
 #include "Utils.hpp"
+#include <cstring> // std::memset()
 #include <sys/eventfd.h>
 #include <sys/resource.h>
+#include <sys/socket.h> // getsockname()
 #include <sys/utsname.h>
 
 /* Static variables. */
@@ -46,6 +49,23 @@ inline static void onFdEvent(uv_poll_t* handle, int status, int events)
 		struct io_uring_cqe* cqe = cqes[i];
 		auto* userData           = static_cast<DepLibUring::UserData*>(io_uring_cqe_get_data(cqe));
 
+		// CQE of a cancelation request, nothing to do.
+		if (!userData)
+		{
+			io_uring_cqe_seen(liburing->GetRing(), cqe);
+
+			continue;
+		}
+
+		// CQE of a multishot receive.
+		if (liburing->IsRecvData(userData))
+		{
+			liburing->ProcessRecvCqe(cqe);
+			io_uring_cqe_seen(liburing->GetRing(), cqe);
+
+			continue;
+		}
+
 		if (liburing->IsZeroCopyEnabled())
 		{
 			// CQE notification for a zero-copy submission.
@@ -110,6 +130,8 @@ inline static void onFdEvent(uv_poll_t* handle, int status, int events)
 		liburing->ReleaseUserDataEntry(userData->idx);
 		io_uring_cqe_seen(liburing->GetRing(), cqe);
 	}
+
+	liburing->CompleteRecvCqes();
 }
 
 /* Static class methods */
@@ -264,6 +286,54 @@ bool DepLibUring::IsActive()
 	return DepLibUring::liburing->IsActive();
 }
 
+bool DepLibUring::IsRecvEnabled()
+{
+	MS_TRACE();
+
+	if (!DepLibUring::liburing)
+	{
+		return false;
+	}
+
+	return DepLibUring::liburing->IsRecvEnabled();
+}
+
+bool DepLibUring::StartRecvMsg(int sockfd, onRecvCallback cb, void* data)
+{
+	MS_TRACE();
+
+	if (!DepLibUring::liburing)
+	{
+		return false;
+	}
+
+	return DepLibUring::liburing->StartRecv(sockfd, /*datagram*/ true, cb, data);
+}
+
+bool DepLibUring::StartRecv(int sockfd, onRecvCallback cb, void* data)
+{
+	MS_TRACE();
+
+	if (!DepLibUring::liburing)
+	{
+		return false;
+	}
+
+	return DepLibUring::liburing->StartRecv(sockfd, /*datagram*/ false, cb, data);
+}
+
+void DepLibUring::StopRecv(int sockfd)
+{
+	MS_TRACE();
+
+	if (!DepLibUring::liburing)
+	{
+		return;
+	}
+
+	DepLibUring::liburing->StopRecv(sockfd);
+}
+
 /* Instance methods. */
 
 DepLibUring::LibUring::LibUring()
@@ -356,6 +426,19 @@ DepLibUring::LibUring::LibUring()
 			MS_THROW_ERROR("io_uring_register_buffers() failed: %s", std::strerror(error));
 		}
 	}
+
+	// Initialize available RecvData entries.
+	for (size_t i{ 0 }; i < DepLibUring::MaxRecvEntries; ++i)
+	{
+		this->recvDatas[i].idx = i;
+		this->availableRecvDataEntries.push(i);
+	}
+
+	// Receiving over io_uring is opt-in, sockets use libuv otherwise.
+	if (Settings::configuration.liburingRecv)
+	{
+		SetupRecvBufferRing();
+	}
 }
 
 DepLibUring::LibUring::~LibUring()
@@ -373,8 +456,19 @@ DepLibUring::LibUring::~LibUring()
 		MS_ABORT("close() failed: %s", std::strerror(error));
 	}
 
+	if (this->recvBufferRing)
+	{
+		io_uring_free_buf_ring(
+		  std::addressof(this->ring),
+		  this->recvBufferRing,
+		  DepLibUring::RecvBuffersCount,
+		  DepLibUring::RecvBufferGroupId);
+	}
+
 	// Close the ring.
 	io_uring_queue_exit(std::addressof(this->ring));
+
+	delete[] this->recvBuffers;
 }
 
 flatbuffers::Offset<FBS::LibUring::Dump> DepLibUring::LibUring::FillBuffer(
@@ -383,7 +477,13 @@ flatbuffers::Offset<FBS::LibUring::Dump> DepLibUring::LibUring::FillBuffer(
 	MS_TRACE();
 
 	return FBS::LibUring::CreateDump(
-	  builder, this->sqeProcessCount, this->sqeMissCount, this->userDataMissCount);
+	  builder,
+	  this->sqeProcessCount,
+	  this->sqeMissCount,
+	  this->userDataMissCount,
+	  this->recvCount,
+	  this->recvBufferMissCount,
+	  this->recvTruncatedCount);
 }
 
 void DepLibUring::LibUring::StartPollingCQEs()
@@ -597,6 +697,400 @@ void DepLibUring::LibUring::Submit()
 	}
 }
 
+bool DepLibUring::LibUring::StartRecv(int sockfd, bool datagram, onRecvCallback cb, void* data)
+{
+	MS_TRACE();
+
+	if (!this->recvBufferRing)
+	{
+		return false;
+	}
+
+	if (this->availableRecvDataEntries.empty())
+	{
+		MS_DEBUG_DEV("no recv data entry available");
+
+		return false;
+	}
+
+	auto idx = this->availableRecvDataEntries.front();
+
+	auto* recvData     = std::addressof(this->recvDatas[idx]);
+	recvData->sockfd   = sockfd;
+	recvData->datagram = datagram;
+	recvData->cb       = cb;
+	recvData->data     = data;
+
+	// Only the source address is wanted, payload goes into the provided buffer.
+	std::memset(std::addressof(recvData->msg), 0, sizeof(recvData->msg));
+
+	if (datagram)
+	{
+		// The source address takes room in the provided buffer, so limit it to
+		// the socket family.
+		struct sockaddr_storage localAddr{};
+		socklen_t localAddrLen = sizeof(localAddr);
+
+		if (
+		  getsockname(
+		    sockfd,
+		    reinterpret_cast<struct sockaddr*>(std::addressof(localAddr)),
+		    std::addressof(localAddrLen)) == 0 &&
+		  localAddr.ss_family == AF_INET)
+		{
+			recvData->msg.msg_namelen = sizeof(struct sockaddr_in);
+		}
+		else
+		{
+			recvData->msg.msg_namelen = sizeof(struct sockaddr_in6);
+		}
+	}
+
+	if (!PrepareRecv(recvData))
+	{
+		recvData->cb   = nullptr;
+		recvData->data = nullptr;
+
+		return false;
+	}
+
+	this->availableRecvDataEntries.pop();
+	this->mapSockFdRecvData[sockfd] = recvData;
+
+	// Receiving is started right away, it is not part of any sending batch.
+	SubmitRecv();
+
+	return true;
+}
+
+void DepLibUring::LibUring::StopRecv(int sockfd)
+{
+	MS_TRACE();
+
+	auto it = this->mapSockFdRecvData.find(sockfd);
+
+	if (it == this->mapSockFdRecvData.end())
+	{
+		return;
+	}
+
+	auto* recvData = it->second;
+
+	this->mapSockFdRecvData.erase(it);
+
+	// Completions received from now on are ignored and the entry is released
+	// once the multishot receive terminates.
+	recvData->cb   = nullptr;
+	recvData->data = nullptr;
+
+	// Not armed entries are released by CompleteRecvCqes().
+	if (!recvData->armed)
+	{
+		return;
+	}
+
+	auto* sqe = io_uring_get_sqe(std::addressof(this->ring));
+
+	if (!sqe)
+	{
+		SubmitRecv();
+
+		sqe = io_uring_get_sqe(std::addressof(this->ring));
+	}
+
+	if (!sqe)
+	{
+		MS_WARN_TAG(info, "no sqe available to cancel multishot receive [sockfd:%d]", sockfd);
+
+		return;
+	}
+
+	io_uring_prep_cancel64(sqe, reinterpret_cast<uintptr_t>(recvData), 0);
+	io_uring_sqe_set_data(sqe, nullptr);
+
+	SubmitRecv();
+}
+
+void DepLibUring::LibUring::ProcessRecvCqe(struct io_uring_cqe* cqe)
+{
+	MS_TRACE();
+
+	auto* recvData = static_cast<DepLibUring::RecvData*>(io_uring_cqe_get_data(cqe));
+
+	if (cqe->flags & IORING_CQE_F_BUFFER)
+	{
+		const auto bid = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+		auto* buffer   = this->recvBuffers + (static_cast<size_t>(bid) * DepLibUring::RecvBufferSize);
+
+		if (cqe->res > 0 && recvData->cb)
+		{
+			this->recvCount++;
+
+			if (recvData->datagram)
+			{
+				auto* out = io_uring_recvmsg_validate(buffer, cqe->res, std::addressof(recvData->msg));
+
+				if (!out)
+				{
+					MS_WARN_DEV("invalid recvmsg result, ignoring it");
+				}
+				// The datagram is lost, let libuv (with a big enough buffer) receive the
+				// next ones.
+				else if (out->flags & MSG_TRUNC)
+				{
+					MS_WARN_TAG(
+					  info,
+					  "received datagram was truncated due to insufficient buffer, ignoring it [sockfd:%d]",
+					  recvData->sockfd);
+
+					this->recvTruncatedCount++;
+
+					auto* cb   = recvData->cb;
+					auto* data = recvData->data;
+
+					StopRecv(recvData->sockfd);
+
+					(*cb)(data, nullptr, -EMSGSIZE, nullptr);
+				}
+				else
+				{
+					auto* payload = static_cast<uint8_t*>(
+					  io_uring_recvmsg_payload(out, std::addressof(recvData->msg)));
+					auto len = io_uring_recvmsg_payload_length(out, cqe->res, std::addressof(recvData->msg));
+					auto* addr =
+					  static_cast<const struct sockaddr*>(io_uring_recvmsg_name(out));
+
+					(*recvData->cb)(recvData->data, payload, static_cast<ssize_t>(len), addr);
+				}
+			}
+			else
+			{
+				const auto len = static_cast<size_t>(cqe->res);
+				size_t offset{ 0u };
+
+				// NOTE: Closing the connection stops receiving, which unsets the callback,
+				// and the entry is not released before the final CQE.
+				while (recvData->cb && offset < len)
+				{
+					const auto consumed =
+					  (*recvData->cb)(recvData->data, buffer + offset, len - offset, nullptr);
+
+					if (consumed == 0)
+					{
+						break;
+					}
+
+					offset += consumed;
+				}
+			}
+		}
+
+		RecycleRecvBuffer(bid);
+	}
+
+	// The multishot receive goes on.
+	if (cqe->flags & IORING_CQE_F_MORE)
+	{
+		return;
+	}
+
+	recvData->armed = false;
+
+	// Receiving was stopped or the callback has stopped it.
+	if (!recvData->cb)
+	{
+		this->availableRecvDataEntries.push(recvData->idx);
+	}
+	// All provided buffers are in use, re-arm once they are given back.
+	else if (cqe->res == -ENOBUFS)
+	{
+		this->recvBufferMissCount++;
+
+		this->recvDatasToRearm.push_back(recvData);
+	}
+	// Error or TCP EOF, reception is over.
+	else if (cqe->res < 0 || (cqe->res == 0 && !recvData->datagram))
+	{
+		auto* cb   = recvData->cb;
+		auto* data = recvData->data;
+
+		this->mapSockFdRecvData.erase(recvData->sockfd);
+		recvData->cb   = nullptr;
+		recvData->data = nullptr;
+		this->availableRecvDataEntries.push(recvData->idx);
+
+		(*cb)(data, nullptr, cqe->res, nullptr);
+	}
+	// Terminated by the kernel (i.e. CQ overflow), re-arm.
+	else
+	{
+		this->recvDatasToRearm.push_back(recvData);
+	}
+}
+
+void DepLibUring::LibUring::CompleteRecvCqes()
+{
+	MS_TRACE();
+
+	if (this->recvBuffersConsumed > 0)
+	{
+		io_uring_buf_ring_advance(this->recvBufferRing, this->recvBuffersConsumed);
+
+		this->recvBuffersConsumed = 0;
+	}
+
+	if (this->recvDatasToRearm.empty())
+	{
+		return;
+	}
+
+	// Callbacks below may stop other receives.
+	std::vector<RecvData*> recvDatas;
+
+	recvDatas.swap(this->recvDatasToRearm);
+
+	bool submit{ false };
+
+	for (auto* recvData : recvDatas)
+	{
+		if (!recvData->cb)
+		{
+			this->availableRecvDataEntries.push(recvData->idx);
+		}
+		else if (PrepareRecv(recvData))
+		{
+			submit = true;
+		}
+		else
+		{
+			auto* cb   = recvData->cb;
+			auto* data = recvData->data;
+
+			this->mapSockFdRecvData.erase(recvData->sockfd);
+			recvData->cb   = nullptr;
+			recvData->data = nullptr;
+			this->availableRecvDataEntries.push(recvData->idx);
+
+			(*cb)(data, nullptr, -ENOBUFS, nullptr);
+		}
+	}
+
+	if (submit)
+	{
+		SubmitRecv();
+	}
+}
+
+void DepLibUring::LibUring::SetupRecvBufferRing()
+{
+	MS_TRACE();
+
+	int err{ 0 };
+
+	// Requires kernel 5.19, multishot receive requires kernel 6.0.
+	this->recvBufferRing = io_uring_setup_buf_ring(
+	  std::addressof(this->ring),
+	  DepLibUring::RecvBuffersCount,
+	  DepLibUring::RecvBufferGroupId,
+	  0,
+	  std::addressof(err));
+
+	if (!this->recvBufferRing)
+	{
+		// Get positive errno.
+		int error = -err;
+
+		MS_WARN_TAG(
+		  info,
+		  "io_uring_setup_buf_ring() failed, receiving via libuv: %s",
+		  std::strerror(error));
+
+		return;
+	}
+
+	this->recvBuffers = new uint8_t[DepLibUring::RecvBuffersCount * DepLibUring::RecvBufferSize];
+
+	const auto mask = io_uring_buf_ring_mask(DepLibUring::RecvBuffersCount);
+
+	for (size_t i{ 0 }; i < DepLibUring::RecvBuffersCount; ++i)
+	{
+		io_uring_buf_ring_add(
+		  this->recvBufferRing,
+		  this->recvBuffers + (i * DepLibUring::RecvBufferSize),
+		  DepLibUring::RecvBufferSize,
+		  static_cast<unsigned short>(i),
+		  mask,
+		  static_cast<int>(i));
+	}
+
+	io_uring_buf_ring_advance(this->recvBufferRing, DepLibUring::RecvBuffersCount);
+}
+
+bool DepLibUring::LibUring::PrepareRecv(RecvData* recvData)
+{
+	MS_TRACE();
+
+	auto* sqe = io_uring_get_sqe(std::addressof(this->ring));
+
+	if (!sqe)
+	{
+		MS_DEBUG_DEV("no sqe available");
+
+		this->sqeMissCount++;
+
+		return false;
+	}
+
+	if (recvData->datagram)
+	{
+		io_uring_prep_recvmsg_multishot(sqe, recvData->sockfd, std::addressof(recvData->msg), 0);
+	}
+	else
+	{
+		io_uring_prep_recv_multishot(sqe, recvData->sockfd, nullptr, 0, 0);
+	}
+
+	// Let the kernel pick a buffer from the provided buffers ring.
+	sqe->flags |= IOSQE_BUFFER_SELECT;
+	sqe->buf_group = DepLibUring::RecvBufferGroupId;
+
+	io_uring_sqe_set_data(sqe, recvData);
+
+	recvData->armed = true;
+
+	return true;
+}
+
+void DepLibUring::LibUring::SubmitRecv()
+{
+	MS_TRACE();
+
+	// NOTE: Unlike Submit() this doesn't end the current sending batch.
+	auto err = io_uring_submit(std::addressof(this->ring));
+
+	if (err < 0)
+	{
+		// Get positive errno.
+		int error = -err;
+
+		MS_ERROR("io_uring_submit() failed: %s", std::strerror(error));
+	}
+}
+
+void DepLibUring::LibUring::RecycleRecvBuffer(uint16_t bid)
+{
+	MS_TRACE();
+
+	// NOTE: The ring is advanced once for all the buffers in CompleteRecvCqes().
+	io_uring_buf_ring_add(
+	  this->recvBufferRing,
+	  this->recvBuffers + (static_cast<size_t>(bid) * DepLibUring::RecvBufferSize),
+	  DepLibUring::RecvBufferSize,
+	  bid,
+	  io_uring_buf_ring_mask(DepLibUring::RecvBuffersCount),
+	  this->recvBuffersConsumed++);
+}
+
 DepLibUring::UserData* DepLibUring::LibUring::GetUserData()
 {
 	MS_TRACE();
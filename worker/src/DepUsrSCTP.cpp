@@ -7,6 +7,7 @@
 #endif
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
+#include "handles/UdpSocketHandle.hpp"
 #include <usrsctp.h>
 #include <cstdio> // std::vsnprintf()
 #include <mutex>
@@ -259,7 +260,11 @@ void DepUsrSCTP::Checker::OnTimer(TimerHandle* /*timer*/)
 	DepLibUring::SetActive();
 #endif
 
-	usrsctp_handle_timers(elapsedMs);
+	{
+		const UdpSocketHandle::SendBatch sendBatch;
+
+		usrsctp_handle_timers(elapsedMs);
+	}
 
 #ifdef MS_LIBURING_SUPPORTED
 	// Submit all prepared submission entries.
@@ -103,7 +103,7 @@ namespace RTC
                 *stereo = toc & 0x04;
             }
             if (codeNumber) {
-                const uint8_t number = toc | 0x03;
+                const uint8_t number = toc & 0x03;
                 MS_ASSERT(number <= static_cast<uint8_t>(CodeNumber::Arbitrary), "OPUS TOC code number is invalid");
                 *codeNumber = static_cast<CodeNumber>(number);
             }
@@ -438,6 +438,23 @@ namespace RTC
 		this->shared->channelNotifier->Emit(this->id, FBS::Notification::Event::CONSUMER_PRODUCER_RESUME);
 	}
 
+	void Consumer::SetMediaReplaced(bool mediaReplaced)
+	{
+		MS_TRACE();
+
+		if (mediaReplaced == this->mediaReplaced)
+		{
+			return;
+		}
+
+		this->mediaReplaced = mediaReplaced;
+
+		MS_DEBUG_DEV(
+		  "media %s [consumerId:%s]", mediaReplaced ? "replaced" : "restored", this->id.c_str());
+
+		UserOnMediaReplaced();
+	}
+
 	void Consumer::ProducerRtpStreamScores(const std::vector<uint8_t>* scores)
 	{
 		MS_TRACE();
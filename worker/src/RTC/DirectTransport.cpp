@@ -149,6 +149,8 @@ namespace RTC
 			return;
 		}
 
+		RTC::Transport::UpdateMid(consumer, packet);
+
 		const auto data = this->shared->channelNotifier->GetBufferBuilder().CreateVector(
 		  packet->GetData(), packet->GetSize());
 
@@ -0,0 +1,454 @@
+#define MS_CLASS "RTC::AsyncFileWriter"
+#include "RTC/MediaTranslate/AsyncFileWriter.hpp"
+#include "MemoryBuffer.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline bool SyncFileData(FILE* file) {
+#if defined(_WIN32)
+    return 0 == ::_commit(::_fileno(file));
+#elif defined(__APPLE__)
+    return 0 == ::fsync(::fileno(file));
+#else
+    return 0 == ::fdatasync(::fileno(file));
+#endif
+}
+
+FILE* FileOpen(std::string_view fileNameUtf8, int* error) {
+#if defined(_WIN32)
+    std::string fileName(fileNameUtf8);
+    int len = ::MultiByteToWideChar(CP_UTF8, 0, fileName.c_str(), -1, nullptr, 0);
+    std::wstring wstr(len, 0);
+    ::MultiByteToWideChar(CP_UTF8, 0, fileName.c_str(), -1, &wstr[0], len);
+    FILE* file = ::_wfopen(wstr.c_str(), L"wb");
+#else
+    FILE* file = ::fopen(std::string(fileNameUtf8).c_str(), "wb");
+#endif
+    if (!file && error) {
+        *error = errno;
+    }
+    return file;
+}
+
+}
+
+namespace RTC
+{
+
+// data of recording is collected into chunk on the caller thread,
+// the file is opened, written & closed by the writer thread
+class AsyncFileWriter::File : public std::enable_shared_from_this<AsyncFileWriter::File>
+{
+public:
+    File(std::string fileNameUtf8, const RecordingSettings& settings);
+    // sync (depends on policy) and close, called by the writer thread after the last chunk
+    ~File();
+    // caller thread, complete chunks are handed to the writer thread
+    void Write(const uint8_t* data, size_t size);
+    void Flush();
+    // writer thread, hand partially filled chunk which is older than flush interval,
+    // so media of idle recording isn't kept in memory until the next write
+    void FlushIfIdle(std::chrono::steady_clock::time_point now);
+    // called on the writer thread
+    void WriteChunk(std::vector<uint8_t> chunk);
+    std::chrono::milliseconds GetFlushInterval() const { return _flushInterval; }
+    uint64_t GetWrittenBytes() const { return _writtenBytes.load(std::memory_order_relaxed); }
+    uint64_t GetPendingBytes() const { return _pendingBytes.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedBytes() const { return _droppedBytes.load(std::memory_order_relaxed); }
+    uint64_t GetFailedWrites() const { return _failedWrites.load(std::memory_order_relaxed); }
+private:
+    // writer thread, return false if file can't be opened
+    bool Open();
+    // must be called under lock of [_chunkMutex]
+    void FlushChunk(std::chrono::steady_clock::time_point now);
+    // account [size] bytes as pending, return false if back-pressure limit is exceeded
+    bool Reserve(size_t size);
+    // recycled chunk with capacity at least [_chunkSize] bytes
+    std::vector<uint8_t> TakeFreeChunk();
+private:
+    const std::string _fileName;
+    const RecordingSyncPolicy _syncPolicy;
+    const uint64_t _maxPendingSize;
+    const std::chrono::milliseconds _flushInterval;
+    const size_t _chunkSize;
+    // writer thread only
+    FILE* _handle = nullptr;
+    bool _openFailed = false;
+    // caller thread, flusher takes idle chunk
+    std::mutex _chunkMutex;
+    std::vector<uint8_t> _chunk;
+    std::chrono::steady_clock::time_point _lastFlushTime;
+    std::atomic<uint64_t> _writtenBytes = 0ULL;
+    std::atomic<uint64_t> _pendingBytes = 0ULL;
+    std::atomic<uint64_t> _droppedBytes = 0ULL;
+    std::atomic<uint64_t> _failedWrites = 0ULL;
+    std::mutex _freeChunksMutex;
+    std::vector<std::vector<uint8_t>> _freeChunks;
+};
+
+// single background thread serving all recordings of the process
+class AsyncFileWriter::Flusher
+{
+    using Task = std::pair<std::shared_ptr<File>, std::vector<uint8_t>>;
+public:
+    ~Flusher();
+    static Flusher& GetInstance();
+    // file is opened by the first task
+    void Register(const std::shared_ptr<File>& file);
+    void Enqueue(std::shared_ptr<File> file, std::vector<uint8_t> chunk);
+private:
+    Flusher();
+    void Run();
+    // must be called under lock of [_mutex], shortest flush interval of alive files,
+    // expired files are forgotten
+    std::optional<std::chrono::milliseconds> GetFlushInterval();
+    void FlushIdleFiles(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point now);
+private:
+    // idle chunks are checked not more often
+    static inline constexpr std::chrono::milliseconds _minIdleCheckInterval{10};
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Task> _tasks;
+    std::vector<std::weak_ptr<File>> _files;
+    bool _stopped = false;
+    std::thread _thread;
+};
+
+AsyncFileWriter::AsyncFileWriter(std::shared_ptr<File> file)
+    : _file(std::move(file))
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    Close();
+}
+
+std::unique_ptr<AsyncFileWriter> AsyncFileWriter::Create(std::string fileNameUtf8,
+                                                         const RecordingSettings& settings)
+{
+    if (!fileNameUtf8.empty()) {
+        auto file = std::make_shared<File>(std::move(fileNameUtf8), settings);
+        Flusher::GetInstance().Register(file);
+        return std::unique_ptr<AsyncFileWriter>(new AsyncFileWriter(std::move(file)));
+    }
+    return nullptr;
+}
+
+void AsyncFileWriter::Close()
+{
+    if (_file) {
+        _file->Flush();
+        // last reference is released on the writer thread, after all pending chunks
+        Flusher::GetInstance().Enqueue(std::move(_file), {});
+    }
+}
+
+uint64_t AsyncFileWriter::GetWrittenBytes() const
+{
+    return _file ? _file->GetWrittenBytes() : 0ULL;
+}
+
+uint64_t AsyncFileWriter::GetPendingBytes() const
+{
+    return _file ? _file->GetPendingBytes() : 0ULL;
+}
+
+uint64_t AsyncFileWriter::GetDroppedBytes() const
+{
+    return _file ? _file->GetDroppedBytes() : 0ULL;
+}
+
+uint64_t AsyncFileWriter::GetFailedWrites() const
+{
+    return _file ? _file->GetFailedWrites() : 0ULL;
+}
+
+void AsyncFileWriter::Write(const std::shared_ptr<const MemoryBuffer>& buffer)
+{
+    if (_file && buffer && !buffer->IsEmpty()) {
+        _file->Write(buffer->GetData(), buffer->GetSize());
+    }
+}
+
+size_t AsyncFileWriter::AlignChunkSize(uint32_t size)
+{
+    constexpr size_t alignment = 4096UL;
+    return std::max<size_t>(1UL, (size + alignment - 1UL) / alignment) * alignment;
+}
+
+AsyncFileWriter::File::File(std::string fileNameUtf8, const RecordingSettings& settings)
+    : _fileName(std::move(fileNameUtf8))
+    , _syncPolicy(settings._syncPolicy)
+    , _maxPendingSize(settings._maxPendingSize)
+    , _flushInterval(settings._flushIntervalMs)
+    , _chunkSize(AlignChunkSize(settings._flushSize))
+    , _lastFlushTime(std::chrono::steady_clock::now())
+{
+    _chunk.reserve(_chunkSize);
+}
+
+AsyncFileWriter::File::~File()
+{
+    if (_handle) {
+        if (RecordingSyncPolicy::OnClose == _syncPolicy && !SyncFileData(_handle)) {
+            MS_ERROR("file data sync error, error code: %d", errno);
+        }
+        ::fclose(_handle);
+    }
+}
+
+void AsyncFileWriter::File::Write(const uint8_t* data, size_t size)
+{
+    const std::lock_guard<std::mutex> lock(_chunkMutex);
+    while (size) {
+        const auto len = std::min(size, _chunkSize - _chunk.size());
+        _chunk.insert(_chunk.end(), data, data + len);
+        data += len;
+        size -= len;
+        if (_chunk.size() == _chunkSize) {
+            FlushChunk(std::chrono::steady_clock::now());
+        }
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (!_chunk.empty() && now - _lastFlushTime >= _flushInterval) {
+        FlushChunk(now);
+    }
+}
+
+void AsyncFileWriter::File::Flush()
+{
+    const std::lock_guard<std::mutex> lock(_chunkMutex);
+    FlushChunk(std::chrono::steady_clock::now());
+}
+
+void AsyncFileWriter::File::FlushIfIdle(std::chrono::steady_clock::time_point now)
+{
+    const std::lock_guard<std::mutex> lock(_chunkMutex);
+    if (!_chunk.empty() && now - _lastFlushTime >= _flushInterval) {
+        FlushChunk(now);
+    }
+}
+
+void AsyncFileWriter::File::FlushChunk(std::chrono::steady_clock::time_point now)
+{
+    _lastFlushTime = now;
+    if (!_chunk.empty()) {
+        if (Reserve(_chunk.size())) {
+            // enqueued under the lock, so chunks are written in order
+            Flusher::GetInstance().Enqueue(shared_from_this(), std::move(_chunk));
+            _chunk = TakeFreeChunk();
+        }
+        else {
+            _chunk.clear();
+        }
+    }
+}
+
+bool AsyncFileWriter::File::Open()
+{
+    if (!_handle && !_openFailed) {
+        int error = 0;
+        _handle = FileOpen(_fileName, &error);
+        if (_handle) {
+            // chunks are large enough, no need in stdio buffering
+            ::setvbuf(_handle, nullptr, _IONBF, 0U);
+        }
+        else {
+            _openFailed = true;
+            _failedWrites.fetch_add(1ULL, std::memory_order_relaxed);
+            MS_ERROR("failed to open recording file %s, error code: %d", _fileName.c_str(), error);
+        }
+    }
+    return nullptr != _handle;
+}
+
+bool AsyncFileWriter::File::Reserve(size_t size)
+{
+    const auto pending = _pendingBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    if (pending > _maxPendingSize) {
+        _pendingBytes.fetch_sub(size, std::memory_order_relaxed);
+        _droppedBytes.fetch_add(size, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> AsyncFileWriter::File::TakeFreeChunk()
+{
+    std::vector<uint8_t> chunk;
+    {
+        const std::lock_guard<std::mutex> lock(_freeChunksMutex);
+        if (!_freeChunks.empty()) {
+            chunk = std::move(_freeChunks.back());
+            _freeChunks.pop_back();
+        }
+    }
+    chunk.reserve(_chunkSize);
+    return chunk;
+}
+
+void AsyncFileWriter::File::WriteChunk(std::vector<uint8_t> chunk)
+{
+    // the first task of file opens it
+    const auto opened = Open();
+    if (!chunk.empty()) {
+        const auto expected = chunk.size();
+        size_t actual = 0UL;
+        if (opened) {
+            actual = ::fwrite(chunk.data(), 1U, expected, _handle);
+            if (expected != actual) {
+                _failedWrites.fetch_add(1ULL, std::memory_order_relaxed);
+                MS_ERROR("file write error, expected %zu but written only %zu bytes, error code: %d",
+                         expected, actual, errno);
+            }
+            else if (RecordingSyncPolicy::OnFlush == _syncPolicy && !SyncFileData(_handle)) {
+                MS_ERROR("file data sync error, error code: %d", errno);
+            }
+        }
+        else {
+            _droppedBytes.fetch_add(expected, std::memory_order_relaxed);
+        }
+        _writtenBytes.fetch_add(actual, std::memory_order_relaxed);
+        _pendingBytes.fetch_sub(expected, std::memory_order_relaxed);
+        chunk.clear();
+        const std::lock_guard<std::mutex> lock(_freeChunksMutex);
+        _freeChunks.push_back(std::move(chunk));
+    }
+}
+
+AsyncFileWriter::Flusher::Flusher()
+    : _thread(&Flusher::Run, this)
+{
+}
+
+AsyncFileWriter::Flusher::~Flusher()
+{
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _condition.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+AsyncFileWriter::Flusher& AsyncFileWriter::Flusher::GetInstance()
+{
+    static Flusher flusher;
+    return flusher;
+}
+
+void AsyncFileWriter::Flusher::Register(const std::shared_ptr<File>& file)
+{
+    if (file) {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _files.push_back(file);
+            _tasks.emplace_back(file, std::vector<uint8_t>());
+        }
+        _condition.notify_one();
+    }
+}
+
+void AsyncFileWriter::Flusher::Enqueue(std::shared_ptr<File> file, std::vector<uint8_t> chunk)
+{
+    if (file) {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back(std::move(file), std::move(chunk));
+        }
+        _condition.notify_one();
+    }
+}
+
+void AsyncFileWriter::Flusher::Run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto nextIdleCheck = std::chrono::steady_clock::now();
+    const auto hasTasks = [this]() { return _stopped || !_tasks.empty(); };
+    while (true) {
+        if (const auto interval = GetFlushInterval()) {
+            // wake up for partially filled chunks of idle recordings
+            _condition.wait_until(lock, nextIdleCheck, hasTasks);
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= nextIdleCheck) {
+                nextIdleCheck = now + interval.value();
+                FlushIdleFiles(lock, now);
+            }
+        }
+        else {
+            _condition.wait(lock, hasTasks);
+        }
+        // pending chunks are written even if stopped
+        if (_tasks.empty()) {
+            if (_stopped) {
+                break;
+            }
+            continue;
+        }
+        auto task = std::move(_tasks.front());
+        _tasks.pop_front();
+        lock.unlock();
+        task.first->WriteChunk(std::move(task.second));
+        // file may be closed here if it was the last chunk
+        task.first.reset();
+        lock.lock();
+    }
+}
+
+std::optional<std::chrono::milliseconds> AsyncFileWriter::Flusher::GetFlushInterval()
+{
+    std::optional<std::chrono::milliseconds> interval;
+    for (auto it = _files.begin(); it != _files.end();) {
+        if (const auto file = it->lock()) {
+            interval = std::min(interval.value_or(file->GetFlushInterval()), file->GetFlushInterval());
+            ++it;
+        }
+        else {
+            it = _files.erase(it);
+        }
+    }
+    if (interval) {
+        return std::max(interval.value(), _minIdleCheckInterval);
+    }
+    return std::nullopt;
+}
+
+void AsyncFileWriter::Flusher::FlushIdleFiles(std::unique_lock<std::mutex>& lock,
+                                              std::chrono::steady_clock::time_point now)
+{
+    std::vector<std::shared_ptr<File>> files;
+    files.reserve(_files.size());
+    for (const auto& weakFile : _files) {
+        if (auto file = weakFile.lock()) {
+            files.push_back(std::move(file));
+        }
+    }
+    // chunks are enqueued by files, so never under lock
+    lock.unlock();
+    for (const auto& file : files) {
+        file->FlushIfIdle(now);
+    }
+    files.clear();
+    lock.lock();
+}
+
+} // namespace RTC
@@ -1,6 +1,8 @@
 #define MS_CLASS "RTC::ConsumerTranslator"
 #include "RTC/MediaTranslate/ConsumerTranslator.hpp"
 #include "RTC/MediaTranslate/TranslatorEndPoint.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPointFactory.hpp"
+#include "RTC/MediaTranslate/RtpPacketizerOpus.hpp"
 #include "RTC/Consumer.hpp"
 #include "Logger.hpp"
 
@@ -9,22 +11,23 @@ namespace RTC
 
 ConsumerTranslator::ConsumerTranslator(Consumer* consumer,
                                        const std::string& producerId,
-                                       const std::string& serviceUri,
-                                       const std::string& serviceUser,
-                                       const std::string& servicePassword)
+                                       TranslatorEndPointFactory* endPointsFactory)
     : _consumer(consumer)
     , _producerId(producerId)
-    , _endPoint(std::make_unique<TranslatorEndPoint>(serviceUri, serviceUser, servicePassword))
+    , _endPointsFactory(endPointsFactory)
 {
     MS_ASSERT(_consumer, "consumer must not be null");
     MS_ASSERT(!_producerId.empty(), "producer ID must not be empty");
-    if (IsEnabled()) {
-        _endPoint->Open();
-    }
+    MS_ASSERT(_endPointsFactory, "end-points factory must not be null");
+    UpdateEndPoint();
 }
 
 ConsumerTranslator::~ConsumerTranslator()
 {
+    if (_endPoint) {
+        _endPoint->RemoveOutput(this);
+    }
+    SetMediaReplaced(false);
 }
 
 const std::string& ConsumerTranslator::GetId() const
@@ -51,19 +54,14 @@ void ConsumerTranslator::RemoveObserver(ConsumerObserver* observer)
     }
 }
 
-uint32_t ConsumerTranslator::GetProducerInputSsrc() const
-{
-    return _endPoint->GetProducerInputSsrc();
-}
-
-void ConsumerTranslator::SetProducerInput(const std::shared_ptr<ProducerInputMediaStreamer>& input)
-{
-    _endPoint->SetInput(input);
-}
-
-void ConsumerTranslator::SetProducerLanguage(const std::optional<MediaLanguage>& language)
+TranslationStats ConsumerTranslator::GetStats() const
 {
-    _endPoint->SetProducerLanguage(language);
+    TranslationStats stats;
+    if (_endPoint) {
+        stats = _endPoint->GetStats();
+    }
+    stats._sentPackets = _sentPackets;
+    return stats;
 }
 
 void ConsumerTranslator::SetLanguage(MediaLanguage language)
@@ -72,7 +70,7 @@ void ConsumerTranslator::SetLanguage(MediaLanguage language)
         const auto from = _language;
         _language = language;
         InvokeObserverMethod(&ConsumerObserver::OnConsumerLanguageChanged, from, language);
-        _endPoint->SetConsumerLanguage(language);
+        UpdateEndPoint();
     }
 }
 
@@ -82,7 +80,7 @@ void ConsumerTranslator::SetVoice(MediaVoice voice)
         const auto from = _voice;
         _voice = voice;
         InvokeObserverMethod(&ConsumerObserver::OnConsumerVoiceChanged, from, voice);
-        _endPoint->SetConsumerVoice(voice);
+        UpdateEndPoint();
     }
 }
 
@@ -91,11 +89,24 @@ void ConsumerTranslator::SetEnabled(bool enabled)
     if (enabled != _enabled) {
         _enabled = enabled;
         InvokeObserverMethod(&ConsumerObserver::OnConsumerEnabledChanged, enabled);
-        if (enabled) {
-            _endPoint->Open();
-        }
-        else {
-            _endPoint->Close();
+        UpdateEndPoint();
+    }
+}
+
+void ConsumerTranslator::OnTranslatedFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                                           bool newSequence, uint64_t nowMs)
+{
+    if (!_packetizer && !_packetizerFailed) {
+        _packetizer = CreatePacketizer();
+        _packetizerFailed = nullptr == _packetizer;
+    }
+    if (_packetizer) {
+        if (const auto packet = _packetizer->Packetize(frame, newSequence, nowMs)) {
+            SetMediaReplaced(true);
+            // packet buffer is re-used by packetizer, send stream makes its own copy
+            std::shared_ptr<RtpPacket> sharedPacket;
+            _consumer->SendRtpPacket(packet, sharedPacket);
+            ++_sentPackets;
         }
     }
 }
@@ -105,6 +116,46 @@ void ConsumerTranslator::OnPauseChanged(bool pause)
     InvokeObserverMethod(&ConsumerObserver::OnConsumerPauseChanged, pause);
 }
 
+void ConsumerTranslator::UpdateEndPoint()
+{
+    std::shared_ptr<TranslatorEndPoint> endPoint;
+    if (IsEnabled()) {
+        endPoint = _endPointsFactory->GetEndPoint(GetProducerId(), GetLanguage(), GetVoice());
+    }
+    if (endPoint != _endPoint) {
+        if (_endPoint) {
+            _endPoint->RemoveOutput(this);
+        }
+        _endPoint = std::move(endPoint);
+        if (_endPoint) {
+            _endPoint->AddOutput(this);
+        }
+        else {
+            SetMediaReplaced(false);
+        }
+    }
+}
+
+void ConsumerTranslator::SetMediaReplaced(bool replaced)
+{
+    _consumer->SetMediaReplaced(replaced);
+}
+
+std::unique_ptr<RtpPacketizerOpus> ConsumerTranslator::CreatePacketizer() const
+{
+    const auto& rtpParameters = _consumer->GetRtpParameters();
+    if (!rtpParameters.encodings.empty()) {
+        for (const auto& codec : rtpParameters.codecs) {
+            if (RtpCodecMimeType::Subtype::OPUS == codec.mimeType.GetSubtype()) {
+                return std::make_unique<RtpPacketizerOpus>(rtpParameters.encodings.front().ssrc,
+                                                           codec.payloadType);
+            }
+        }
+    }
+    MS_WARN_TAG(rtp, "consumer %s doesn't support OPUS, translated media is ignored", GetId().c_str());
+    return nullptr;
+}
+
 template <class Method, typename... Args>
 void ConsumerTranslator::InvokeObserverMethod(const Method& method, Args&&... args) const
 {
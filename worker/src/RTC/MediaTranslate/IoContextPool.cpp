@@ -0,0 +1,74 @@
+#define MS_CLASS "RTC::IoContextPool"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
+#include "Settings.hpp"
+#include <asio/io_context.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <algorithm>
+
+namespace RTC
+{
+
+class IoContextPool::Guard
+{
+public:
+    Guard(asio::io_context& context);
+    void Reset() { _guard.reset(); }
+private:
+    asio::executor_work_guard<asio::io_context::executor_type> _guard;
+};
+
+IoContextPool::IoContextPool(size_t size)
+{
+    _contexts.reserve(size);
+    _guards.reserve(size);
+    _threads.reserve(size);
+    for (size_t i = 0UL; i < size; ++i) {
+        _contexts.push_back(std::make_unique<asio::io_context>(1));
+        _guards.push_back(std::make_unique<Guard>(*_contexts.back()));
+    }
+    for (const auto& context : _contexts) {
+        _threads.emplace_back([context = context.get()]() {
+            context->run();
+        });
+    }
+}
+
+IoContextPool::~IoContextPool()
+{
+    for (const auto& guard : _guards) {
+        guard->Reset();
+    }
+    for (const auto& context : _contexts) {
+        context->stop();
+    }
+    for (auto& thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+IoContextPool& IoContextPool::GetInstance()
+{
+    static IoContextPool pool([]() {
+        size_t size = Settings::configuration.translationThreads;
+        if (0UL == size) {
+            size = std::max<size_t>(1UL, std::thread::hardware_concurrency());
+        }
+        return size;
+    }());
+    return pool;
+}
+
+asio::io_context* IoContextPool::NextContext()
+{
+    const auto index = _next.fetch_add(1UL, std::memory_order_relaxed) % _contexts.size();
+    return _contexts[index].get();
+}
+
+IoContextPool::Guard::Guard(asio::io_context& context)
+    : _guard(asio::make_work_guard(context))
+{
+}
+
+} // namespace RTC
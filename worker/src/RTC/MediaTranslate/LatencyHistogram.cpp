@@ -0,0 +1,72 @@
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace RTC
+{
+
+void LatencyHistogram::Add(uint64_t latencyUs)
+{
+    const auto it = std::lower_bound(_boundsUs.begin(), _boundsUs.end(), latencyUs);
+    _buckets[std::distance(_boundsUs.begin(), it)].fetch_add(1ULL, std::memory_order_relaxed);
+    _count.fetch_add(1ULL, std::memory_order_relaxed);
+    _sumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+    auto maxUs = _maxUs.load(std::memory_order_relaxed);
+    while (latencyUs > maxUs && !_maxUs.compare_exchange_weak(maxUs, latencyUs,
+                                                              std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::AddSince(uint64_t startUs)
+{
+    const auto nowUs = NowUs();
+    Add(nowUs - std::min(nowUs, startUs));
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const
+{
+    // counters are not consistent with each other if samples are added meanwhile,
+    // that's acceptable for statistics
+    Snapshot snapshot;
+    for (size_t i = 0UL; i < _bucketsCount; ++i) {
+        snapshot._buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot._count = _count.load(std::memory_order_relaxed);
+    snapshot._sumUs = _sumUs.load(std::memory_order_relaxed);
+    snapshot._maxUs = _maxUs.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::NowUs()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+void LatencyHistogram::Snapshot::Merge(const Snapshot& other)
+{
+    for (size_t i = 0UL; i < _bucketsCount; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _sumUs += other._sumUs;
+    _maxUs = std::max(_maxUs, other._maxUs);
+}
+
+uint64_t LatencyHistogram::Snapshot::GetPercentileUs(double percentile) const
+{
+    if (_count) {
+        const auto rank = static_cast<uint64_t>(_count * std::clamp(percentile, 0., 100.) / 100.);
+        uint64_t samples = 0ULL;
+        for (size_t i = 0UL; i < _boundsUs.size(); ++i) {
+            samples += _buckets[i];
+            if (samples >= std::max<uint64_t>(1ULL, rank)) {
+                return std::min<uint64_t>(_boundsUs[i], _maxUs);
+            }
+        }
+        return _maxUs;
+    }
+    return 0ULL;
+}
+
+} // namespace RTC
@@ -0,0 +1,32 @@
+#include "RTC/MediaTranslate/MediaFrameFormat.hpp"
+
+namespace RTC
+{
+
+std::string_view MediaFrameFormatToString(MediaFrameFormat format)
+{
+    switch (format) {
+        case MediaFrameFormat::WebM:
+            return "webm";
+        case MediaFrameFormat::Raw:
+            return "raw";
+        case MediaFrameFormat::Ogg:
+            return "ogg";
+        default:
+            // assert
+            break;
+    }
+    return "";
+}
+
+std::optional<MediaFrameFormat> MediaFrameFormatFromString(const std::string_view& str)
+{
+    for (const auto format : {MediaFrameFormat::WebM, MediaFrameFormat::Raw, MediaFrameFormat::Ogg}) {
+        if (str == MediaFrameFormatToString(format)) {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace RTC
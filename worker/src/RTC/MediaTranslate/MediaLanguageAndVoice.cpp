@@ -41,6 +41,13 @@ TranslationPack::TranslationPack(MediaLanguage languageTo, MediaVoice voice,
 {
 }
 
+bool TranslationPack::operator == (const TranslationPack& other) const
+{
+    return _languageTo == other._languageTo &&
+           _voice == other._voice &&
+           _languageFrom == other._languageFrom;
+}
+
 std::string_view MediaLanguageToString(const std::optional<MediaLanguage>& language)
 {
     if (language.has_value()) {
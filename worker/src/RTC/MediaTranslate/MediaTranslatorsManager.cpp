@@ -3,7 +3,13 @@
 #include "RTC/RtpPacketsCollector.hpp"
 #include "RTC/MediaTranslate/ProducerTranslator.hpp"
 #include "RTC/MediaTranslate/ConsumerTranslator.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPoint.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPointFactory.hpp"
+#include "RTC/MediaTranslate/ProducerInputMediaStreamer.hpp"
+#include "RTC/MediaTranslate/MediaVoice.hpp"
+#include "RTC/MediaTranslate/TimerWheel.hpp"
 #include "RTC/MediaTranslate/TranslatorUtils.hpp"
+#include "RTC/MediaTranslate/TranslatorsIndex.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/Producer.hpp"
 #include "RTC/Consumer.hpp"
@@ -15,25 +21,38 @@
 namespace RTC
 {
 
-using ConsumerTranslatorsList = std::list<std::shared_ptr<ConsumerTranslator>>;
-
-class MediaTranslatorsManager::Impl : public ProducerObserver
+class MediaTranslatorsManager::Impl : public ProducerObserver, public TranslatorEndPointFactory
 {
+    // key is translation settings, producer language is the same for all end-points of producer
+    using EndPointsMap = absl::flat_hash_map<TranslationPack, std::weak_ptr<TranslatorEndPoint>>;
 public:
-    Impl(const std::string& serviceUri, const std::string& serviceUser, const std::string& servicePassword);
+    Impl(const std::vector<TranslationServiceHost>& services,
+         MediaFrameFormat serviceMediaFormat,
+         const WriteCoalescingSettings& serviceCoalescing,
+         const WebsocketSendQueueSettings& serviceSendQueue,
+         const VoiceActivitySettings& voiceActivity,
+         const WebsocketPoolSettings& servicePool,
+         const TranslationBalancingSettings& serviceBalancing);
     // producers API
     bool Register(Producer* producer);
     std::shared_ptr<ProducerTranslator> GetRegistered(const Producer* producer) const;
+    // media path, no string keys & reference counting
+    ProducerTranslator* FindRegistered(const Producer* producer) const { return _producersIndex.Find(producer); }
     std::shared_ptr<ProducerTranslator> GetRegisteredProducer(const std::string& id) const;
     bool UnRegister(const Producer* producer);
+    // aggregated uplink stats of all end-points of the producer
+    void GetSendStats(const std::string& producerId, std::optional<WebsocketSendStats>& stats) const;
+    void GetLatencyStats(const Producer* producer, ProducerTranslationLatencyStats& stats) const;
     void RegisterProducerStream(const std::string& id, const RtpStream* stream, uint32_t mappedSsrc);
     // consumers API
     bool Register(Consumer* consumer, const std::string& producerId);
     std::shared_ptr<ConsumerTranslator> GetRegistered(const Consumer* consumer) const;
     std::shared_ptr<ConsumerTranslator> GetRegisteredConsumer(const std::string& id) const;
-    ConsumerTranslatorsList GetAssociated(const std::shared_ptr<ProducerTranslator>& producer) const;
-    ConsumerTranslatorsList GetAssociated(const std::string& producerId) const;
     bool UnRegister(const Consumer* consumer);
+    // impl. of TranslatorEndPointFactory
+    std::shared_ptr<TranslatorEndPoint> GetEndPoint(const std::string& producerId,
+                                                    MediaLanguage languageTo,
+                                                    MediaVoice voice) final;
     // impl. of ProducerObserver
     void onProducerStreamRegistered(const std::string& producerId, bool audio,
                                     uint32_t ssrc, uint32_t mappedSsrc,
@@ -45,20 +64,38 @@ public:
 private:
     static void RegisterStream(const std::shared_ptr<ProducerTranslator>& producerTranslator,
                                const RtpStream* stream, uint32_t mappedSsrc);
+    static std::shared_ptr<ProducerInputMediaStreamer> GetMediaInput(const std::shared_ptr<ProducerTranslator>& producerTranslator);
+    static void RemoveExpiredEndPoints(EndPointsMap& endPoints);
 private:
-    const std::string _serviceUri;
-    const std::string _serviceUser;
-    const std::string _servicePassword;
+    const MediaFrameFormat _serviceMediaFormat;
+    const WriteCoalescingSettings _serviceCoalescing;
+    const WebsocketSendQueueSettings _serviceSendQueue;
+    const VoiceActivitySettings _voiceActivity;
+    // chooses host of the service for end-points, warm connections of hosts are shared
+    // with other routers, null if there are no valid hosts
+    const std::shared_ptr<TranslationServiceBalancer> _serviceBalancer;
+    // paces play-out of translated media for all end-points of the router,
+    // must outlive them
+    const std::unique_ptr<TimerWheel> _timerWheel;
     absl::flat_hash_map<std::string, std::shared_ptr<ProducerTranslator>> _producerTranslators;
+    // same translators as above, for dispatch of RTP packets
+    TranslatorsIndex<Producer, ProducerTranslator> _producersIndex;
     absl::flat_hash_map<std::string, std::shared_ptr<ConsumerTranslator>> _consumerTranslators;
+    // key is producer ID
+    absl::flat_hash_map<std::string, EndPointsMap> _endPoints;
 };
 
 MediaTranslatorsManager::MediaTranslatorsManager(TransportListener* router,
-                                                 const std::string& serviceUri,
-                                                 const std::string& serviceUser,
-                                                 const std::string& servicePassword)
+                                                 const std::vector<TranslationServiceHost>& services,
+                                                 MediaFrameFormat serviceMediaFormat,
+                                                 const WriteCoalescingSettings& serviceCoalescing,
+                                                 const WebsocketSendQueueSettings& serviceSendQueue,
+                                                 const VoiceActivitySettings& voiceActivity,
+                                                 const WebsocketPoolSettings& servicePool,
+                                                 const TranslationBalancingSettings& serviceBalancing)
     : _router(router)
-    , _impl(std::make_shared<Impl>(serviceUri, serviceUser, servicePassword))
+    , _impl(std::make_shared<Impl>(services, serviceMediaFormat, serviceCoalescing, serviceSendQueue,
+                                   voiceActivity, servicePool, serviceBalancing))
 {
     MS_ASSERT(nullptr != _router, "router must be non-null");
 }
@@ -139,7 +176,8 @@ void MediaTranslatorsManager::OnTransportProducerRtpPacketReceived(Transport* tr
 {
     _router->OnTransportProducerRtpPacketReceived(transport, producer, packet);
     if (packet) {
-        if (const auto producerTranslator = _impl->GetRegistered(producer)) {
+        // translator skips packets at once while nobody consumes the translation
+        if (const auto producerTranslator = _impl->FindRegistered(producer)) {
             producerTranslator->AddPacket(packet);
         }
     }
@@ -154,6 +192,44 @@ void MediaTranslatorsManager::OnTransportNeedWorstRemoteFractionLost(Transport*
                                                     mappedSsrc, worstRemoteFractionLost);
 }
 
+void MediaTranslatorsManager::OnTransportProducerRecordingChanged(Transport* transport,
+                                                                  Producer* producer,
+                                                                  const std::optional<RecordingSettings>& settings)
+{
+    _router->OnTransportProducerRecordingChanged(transport, producer, settings);
+    if (const auto producerTranslator = _impl->GetRegistered(producer)) {
+        producerTranslator->SetRecording(settings);
+    }
+}
+
+void MediaTranslatorsManager::OnTransportProducerNeedTranslationUplinkStats(Transport* transport,
+                                                                           const Producer* producer,
+                                                                           std::optional<WebsocketSendStats>& stats)
+{
+    _router->OnTransportProducerNeedTranslationUplinkStats(transport, producer, stats);
+    if (producer) {
+        _impl->GetSendStats(producer->id, stats);
+    }
+}
+
+void MediaTranslatorsManager::OnTransportProducerNeedTranslationLatencyStats(Transport* transport,
+                                                                            const Producer* producer,
+                                                                            ProducerTranslationLatencyStats& stats)
+{
+    _router->OnTransportProducerNeedTranslationLatencyStats(transport, producer, stats);
+    _impl->GetLatencyStats(producer, stats);
+}
+
+void MediaTranslatorsManager::OnTransportConsumerNeedTranslationStats(Transport* transport,
+                                                                     const Consumer* consumer,
+                                                                     std::optional<TranslationStats>& stats)
+{
+    _router->OnTransportConsumerNeedTranslationStats(transport, consumer, stats);
+    if (const auto consumerTranslator = _impl->GetRegistered(consumer)) {
+        stats = consumerTranslator->GetStats();
+    }
+}
+
 void MediaTranslatorsManager::OnTransportNewConsumer(Transport* transport, Consumer* consumer,
                                                      const std::string& producerId)
 {
@@ -239,12 +315,20 @@ void MediaTranslatorsManager::OnTransportListenServerClosed(Transport* transport
     _router->OnTransportListenServerClosed(transport);
 }
 
-MediaTranslatorsManager::Impl::Impl(const std::string& serviceUri,
-                                    const std::string& serviceUser,
-                                    const std::string& servicePassword)
-    : _serviceUri(serviceUri)
-    , _serviceUser(serviceUser)
-    , _servicePassword(servicePassword)
+MediaTranslatorsManager::Impl::Impl(const std::vector<TranslationServiceHost>& services,
+                                    MediaFrameFormat serviceMediaFormat,
+                                    const WriteCoalescingSettings& serviceCoalescing,
+                                    const WebsocketSendQueueSettings& serviceSendQueue,
+                                    const VoiceActivitySettings& voiceActivity,
+                                    const WebsocketPoolSettings& servicePool,
+                                    const TranslationBalancingSettings& serviceBalancing)
+    : _serviceMediaFormat(serviceMediaFormat)
+    , _serviceCoalescing(serviceCoalescing)
+    , _serviceSendQueue(serviceSendQueue)
+    , _voiceActivity(voiceActivity)
+    , _serviceBalancer(TranslatorEndPoint::CreateServiceBalancer(services, serviceBalancing, servicePool,
+                                                                 serviceMediaFormat, serviceSendQueue))
+    , _timerWheel(std::make_unique<TimerWheel>())
 {
 }
 
@@ -253,12 +337,13 @@ bool MediaTranslatorsManager::Impl::Register(Producer* producer)
     if (producer && !producer->id.empty()) {
         const auto it = _producerTranslators.find(producer->id);
         if (it == _producerTranslators.end()) {
-            const auto producerTranslator = std::make_shared<ProducerTranslator>(producer);
+            const auto producerTranslator = std::make_shared<ProducerTranslator>(producer, _voiceActivity);
             const auto& streams = producer->GetRtpStreams();
             for (auto it = streams.begin(); it != streams.end(); ++it) {
                 RegisterStream(producerTranslator, it->first, it->second);
             }
             _producerTranslators[producer->id] = producerTranslator;
+            _producersIndex.Add(producer, producerTranslator.get());
             producerTranslator->AddObserver(this);
         }
         return true;
@@ -288,7 +373,17 @@ bool MediaTranslatorsManager::Impl::UnRegister(const Producer* producer)
         const auto it = _producerTranslators.find(producer->id);
         if (it != _producerTranslators.end()) {
             it->second->RemoveObserver(this);
+            _producersIndex.Remove(producer);
             _producerTranslators.erase(it);
+            const auto ite = _endPoints.find(producer->id);
+            if (ite != _endPoints.end()) {
+                for (auto itp = ite->second.begin(); itp != ite->second.end(); ++itp) {
+                    if (const auto endPoint = itp->second.lock()) {
+                        endPoint->SetInput(nullptr);
+                    }
+                }
+                _endPoints.erase(ite);
+            }
             return true;
         }
     }
@@ -311,18 +406,9 @@ bool MediaTranslatorsManager::Impl::Register(Consumer* consumer, const std::stri
             const auto it = _consumerTranslators.find(consumer->id);
             std::shared_ptr<ConsumerTranslator> consumerTranslator;
             if (it == _consumerTranslators.end()) {
-                consumerTranslator = std::make_shared<ConsumerTranslator>(consumer,
-                                                                          producerId,
-                                                                          _serviceUri,
-                                                                          _serviceUser,
-                                                                          _servicePassword);
+                consumerTranslator = std::make_shared<ConsumerTranslator>(consumer, producerId, this);
                 _consumerTranslators[consumer->id] = consumerTranslator;
             }
-            else {
-                consumerTranslator = it->second;
-            }
-            consumerTranslator->SetProducerLanguage(producerTranslator->GetLanguage());
-            //consumerTranslator->SetProducerInput(producerTranslator->GetMediaStreamer());
             return true;
         }
     }
@@ -336,7 +422,7 @@ std::shared_ptr<ConsumerTranslator> MediaTranslatorsManager::Impl::GetRegistered
 
 std::shared_ptr<ConsumerTranslator> MediaTranslatorsManager::Impl::GetRegisteredConsumer(const std::string& id) const
 {
-    if (id.empty()) {
+    if (!id.empty()) {
         const auto it = _consumerTranslators.find(id);
         if (it != _consumerTranslators.end()) {
             return it->second;
@@ -345,37 +431,97 @@ std::shared_ptr<ConsumerTranslator> MediaTranslatorsManager::Impl::GetRegistered
     return nullptr;
 }
 
-ConsumerTranslatorsList MediaTranslatorsManager::Impl::GetAssociated(const std::shared_ptr<ProducerTranslator>& producer) const
+bool MediaTranslatorsManager::Impl::UnRegister(const Consumer* consumer)
 {
-    if (producer) {
-        return GetAssociated(producer->GetId());
+    if (consumer && !consumer->id.empty()) {
+        const auto it = _consumerTranslators.find(consumer->id);
+        if (it != _consumerTranslators.end()) {
+            const auto producerId = it->second->GetProducerId();
+            _consumerTranslators.erase(it);
+            const auto ite = _endPoints.find(producerId);
+            if (ite != _endPoints.end()) {
+                RemoveExpiredEndPoints(ite->second);
+                if (ite->second.empty()) {
+                    _endPoints.erase(ite);
+                }
+            }
+            return true;
+        }
     }
-    return {};
+    return false;
 }
 
-ConsumerTranslatorsList MediaTranslatorsManager::Impl::GetAssociated(const std::string& producerId) const
+void MediaTranslatorsManager::Impl::GetSendStats(const std::string& producerId,
+                                                 std::optional<WebsocketSendStats>& stats) const
 {
-    ConsumerTranslatorsList consumers;
-    if (!producerId.empty()) {
-        for (auto it = _consumerTranslators.begin(); it != _consumerTranslators.end(); ++it) {
-            if (it->second->GetProducerId() == producerId) {
-                consumers.push_back(it->second);
+    const auto it = _endPoints.find(producerId);
+    if (it != _endPoints.end()) {
+        for (auto ite = it->second.begin(); ite != it->second.end(); ++ite) {
+            if (const auto endPoint = ite->second.lock()) {
+                const auto endPointStats = endPoint->GetSendStats();
+                if (!stats.has_value()) {
+                    stats = endPointStats;
+                }
+                else {
+                    stats->_queuedMessages += endPointStats._queuedMessages;
+                    stats->_queuedBytes += endPointStats._queuedBytes;
+                    stats->_queueDelayMs = std::max(stats->_queueDelayMs, endPointStats._queueDelayMs);
+                    stats->_sentMessages += endPointStats._sentMessages;
+                    stats->_sentBytes += endPointStats._sentBytes;
+                    stats->_droppedMessages += endPointStats._droppedMessages;
+                    stats->_droppedBytes += endPointStats._droppedBytes;
+                    stats->_writeLatencyMs = std::max(stats->_writeLatencyMs, endPointStats._writeLatencyMs);
+                    stats->_maxWriteLatencyMs = std::max(stats->_maxWriteLatencyMs,
+                                                         endPointStats._maxWriteLatencyMs);
+                    stats->_writeLatencyHistogram.Merge(endPointStats._writeLatencyHistogram);
+                    stats->_congestions += endPointStats._congestions;
+                    stats->_congested = stats->_congested || endPointStats._congested;
+                }
             }
         }
     }
-    return consumers;
 }
 
-bool MediaTranslatorsManager::Impl::UnRegister(const Consumer* consumer)
+void MediaTranslatorsManager::Impl::GetLatencyStats(const Producer* producer,
+                                                    ProducerTranslationLatencyStats& stats) const
 {
-    if (consumer && !consumer->id.empty()) {
-        const auto it = _consumerTranslators.find(consumer->id);
-        if (it != _consumerTranslators.end()) {
-            _consumerTranslators.erase(it);
-            return true;
+    if (const auto producerTranslator = GetRegistered(producer)) {
+        stats._streams = producerTranslator->GetLatencyStats();
+        const auto it = _endPoints.find(producer->id);
+        if (it != _endPoints.end()) {
+            for (auto ite = it->second.begin(); ite != it->second.end(); ++ite) {
+                if (const auto endPoint = ite->second.lock()) {
+                    stats._endPoints.push_back(endPoint->GetLatencyStats());
+                }
+            }
         }
     }
-    return false;
+}
+
+std::shared_ptr<TranslatorEndPoint> MediaTranslatorsManager::Impl::GetEndPoint(const std::string& producerId,
+                                                                               MediaLanguage languageTo,
+                                                                               MediaVoice voice)
+{
+    if (const auto producerTranslator = GetRegisteredProducer(producerId)) {
+        const TranslationPack pack(languageTo, voice, producerTranslator->GetLanguage());
+        auto& endPoints = _endPoints[producerId];
+        RemoveExpiredEndPoints(endPoints);
+        auto& endPointRef = endPoints[pack];
+        auto endPoint = endPointRef.lock();
+        if (!endPoint) {
+            endPoint = std::make_shared<TranslatorEndPoint>(_timerWheel.get(), _serviceMediaFormat,
+                                                            _serviceCoalescing, _serviceSendQueue,
+                                                            _serviceBalancer);
+            endPoint->SetProducerLanguage(pack._languageFrom);
+            endPoint->SetConsumerLanguage(pack._languageTo);
+            endPoint->SetConsumerVoice(pack._voice);
+            endPoint->SetInput(GetMediaInput(producerTranslator));
+            endPoint->Open();
+            endPointRef = endPoint;
+        }
+        return endPoint;
+    }
+    return nullptr;
 }
 
 void MediaTranslatorsManager::Impl::onProducerStreamRegistered(const std::string& producerId,
@@ -386,12 +532,17 @@ void MediaTranslatorsManager::Impl::onProducerStreamRegistered(const std::string
     if (ssrc && !producerId.empty()) {
         if (audio) {
             if (const auto producerTranslator = GetRegisteredProducer(producerId)) {
-                for (const auto& consumerTranslator : GetAssociated(producerTranslator)) {
-                    if (registered) {
-                        consumerTranslator->SetProducerInput(producerTranslator->GetMediaStreamer(mappedSsrc));
-                    }
-                    else if (consumerTranslator->GetProducerInputSsrc() == ssrc) {
-                        consumerTranslator->SetProducerInput(nullptr);
+                const auto it = _endPoints.find(producerId);
+                if (it != _endPoints.end()) {
+                    for (auto ite = it->second.begin(); ite != it->second.end(); ++ite) {
+                        if (const auto endPoint = ite->second.lock()) {
+                            if (registered) {
+                                endPoint->SetInput(producerTranslator->GetMediaStreamer(mappedSsrc));
+                            }
+                            else if (endPoint->GetProducerInputSsrc() == ssrc) {
+                                endPoint->SetInput(nullptr);
+                            }
+                        }
                     }
                 }
             }
@@ -409,10 +560,17 @@ void MediaTranslatorsManager::Impl::OnProducerLanguageChanged(const std::string&
                                                               const std::optional<MediaLanguage>& to)
 {
     if (!producerId.empty()) {
-        for (auto it = _consumerTranslators.begin(); it != _consumerTranslators.end(); ++it) {
-            if (it->second->GetProducerId() == producerId) {
-                it->second->SetProducerLanguage(to);
+        const auto it = _endPoints.find(producerId);
+        if (it != _endPoints.end()) {
+            // re-key all shared end-points of producer, they remains distinct after that
+            EndPointsMap endPoints;
+            for (auto ite = it->second.begin(); ite != it->second.end(); ++ite) {
+                if (const auto endPoint = ite->second.lock()) {
+                    endPoint->SetProducerLanguage(to);
+                    endPoints[TranslationPack(ite->first._languageTo, ite->first._voice, to)] = endPoint;
+                }
             }
+            it->second = std::move(endPoints);
         }
     }
 }
@@ -427,6 +585,30 @@ void MediaTranslatorsManager::Impl::RegisterStream(const std::shared_ptr<Produce
     }
 }
 
+std::shared_ptr<ProducerInputMediaStreamer> MediaTranslatorsManager::Impl::
+    GetMediaInput(const std::shared_ptr<ProducerTranslator>& producerTranslator)
+{
+    if (producerTranslator && producerTranslator->IsAudio()) {
+        const auto ssrcs = producerTranslator->GetRegisteredSsrcs(true);
+        if (!ssrcs.empty()) {
+            return producerTranslator->GetMediaStreamer(ssrcs.front());
+        }
+    }
+    return nullptr;
+}
+
+void MediaTranslatorsManager::Impl::RemoveExpiredEndPoints(EndPointsMap& endPoints)
+{
+    for (auto it = endPoints.begin(); it != endPoints.end();) {
+        if (it->second.expired()) {
+            endPoints.erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
 void TranslatorUnit::Pause(bool pause)
 {
     if (pause != _paused.exchange(pause)) {
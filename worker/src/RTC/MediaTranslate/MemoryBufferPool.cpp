@@ -0,0 +1,75 @@
+#define MS_CLASS "RTC::MemoryBufferPool"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+
+namespace RTC
+{
+
+MemoryBufferPool::MemoryBufferPool(size_t maxBuffersPerClass)
+    : _maxBuffersPerClass(maxBuffersPerClass)
+{
+}
+
+MemoryBufferPool::~MemoryBufferPool()
+{
+}
+
+std::shared_ptr<SimpleMemoryBuffer> MemoryBufferPool::Allocate(size_t capacity)
+{
+    if (const auto sizeClass = GetSizeClass(capacity)) {
+        auto& buffers = _buffers[sizeClass.value()];
+        for (const auto& buffer : buffers) {
+            // only the pool holds this buffer
+            if (1L == buffer.use_count()) {
+                // synchronize with release of last external reference on other thread
+                std::atomic_thread_fence(std::memory_order_acquire);
+                buffer->Resize(0UL);
+                _reuses.fetch_add(1ULL, std::memory_order_relaxed);
+                return buffer;
+            }
+        }
+        auto buffer = CreateBuffer(GetSizeClassCapacity(sizeClass.value()));
+        if (buffers.size() < _maxBuffersPerClass) {
+            buffers.push_back(buffer);
+        }
+        return buffer;
+    }
+    // too large for pooling
+    return CreateBuffer(capacity);
+}
+
+std::shared_ptr<SimpleMemoryBuffer> MemoryBufferPool::Allocate(const uint8_t* data, size_t len)
+{
+    if (data && len) {
+        auto buffer = Allocate(len);
+        buffer->Append(data, len);
+        return buffer;
+    }
+    return nullptr;
+}
+
+std::optional<size_t> MemoryBufferPool::GetSizeClass(size_t size)
+{
+    size_t sizeClass = 0UL;
+    while (GetSizeClassCapacity(sizeClass) < size) {
+        if (++sizeClass == _sizeClassesCount) {
+            return std::nullopt;
+        }
+    }
+    return sizeClass;
+}
+
+size_t MemoryBufferPool::GetSizeClassCapacity(size_t sizeClass)
+{
+    return 1UL << (_minSizeClassLog2 + sizeClass);
+}
+
+std::shared_ptr<SimpleMemoryBuffer> MemoryBufferPool::CreateBuffer(size_t capacity)
+{
+    auto buffer = std::make_shared<SimpleMemoryBuffer>();
+    buffer->Reserve(capacity);
+    _allocations.fetch_add(1ULL, std::memory_order_relaxed);
+    return buffer;
+}
+
+} // namespace RTC
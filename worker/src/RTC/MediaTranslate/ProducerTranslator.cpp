@@ -1,18 +1,26 @@
 #define MS_CLASS "RTC::ProducerTranslator"
 #include "RTC/MediaTranslate/ProducerTranslator.hpp"
-#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrameFanOut.hpp"
+#include "RTC/MediaTranslate/RtpWebMSerializer.hpp"
 #include "RTC/MediaTranslate/RtpDepacketizer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include "RTC/MediaTranslate/RtpPacketsQueue.hpp"
 #include "RTC/MediaTranslate/TranslatorUtils.hpp"
+#include "RTC/MediaTranslate/VoiceActivityGate.hpp"
 #include "RTC/MediaTranslate/OutputDevice.hpp"
 #include "RTC/MediaTranslate/ProducerInputMediaStreamer.hpp"
-#ifdef WRITE_PRODUCER_RECV_TO_FILE
-#include "RTC/MediaTranslate/FileWriter.hpp"
-#endif
+#include "RTC/MediaTranslate/AsyncFileWriter.hpp"
 #include "RTC/RtpStream.hpp"
 #include "RTC/Producer.hpp"
-#include "ProtectedObj.hpp"
+#include "ProtectedSnapshot.hpp"
 #include "Logger.hpp"
-#include <absl/container/flat_hash_set.h>
+#include <absl/container/flat_hash_map.h>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
 
 namespace {
 
@@ -28,51 +36,121 @@ enum class MimeChangeStatus
 namespace RTC
 {
 
+// depacketizer & serializers are touched only on the translation thread of the stream,
+// output devices are read-mostly snapshot, so the media path has no exclusive locks,
+// removed device is released by the last snapshot or by its finalized serializer;
+// the pipeline is created lazily by the first output device and destroyed
+// after grace period once the last device is gone, a dormant stream drops packets
 class ProducerTranslator::StreamInfo : public ProducerInputMediaStreamer,
-                                       private OutputDevice
-{
-    using OutputDevicesSet = absl::flat_hash_set<OutputDevice*>;
+                                       public std::enable_shared_from_this<ProducerTranslator::StreamInfo>
+{
+    using OutputDevicesMap = RtpMediaFrameFanOut::Outputs;
+    struct QueuedPacketInfo
+    {
+        uint64_t _arrivalUs = 0ULL;
+        // read on the worker thread
+        std::optional<VoiceActivityGate::AudioLevel> _audioLevel;
+    };
+    using PacketsQueue = RtpPacketsQueue<QueuedPacketInfo>;
+    using QueuedPacket = PacketsQueue::Item;
 public:
-    StreamInfo(uint32_t sampleRate, uint32_t mappedSsrc, uint32_t ssrc);
+    // [activeStreams] is the counter of streams with pipeline, shared by all streams of producer
+    StreamInfo(uint32_t sampleRate, uint32_t mappedSsrc, uint32_t ssrc,
+               const VoiceActivitySettings& voiceActivity,
+               const std::shared_ptr<std::atomic<uint32_t>>& activeStreams);
     ~StreamInfo() final;
     uint32_t GetMappedSsrc() const { return _mappedSsrc; }
     void SetSsrc(uint32_t ssrc) { _ssrc = ssrc; }
     MimeChangeStatus SetMime(const RtpCodecMimeType& mime);
-    std::optional<RtpCodecMimeType> GetMime() const;
-    void DepacketizeAndSerialize(const RtpPacket* packet) const;
+    const std::optional<RtpCodecMimeType>& GetMime() const { return _mime; }
+    // called on worker thread, packet is copied into recycled item of queue for the translation thread
+    void AddPacket(const RtpPacket* packet);
+    uint64_t GetDroppedPacketsCount() const;
+    TranslationStreamLatencyStats GetLatencyStats() const;
+    // worker thread, true if depacketizer lost decodability of video since the last call
+    bool TakeKeyFrameRequest();
+    // null settings disables recording
+    void SetRecording(const std::optional<RecordingSettings>& settings, const std::string& fileNamePrefix);
     // impl. of ProducerInputMediaStreamer
     uint32_t GetSsrc() const final { return _ssrc.load(std::memory_order_relaxed); }
-    bool AddOutputDevice(OutputDevice* outputDevice) final;
+    bool AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice, MediaFrameFormat format) final;
     bool RemoveOutputDevice(OutputDevice* outputDevice) final;
 private:
-#ifdef WRITE_PRODUCER_RECV_TO_FILE
-    std::string_view GetFileExtension(const RtpCodecMimeType& mime) const;
-    bool EnsureFileWriter(const RTC::RtpCodecMimeType& mime);
-#endif
-    void SetOutputDevice(OutputDevice* outputDevice) const;
-    void SetLiveMode(bool live) const;
-    // impl. of OutputDevice
-    void BeginWriteMediaPayload(uint32_t ssrc, bool isKeyFrame,
-                                const RtpCodecMimeType& mimeType,
-                                uint16_t rtpSequenceNumber,
-                                uint32_t rtpTimestamp,
-                                uint32_t rtpAbsSendtime) final;
-    void EndWriteMediaPayload(uint32_t ssrc, bool ok) final;
-    void Write(const std::shared_ptr<const MemoryBuffer>& buffer) final;
+    // [liveMode] is false for recording, other outputs keep the live mode of own serializers
+    bool AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice, MediaFrameFormat format,
+                         bool liveMode);
+    void UpdateRecorder();
+    // run [task] on translation thread if this stream is still alive
+    template <class Task>
+    void Post(Task task);
+    void ScheduleDrain();
+    // called on translation thread
+    void Drain();
+    void DepacketizeAndSerialize(const QueuedPacket& packet);
+    void ProcessFrame(const std::shared_ptr<RtpMediaFrame>& frame, const QueuedPacket& packet);
+    void UpdateAssemblyCounters();
+    bool Serialize(const std::shared_ptr<RtpMediaFrame>& frame);
+    void SetPipelineMime(const RtpCodecMimeType& mime);
+    void UpdatePipeline();
+    void CreatePipeline();
+    void DestroyPipeline();
+    void UpdateSerializers();
+    void SetActive(bool active);
 private:
     const uint32_t _sampleRate;
     const uint32_t _mappedSsrc;
     std::atomic<uint32_t> _ssrc;
-    ProtectedUniquePtr<RtpDepacketizer> _depacketizer;
-    ProtectedUniquePtr<RtpMediaFrameSerializer> _serializer;
-    ProtectedObj<OutputDevicesSet> _outputDevices;
-#ifdef WRITE_PRODUCER_RECV_TO_FILE
-    ProtectedUniquePtr<FileWriter> _fileWriter;
-#endif
+    // payload buffers for depacketizer, survive changes of mime type
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    // worker thread only
+    std::optional<RtpCodecMimeType> _mime;
+    std::string _fileExtension;
+    std::optional<RecordingSettings> _recording;
+    std::string _recordingFileNamePrefix;
+    std::shared_ptr<AsyncFileWriter> _recorder;
+    // translation thread only, each output device has own serializer,
+    // so a device connected later receives the stream from its beginning
+    std::optional<RtpCodecMimeType> _pipelineMime;
+    std::unique_ptr<RtpDepacketizer> _depacketizer;
+    RtpMediaFrameFanOut _serializers;
+    // audio only, passed frames are reused between packets
+    VoiceActivityGate _voiceActivityGate;
+    VoiceActivityGate::Frames _voiceFrames;
+    bool _gated = false;
+    // shared
+    ProtectedSnapshot<OutputDevicesMap> _outputDevices;
+    // written by translation thread, true while at least one output device is connected
+    std::atomic_bool _active = false;
+    const std::shared_ptr<std::atomic<uint32_t>> _activeStreams;
+    // ~2.5 seconds of 20ms audio packets
+    static inline constexpr size_t _packetsQueueCapacity = 128UL;
+    PacketsQueue _packets;
+    // written by translation thread
+    LatencyHistogram _assemblyLatency;
+    LatencyHistogram _serializationLatency;
+    std::atomic<uint64_t> _frames = 0ULL;
+    std::atomic<uint64_t> _bytes = 0ULL;
+    std::atomic<uint64_t> _incompleteFrames = 0ULL;
+    std::atomic<uint64_t> _undecodableFrames = 0ULL;
+    std::atomic_bool _keyFrameRequested = false;
+    // translation thread, counters of destroyed depacketizers
+    uint64_t _pastIncompleteFrames = 0ULL;
+    uint64_t _pastUndecodableFrames = 0ULL;
+    // worker thread
+    std::atomic<uint64_t> _keyFrameRequests = 0ULL;
+    std::atomic<uint64_t> _oversizedPackets = 0ULL;
+    // translation thread, pinned at creation
+    asio::io_context* const _context;
+    std::atomic_bool _drainScheduled = false;
+    // short reconnection of end-point (or re-creation of recorder) keeps the pipeline
+    static inline constexpr std::chrono::seconds _pipelineTeardownDelay{5};
+    asio::steady_timer _pipelineTeardownTimer;
 };
 
-ProducerTranslator::ProducerTranslator(Producer* producer)
+ProducerTranslator::ProducerTranslator(Producer* producer, const VoiceActivitySettings& voiceActivity)
     : _producer(producer)
+    , _voiceActivity(voiceActivity)
+    , _activeStreams(std::make_shared<std::atomic<uint32_t>>(0U))
 {
     MS_ASSERT(_producer, "producer must not be null");
 }
@@ -119,7 +197,10 @@ bool ProducerTranslator::RegisterStream(const RtpStream* stream, uint32_t mapped
             if (it == _streams.end()) {
                 const auto streamInfo = std::make_shared<StreamInfo>(stream->GetClockRate(),
                                                                      mappedSsrc,
-                                                                     stream->GetSsrc());
+                                                                     stream->GetSsrc(),
+                                                                     _voiceActivity,
+                                                                     _activeStreams);
+                streamInfo->SetRecording(_recording, GetRecordingFileNamePrefix());
                 ok = MimeChangeStatus::Changed == streamInfo->SetMime(mime);
                 if (ok) {
                     _streams[mappedSsrc] = streamInfo;
@@ -199,6 +280,38 @@ std::list<uint32_t> ProducerTranslator::GetRegisteredSsrcs(bool mapped) const
     return ssrcs;
 }
 
+uint64_t ProducerTranslator::GetDroppedPacketsCount() const
+{
+    uint64_t count = 0ULL;
+    for (auto it = _streams.begin(); it != _streams.end(); ++it) {
+        count += it->second->GetDroppedPacketsCount();
+    }
+    return count;
+}
+
+std::vector<TranslationStreamLatencyStats> ProducerTranslator::GetLatencyStats() const
+{
+    std::vector<TranslationStreamLatencyStats> stats;
+    stats.reserve(_streams.size());
+    for (auto it = _streams.begin(); it != _streams.end(); ++it) {
+        stats.push_back(it->second->GetLatencyStats());
+    }
+    return stats;
+}
+
+void ProducerTranslator::SetRecording(const std::optional<RecordingSettings>& settings)
+{
+    _recording = settings;
+    for (auto it = _streams.begin(); it != _streams.end(); ++it) {
+        it->second->SetRecording(_recording, GetRecordingFileNamePrefix());
+    }
+}
+
+std::string ProducerTranslator::GetRecordingFileNamePrefix() const
+{
+    return GetId() + "_";
+}
+
 const std::string& ProducerTranslator::GetId() const
 {
     return _producer->id;
@@ -206,10 +319,14 @@ const std::string& ProducerTranslator::GetId() const
 
 void ProducerTranslator::AddPacket(const RtpPacket* packet)
 {
-    if (packet && !IsPaused()) {
+    if (packet && IsActive() && !IsPaused()) {
         const auto it = _streams.find(packet->GetSsrc());
         if (it != _streams.end()) {
-            it->second->DepacketizeAndSerialize(packet);
+            it->second->AddPacket(packet);
+            // raised on translation thread, requested here because producer is worker thread only
+            if (it->second->TakeKeyFrameRequest()) {
+                _producer->RequestKeyFrame(it->second->GetMappedSsrc());
+            }
         }
     }
 }
@@ -250,190 +367,343 @@ void ProducerTranslator::OnPauseChanged(bool pause)
     InvokeObserverMethod(&ProducerObserver::OnProducerPauseChanged, pause);
 }
 
-ProducerTranslator::StreamInfo::StreamInfo(uint32_t sampleRate, uint32_t mappedSsrc, uint32_t ssrc)
+ProducerTranslator::StreamInfo::StreamInfo(uint32_t sampleRate, uint32_t mappedSsrc, uint32_t ssrc,
+                                           const VoiceActivitySettings& voiceActivity,
+                                           const std::shared_ptr<std::atomic<uint32_t>>& activeStreams)
     : _sampleRate(sampleRate)
     , _mappedSsrc(mappedSsrc)
     , _ssrc(ssrc)
+    , _buffersPool(std::make_shared<MemoryBufferPool>())
+    , _serializers(_buffersPool)
+    , _voiceActivityGate(voiceActivity)
+    , _activeStreams(activeStreams)
+    , _packets(_packetsQueueCapacity)
+    , _context(IoContextPool::GetInstance().NextContext())
+    , _pipelineTeardownTimer(*_context)
 {
 }
 
 ProducerTranslator::StreamInfo::~StreamInfo()
 {
-    SetOutputDevice(nullptr);
+    // no pending tasks may hold this stream, finalize on the current thread
+    _serializers.Reset();
+    SetActive(false);
+}
+
+template <class Task>
+void ProducerTranslator::StreamInfo::Post(Task task)
+{
+    asio::post(*_context, [weakSelf = weak_from_this(), task = std::move(task)]() mutable {
+        if (const auto self = weakSelf.lock()) {
+            task(self.get());
+        }
+    });
 }
 
 MimeChangeStatus ProducerTranslator::StreamInfo::SetMime(const RtpCodecMimeType& mime)
 {
-    MimeChangeStatus status = MimeChangeStatus::Failed;
-    LOCK_WRITE_PROTECTED_OBJ(_depacketizer);
-    if (_depacketizer->get() && mime == _depacketizer->get()->GetCodecMimeType()) {
-        status = MimeChangeStatus::NotChanged;
+    if (_mime == mime) {
+        return MimeChangeStatus::NotChanged;
     }
-    else {
-        if (auto serializer = RtpMediaFrameSerializer::create(mime)) {
-            if (auto depacketizer = RtpDepacketizer::create(mime, _sampleRate)) {
-                LOCK_WRITE_PROTECTED_OBJ(_serializer);
-                _serializer = std::move(serializer);
-                _depacketizer = std::move(depacketizer);
-                status = MimeChangeStatus::Changed;
-            }
-        }
+    // WebM is mandatory as fallback & recording format, other formats are optional,
+    // pipeline objects are not created until first output device
+    if (RtpWebMSerializer::IsSupported(mime) && RtpDepacketizer::IsSupported(mime)) {
+        _mime = mime;
+        _fileExtension = RtpWebMSerializer::_fileExtension;
+        UpdateRecorder();
+        Post([mime](StreamInfo* self) { self->SetPipelineMime(mime); });
+        return MimeChangeStatus::Changed;
     }
-    if (MimeChangeStatus::Changed == status) {
-#ifdef WRITE_PRODUCER_RECV_TO_FILE
-        if (EnsureFileWriter(mime)) {
-            SetLiveMode(false);
+    return MimeChangeStatus::Failed;
+}
+
+void ProducerTranslator::StreamInfo::AddPacket(const RtpPacket* packet)
+{
+    if (packet && _active.load(std::memory_order_relaxed)) {
+        // network input is not limited by size, but queued packets are copied into MTU-sized buffers
+        if (packet->GetSize() > PacketsQueue::_maxPacketSize) {
+            const auto dropped = _oversizedPackets.fetch_add(1ULL, std::memory_order_relaxed) + 1ULL;
+            MS_WARN_DEV("packet too big for translation [size:%zu], total oversized drops: %" PRIu64,
+                        packet->GetSize(), dropped);
+            return;
         }
-#endif
-        LOCK_READ_PROTECTED_OBJ(_outputDevices);
-        if (!_outputDevices->empty()) {
-            SetOutputDevice(this);
+        QueuedPacketInfo info;
+        info._arrivalUs = LatencyHistogram::NowUs();
+        VoiceActivityGate::AudioLevel value;
+        if (packet->ReadSsrcAudioLevel(value._level, value._voice)) {
+            info._audioLevel = value;
         }
+        if (!_packets.Push(packet, std::move(info))) {
+            MS_WARN_DEV("translation queue overflow, oldest packet dropped, total drops: %" PRIu64,
+                        _packets.GetDroppedCount());
+        }
+        ScheduleDrain();
     }
-    return status;
 }
 
-std::optional<RtpCodecMimeType> ProducerTranslator::StreamInfo::GetMime() const
+bool ProducerTranslator::StreamInfo::AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice,
+                                                     MediaFrameFormat format)
 {
-    LOCK_READ_PROTECTED_OBJ(_depacketizer);
-    if (const auto& depacketizer = _depacketizer.ConstRef()) {
-        return depacketizer->GetCodecMimeType();
-    }
-    return std::nullopt;
+    return AddOutputDevice(outputDevice, format, true);
 }
 
-void ProducerTranslator::StreamInfo::DepacketizeAndSerialize(const RtpPacket* packet) const
+bool ProducerTranslator::StreamInfo::AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice,
+                                                     MediaFrameFormat format, bool liveMode)
 {
-    if (packet) {
-        LOCK_READ_PROTECTED_OBJ(_depacketizer);
-        if (const auto& depacketizer = _depacketizer.ConstRef()) {
-            if (const auto frame = depacketizer->AddPacket(packet)) {
-                LOCK_READ_PROTECTED_OBJ(_serializer);
-                if (const auto& serializer = _serializer.ConstRef()) {
-                    serializer->Push(frame);
-                }
+    if (outputDevice) {
+        const auto changed = _outputDevices.Update([&outputDevice, format, liveMode](OutputDevicesMap& devices) {
+            const auto it = devices.find(outputDevice.get());
+            if (it == devices.end()) {
+                devices.emplace(outputDevice.get(), RtpMediaFrameFanOut::Output{outputDevice, format, liveMode});
+                return true;
+            }
+            if (it->second._format != format || it->second._liveMode != liveMode) {
+                it->second._format = format;
+                it->second._liveMode = liveMode;
+                return true;
             }
+            return false;
+        });
+        if (changed) {
+            Post([](StreamInfo* self) { self->UpdatePipeline(); });
         }
+        return true;
     }
+    return false;
 }
 
-bool ProducerTranslator::StreamInfo::AddOutputDevice(OutputDevice* outputDevice)
+bool ProducerTranslator::StreamInfo::RemoveOutputDevice(OutputDevice* outputDevice)
 {
     if (outputDevice) {
-        LOCK_WRITE_PROTECTED_OBJ(_outputDevices);
-        if (!_outputDevices->count(outputDevice)) {
-            _outputDevices->insert(outputDevice);
-            if (1UL == _outputDevices->size()) {
-                SetLiveMode(true);
-                SetOutputDevice(this);
-            }
+        const auto removed = _outputDevices.Update([outputDevice](OutputDevicesMap& devices) {
+            return devices.erase(outputDevice) > 0UL;
+        });
+        if (removed) {
+            Post([](StreamInfo* self) { self->UpdatePipeline(); });
         }
-        return true;
+        return removed;
     }
     return false;
 }
 
-bool ProducerTranslator::StreamInfo::RemoveOutputDevice(OutputDevice* outputDevice)
+void ProducerTranslator::StreamInfo::SetRecording(const std::optional<RecordingSettings>& settings,
+                                                  const std::string& fileNamePrefix)
 {
-    if (outputDevice) {
-        LOCK_WRITE_PROTECTED_OBJ(_outputDevices);
-        const auto it = _outputDevices->find(outputDevice);
-        if (it != _outputDevices->end()) {
-            _outputDevices->erase(it);
-            if (_outputDevices->empty()) {
-                SetOutputDevice(nullptr);
+    _recording = settings;
+    _recordingFileNamePrefix = fileNamePrefix;
+    UpdateRecorder();
+}
+
+void ProducerTranslator::StreamInfo::UpdateRecorder()
+{
+    if (const auto recorder = std::move(_recorder)) {
+        // file is closed asynchronously by the last owner, maybe by translation thread
+        RemoveOutputDevice(recorder.get());
+    }
+    if (_recording && _mime && !_fileExtension.empty()) {
+        const auto& type = MimeTypeToString(_mime.value());
+        if (!type.empty()) {
+            std::string fileName = _recordingFileNamePrefix + type + std::to_string(GetMappedSsrc());
+            fileName = _recording->_directory + "/" + fileName + "." + _fileExtension;
+            // file is opened by the writer thread, open errors are logged there
+            std::shared_ptr<AsyncFileWriter> recorder = AsyncFileWriter::Create(std::move(fileName),
+                                                                                _recording.value());
+            // recording requires file mode of own serializer only, live outputs are not affected
+            if (recorder && AddOutputDevice(recorder, MediaFrameFormat::WebM, false)) {
+                _recorder = std::move(recorder);
             }
-            return true;
         }
     }
+}
+
+void ProducerTranslator::StreamInfo::ScheduleDrain()
+{
+    if (!_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        Post([](StreamInfo* self) { self->Drain(); });
+    }
+}
+
+void ProducerTranslator::StreamInfo::Drain()
+{
+    do {
+        while (auto packet = _packets.Pop()) {
+            DepacketizeAndSerialize(*packet);
+            _packets.Recycle(std::move(packet));
+        }
+        _drainScheduled.store(false, std::memory_order_release);
+        // packets might be added after last pop but before reset of flag
+    }
+    while (!_packets.IsEmpty() && !_drainScheduled.exchange(true, std::memory_order_acq_rel));
+}
+
+uint64_t ProducerTranslator::StreamInfo::GetDroppedPacketsCount() const
+{
+    return _packets.GetDroppedCount() + _oversizedPackets.load(std::memory_order_relaxed);
+}
+
+TranslationStreamLatencyStats ProducerTranslator::StreamInfo::GetLatencyStats() const
+{
+    TranslationStreamLatencyStats stats;
+    stats._mappedSsrc = GetMappedSsrc();
+    stats._assembly = _assemblyLatency.GetSnapshot();
+    stats._serialization = _serializationLatency.GetSnapshot();
+    stats._frames = _frames.load(std::memory_order_relaxed);
+    stats._bytes = _bytes.load(std::memory_order_relaxed);
+    stats._droppedPackets = GetDroppedPacketsCount();
+    stats._gatedFrames = _voiceActivityGate.GetGatedFrames();
+    stats._gatedBytes = _voiceActivityGate.GetGatedBytes();
+    stats._speechSegments = _voiceActivityGate.GetSpeechSegments();
+    stats._incompleteFrames = _incompleteFrames.load(std::memory_order_relaxed);
+    stats._undecodableFrames = _undecodableFrames.load(std::memory_order_relaxed);
+    stats._keyFrameRequests = _keyFrameRequests.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ProducerTranslator::StreamInfo::TakeKeyFrameRequest()
+{
+    if (_keyFrameRequested.load(std::memory_order_relaxed) &&
+        _keyFrameRequested.exchange(false, std::memory_order_relaxed)) {
+        _keyFrameRequests.fetch_add(1ULL, std::memory_order_relaxed);
+        return true;
+    }
     return false;
 }
 
-#ifdef WRITE_PRODUCER_RECV_TO_FILE
-std::string_view ProducerTranslator::StreamInfo::GetFileExtension(const RtpCodecMimeType& mime) const
+void ProducerTranslator::StreamInfo::DepacketizeAndSerialize(const QueuedPacket& packet)
 {
-    LOCK_READ_PROTECTED_OBJ(_serializer);
-    if (const auto& serializer = _serializer.ConstRef()) {
-        return serializer->GetFileExtension(mime);
+    if (_depacketizer) {
+        // late packet of reordered video may complete several frames
+        for (auto frame = _depacketizer->AddPacket(packet._packet.get()); frame;
+             frame = _depacketizer->NextFrame()) {
+            ProcessFrame(frame, packet);
+        }
+        UpdateAssemblyCounters();
     }
-    return {};
 }
 
-bool ProducerTranslator::StreamInfo::EnsureFileWriter(const RTC::RtpCodecMimeType& mime)
+void ProducerTranslator::StreamInfo::ProcessFrame(const std::shared_ptr<RtpMediaFrame>& frame,
+                                                  const QueuedPacket& packet)
 {
-    LOCK_WRITE_PROTECTED_OBJ(_fileWriter);
-    if (auto fileWriter = _fileWriter.Take()) {
-        RemoveOutputDevice(fileWriter.get());
+    const auto assembledUs = LatencyHistogram::NowUs();
+    _assemblyLatency.Add(assembledUs - std::min(assembledUs, packet._info._arrivalUs));
+    _frames.fetch_add(1ULL, std::memory_order_relaxed);
+    if (const auto& payload = frame->GetPayload()) {
+        _bytes.fetch_add(payload->GetSize(), std::memory_order_relaxed);
     }
-    const auto depacketizerPath = std::getenv("MEDIASOUP_DEPACKETIZER_PATH");
-    if (depacketizerPath && std::strlen(depacketizerPath)) {
-        const auto& type = MimeTypeToString(mime);
-        if (!type.empty()) {
-            const auto extension = GetFileExtension(mime);
-            if (!extension.empty()) {
-                std::string fileName = type + std::to_string(GetMappedSsrc()) + "." + std::string(extension);
-                fileName = std::string(depacketizerPath) + "/" + fileName;
-                auto fileWriter = std::make_unique<FileWriter>(fileName);
-                if (fileWriter->IsOpen()) {
-                    if (AddOutputDevice(fileWriter.get())) {
-                        _fileWriter = std::move(fileWriter);
-                    }
-                    else {
-                        fileWriter->Close();
-                        ::remove(fileName.c_str()); // from stdio.h
-                    }
-                }
-            }
+    bool serialized = false;
+    if (_gated) {
+        // silence is suspended, speech may be preceded by pre-roll
+        _voiceActivityGate.Push(frame, packet._info._audioLevel, _voiceFrames);
+        for (const auto& voiceFrame : _voiceFrames) {
+            serialized = Serialize(voiceFrame) || serialized;
         }
+        _voiceFrames.clear();
+    }
+    else {
+        serialized = Serialize(frame);
+    }
+    if (serialized) {
+        _serializationLatency.AddSince(assembledUs);
     }
-    return nullptr != _fileWriter->get();
 }
-#endif
 
-void ProducerTranslator::StreamInfo::SetOutputDevice(OutputDevice* outputDevice) const
+void ProducerTranslator::StreamInfo::UpdateAssemblyCounters()
 {
-    LOCK_READ_PROTECTED_OBJ(_serializer);
-    if (const auto& serializer = _serializer.ConstRef()) {
-        serializer->SetOutputDevice(outputDevice);
+    if (_depacketizer->TakeKeyFrameRequest()) {
+        _keyFrameRequested.store(true, std::memory_order_relaxed);
     }
+    _incompleteFrames.store(_pastIncompleteFrames + _depacketizer->GetIncompleteFramesCount(),
+                            std::memory_order_relaxed);
+    _undecodableFrames.store(_pastUndecodableFrames + _depacketizer->GetUndecodableFramesCount(),
+                             std::memory_order_relaxed);
+}
+
+bool ProducerTranslator::StreamInfo::Serialize(const std::shared_ptr<RtpMediaFrame>& frame)
+{
+    return _serializers.Push(frame);
 }
 
-void ProducerTranslator::StreamInfo::SetLiveMode(bool live) const
+void ProducerTranslator::StreamInfo::SetPipelineMime(const RtpCodecMimeType& mime)
 {
-    LOCK_READ_PROTECTED_OBJ(_serializer);
-    if (const auto& serializer = _serializer.ConstRef()) {
-        serializer->SetLiveMode(live);
+    if (_pipelineMime != mime) {
+        // finalize previous media segment, new pipeline is created on demand
+        DestroyPipeline();
+        _pipelineMime = mime;
+        UpdatePipeline();
     }
 }
 
-void ProducerTranslator::StreamInfo::BeginWriteMediaPayload(uint32_t ssrc, bool isKeyFrame,
-                                                            const RtpCodecMimeType& codecMimeType,
-                                                            uint16_t rtpSequenceNumber,
-                                                            uint32_t rtpTimestamp,
-                                                            uint32_t rtpAbsSendtime)
+void ProducerTranslator::StreamInfo::UpdatePipeline()
 {
-    LOCK_READ_PROTECTED_OBJ(_outputDevices);
-    for (const auto outputDevice : _outputDevices.ConstRef()) {
-        outputDevice->BeginWriteMediaPayload(ssrc, isKeyFrame, codecMimeType,
-                                             rtpSequenceNumber, rtpTimestamp,
-                                             rtpAbsSendtime);
+    const auto hasOutputs = !_outputDevices.Get()->empty();
+    if (hasOutputs) {
+        _pipelineTeardownTimer.cancel();
+        if (!_depacketizer) {
+            CreatePipeline();
+        }
+        UpdateSerializers();
     }
+    else if (_depacketizer) {
+        UpdateSerializers();
+        _pipelineTeardownTimer.expires_after(_pipelineTeardownDelay);
+        _pipelineTeardownTimer.async_wait([weakSelf = weak_from_this()](const asio::error_code& error) {
+            if (!error) {
+                if (const auto self = weakSelf.lock()) {
+                    if (self->_outputDevices.Get()->empty()) {
+                        self->DestroyPipeline();
+                    }
+                }
+            }
+        });
+    }
+    // packets are accepted only after (re)creation of the pipeline
+    SetActive(hasOutputs && _depacketizer);
 }
 
-void ProducerTranslator::StreamInfo::EndWriteMediaPayload(uint32_t ssrc, bool ok)
+void ProducerTranslator::StreamInfo::CreatePipeline()
 {
-    LOCK_READ_PROTECTED_OBJ(_outputDevices);
-    for (const auto outputDevice : _outputDevices.ConstRef()) {
-        outputDevice->EndWriteMediaPayload(ssrc, ok);
+    if (_pipelineMime) {
+        const auto& mime = _pipelineMime.value();
+        _depacketizer = RtpDepacketizer::create(mime, _sampleRate, _buffersPool);
+        if (_depacketizer) {
+            // DTX heuristic is specific for OPUS
+            _voiceActivityGate.Reset();
+            _gated = RtpCodecMimeType::Subtype::OPUS == mime.GetSubtype();
+            MS_DEBUG_DEV("pipeline of stream %u activated", GetMappedSsrc());
+        }
+    }
+}
+
+void ProducerTranslator::StreamInfo::DestroyPipeline()
+{
+    // finalize media segments
+    _serializers.Reset();
+    if (_depacketizer) {
+        _pastIncompleteFrames += _depacketizer->GetIncompleteFramesCount();
+        _pastUndecodableFrames += _depacketizer->GetUndecodableFramesCount();
+        _depacketizer.reset();
+        _voiceFrames.clear();
+        _voiceActivityGate.Reset();
+        _gated = false;
+        MS_DEBUG_DEV("pipeline of stream %u deactivated", GetMappedSsrc());
     }
 }
 
-void ProducerTranslator::StreamInfo::Write(const std::shared_ptr<const MemoryBuffer>& buffer)
+void ProducerTranslator::StreamInfo::UpdateSerializers()
 {
-    if (buffer) {
-        LOCK_READ_PROTECTED_OBJ(_outputDevices);
-        for (const auto outputDevice : _outputDevices.ConstRef()) {
-            outputDevice->Write(buffer);
+    if (_depacketizer && _pipelineMime) {
+        _serializers.Update(_pipelineMime.value(), *_outputDevices.Get());
+    }
+}
+
+void ProducerTranslator::StreamInfo::SetActive(bool active)
+{
+    if (active != _active.exchange(active, std::memory_order_relaxed)) {
+        if (active) {
+            _activeStreams->fetch_add(1U, std::memory_order_relaxed);
+        }
+        else {
+            _activeStreams->fetch_sub(1U, std::memory_order_relaxed);
         }
     }
 }
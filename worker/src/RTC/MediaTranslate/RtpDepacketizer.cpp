@@ -1,28 +1,68 @@
 #define MS_CLASS "RTC::RtpDepacketizer"
 #include "RTC/MediaTranslate/RtpDepacketizerOpus.hpp"
 #include "RTC/MediaTranslate/RtpDepacketizerVpx.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "Logger.hpp"
 
 namespace RTC
 {
 
-RtpDepacketizer::RtpDepacketizer(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate)
+RtpDepacketizer::RtpDepacketizer(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate,
+                                 const std::shared_ptr<MemoryBufferPool>& buffersPool)
     : _codecMimeType(codecMimeType)
     , _sampleRate(sampleRate)
+    , _buffersPool(buffersPool)
 {
     MS_ASSERT(_codecMimeType.IsMediaCodec(), "invalid media codec");
 }
 
+uint64_t RtpDepacketizer::GetAllocationsCount() const
+{
+    if (_buffersPool) {
+        return _allocations + _buffersPool->GetAllocationsCount();
+    }
+    return _allocations;
+}
+
+bool RtpDepacketizer::IsSupported(const RtpCodecMimeType& mimeType)
+{
+    switch (mimeType.GetType()) {
+        case RtpCodecMimeType::Type::AUDIO:
+            switch (mimeType.GetSubtype()) {
+                case RtpCodecMimeType::Subtype::MULTIOPUS:
+                case RtpCodecMimeType::Subtype::OPUS:
+                    return true;
+                default:
+                    break;
+            }
+            break;
+        case RtpCodecMimeType::Type::VIDEO:
+            switch (mimeType.GetSubtype()) {
+                case RtpCodecMimeType::Subtype::VP8:
+                case RtpCodecMimeType::Subtype::VP9:
+                    return true;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
 std::unique_ptr<RtpDepacketizer> RtpDepacketizer::create(const RtpCodecMimeType& mimeType,
-                                                         uint32_t sampleRate)
+                                                         uint32_t sampleRate,
+                                                         const std::shared_ptr<MemoryBufferPool>& buffersPool)
 {
     switch (mimeType.GetType()) {
         case RtpCodecMimeType::Type::AUDIO:
             switch (mimeType.GetSubtype()) {
                 case RtpCodecMimeType::Subtype::MULTIOPUS:
                 case RtpCodecMimeType::Subtype::OPUS:
-                    return std::make_unique<RtpDepacketizerOpus>(mimeType, sampleRate);
+                    return std::make_unique<RtpDepacketizerOpus>(mimeType, sampleRate, buffersPool);
                 default:
                     break;
             }
@@ -31,7 +71,7 @@ std::unique_ptr<RtpDepacketizer> RtpDepacketizer::create(const RtpCodecMimeType&
             switch (mimeType.GetSubtype()) {
                 case RtpCodecMimeType::Subtype::VP8:
                 case RtpCodecMimeType::Subtype::VP9:
-                    return std::make_unique<RtpDepacketizerVpx>(mimeType, sampleRate);
+                    return std::make_unique<RtpDepacketizerVpx>(mimeType, sampleRate, buffersPool);
                 default:
                     break;
             }
@@ -42,4 +82,27 @@ std::unique_ptr<RtpDepacketizer> RtpDepacketizer::create(const RtpCodecMimeType&
     return nullptr;
 }
 
+std::shared_ptr<SimpleMemoryBuffer> RtpDepacketizer::AllocatePayload(size_t capacity)
+{
+    if (_buffersPool) {
+        return _buffersPool->Allocate(capacity);
+    }
+    auto buffer = std::make_shared<SimpleMemoryBuffer>();
+    buffer->Reserve(capacity);
+    IncrementAllocationsCount();
+    return buffer;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpDepacketizer::CopyPayload(const uint8_t* data, size_t len)
+{
+    if (data && len) {
+        if (_buffersPool) {
+            return _buffersPool->Allocate(data, len);
+        }
+        IncrementAllocationsCount();
+        return SimpleMemoryBuffer::Create(data, len);
+    }
+    return nullptr;
+}
+
 } // namespace RTC
@@ -1,12 +1,12 @@
 #define MS_CLASS "RTC::RtpDepacketizerOpus"
 #include "RTC/MediaTranslate/RtpDepacketizerOpus.hpp"
 #include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
 #include "RTC/MediaTranslate/TranslatorUtils.hpp"
 #include "RTC/Codecs/Opus.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "MemoryBuffer.hpp"
 #include "Logger.hpp"
-#include <absl/container/flat_hash_map.h>
 
 namespace RTC
 {
@@ -24,8 +24,9 @@ private:
 };
 
 RtpDepacketizerOpus::RtpDepacketizerOpus(const RtpCodecMimeType& codecMimeType,
-                                         uint32_t sampleRate)
-    : RtpDepacketizer(codecMimeType, sampleRate)
+                                         uint32_t sampleRate,
+                                         const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : RtpDepacketizer(codecMimeType, sampleRate, buffersPool)
 {
 }
 
@@ -34,17 +35,39 @@ std::shared_ptr<RtpMediaFrame> RtpDepacketizerOpus::AddPacket(const RtpPacket* p
     if (packet && packet->GetPayload()) {
         bool stereo = false;
         Codecs::Opus::ParseTOC(packet->GetPayload()[0], nullptr, nullptr, nullptr, &stereo);
-        RtpAudioFrameConfig config;
-        config._channelCount = stereo ? 2U : 1U;
-        config._bitsPerSample = 16U;
-        config._codecSpecificData = std::make_unique<OpusHeadBuffer>(config._channelCount,
-                                                                     GetSampleRate());
-        return RtpMediaFrame::CreateAudio(packet, GetCodecMimeType().GetSubtype(),
-                                          GetSampleRate(), std::move(config));
+        const uint8_t channelCount = stereo ? 2U : 1U;
+        if (const auto payload = CopyPayload(packet->GetPayload(), packet->GetPayloadLength())) {
+            // frame is not retained by serializer or output devices
+            if (_frame && 1L == _frame.use_count() &&
+                channelCount == _frame->GetAudioConfig()->_channelCount) {
+                _frame->Reset(packet, payload);
+            }
+            else {
+                RtpAudioFrameConfig config;
+                config._channelCount = channelCount;
+                config._bitsPerSample = 16U;
+                config._codecSpecificData = GetOpusHead(channelCount);
+                _frame = RtpMediaFrame::CreateAudio(packet, payload,
+                                                    GetCodecMimeType().GetSubtype(),
+                                                    GetSampleRate(), std::move(config));
+                IncrementAllocationsCount();
+            }
+            return _frame;
+        }
     }
     return nullptr;
 }
 
+const std::shared_ptr<const MemoryBuffer>& RtpDepacketizerOpus::GetOpusHead(uint8_t channelCount)
+{
+    if (!_opusHead || channelCount != _opusHeadChannelCount) {
+        _opusHead = std::make_shared<OpusHeadBuffer>(channelCount, GetSampleRate());
+        _opusHeadChannelCount = channelCount;
+        IncrementAllocationsCount();
+    }
+    return _opusHead;
+}
+
 RtpDepacketizerOpus::OpusHeadBuffer::OpusHeadBuffer(uint8_t channelCount, uint32_t sampleRate)
     : _head(channelCount, sampleRate)
 {
@@ -7,7 +7,11 @@
 #include "RTC/Codecs/VP9.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "Logger.hpp"
+#include "RTC/SeqManager.hpp"
+#include "Logger.hpp"
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -20,6 +24,30 @@ inline std::optional<size_t> GetPayloadDescriptorSize(const RTC::RtpPacket* pack
     return std::nullopt;
 }
 
+// MSB first, for uncompressed header of VP9
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t len) : _data(data), _len(len) {}
+    bool Read(size_t bits, uint32_t& value);
+private:
+    const uint8_t* const _data;
+    const size_t _len;
+    size_t _position = 0UL;
+};
+
+bool BitReader::Read(size_t bits, uint32_t& value)
+{
+    if (_position + bits > _len * 8UL) {
+        return false;
+    }
+    value = 0U;
+    for (size_t i = 0UL; i < bits; ++i, ++_position) {
+        value = (value << 1) | ((_data[_position >> 3] >> (7U - (_position & 7U))) & 1U);
+    }
+    return true;
+}
+
 }
 
 namespace RTC
@@ -27,24 +55,77 @@ namespace RTC
 
 class RtpDepacketizerVpx::RtpAssembly
 {
+    struct Slot;
 public:
-    RtpAssembly(const RtpDepacketizerVpx* owner);
-    std::shared_ptr<RtpMediaFrame> AddPacket(const RtpPacket* packet);
+    RtpAssembly(RtpDepacketizerVpx* owner, uint32_t ssrc);
+    ~RtpAssembly();
+    void AddPacket(const RtpPacket* packet);
+    // the next complete & decodable frame from the head of window
+    std::shared_ptr<RtpMediaFrame> NextFrame();
 private:
     static bool ParseVp8VideoConfig(const RtpPacket* packet,
                                     RtpVideoFrameConfig& videoConfig);
     static bool ParseVp9VideoConfig(const RtpPacket* packet,
                                     RtpVideoFrameConfig& videoConfig);
-    bool AddPayload(const RtpPacket* packet);
+    bool ParseVideoConfig(const RtpPacket* packet, RtpVideoFrameConfig& videoConfig) const;
+    // [descriptor] is the 1st byte of payload descriptor
+    bool IsFrameStart(uint8_t descriptor) const;
+    Slot& GetSlot(uint16_t seq) { return _slots[seq % _windowSize]; }
+    const Slot& GetSlot(uint16_t seq) const { return _slots[seq % _windowSize]; }
+    bool HasPendingPackets() const;
+    // number of packets of complete frame which starts at [seq], zero if frame is not complete
+    uint16_t GetFrameLength(uint16_t seq) const;
+    std::optional<uint16_t> FindKeyFrame() const;
+    // head of window is lost or awaited longer than reordering is tolerated
+    bool IsHeadLost() const;
+    // drops packets of broken frame at head of window
+    void SkipHead();
+    void SkipTo(uint16_t seq);
+    void Reset(uint16_t seq);
+    std::shared_ptr<RtpMediaFrame> Assemble(uint16_t length);
+    void RequestKeyFrame(uint32_t timestamp);
+    uint32_t ToRtpClock(uint32_t ms) const { return ms * (_owner->GetSampleRate() / 1000U); }
 private:
-    const RtpDepacketizerVpx* const _owner;
-    SimpleMemoryBuffer _payload;
-    uint32_t _lastTimeStamp = 0U;
+    // ~300 Kb of payload, enough for key frame of 1080p
+    static inline constexpr uint16_t _windowSize = 256U;
+    // missing packets are awaited for this time of RTP clock, then they are lost
+    static inline constexpr uint32_t _maxReorderDelayMs = 100U;
+    static inline constexpr uint32_t _keyFrameRequestIntervalMs = 1000U;
+    RtpDepacketizerVpx* const _owner;
+    const uint32_t _ssrc;
+    // indexed by sequence number, payload capacity is kept between packets
+    std::vector<Slot> _slots;
+    // first packet which is not consumed yet
+    std::optional<uint16_t> _headSeq;
+    uint16_t _highestSeq = 0U;
+    uint32_t _highestTimestamp = 0U;
+    // frame of the last consumed packet
+    std::optional<uint32_t> _lastTimestamp;
+    // delta frames are dropped until the next key frame
+    bool _decodable = false;
+    std::optional<uint32_t> _lastKeyFrameRequestTimestamp;
+    // start of the last received key frame
+    std::optional<uint16_t> _keyFrameSeq;
+};
+
+struct RtpDepacketizerVpx::RtpAssembly::Slot
+{
+    bool _used = false;
+    uint16_t _seq = 0U;
+    uint32_t _timestamp = 0U;
+    bool _start = false;
+    bool _marker = false;
+    // start of key frame with valid config
+    bool _keyFrame = false;
+    RtpVideoFrameConfig _config;
+    // without payload descriptor
+    std::vector<uint8_t> _payload;
 };
 
 
-RtpDepacketizerVpx::RtpDepacketizerVpx(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate)
-    : RtpDepacketizer(codecMimeType, sampleRate)
+RtpDepacketizerVpx::RtpDepacketizerVpx(const RtpCodecMimeType& codecMimeType, uint32_t sampleRate,
+                                       const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : RtpDepacketizer(codecMimeType, sampleRate, buffersPool)
 {
 }
 
@@ -57,70 +138,305 @@ std::shared_ptr<RtpMediaFrame> RtpDepacketizerVpx::AddPacket(const RtpPacket* pa
     if (packet && packet->GetPayload() && packet->GetPayloadLength()) {
         auto it = _assemblies.find(packet->GetSsrc());
         if (it == _assemblies.end()) {
-            auto assembly = std::make_unique<RtpAssembly>(this);
+            auto assembly = std::make_unique<RtpAssembly>(this, packet->GetSsrc());
             it = _assemblies.insert({packet->GetSsrc(), std::move(assembly)}).first;
         }
-        return it->second->AddPacket(packet);
+        _lastAssembly = it->second.get();
+        _lastAssembly->AddPacket(packet);
+        return _lastAssembly->NextFrame();
     }
     return nullptr;
 }
 
-RtpDepacketizerVpx::RtpAssembly::RtpAssembly(const RtpDepacketizerVpx* owner)
+std::shared_ptr<RtpMediaFrame> RtpDepacketizerVpx::NextFrame()
+{
+    return _lastAssembly ? _lastAssembly->NextFrame() : nullptr;
+}
+
+bool RtpDepacketizerVpx::TakeKeyFrameRequest()
+{
+    return std::exchange(_keyFrameRequested, false);
+}
+
+RtpDepacketizerVpx::RtpAssembly::RtpAssembly(RtpDepacketizerVpx* owner, uint32_t ssrc)
     : _owner(owner)
+    , _ssrc(ssrc)
+    , _slots(_windowSize)
 {
 }
 
-std::shared_ptr<RtpMediaFrame> RtpDepacketizerVpx::RtpAssembly::AddPacket(const RtpPacket* packet)
+RtpDepacketizerVpx::RtpAssembly::~RtpAssembly()
 {
-    if (packet && packet->GetPayload() && packet->GetPayloadLength()) {
-        const auto& mime = _owner->GetCodecMimeType();
-        if (_lastTimeStamp != packet->GetTimestamp()) {
-            _lastTimeStamp = packet->GetTimestamp();
-            _payload.Resize(0U);
-        }
-        // Add payload
-        if (AddPayload(packet)) {
-            RtpVideoFrameConfig videoConfig;
-            bool ok = true;
-            if (packet->IsKeyFrame()) {
-                switch (mime.GetSubtype()) {
-                    case RtpCodecMimeType::Subtype::VP8:
-                        ok = ParseVp8VideoConfig(packet, videoConfig);
-                        break;
-                    case RtpCodecMimeType::Subtype::VP9:
-                        ok = ParseVp9VideoConfig(packet, videoConfig);
-                        break;
-                    default:
-                        break;
-                }
-            }
-            if (ok) {
-                if (packet->HasMarker()) {
-                    if (const auto payload = _payload.Take()) {
-                        return RtpMediaFrame::CreateVideo(packet, payload,
-                                                          mime.GetSubtype(),
-                                                          _owner->GetSampleRate(),
-                                                          std::move(videoConfig));
-                    }
-                    else {
-                        const auto error = GetStreamInfoString(mime, packet->GetSsrc());
-                        MS_ERROR("failed to take assembled payload for stream [%s]", error.c_str());
-                    }
-                }
+}
+
+void RtpDepacketizerVpx::RtpAssembly::AddPacket(const RtpPacket* packet)
+{
+    const auto pds = GetPayloadDescriptorSize(packet);
+    if (!pds || !pds.value() || packet->GetPayloadLength() < pds.value()) {
+        const auto error = GetStreamInfoString(_owner->GetCodecMimeType(), _ssrc);
+        MS_ERROR("failed to add payload for stream [%s]", error.c_str());
+        return;
+    }
+    const auto seq = packet->GetSequenceNumber();
+    if (!_headSeq) {
+        Reset(seq);
+    }
+    else {
+        const uint16_t ahead = seq - _headSeq.value();
+        if (ahead >= _windowSize) {
+            const uint16_t behind = _headSeq.value() - seq;
+            if (behind <= _windowSize) {
+                // too late, frame was already consumed or dropped
+                return;
             }
-            else {
-                const auto error = GetStreamInfoString(mime, packet->GetSsrc());
-                MS_ERROR("failed to parse video config for stream [%s]", error.c_str());
+            // big gap or restart of sequence numbering
+            Reset(seq);
+        }
+    }
+    auto& slot = GetSlot(seq);
+    if (slot._used) {
+        // duplicate
+        return;
+    }
+    if (seq == _highestSeq || RTC::SeqManager<uint16_t>::IsSeqHigherThan(seq, _highestSeq)) {
+        _highestSeq = seq;
+        _highestTimestamp = packet->GetTimestamp();
+    }
+    const auto payload = packet->GetPayload();
+    slot._used = true;
+    slot._seq = seq;
+    slot._timestamp = packet->GetTimestamp();
+    slot._start = IsFrameStart(payload[0]);
+    slot._marker = packet->HasMarker();
+    slot._keyFrame = false;
+    if (slot._start && packet->IsKeyFrame()) {
+        slot._keyFrame = ParseVideoConfig(packet, slot._config);
+        if (slot._keyFrame) {
+            _keyFrameSeq = seq;
+        }
+        else {
+            const auto error = GetStreamInfoString(_owner->GetCodecMimeType(), _ssrc);
+            MS_ERROR("failed to parse video config for stream [%s]", error.c_str());
+        }
+    }
+    slot._payload.assign(payload + pds.value(), payload + packet->GetPayloadLength());
+}
+
+std::shared_ptr<RtpMediaFrame> RtpDepacketizerVpx::RtpAssembly::NextFrame()
+{
+    while (HasPendingPackets()) {
+        if (const auto length = GetFrameLength(_headSeq.value())) {
+            if (auto frame = Assemble(length)) {
+                return frame;
             }
         }
+        else if (const auto keyFrame = FindKeyFrame()) {
+            // nothing before the key frame is needed
+            SkipTo(keyFrame.value());
+        }
+        else if (IsHeadLost()) {
+            SkipHead();
+        }
         else {
-            const auto error = GetStreamInfoString(mime, packet->GetSsrc());
-            MS_ERROR("failed to add payload for stream [%s]", error.c_str());
+            // wait for reordered packets
+            break;
         }
     }
     return nullptr;
 }
 
+bool RtpDepacketizerVpx::RtpAssembly::ParseVideoConfig(const RtpPacket* packet,
+                                                       RtpVideoFrameConfig& videoConfig) const
+{
+    switch (_owner->GetCodecMimeType().GetSubtype()) {
+        case RtpCodecMimeType::Subtype::VP8:
+            return ParseVp8VideoConfig(packet, videoConfig);
+        case RtpCodecMimeType::Subtype::VP9:
+            return ParseVp9VideoConfig(packet, videoConfig);
+        default:
+            break;
+    }
+    return false;
+}
+
+bool RtpDepacketizerVpx::RtpAssembly::IsFrameStart(uint8_t descriptor) const
+{
+    switch (_owner->GetCodecMimeType().GetSubtype()) {
+        case RtpCodecMimeType::Subtype::VP8:
+            // S bit & partition index 0
+            return 0x10 == (descriptor & 0x17);
+        case RtpCodecMimeType::Subtype::VP9:
+            // B bit, start of (layer) frame
+            return 0x08 == (descriptor & 0x08);
+        default:
+            break;
+    }
+    return false;
+}
+
+bool RtpDepacketizerVpx::RtpAssembly::HasPendingPackets() const
+{
+    return _headSeq && static_cast<uint16_t>(_highestSeq - _headSeq.value()) < _windowSize;
+}
+
+uint16_t RtpDepacketizerVpx::RtpAssembly::GetFrameLength(uint16_t seq) const
+{
+    const auto& first = GetSlot(seq);
+    // the start of layer frame which follows the 1st layer of VP9 isn't a frame start
+    if (first._used && first._seq == seq && first._start && first._timestamp != _lastTimestamp) {
+        for (uint16_t length = 1U; length <= _windowSize; ++length, ++seq) {
+            const auto& slot = GetSlot(seq);
+            if (!slot._used || slot._seq != seq) {
+                break;
+            }
+            if (slot._timestamp != first._timestamp) {
+                // marker was not set, the next frame has already started
+                return slot._start ? length - 1U : 0U;
+            }
+            if (slot._marker) {
+                return length;
+            }
+        }
+    }
+    return 0U;
+}
+
+std::optional<uint16_t> RtpDepacketizerVpx::RtpAssembly::FindKeyFrame() const
+{
+    if (_keyFrameSeq) {
+        const uint16_t ahead = _keyFrameSeq.value() - _headSeq.value();
+        if (ahead && ahead < _windowSize && GetFrameLength(_keyFrameSeq.value())) {
+            return _keyFrameSeq;
+        }
+    }
+    return std::nullopt;
+}
+
+bool RtpDepacketizerVpx::RtpAssembly::IsHeadLost() const
+{
+    const auto& slot = GetSlot(_headSeq.value());
+    if (slot._used) {
+        // packets before head are not accepted anymore, so start of this frame is lost
+        if (!slot._start || slot._timestamp == _lastTimestamp) {
+            return true;
+        }
+        return static_cast<int32_t>(_highestTimestamp - slot._timestamp) > static_cast<int32_t>(ToRtpClock(_maxReorderDelayMs));
+    }
+    if (_lastTimestamp) {
+        return static_cast<int32_t>(_highestTimestamp - _lastTimestamp.value()) > static_cast<int32_t>(ToRtpClock(_maxReorderDelayMs));
+    }
+    return true;
+}
+
+void RtpDepacketizerVpx::RtpAssembly::SkipHead()
+{
+    auto seq = _headSeq.value();
+    const auto& head = GetSlot(seq);
+    const auto broken = head._used ? std::optional<uint32_t>(head._timestamp) : _lastTimestamp;
+    do {
+        ++seq;
+        const auto& slot = GetSlot(seq);
+        if (slot._used && slot._start && slot._timestamp != broken) {
+            break;
+        }
+    }
+    while (seq != static_cast<uint16_t>(_highestSeq + 1U));
+    SkipTo(seq);
+}
+
+void RtpDepacketizerVpx::RtpAssembly::SkipTo(uint16_t seq)
+{
+    uint64_t frames = 0ULL;
+    bool dropped = false;
+    for (auto head = _headSeq.value(); head != seq; ++head) {
+        auto& slot = GetSlot(head);
+        if (slot._used) {
+            if (slot._timestamp != _lastTimestamp) {
+                _lastTimestamp = slot._timestamp;
+                ++frames;
+            }
+            slot._used = false;
+            dropped = true;
+        }
+    }
+    if (!dropped) {
+        // entirely lost frame
+        frames = 1ULL;
+    }
+    _owner->_incompleteFrames += frames;
+    _headSeq = seq;
+    _decodable = false;
+}
+
+void RtpDepacketizerVpx::RtpAssembly::Reset(uint16_t seq)
+{
+    bool pending = false;
+    for (auto& slot : _slots) {
+        pending = pending || slot._used;
+        slot._used = false;
+    }
+    if (pending) {
+        ++_owner->_incompleteFrames;
+    }
+    _headSeq = _highestSeq = seq;
+    _lastTimestamp.reset();
+    _keyFrameSeq.reset();
+    _decodable = false;
+}
+
+std::shared_ptr<RtpMediaFrame> RtpDepacketizerVpx::RtpAssembly::Assemble(uint16_t length)
+{
+    const auto head = _headSeq.value();
+    auto& first = GetSlot(head);
+    const auto timestamp = first._timestamp;
+    const auto keyFrame = first._keyFrame;
+    std::shared_ptr<RtpMediaFrame> frame;
+    if (keyFrame) {
+        _decodable = true;
+        _lastKeyFrameRequestTimestamp.reset();
+    }
+    if (_decodable) {
+        size_t size = 0UL;
+        for (uint16_t i = 0U; i < length; ++i) {
+            size += GetSlot(head + i)._payload.size();
+        }
+        if (size) {
+            const auto payload = _owner->AllocatePayload(size);
+            for (uint16_t i = 0U; i < length; ++i) {
+                const auto& data = GetSlot(head + i)._payload;
+                payload->Append(data.data(), data.size());
+            }
+            _owner->IncrementAllocationsCount();
+            frame = RtpMediaFrame::CreateVideo(payload, _owner->GetCodecMimeType().GetSubtype(),
+                                               keyFrame, timestamp, _ssrc,
+                                               static_cast<uint16_t>(head + length - 1U),
+                                               _owner->GetSampleRate(),
+                                               keyFrame ? std::move(first._config) : RtpVideoFrameConfig());
+        }
+    }
+    if (!frame) {
+        ++_owner->_undecodableFrames;
+        if (!_decodable) {
+            RequestKeyFrame(timestamp);
+        }
+    }
+    for (uint16_t i = 0U; i < length; ++i) {
+        GetSlot(head + i)._used = false;
+    }
+    _headSeq = static_cast<uint16_t>(head + length);
+    _lastTimestamp = timestamp;
+    return frame;
+}
+
+void RtpDepacketizerVpx::RtpAssembly::RequestKeyFrame(uint32_t timestamp)
+{
+    if (!_lastKeyFrameRequestTimestamp ||
+        static_cast<int32_t>(timestamp - _lastKeyFrameRequestTimestamp.value()) >= static_cast<int32_t>(ToRtpClock(_keyFrameRequestIntervalMs))) {
+        _lastKeyFrameRequestTimestamp = timestamp;
+        _owner->_keyFrameRequested = true;
+    }
+}
+
 bool RtpDepacketizerVpx::RtpAssembly::ParseVp8VideoConfig(const RtpPacket* packet,
                                                           RtpVideoFrameConfig& videoConfig)
 {
@@ -163,26 +479,49 @@ bool RtpDepacketizerVpx::RtpAssembly::ParseVp9VideoConfig(const RtpPacket* packe
 {
     if (const auto pds = GetPayloadDescriptorSize(packet)) {
         if (const auto payload = packet->GetPayload()) {
-            //const auto offset = pds.value();
-            /*vp9_parser::Vp9HeaderParser parser;
-            if (parser.ParseUncompressedHeader(payload, packet->GetPayloadLength())) {
-                videoConfig._width = parser.width();
-                videoConfig._height = parser.height();
-                return true;
-            }*/
-        }
-    }
-    return false;
-}
-
-bool RtpDepacketizerVpx::RtpAssembly::AddPayload(const RtpPacket* packet)
-{
-    if (const auto pds = GetPayloadDescriptorSize(packet)) {
-        if (const auto payload = packet->GetPayload()) {
+            const auto offset = pds.value();
             const auto len = packet->GetPayloadLength();
-            if (len > pds.value()) {
-                const auto data = packet->GetPayload() + pds.value();
-                return _payload.Append(data, len - pds.value());
+            if (len > offset) {
+                // uncompressed header of key frame, see section 6.2 of VP9 bitstream specification
+                BitReader reader(payload + offset, len - offset);
+                uint32_t marker = 0U, profileLow = 0U, profileHigh = 0U, reserved = 0U;
+                uint32_t showExisting = 0U, frameType = 0U, flags = 0U, syncCode = 0U;
+                if (!reader.Read(2U, marker) || 2U != marker ||
+                    !reader.Read(1U, profileLow) || !reader.Read(1U, profileHigh)) {
+                    return false;
+                }
+                const auto profile = (profileHigh << 1) | profileLow;
+                if (3U == profile && !reader.Read(1U, reserved)) {
+                    return false;
+                }
+                // show_frame & error_resilient_mode are skipped
+                if (!reader.Read(1U, showExisting) || showExisting ||
+                    !reader.Read(1U, frameType) || frameType ||
+                    !reader.Read(2U, flags) ||
+                    !reader.Read(24U, syncCode) || 0x498342 != syncCode) {
+                    return false;
+                }
+                // color config
+                uint32_t bitDepth = 0U, colorSpace = 0U, colorRange = 0U, subsampling = 0U;
+                if ((profile >= 2U && !reader.Read(1U, bitDepth)) || !reader.Read(3U, colorSpace)) {
+                    return false;
+                }
+                const bool extended = 1U == profile || 3U == profile;
+                // not RGB
+                if (7U != colorSpace) {
+                    if (!reader.Read(1U, colorRange) || (extended && !reader.Read(3U, subsampling))) {
+                        return false;
+                    }
+                }
+                else if (extended && !reader.Read(1U, reserved)) {
+                    return false;
+                }
+                uint32_t width = 0U, height = 0U;
+                if (reader.Read(16U, width) && reader.Read(16U, height)) {
+                    videoConfig._width = static_cast<int32_t>(width + 1U);
+                    videoConfig._height = static_cast<int32_t>(height + 1U);
+                    return true;
+                }
             }
         }
     }
@@ -1,7 +1,6 @@
 #define MS_CLASS "RTC::RtpMediaFrame"
 #include "RTC/MediaTranslate/RtpMediaFrame.hpp"
 #include "RTC/MediaTranslate/TranslatorUtils.hpp"
-#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "Logger.hpp"
 
@@ -53,19 +52,6 @@ RtpMediaFrame::RtpMediaFrame(const RtpCodecMimeType& codecMimeType,
     MS_ASSERT(_sampleRate, "sample rate must be greater than zero");
 }
 
-std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateAudio(const RtpPacket* packet,
-                                                          RtpCodecMimeType::Subtype codecType,
-                                                          uint32_t sampleRate,
-                                                          RtpAudioFrameConfig audioConfig,
-                                                          const std::allocator<uint8_t>& payloadAllocator)
-{
-    if (packet) {
-        const auto payload = CreatePayload(packet, payloadAllocator);
-        return CreateAudio(packet, payload, codecType, sampleRate, std::move(audioConfig));
-    }
-    return nullptr;
-}
-
 std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateAudio(const RtpPacket* packet,
                                                           const std::shared_ptr<const MemoryBuffer>& payload,
                                                           RtpCodecMimeType::Subtype codecType,
@@ -84,47 +70,51 @@ std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateAudio(const RtpPacket* packe
 }
 
 std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateVideo(const RtpPacket* packet,
+                                                          const std::shared_ptr<const MemoryBuffer>& payload,
                                                           RtpCodecMimeType::Subtype codecType,
                                                           uint32_t sampleRate,
-                                                          RtpVideoFrameConfig videoConfig,
-                                                          const std::allocator<uint8_t>& payloadAllocator)
+                                                          RtpVideoFrameConfig videoConfig)
 {
     if (packet) {
-        const auto payload = CreatePayload(packet, payloadAllocator);
-        return CreateVideo(packet, payload, codecType, sampleRate, std::move(videoConfig));
+        return CreateVideo(payload, codecType, packet->IsKeyFrame(), packet->GetTimestamp(),
+                           packet->GetSsrc(), packet->GetSequenceNumber(), sampleRate,
+                           std::move(videoConfig));
     }
     return nullptr;
 }
 
-std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateVideo(const RtpPacket* packet,
-                                                          const std::shared_ptr<const MemoryBuffer>& payload,
+std::shared_ptr<RtpMediaFrame> RtpMediaFrame::CreateVideo(const std::shared_ptr<const MemoryBuffer>& payload,
                                                           RtpCodecMimeType::Subtype codecType,
+                                                          bool isKeyFrame, uint32_t timestamp,
+                                                          uint32_t ssrc, uint16_t sequenceNumber,
                                                           uint32_t sampleRate,
                                                           RtpVideoFrameConfig videoConfig)
 {
-    if (packet && payload) {
+    if (payload) {
         const RtpCodecMimeType codecMimeType(RtpCodecMimeType::Type::VIDEO, codecType);
         MS_ASSERT(codecMimeType.IsVideoCodec(), "is not video codec");
-        return std::make_shared<RtpVideoFrame>(codecMimeType, payload, packet->IsKeyFrame(),
-                                               packet->GetTimestamp(), packet->GetSsrc(),
-                                               packet->GetSequenceNumber(), sampleRate,
+        return std::make_shared<RtpVideoFrame>(codecMimeType, payload, isKeyFrame, timestamp,
+                                               ssrc, sequenceNumber, sampleRate,
                                                std::move(videoConfig));
     }
     return nullptr;
 }
 
-bool RtpMediaFrame::IsAudio() const
+void RtpMediaFrame::Reset(const RtpPacket* packet, const std::shared_ptr<const MemoryBuffer>& payload)
 {
-    return _codecMimeType.IsAudioCodec();
+    MS_ASSERT(packet, "packet must not be null");
+    MS_ASSERT(payload && !payload->IsEmpty(), "wrong payload");
+    _payload = payload;
+    _isKeyFrame = packet->IsKeyFrame();
+    _timestamp = packet->GetTimestamp();
+    _ssrc = packet->GetSsrc();
+    _sequenceNumber = packet->GetSequenceNumber();
+    _absSendtime = 0U;
 }
 
-std::shared_ptr<const MemoryBuffer> RtpMediaFrame::CreatePayload(const RtpPacket* packet,
-                                                                 const std::allocator<uint8_t>& payloadAllocator)
+bool RtpMediaFrame::IsAudio() const
 {
-    if (packet) {
-        return SimpleMemoryBuffer::Create(packet->GetPayload(), packet->GetPayloadLength(), payloadAllocator);
-    }
-    return nullptr;
+    return _codecMimeType.IsAudioCodec();
 }
 
 RtpMediaFrame::RtpAudioFrame::RtpAudioFrame(const RtpCodecMimeType& codecMimeType,
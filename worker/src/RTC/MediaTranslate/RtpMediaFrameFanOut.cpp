@@ -0,0 +1,91 @@
+#define MS_CLASS "RTC::RtpMediaFrameFanOut"
+#include "RTC/MediaTranslate/RtpMediaFrameFanOut.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "Logger.hpp"
+
+namespace RTC
+{
+
+RtpMediaFrameFanOut::RtpMediaFrameFanOut(const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : _buffersPool(buffersPool)
+{
+}
+
+RtpMediaFrameFanOut::~RtpMediaFrameFanOut()
+{
+    Reset();
+}
+
+void RtpMediaFrameFanOut::Update(const RtpCodecMimeType& mime, const Outputs& outputs)
+{
+    if (_mime != mime) {
+        // finalize media of the previous codec, devices start the new stream
+        Reset();
+        _mime = mime;
+    }
+    for (auto it = _serializers.begin(); it != _serializers.end();) {
+        const auto output = outputs.find(it->first);
+        if (output == outputs.end() || output->second._format != it->second._format ||
+            output->second._liveMode != it->second._liveMode) {
+            Finalize(it->second);
+            _serializers.erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+    for (auto it = outputs.begin(); it != outputs.end(); ++it) {
+        if (it->second._device && !_serializers.contains(it->first)) {
+            SerializerInfo info;
+            info._device = it->second._device;
+            info._format = it->second._format;
+            info._liveMode = it->second._liveMode;
+            info._serializer = RtpMediaFrameSerializer::create(mime, info._format, _buffersPool);
+            if (info._serializer) {
+                info._serializer->SetLiveMode(info._liveMode);
+                info._serializer->SetOutputDevice(info._device.get());
+            }
+            else {
+                MS_WARN_DEV("format %s doesn't support codec %s",
+                            MediaFrameFormatToString(info._format).data(), mime.ToString().c_str());
+            }
+            _serializers.emplace(it->first, std::move(info));
+        }
+    }
+}
+
+void RtpMediaFrameFanOut::Reset()
+{
+    for (auto it = _serializers.begin(); it != _serializers.end(); ++it) {
+        Finalize(it->second);
+    }
+    _serializers.clear();
+    _mime.reset();
+}
+
+bool RtpMediaFrameFanOut::Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame)
+{
+    bool pushed = false;
+    if (mediaFrame) {
+        for (auto it = _serializers.begin(); it != _serializers.end(); ++it) {
+            if (const auto& serializer = it->second._serializer) {
+                serializer->Push(mediaFrame);
+                pushed = true;
+            }
+        }
+    }
+    return pushed;
+}
+
+void RtpMediaFrameFanOut::Finalize(SerializerInfo& info)
+{
+    if (info._serializer) {
+        // trailing data is written into the device which is still alive here
+        info._serializer->SetOutputDevice(nullptr);
+        info._serializer.reset();
+    }
+}
+
+} // namespace RTC
@@ -1,5 +1,7 @@
 #define MS_CLASS "RTC::RtpMediaFrameSerializer"
 #include "RTC/MediaTranslate/RtpWebMSerializer.hpp"
+#include "RTC/MediaTranslate/RtpRawFrameSerializer.hpp"
+#include "RTC/MediaTranslate/RtpOggOpusSerializer.hpp"
 #include "RTC/MediaTranslate/RtpMediaFrame.hpp"
 #include "RTC/MediaTranslate/TranslatorUtils.hpp"
 #include "RTC/RtpDictionaries.hpp"
@@ -18,10 +20,28 @@ std::string_view RtpMediaFrameSerializer::GetFileExtension(const RtpCodecMimeTyp
     return MimeSubTypeToString(mimeType.GetSubtype());
 }
 
-std::unique_ptr<RtpMediaFrameSerializer> RtpMediaFrameSerializer::create(const RtpCodecMimeType& mimeType)
+std::unique_ptr<RtpMediaFrameSerializer> RtpMediaFrameSerializer::create(const RtpCodecMimeType& mimeType,
+                                                                         MediaFrameFormat format,
+                                                                         const std::shared_ptr<MemoryBufferPool>& buffersPool)
 {
-    if (RtpWebMSerializer::IsSupported(mimeType)) {
-        return std::make_unique<RtpWebMSerializer>();
+    switch (format) {
+        case MediaFrameFormat::WebM:
+            if (RtpWebMSerializer::IsSupported(mimeType)) {
+                return std::make_unique<RtpWebMSerializer>();
+            }
+            break;
+        case MediaFrameFormat::Raw:
+            if (RtpRawFrameSerializer::IsSupported(mimeType)) {
+                return std::make_unique<RtpRawFrameSerializer>(buffersPool);
+            }
+            break;
+        case MediaFrameFormat::Ogg:
+            if (RtpOggOpusSerializer::IsSupported(mimeType)) {
+                return std::make_unique<RtpOggOpusSerializer>(buffersPool);
+            }
+            break;
+        default:
+            break;
     }
     return nullptr;
 }
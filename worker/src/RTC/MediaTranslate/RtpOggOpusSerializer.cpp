@@ -0,0 +1,344 @@
+#define MS_CLASS "RTC::RtpOggOpusSerializer"
+#include "RTC/MediaTranslate/RtpOggOpusSerializer.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/TranslatorUtils.hpp"
+#include "RTC/Codecs/Opus.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+// RFC 7845, section 5.1
+constexpr size_t OpusHeadSize = 19UL;
+constexpr uint32_t OpusSampleRate = 48000U;
+// 120 ms is the longest Opus packet
+constexpr uint32_t MaxPacketSamples = 5760U;
+constexpr uint32_t DefaultPacketSamples = 960U;
+constexpr std::string_view OpusHeadMagic = "OpusHead";
+constexpr std::string_view OpusTagsMagic = "OpusTags";
+constexpr std::string_view PageMagic = "OggS";
+constexpr std::string_view Vendor = "mediasoup";
+
+inline void SetLE4Bytes(uint8_t* data, size_t i, uint32_t value) {
+    for (size_t b = 0UL; b < sizeof(value); ++b) {
+        data[i + b] = static_cast<uint8_t>(value >> (8UL * b));
+    }
+}
+
+inline void SetLE8Bytes(uint8_t* data, size_t i, uint64_t value) {
+    for (size_t b = 0UL; b < sizeof(value); ++b) {
+        data[i + b] = static_cast<uint8_t>(value >> (8UL * b));
+    }
+}
+
+// CRC-32 of Ogg framing: polynomial 0x04c11db7, no reflection, zero initial & final values
+class OggCrc
+{
+public:
+    OggCrc();
+    uint32_t Calculate(const uint8_t* data, size_t len) const;
+private:
+    std::array<uint32_t, 256UL> _table;
+};
+
+OggCrc::OggCrc()
+{
+    for (uint32_t i = 0U; i < _table.size(); ++i) {
+        uint32_t r = i << 24;
+        for (int bit = 0; bit < 8; ++bit) {
+            r = (r & 0x80000000U) ? ((r << 1) ^ 0x04C11DB7U) : (r << 1);
+        }
+        _table[i] = r;
+    }
+}
+
+uint32_t OggCrc::Calculate(const uint8_t* data, size_t len) const
+{
+    uint32_t crc = 0U;
+    for (size_t i = 0UL; i < len; ++i) {
+        crc = (crc << 8) ^ _table[((crc >> 24) & 0xFFU) ^ data[i]];
+    }
+    return crc;
+}
+
+const OggCrc& GetOggCrc() {
+    static const OggCrc crc;
+    return crc;
+}
+
+// number of 48 kHz samples in Opus packet, RFC 6716 section 3.1
+uint32_t GetOpusPacketSamples(const uint8_t* data, size_t len) {
+    if (data && len) {
+        RTC::Codecs::Opus::FrameSize frameSize = RTC::Codecs::Opus::FrameSize::ms20;
+        RTC::Codecs::Opus::CodeNumber codeNumber = RTC::Codecs::Opus::CodeNumber::One;
+        RTC::Codecs::Opus::ParseTOC(data[0], nullptr, nullptr, &frameSize, nullptr, &codeNumber);
+        uint32_t framesCount = 0U;
+        switch (codeNumber) {
+            case RTC::Codecs::Opus::CodeNumber::One:
+                framesCount = 1U;
+                break;
+            case RTC::Codecs::Opus::CodeNumber::Two:
+            case RTC::Codecs::Opus::CodeNumber::Three:
+                framesCount = 2U;
+                break;
+            case RTC::Codecs::Opus::CodeNumber::Arbitrary:
+                if (len > 1UL) {
+                    framesCount = data[1] & 0x3F;
+                }
+                break;
+        }
+        const auto samples = framesCount * static_cast<uint32_t>(frameSize);
+        if (samples && samples <= MaxPacketSamples) {
+            return samples;
+        }
+    }
+    return 0U;
+}
+
+}
+
+namespace RTC
+{
+
+RtpOggOpusSerializer::RtpOggOpusSerializer(const std::shared_ptr<MemoryBufferPool>& buffersPool,
+                                           size_t packetsPerPage)
+    : _buffersPool(buffersPool ? buffersPool : std::make_shared<MemoryBufferPool>())
+    , _packetsPerPage(std::clamp(packetsPerPage, 1UL, MaxSegmentsPerPage))
+{
+}
+
+RtpOggOpusSerializer::~RtpOggOpusSerializer()
+{
+    RtpOggOpusSerializer::SetOutputDevice(nullptr);
+}
+
+bool RtpOggOpusSerializer::IsSupported(const RtpCodecMimeType& mimeType)
+{
+    // multistream Opus needs channel mapping family 1 in ID header, not supported yet
+    return RtpCodecMimeType::Subtype::OPUS == mimeType.GetSubtype();
+}
+
+void RtpOggOpusSerializer::SetOutputDevice(OutputDevice* outputDevice)
+{
+    if (outputDevice != GetOutputDevice()) {
+        if (const auto previous = GetOutputDevice()) {
+            Finalize(previous);
+        }
+        // the new output starts from ID & comment headers of the new logical stream
+        _headersWritten = false;
+        _serialNumber = _pageSequenceNumber = 0U;
+        _lastTimestamp.reset();
+        _position = _granulePosition = 0ULL;
+        _packets.clear();
+        _segments.clear();
+        _bodySize = 0UL;
+    }
+    RtpMediaFrameSerializer::SetOutputDevice(outputDevice);
+}
+
+void RtpOggOpusSerializer::SetLiveMode(bool liveMode)
+{
+    RtpMediaFrameSerializer::SetLiveMode(liveMode);
+    _liveMode = liveMode;
+}
+
+std::string_view RtpOggOpusSerializer::GetFileExtension(const RtpCodecMimeType&) const
+{
+    // RFC 7845, section 9
+    return "opus";
+}
+
+void RtpOggOpusSerializer::Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame)
+{
+    if (mediaFrame && mediaFrame->GetPayload()) {
+        if (const auto outputDevice = GetOutputDevice()) {
+            if (!IsSupported(mediaFrame->GetCodecMimeType())) {
+                const auto frameInfo = GetMediaFrameInfoString(mediaFrame);
+                MS_WARN_DEV("unsupported codec of media frame [%s]", frameInfo.c_str());
+                return;
+            }
+            if (!_headersWritten && !WriteHeaders(*mediaFrame, outputDevice)) {
+                return;
+            }
+            outputDevice->BeginWriteMediaPayload(mediaFrame->GetSsrc(),
+                                                 mediaFrame->IsKeyFrame(),
+                                                 mediaFrame->GetCodecMimeType(),
+                                                 mediaFrame->GetSequenceNumber(),
+                                                 mediaFrame->GetTimestamp(),
+                                                 mediaFrame->GetAbsSendtime());
+            const auto ok = AddPacket(*mediaFrame, outputDevice);
+            outputDevice->EndWriteMediaPayload(mediaFrame->GetSsrc(), ok);
+        }
+    }
+}
+
+bool RtpOggOpusSerializer::WriteHeaders(const RtpMediaFrame& mediaFrame, OutputDevice* outputDevice)
+{
+    _serialNumber = mediaFrame.GetSsrc();
+    const auto head = CreateOpusHead(mediaFrame);
+    const auto tags = CreateOpusTags();
+    if (head && tags && WritePage(head, PageFlags::FirstPage, outputDevice) &&
+        WritePage(tags, 0U, outputDevice)) {
+        _headersWritten = true;
+    }
+    return _headersWritten;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpOggOpusSerializer::CreateOpusHead(const RtpMediaFrame& mediaFrame) const
+{
+    if (const auto config = mediaFrame.GetAudioConfig()) {
+        // depacketizer provides ready ID header
+        if (const auto& data = config->_codecSpecificData) {
+            if (data->GetSize() >= OpusHeadSize &&
+                0 == std::memcmp(data->GetData(), OpusHeadMagic.data(), OpusHeadMagic.size())) {
+                return _buffersPool->Allocate(data->GetData(), data->GetSize());
+            }
+        }
+    }
+    std::array<uint8_t, OpusHeadSize> head = {};
+    std::memcpy(head.data(), OpusHeadMagic.data(), OpusHeadMagic.size());
+    head[8] = 1U; // version
+    if (const auto config = mediaFrame.GetAudioConfig()) {
+        head[9] = std::max<uint8_t>(1U, config->_channelCount);
+    }
+    else {
+        head[9] = 1U;
+    }
+    // zero pre-skip, output gain & mapping family
+    SetLE4Bytes(head.data(), 12UL, OpusSampleRate);
+    return _buffersPool->Allocate(head.data(), head.size());
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpOggOpusSerializer::CreateOpusTags() const
+{
+    // magic, vendor string & zero count of user comments
+    const auto size = OpusTagsMagic.size() + sizeof(uint32_t) + Vendor.size() + sizeof(uint32_t);
+    auto tags = _buffersPool->Allocate(size);
+    if (tags) {
+        std::array<uint8_t, sizeof(uint32_t)> length;
+        tags->Append(OpusTagsMagic.data(), OpusTagsMagic.size());
+        SetLE4Bytes(length.data(), 0UL, static_cast<uint32_t>(Vendor.size()));
+        tags->Append(length.data(), length.size());
+        tags->Append(Vendor.data(), Vendor.size());
+        SetLE4Bytes(length.data(), 0UL, 0U);
+        tags->Append(length.data(), length.size());
+    }
+    return tags;
+}
+
+bool RtpOggOpusSerializer::AddPacket(const RtpMediaFrame& mediaFrame, OutputDevice* outputDevice)
+{
+    const auto& payload = mediaFrame.GetPayload();
+    const auto payloadSize = payload->GetSize();
+    // 255 lacing values at most, a packet doesn't span pages here
+    if (!payloadSize || payloadSize / 255UL + 1UL > MaxSegmentsPerPage) {
+        MS_ERROR("invalid size of Opus packet, %zu bytes", payloadSize);
+        return false;
+    }
+    if (_segments.size() + payloadSize / 255UL + 1UL > MaxSegmentsPerPage) {
+        if (!WritePage(0U, outputDevice)) {
+            return false;
+        }
+    }
+    const auto timestamp = mediaFrame.GetTimestamp();
+    auto sampleRate = mediaFrame.GetSampleRate();
+    if (!sampleRate) {
+        sampleRate = OpusSampleRate;
+    }
+    uint32_t delta = 0U;
+    if (_lastTimestamp.has_value()) {
+        const auto diff = static_cast<int32_t>(timestamp - _lastTimestamp.value());
+        // reordered or repeated packets keep the position
+        if (diff > 0) {
+            delta = static_cast<uint32_t>(diff);
+            _position += delta;
+            _lastTimestamp = timestamp;
+        }
+    }
+    else {
+        _lastTimestamp = timestamp;
+    }
+    auto samples = GetOpusPacketSamples(payload->GetData(), payloadSize);
+    if (!samples) {
+        samples = delta ? static_cast<uint32_t>(uint64_t(delta) * OpusSampleRate / sampleRate) :
+            DefaultPacketSamples;
+        samples = std::min(samples, MaxPacketSamples);
+    }
+    // granule position is the end of the last packet on the page and never decreases
+    const auto granulePosition = _position * OpusSampleRate / sampleRate + samples;
+    _granulePosition = std::max(_granulePosition, granulePosition);
+    AddLacingValues(payloadSize, _segments);
+    _packets.push_back(payload);
+    _bodySize += payloadSize;
+    if (_packets.size() >= GetPacketsPerPage()) {
+        return WritePage(0U, outputDevice);
+    }
+    return true;
+}
+
+bool RtpOggOpusSerializer::WritePage(uint8_t flags, OutputDevice* outputDevice)
+{
+    if (_segments.empty() && !(flags & PageFlags::LastPage)) {
+        return true;
+    }
+    const auto segmentsCount = _segments.size();
+    auto page = _buffersPool->Allocate(PageHeaderSize + segmentsCount + _bodySize);
+    if (!page) {
+        return false;
+    }
+    std::array<uint8_t, PageHeaderSize> header = {};
+    std::memcpy(header.data(), PageMagic.data(), PageMagic.size());
+    header[5] = flags;
+    SetLE8Bytes(header.data(), 6UL, _granulePosition);
+    SetLE4Bytes(header.data(), 14UL, _serialNumber);
+    SetLE4Bytes(header.data(), 18UL, _pageSequenceNumber++);
+    // CRC is calculated with zeroed field below
+    header[26] = static_cast<uint8_t>(segmentsCount);
+    page->Append(header.data(), header.size());
+    page->Append(_segments.data(), segmentsCount);
+    for (const auto& packet : _packets) {
+        page->Append(packet->GetData(), packet->GetSize());
+    }
+    SetLE4Bytes(page->GetData(), 22UL, GetOggCrc().Calculate(page->GetData(), page->GetSize()));
+    _packets.clear();
+    _segments.clear();
+    _bodySize = 0UL;
+    outputDevice->Write(page);
+    return true;
+}
+
+bool RtpOggOpusSerializer::WritePage(const std::shared_ptr<const MemoryBuffer>& packet, uint8_t flags,
+                                     OutputDevice* outputDevice)
+{
+    MS_ASSERT(_packets.empty(), "pending page must be empty");
+    AddLacingValues(packet->GetSize(), _segments);
+    _packets.push_back(packet);
+    _bodySize = packet->GetSize();
+    return WritePage(flags, outputDevice);
+}
+
+void RtpOggOpusSerializer::Finalize(OutputDevice* outputDevice)
+{
+    if (_headersWritten) {
+        WritePage(PageFlags::LastPage, outputDevice);
+    }
+}
+
+size_t RtpOggOpusSerializer::GetPacketsPerPage() const
+{
+    return _liveMode ? _packetsPerPage : std::max(_packetsPerPage, _filePacketsPerPage);
+}
+
+void RtpOggOpusSerializer::AddLacingValues(size_t packetSize, std::vector<uint8_t>& segments)
+{
+    // packet of size multiple of 255 is terminated by zero lacing value
+    segments.insert(segments.end(), packetSize / 255UL, 255U);
+    segments.push_back(static_cast<uint8_t>(packetSize % 255UL));
+}
+
+} // namespace RTC
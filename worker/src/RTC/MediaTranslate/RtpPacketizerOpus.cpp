@@ -0,0 +1,103 @@
+#define MS_CLASS "RTC::RtpPacketizerOpus"
+#include "RTC/MediaTranslate/RtpPacketizerOpus.hpp"
+#include "RTC/Codecs/Opus.hpp"
+#include "MemoryBuffer.hpp"
+#include "Logger.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace RTC
+{
+
+RtpPacketizerOpus::RtpPacketizerOpus(uint32_t ssrc, uint8_t payloadType)
+    : RtpPacketizerOpus(ssrc, payloadType,
+                        static_cast<uint16_t>(Utils::Crypto::GetRandomUInt(0U, 0xFFFFU)),
+                        Utils::Crypto::GetRandomUInt(0U, 0xFFFFFFFFU))
+{
+}
+
+RtpPacketizerOpus::RtpPacketizerOpus(uint32_t ssrc, uint8_t payloadType,
+                                     uint16_t initialSequenceNumber, uint32_t initialTimestamp)
+    : _ssrc(ssrc)
+    , _payloadType(payloadType)
+    , _sequenceNumber(initialSequenceNumber)
+    , _timestamp(initialTimestamp)
+{
+}
+
+RtpPacketizerOpus::~RtpPacketizerOpus()
+{
+}
+
+RtpPacket* RtpPacketizerOpus::Packetize(const std::shared_ptr<const MemoryBuffer>& frame,
+                                        bool marker, uint64_t nowMs)
+{
+    _packet.reset();
+    if (frame && !frame->IsEmpty()) {
+        const auto size = frame->GetSize();
+        if (size > _buffer.size() - RtpPacket::HeaderSize) {
+            MS_WARN_DEV("too large OPUS frame, %zu bytes", size);
+            return nullptr;
+        }
+        const auto duration = GetSamplesCount(frame->GetData(), size);
+        if (!duration) {
+            MS_WARN_DEV("malformed OPUS frame");
+            return nullptr;
+        }
+        if (_lastDuration) {
+            auto advance = _lastDuration;
+            if (marker && nowMs > _lastPacketMs) {
+                const auto gap = static_cast<uint32_t>((nowMs - _lastPacketMs) * (_clockRate / 1000U));
+                advance = std::max(advance, gap);
+            }
+            _timestamp += advance;
+            ++_sequenceNumber;
+        }
+        // fixed header without CSRC & extensions
+        _buffer[0] = 0x80;
+        _buffer[1] = (marker ? 0x80 : 0x00) | (_payloadType & 0x7F);
+        Utils::Byte::Set2Bytes(_buffer.data(), 2UL, _sequenceNumber);
+        Utils::Byte::Set4Bytes(_buffer.data(), 4UL, _timestamp);
+        Utils::Byte::Set4Bytes(_buffer.data(), 8UL, _ssrc);
+        std::memcpy(_buffer.data() + RtpPacket::HeaderSize, frame->GetData(), size);
+        _packet.reset(RtpPacket::Parse(_buffer.data(), RtpPacket::HeaderSize + size));
+        if (_packet) {
+            _lastDuration = duration;
+            _lastPacketMs = nowMs;
+        }
+    }
+    return _packet.get();
+}
+
+uint32_t RtpPacketizerOpus::GetSamplesCount(const uint8_t* data, size_t len)
+{
+    if (data && len) {
+        Codecs::Opus::FrameSize frameSize;
+        Codecs::Opus::CodeNumber codeNumber;
+        Codecs::Opus::ParseTOC(data[0], nullptr, nullptr, &frameSize, nullptr, &codeNumber);
+        uint32_t framesCount = 0U;
+        switch (codeNumber) {
+            case Codecs::Opus::CodeNumber::One:
+                framesCount = 1U;
+                break;
+            case Codecs::Opus::CodeNumber::Two:
+            case Codecs::Opus::CodeNumber::Three:
+                framesCount = 2U;
+                break;
+            case Codecs::Opus::CodeNumber::Arbitrary:
+                if (len > 1UL) {
+                    framesCount = data[1] & 0x3F;
+                }
+                break;
+        }
+        const auto samples = framesCount * static_cast<uint32_t>(frameSize);
+        // max duration of OPUS packet is 120 ms
+        if (samples <= 120U * (_clockRate / 1000U)) {
+            return samples;
+        }
+    }
+    return 0U;
+}
+
+} // namespace RTC
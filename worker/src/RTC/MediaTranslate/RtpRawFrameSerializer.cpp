@@ -0,0 +1,190 @@
+#define MS_CLASS "RTC::RtpRawFrameSerializer"
+#include "RTC/MediaTranslate/RtpRawFrameSerializer.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/TranslatorUtils.hpp"
+#include "Logger.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+inline const RTC::MemoryBuffer* GetCodecSpecificData(const RTC::RtpMediaFrame& mediaFrame) {
+    if (const auto config = mediaFrame.GetAudioConfig()) {
+        return config->_codecSpecificData.get();
+    }
+    if (const auto config = mediaFrame.GetVideoConfig()) {
+        return config->_codecSpecificData.get();
+    }
+    return nullptr;
+}
+
+}
+
+namespace RTC
+{
+
+RtpRawFrameSerializer::RtpRawFrameSerializer(const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : _buffersPool(buffersPool ? buffersPool : std::make_shared<MemoryBufferPool>())
+{
+}
+
+RtpRawFrameSerializer::~RtpRawFrameSerializer()
+{
+}
+
+bool RtpRawFrameSerializer::IsSupported(const RtpCodecMimeType& mimeType)
+{
+    return GetCodecId(mimeType).has_value();
+}
+
+std::optional<RtpRawFrameSerializer::CodecId> RtpRawFrameSerializer::GetCodecId(const RtpCodecMimeType& mimeType)
+{
+    switch (mimeType.GetSubtype()) {
+        case RtpCodecMimeType::Subtype::OPUS:
+        case RtpCodecMimeType::Subtype::MULTIOPUS:
+            return CodecId::Opus;
+        case RtpCodecMimeType::Subtype::VP8:
+            return CodecId::Vp8;
+        case RtpCodecMimeType::Subtype::VP9:
+            return CodecId::Vp9;
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
+void RtpRawFrameSerializer::SetOutputDevice(OutputDevice* outputDevice)
+{
+    if (outputDevice != GetOutputDevice()) {
+        // the new output starts from configuration record
+        _codec.reset();
+        _codecSpecificData.reset();
+        _width = _height = 0;
+    }
+    RtpMediaFrameSerializer::SetOutputDevice(outputDevice);
+}
+
+std::string_view RtpRawFrameSerializer::GetFileExtension(const RtpCodecMimeType&) const
+{
+    return "raw";
+}
+
+void RtpRawFrameSerializer::Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame)
+{
+    if (mediaFrame && mediaFrame->GetPayload()) {
+        if (const auto outputDevice = GetOutputDevice()) {
+            const auto codec = GetCodecId(mediaFrame->GetCodecMimeType());
+            if (!codec.has_value()) {
+                const auto frameInfo = GetMediaFrameInfoString(mediaFrame);
+                MS_WARN_DEV("unsupported codec of media frame [%s]", frameInfo.c_str());
+                return;
+            }
+            if (IsConfigChanged(*mediaFrame, codec.value())) {
+                if (const auto config = CreateConfig(*mediaFrame, codec.value())) {
+                    outputDevice->Write(config);
+                }
+            }
+            outputDevice->BeginWriteMediaPayload(mediaFrame->GetSsrc(),
+                                                 mediaFrame->IsKeyFrame(),
+                                                 mediaFrame->GetCodecMimeType(),
+                                                 mediaFrame->GetSequenceNumber(),
+                                                 mediaFrame->GetTimestamp(),
+                                                 mediaFrame->GetAbsSendtime());
+            const auto frame = CreateFrame(*mediaFrame, codec.value());
+            if (frame) {
+                outputDevice->Write(frame);
+            }
+            outputDevice->EndWriteMediaPayload(mediaFrame->GetSsrc(), nullptr != frame);
+        }
+    }
+}
+
+bool RtpRawFrameSerializer::IsConfigChanged(const RtpMediaFrame& mediaFrame, CodecId codec) const
+{
+    if (codec != _codec || GetCodecSpecificData(mediaFrame) != _codecSpecificData.get()) {
+        return true;
+    }
+    if (mediaFrame.IsKeyFrame()) {
+        if (const auto config = mediaFrame.GetVideoConfig()) {
+            return config->_width != _width || config->_height != _height;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpRawFrameSerializer::CreateConfig(const RtpMediaFrame& mediaFrame,
+                                                                        CodecId codec)
+{
+    const auto audioConfig = mediaFrame.GetAudioConfig();
+    const auto videoConfig = audioConfig ? nullptr : mediaFrame.GetVideoConfig();
+    const auto codecSpecificData = audioConfig ? audioConfig->_codecSpecificData :
+        (videoConfig ? videoConfig->_codecSpecificData : nullptr);
+    const auto codecSpecificDataSize = codecSpecificData ? codecSpecificData->GetSize() : 0UL;
+    const auto configSize = audioConfig ? AudioConfigSize : VideoConfigSize;
+    auto record = CreateRecord(RecordType::Config, codec, mediaFrame,
+                               configSize + codecSpecificDataSize);
+    if (record) {
+        std::array<uint8_t, std::max(AudioConfigSize, VideoConfigSize)> config = {};
+        Utils::Byte::Set4Bytes(config.data(), 0UL, mediaFrame.GetSampleRate());
+        if (audioConfig) {
+            config[4] = audioConfig->_channelCount;
+            config[5] = audioConfig->_bitsPerSample;
+        }
+        else if (videoConfig) {
+            Utils::Byte::Set2Bytes(config.data(), 4UL, static_cast<uint16_t>(videoConfig->_width));
+            Utils::Byte::Set2Bytes(config.data(), 6UL, static_cast<uint16_t>(videoConfig->_height));
+        }
+        record->Append(config.data(), configSize);
+        if (codecSpecificDataSize) {
+            record->Append(codecSpecificData->GetData(), codecSpecificDataSize);
+        }
+        _codec = codec;
+        _codecSpecificData = codecSpecificData;
+        if (videoConfig) {
+            _width = videoConfig->_width;
+            _height = videoConfig->_height;
+        }
+    }
+    return record;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpRawFrameSerializer::CreateFrame(const RtpMediaFrame& mediaFrame,
+                                                                       CodecId codec)
+{
+    const auto& payload = mediaFrame.GetPayload();
+    auto record = CreateRecord(RecordType::Frame, codec, mediaFrame, payload->GetSize());
+    if (record) {
+        record->Append(payload->GetData(), payload->GetSize());
+    }
+    return record;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> RtpRawFrameSerializer::CreateRecord(RecordType type, CodecId codec,
+                                                                        const RtpMediaFrame& mediaFrame,
+                                                                        size_t bodySize)
+{
+    const auto size = HeaderSize + bodySize;
+    if (size - sizeof(uint32_t) > UINT32_MAX) {
+        MS_ERROR("too large media frame, %zu bytes", bodySize);
+        return nullptr;
+    }
+    auto record = _buffersPool->Allocate(size);
+    if (record) {
+        std::array<uint8_t, HeaderSize> header;
+        Utils::Byte::Set4Bytes(header.data(), 0UL, static_cast<uint32_t>(size - sizeof(uint32_t)));
+        header[4] = static_cast<uint8_t>(type);
+        header[5] = static_cast<uint8_t>(codec);
+        header[6] = mediaFrame.IsKeyFrame() ? 0x01 : 0x00;
+        header[7] = 0x00;
+        Utils::Byte::Set2Bytes(header.data(), 8UL, mediaFrame.GetSequenceNumber());
+        Utils::Byte::Set4Bytes(header.data(), 10UL, mediaFrame.GetTimestamp());
+        record->Append(header.data(), header.size());
+    }
+    return record;
+}
+
+} // namespace RTC
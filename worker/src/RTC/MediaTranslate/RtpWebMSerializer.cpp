@@ -138,7 +138,7 @@ void RtpWebMSerializer::SetLiveMode(bool liveMode)
 
 std::string_view RtpWebMSerializer::GetFileExtension(const RtpCodecMimeType&) const
 {
-    return "webm";
+    return _fileExtension;
 }
 
 void RtpWebMSerializer::Push(const std::shared_ptr<RtpMediaFrame>& mediaFrame)
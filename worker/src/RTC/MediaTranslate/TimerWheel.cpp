@@ -0,0 +1,91 @@
+#define MS_CLASS "RTC::TimerWheel"
+#include "RTC/MediaTranslate/TimerWheel.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+
+namespace RTC
+{
+
+TimerWheel::TimerWheel(uint64_t tickMs, size_t slotsCount)
+    : _tickMs(std::max<uint64_t>(1ULL, tickMs))
+    , _slots(std::max<size_t>(2UL, slotsCount))
+    , _timer(std::make_unique<TimerHandle>(this))
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+void TimerWheel::Schedule(Listener* listener, uint64_t delayMs)
+{
+    if (listener) {
+        Cancel(listener);
+        // never into the current slot, it may be fired right now
+        const auto ticks = std::clamp<uint64_t>((delayMs + _tickMs - 1ULL) / _tickMs,
+                                                1ULL, _slots.size() - 1UL);
+        const auto slot = (_currentSlot + ticks) % _slots.size();
+        _slots[slot].push_back(listener);
+        _positions[listener] = slot;
+        if (!_timer->IsActive()) {
+            _lastTickMs = DepLibUV::GetTimeMs();
+            _timer->Start(_tickMs, _tickMs);
+        }
+    }
+}
+
+void TimerWheel::Cancel(Listener* listener)
+{
+    const auto it = _positions.find(listener);
+    if (it != _positions.end()) {
+        auto& slot = _slots[it->second];
+        const auto its = std::find(slot.begin(), slot.end(), listener);
+        if (its != slot.end()) {
+            *its = slot.back();
+            slot.pop_back();
+        }
+        _positions.erase(it);
+        if (_positions.empty()) {
+            _timer->Stop();
+        }
+    }
+}
+
+void TimerWheel::FireSlot(size_t slot, uint64_t nowMs)
+{
+    auto& listeners = _slots[slot];
+    // listeners may cancel or schedule each other from the callback
+    while (!listeners.empty()) {
+        const auto listener = listeners.back();
+        listeners.pop_back();
+        _positions.erase(listener);
+        if (const auto delayMs = listener->OnTimerWheelTick(nowMs)) {
+            Schedule(listener, delayMs);
+        }
+    }
+}
+
+void TimerWheel::OnTimer(TimerHandle* /*timer*/)
+{
+    const auto nowMs = DepLibUV::GetTimeMs();
+    // catch up all slots passed since the last tick if the loop was late
+    const auto passed = nowMs > _lastTickMs ? (nowMs - _lastTickMs) / _tickMs : 0ULL;
+    const auto elapsed = std::clamp<uint64_t>(passed, 1ULL, _slots.size());
+    if (passed > _slots.size()) {
+        // stall longer than the wheel horizon, re-anchor
+        _lastTickMs = nowMs;
+    }
+    else {
+        _lastTickMs += elapsed * _tickMs;
+    }
+    for (uint64_t i = 0ULL; i < elapsed && !_positions.empty(); ++i) {
+        _currentSlot = (_currentSlot + 1UL) % _slots.size();
+        FireSlot(_currentSlot, nowMs);
+    }
+    if (_positions.empty()) {
+        _timer->Stop();
+    }
+}
+
+} // namespace RTC
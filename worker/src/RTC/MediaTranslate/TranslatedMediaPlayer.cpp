@@ -0,0 +1,145 @@
+#define MS_CLASS "RTC::TranslatedMediaPlayer"
+#include "RTC/MediaTranslate/TranslatedMediaPlayer.hpp"
+#include "RTC/MediaTranslate/RtpPacketizerOpus.hpp"
+#include "DepLibUV.hpp"
+#include "MemoryBuffer.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace RTC
+{
+
+struct TranslatedMediaPlayer::Frame
+{
+    Frame(const std::shared_ptr<const MemoryBuffer>& payload, uint64_t timestampMs,
+          uint64_t durationUs, uint64_t arrivalMs);
+    const std::shared_ptr<const MemoryBuffer> _payload;
+    const uint64_t _timestampMs;
+    const uint64_t _durationUs;
+    const uint64_t _arrivalMs;
+};
+
+TranslatedMediaPlayer::TranslatedMediaPlayer(Listener* listener, size_t capacity)
+    : _listener(listener)
+    , _frames(capacity)
+{
+    MS_ASSERT(_listener, "listener must not be null");
+}
+
+TranslatedMediaPlayer::~TranslatedMediaPlayer()
+{
+    MS_ASSERT(!IsStarted(), "player must be stopped on the worker thread before destruction");
+}
+
+void TranslatedMediaPlayer::Push(const std::shared_ptr<const MemoryBuffer>& frame, uint64_t timestampMs)
+{
+    if (frame && !frame->IsEmpty()) {
+        // 48 samples per millisecond
+        const auto durationUs = RtpPacketizerOpus::GetSamplesCount(frame->GetData(),
+                                                                   frame->GetSize()) * 1000ULL / 48ULL;
+        if (durationUs) {
+            _frames.Push(std::make_unique<Frame>(frame, timestampMs, durationUs, DepLibUV::GetTimeMs()));
+        }
+        else {
+            MS_WARN_DEV("malformed OPUS frame");
+        }
+    }
+}
+
+void TranslatedMediaPlayer::Start(TimerWheel* timerWheel)
+{
+    if (timerWheel && timerWheel != _timerWheel) {
+        Stop();
+        _timerWheel = timerWheel;
+        _nextPlayUs = DepLibUV::GetTimeMs() * 1000ULL;
+        _timerWheel->Schedule(this, 0ULL);
+    }
+}
+
+void TranslatedMediaPlayer::Stop()
+{
+    if (_timerWheel) {
+        _timerWheel->Cancel(this);
+        _timerWheel = nullptr;
+        _expectedTimestampMs.reset();
+        _starved = false;
+    }
+}
+
+TranslationStats TranslatedMediaPlayer::GetStats() const
+{
+    auto stats = _stats;
+    stats._droppedFrames = _frames.GetDroppedCount();
+    stats._bufferedFrames = static_cast<uint32_t>(_frames.GetSize());
+    return stats;
+}
+
+void TranslatedMediaPlayer::Play(const Frame& frame, uint64_t nowMs)
+{
+    bool newSequence = true;
+    if (_expectedTimestampMs.has_value()) {
+        const auto expected = _expectedTimestampMs.value();
+        const auto toleranceMs = std::max<uint64_t>(1ULL, frame._durationUs / 1000ULL);
+        // continuation of the current sequence if frame is adjacent to the previous one
+        if (frame._timestampMs + toleranceMs >= expected && frame._timestampMs <= expected + toleranceMs) {
+            newSequence = false;
+            if (_starved) {
+                ++_stats._lateFrames;
+            }
+            // RFC 3550, section 6.4.1
+            const auto transit = static_cast<double>(frame._arrivalMs) - static_cast<double>(_lastArrivalMs);
+            const auto media = static_cast<double>(frame._timestampMs) - static_cast<double>(_lastTimestampMs);
+            _stats._jitterMs += (std::abs(transit - media) - _stats._jitterMs) / 16.;
+        }
+    }
+    _starved = false;
+    _expectedTimestampMs = frame._timestampMs + frame._durationUs / 1000ULL;
+    _lastArrivalMs = frame._arrivalMs;
+    _lastTimestampMs = frame._timestampMs;
+    const auto delayMs = nowMs > frame._arrivalMs ? nowMs - frame._arrivalMs : 0ULL;
+    _stats._bufferDelayMs += (static_cast<double>(delayMs) - _stats._bufferDelayMs) / 16.;
+    _stats._maxBufferDelayMs = std::max(_stats._maxBufferDelayMs, static_cast<uint32_t>(delayMs));
+    ++_stats._playedFrames;
+    _listener->OnPlayFrame(frame._payload, newSequence, nowMs);
+}
+
+uint64_t TranslatedMediaPlayer::OnTimerWheelTick(uint64_t nowMs)
+{
+    if (!IsStarted()) {
+        return 0ULL;
+    }
+    const auto nowUs = nowMs * 1000ULL;
+    size_t played = 0UL;
+    while (_nextPlayUs <= nowUs) {
+        const auto frame = _frames.Pop();
+        if (!frame) {
+            _starved = _expectedTimestampMs.has_value();
+            _nextPlayUs = nowUs + _idleIntervalUs;
+            break;
+        }
+        Play(*frame, nowMs);
+        // listener may stop the player
+        if (!IsStarted()) {
+            return 0ULL;
+        }
+        _nextPlayUs += frame->_durationUs;
+        if (++played == _maxFramesPerTick) {
+            // the loop was stalled, don't burst into consumers
+            _nextPlayUs = std::max(_nextPlayUs, nowUs);
+            break;
+        }
+    }
+    return std::max<uint64_t>(1ULL, (_nextPlayUs - nowUs) / 1000ULL);
+}
+
+TranslatedMediaPlayer::Frame::Frame(const std::shared_ptr<const MemoryBuffer>& payload,
+                                    uint64_t timestampMs, uint64_t durationUs, uint64_t arrivalMs)
+    : _payload(payload)
+    , _timestampMs(timestampMs)
+    , _durationUs(durationUs)
+    , _arrivalMs(arrivalMs)
+{
+}
+
+} // namespace RTC
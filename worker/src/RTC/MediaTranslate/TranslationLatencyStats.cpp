@@ -0,0 +1,54 @@
+#include "RTC/MediaTranslate/TranslationLatencyStats.hpp"
+
+namespace {
+
+flatbuffers::Offset<FBS::Producer::LatencyHistogram> FillHistogram(flatbuffers::FlatBufferBuilder& builder,
+                                                                   const RTC::LatencyHistogram::Snapshot& snapshot)
+{
+    const auto& bounds = RTC::LatencyHistogram::_boundsUs;
+    return FBS::Producer::CreateLatencyHistogram(builder,
+                                                 builder.CreateVector(bounds.data(), bounds.size()),
+                                                 builder.CreateVector(snapshot._buckets.data(),
+                                                                      snapshot._buckets.size()),
+                                                 snapshot._count,
+                                                 snapshot._sumUs,
+                                                 snapshot._maxUs);
+}
+
+}
+
+namespace RTC
+{
+
+flatbuffers::Offset<FBS::Producer::TranslationStreamLatency> TranslationStreamLatencyStats::
+    FillBuffer(flatbuffers::FlatBufferBuilder& builder) const
+{
+    const auto assembly = FillHistogram(builder, _assembly);
+    const auto serialization = FillHistogram(builder, _serialization);
+    return FBS::Producer::CreateTranslationStreamLatency(builder, _mappedSsrc,
+                                                         assembly, serialization,
+                                                         _frames, _bytes, _droppedPackets,
+                                                         _gatedFrames, _gatedBytes, _speechSegments,
+                                                         _incompleteFrames, _undecodableFrames,
+                                                         _keyFrameRequests);
+}
+
+flatbuffers::Offset<FBS::Producer::TranslationEndPointLatency> TranslationEndPointLatencyStats::
+    FillBuffer(flatbuffers::FlatBufferBuilder& builder) const
+{
+    const auto languageToName = MediaLanguageToString(_languageTo);
+    const auto voiceName = MediaVoiceToString(_voice);
+    const auto languageTo = builder.CreateString(languageToName.data(), languageToName.size());
+    const auto voice = builder.CreateString(voiceName.data(), voiceName.size());
+    const auto socketWrite = FillHistogram(builder, _socketWrite);
+    const auto firstResponse = FillHistogram(builder, _firstResponse);
+    const auto connect = FillHistogram(builder, _connect);
+    return FBS::Producer::CreateTranslationEndPointLatency(builder, languageTo, voice,
+                                                           socketWrite, firstResponse,
+                                                           _sentMessages, _sentBytes,
+                                                           _droppedMessages,
+                                                           _receivedMessages, _receivedBytes,
+                                                           _reconnects, connect, _failovers);
+}
+
+} // namespace RTC
@@ -0,0 +1,343 @@
+#define MS_CLASS "RTC::TranslationServiceBalancer"
+#include "RTC/MediaTranslate/TranslationServiceBalancer.hpp"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include "RTC/MediaTranslate/WebsocketListener.hpp"
+#include "Logger.hpp"
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+
+namespace RTC
+{
+
+struct TranslationServiceBalancer::Host
+{
+    TranslationServiceHost _address;
+    // null if warm sessions are disabled
+    std::shared_ptr<Websocket::Pool> _pool;
+    // smoothed, zero until the first successful probe
+    double _connectLatencyMs = 0.;
+    // smoothed share of failed connections & probes
+    double _errorRate = 0.;
+    uint32_t _sessions = 0U;
+    std::shared_ptr<Probe> _probe;
+};
+
+// single connection attempt, no answer until the next round is failure
+class TranslationServiceBalancer::Probe : public WebsocketListener,
+                                          public std::enable_shared_from_this<TranslationServiceBalancer::Probe>
+{
+public:
+    Probe(const std::weak_ptr<TranslationServiceBalancer>& balancer, size_t host,
+          const std::shared_ptr<Websocket>& websocket);
+    bool Start(const std::string& userAgent);
+    void Finish();
+    // impl. of WebsocketListener
+    void OnStateChanged(uint64_t socketId, WebsocketState state) final;
+    void OnFailed(uint64_t socketId, FailureType type, std::string what) final;
+private:
+    void Complete(const std::optional<uint64_t>& latencyUs);
+    void Close();
+private:
+    const std::weak_ptr<TranslationServiceBalancer> _balancer;
+    const size_t _host;
+    const std::shared_ptr<Websocket> _websocket;
+    const uint64_t _startUs;
+    std::atomic_bool _completed = false;
+};
+
+class TranslationServiceBalancer::Timer
+{
+public:
+    Timer() : _timer(*IoContextPool::GetInstance().NextContext()) {}
+    template <class Handler>
+    void Start(std::chrono::milliseconds delay, Handler handler) {
+        _timer.expires_after(delay);
+        _timer.async_wait([handler = std::move(handler)](const asio::error_code& error) {
+            if (!error) {
+                handler();
+            }
+        });
+    }
+    void Cancel() { _timer.cancel(); }
+private:
+    asio::steady_timer _timer;
+};
+
+TranslationServiceBalancer::TranslationServiceBalancer(const std::vector<TranslationServiceHost>& hosts,
+                                                       const TranslationBalancingSettings& settings,
+                                                       const WebsocketPoolSettings& poolSettings,
+                                                       std::unordered_map<std::string, std::string> headers,
+                                                       const WebsocketSendQueueSettings& sendQueueSettings,
+                                                       const std::string& userAgent)
+    : _settings(settings)
+    , _headers(std::move(headers))
+    , _sendQueueSettings(sendQueueSettings)
+    , _userAgent(userAgent)
+    , _probeTimer(settings._probeIntervalMs ? std::make_unique<Timer>() : nullptr)
+{
+    _hosts.reserve(hosts.size());
+    for (const auto& address : hosts) {
+        if (WebsocketState::Invalid == Websocket(address._uri).GetState()) {
+            MS_WARN_TAG(rtp, "invalid URI of translation service host: %s", address._uri.c_str());
+            continue;
+        }
+        Host host;
+        host._address = address;
+        host._pool = Websocket::GetPool(poolSettings, address._uri, address._user, address._password,
+                                        _headers, _sendQueueSettings, _userAgent);
+        _hosts.push_back(std::move(host));
+    }
+}
+
+TranslationServiceBalancer::~TranslationServiceBalancer()
+{
+    std::vector<std::shared_ptr<Probe>> probes;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        if (_probeTimer) {
+            _probeTimer->Cancel();
+        }
+        for (auto& host : _hosts) {
+            if (host._probe) {
+                probes.push_back(std::move(host._probe));
+            }
+        }
+    }
+    for (const auto& probe : probes) {
+        probe->Finish();
+    }
+}
+
+std::shared_ptr<TranslationServiceBalancer> TranslationServiceBalancer::
+    Create(const std::vector<TranslationServiceHost>& hosts,
+           const TranslationBalancingSettings& settings,
+           const WebsocketPoolSettings& poolSettings,
+           std::unordered_map<std::string, std::string> headers,
+           const WebsocketSendQueueSettings& sendQueueSettings,
+           const std::string& userAgent)
+{
+    auto balancer = std::make_shared<TranslationServiceBalancer>(hosts, settings, poolSettings,
+                                                                 std::move(headers),
+                                                                 sendQueueSettings, userAgent);
+    if (balancer->GetHostsCount()) {
+        balancer->StartProbing();
+        return balancer;
+    }
+    return nullptr;
+}
+
+size_t TranslationServiceBalancer::GetHostsCount() const
+{
+    return _hosts.size();
+}
+
+std::shared_ptr<Websocket> TranslationServiceBalancer::Acquire(const std::optional<size_t>& excluded,
+                                                               size_t& host)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    std::optional<size_t> best;
+    double bestScore = 0.;
+    bool bestHealthy = false;
+    for (size_t i = 0UL; i < _hosts.size(); ++i) {
+        if (excluded == i && _hosts.size() > 1UL) {
+            continue;
+        }
+        const auto score = GetScore(_hosts[i]);
+        const auto healthy = IsHealthy(_hosts[i]);
+        // unhealthy hosts are chosen only if there are no others
+        if (!best || (healthy && !bestHealthy) || (healthy == bestHealthy && score < bestScore)) {
+            best = i;
+            bestScore = score;
+            bestHealthy = healthy;
+        }
+    }
+    if (best) {
+        auto& chosen = _hosts[best.value()];
+        ++chosen._sessions;
+        host = best.value();
+        if (chosen._pool) {
+            return std::make_shared<Websocket>(chosen._pool);
+        }
+        return std::make_shared<Websocket>(chosen._address._uri, chosen._address._user,
+                                           chosen._address._password, _headers,
+                                           _sendQueueSettings);
+    }
+    return nullptr;
+}
+
+void TranslationServiceBalancer::Release(size_t host)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (host < _hosts.size() && _hosts[host]._sessions) {
+        --_hosts[host]._sessions;
+    }
+}
+
+void TranslationServiceBalancer::OnSessionConnected(size_t host)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (host < _hosts.size()) {
+        UpdateErrorRate(_hosts[host], false);
+    }
+}
+
+void TranslationServiceBalancer::OnSessionFailed(size_t host)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (host < _hosts.size()) {
+        UpdateErrorRate(_hosts[host], true);
+    }
+}
+
+const std::string& TranslationServiceBalancer::GetHostUri(size_t host) const
+{
+    static const std::string empty;
+    return host < _hosts.size() ? _hosts[host]._address._uri : empty;
+}
+
+void TranslationServiceBalancer::StartProbing()
+{
+    if (_probeTimer) {
+        ProbeHosts();
+    }
+}
+
+void TranslationServiceBalancer::ProbeHosts()
+{
+    std::vector<std::shared_ptr<Probe>> finished, started;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0UL; i < _hosts.size(); ++i) {
+            auto& host = _hosts[i];
+            if (host._probe) {
+                finished.push_back(std::move(host._probe));
+            }
+            // warm sessions of the pool aren't used here, they hide the actual latency
+            const auto websocket = std::make_shared<Websocket>(host._address._uri,
+                                                               host._address._user,
+                                                               host._address._password,
+                                                               _headers, _sendQueueSettings);
+            host._probe = std::make_shared<Probe>(weak_from_this(), i, websocket);
+            started.push_back(host._probe);
+        }
+        _probeTimer->Start(std::chrono::milliseconds(_settings._probeIntervalMs),
+                           [weakSelf = weak_from_this()]() {
+            if (const auto self = weakSelf.lock()) {
+                self->ProbeHosts();
+            }
+        });
+    }
+    // callbacks of probes take the lock
+    for (const auto& probe : finished) {
+        probe->Finish();
+    }
+    for (const auto& probe : started) {
+        probe->Start(_userAgent);
+    }
+}
+
+void TranslationServiceBalancer::OnProbeResult(size_t host, const std::optional<uint64_t>& latencyUs)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (host < _hosts.size()) {
+        auto& target = _hosts[host];
+        if (latencyUs) {
+            const auto latencyMs = latencyUs.value() / 1000.;
+            if (target._connectLatencyMs > 0.) {
+                target._connectLatencyMs += (latencyMs - target._connectLatencyMs) * _smoothing;
+            }
+            else {
+                target._connectLatencyMs = latencyMs;
+            }
+        }
+        UpdateErrorRate(target, !latencyUs.has_value());
+    }
+}
+
+double TranslationServiceBalancer::GetScore(const Host& host) const
+{
+    // unknown latency is optimistic, so new hosts get sessions soon
+    return (1. + host._connectLatencyMs) * (1. + host._sessions) * (1. + _errorPenalty * host._errorRate);
+}
+
+bool TranslationServiceBalancer::IsHealthy(const Host& host) const
+{
+    return host._errorRate < _maxErrorRate;
+}
+
+void TranslationServiceBalancer::UpdateErrorRate(Host& host, bool failed)
+{
+    const auto wasHealthy = IsHealthy(host);
+    host._errorRate += ((failed ? 1. : 0.) - host._errorRate) * _smoothing;
+    if (wasHealthy != IsHealthy(host)) {
+        MS_WARN_TAG(rtp, "translation service host %s is %s", host._address._uri.c_str(),
+                    wasHealthy ? "out of rotation" : "back in rotation");
+    }
+}
+
+TranslationServiceBalancer::Probe::Probe(const std::weak_ptr<TranslationServiceBalancer>& balancer,
+                                         size_t host, const std::shared_ptr<Websocket>& websocket)
+    : _balancer(balancer)
+    , _host(host)
+    , _websocket(websocket)
+    , _startUs(LatencyHistogram::NowUs())
+{
+}
+
+bool TranslationServiceBalancer::Probe::Start(const std::string& userAgent)
+{
+    _websocket->SetListener(shared_from_this());
+    if (!_websocket->Open(userAgent)) {
+        Complete(std::nullopt);
+        return false;
+    }
+    return true;
+}
+
+void TranslationServiceBalancer::Probe::Finish()
+{
+    // no answer until now
+    Complete(std::nullopt);
+    // breaks reference cycle with the websocket
+    _websocket->SetListener(nullptr);
+    _websocket->Close();
+}
+
+void TranslationServiceBalancer::Probe::OnStateChanged(uint64_t socketId, WebsocketState state)
+{
+    WebsocketListener::OnStateChanged(socketId, state);
+    if (WebsocketState::Connected == state) {
+        const auto nowUs = LatencyHistogram::NowUs();
+        Complete(nowUs - std::min(nowUs, _startUs));
+        Close();
+    }
+}
+
+void TranslationServiceBalancer::Probe::OnFailed(uint64_t socketId, FailureType type, std::string what)
+{
+    WebsocketListener::OnFailed(socketId, type, std::move(what));
+    Complete(std::nullopt);
+}
+
+void TranslationServiceBalancer::Probe::Complete(const std::optional<uint64_t>& latencyUs)
+{
+    if (!_completed.exchange(true)) {
+        if (const auto balancer = _balancer.lock()) {
+            balancer->OnProbeResult(_host, latencyUs);
+        }
+    }
+}
+
+void TranslationServiceBalancer::Probe::Close()
+{
+    // not inside of callback of the connection
+    asio::post(*IoContextPool::GetInstance().NextContext(), [websocket = _websocket]() {
+        websocket->Close();
+    });
+}
+
+} // namespace RTC
@@ -1,22 +1,70 @@
 #define MS_CLASS "RTC::TranslatorEndPoint"
 #include "RTC/MediaTranslate/TranslatorEndPoint.hpp"
 #include "RTC/MediaTranslate/Websocket.hpp"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
 #include "RTC/MediaTranslate/OutputDevice.hpp"
 #include "RTC/MediaTranslate/WebsocketListener.hpp"
 #include "RTC/MediaTranslate/ProducerInputMediaStreamer.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/TranslatedMediaPlayer.hpp"
+#include "RTC/MediaTranslate/TranslationServiceBalancer.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPointSink.hpp"
+#include "RTC/MediaTranslate/WebMDeserializer.hpp"
+#include "RTC/MediaTranslate/WriteCoalescer.hpp"
 #include "RTC/MediaTranslate/MediaLanguage.hpp"
 #include "RTC/MediaTranslate/MediaVoice.hpp"
 #include "ProtectedObj.hpp"
+#include "ProtectedSnapshot.hpp"
 #include "Logger.hpp"
+#include <absl/container/flat_hash_set.h>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <chrono>
+#include <utility>
+
+namespace {
+
+// formats supported by the worker in order of preference, sent in the handshake request,
+// the service confirms the chosen one in the handshake response
+const std::string g_mediaFormatsOfferHeader = "X-Media-Formats";
+const std::string g_mediaFormatAnswerHeader = "X-Media-Format";
+
+std::unordered_map<std::string, std::string> GetHandshakeHeaders(RTC::MediaFrameFormat preferredFormat)
+{
+    std::unordered_map<std::string, std::string> headers;
+    if (RTC::DefaultMediaFrameFormat() != preferredFormat) {
+        std::string formats(RTC::MediaFrameFormatToString(preferredFormat));
+        formats += ", ";
+        formats += RTC::MediaFrameFormatToString(RTC::DefaultMediaFrameFormat());
+        headers[g_mediaFormatsOfferHeader] = std::move(formats);
+    }
+    return headers;
+}
+
+}
 
 namespace RTC
 {
 
-class TranslatorEndPoint::Impl : public WebsocketListener, private OutputDevice
+class TranslatorEndPoint::Impl : public WebsocketListener,
+                                 public std::enable_shared_from_this<TranslatorEndPoint::Impl>,
+                                 private OutputDevice,
+                                 private WebMDeserializer::Listener,
+                                 private TranslatedMediaPlayer::Listener,
+                                 private WriteCoalescer::Listener
 {
+    using OutputsSet = absl::flat_hash_set<TranslatorEndPointSink*>;
 public:
-    Impl(const std::weak_ptr<Websocket>& websocketRef, const std::string& userAgent);
+    Impl(TimerWheel* timerWheel, MediaFrameFormat preferredFormat,
+         const WriteCoalescingSettings& coalescing, WebsocketDropPolicy dropPolicy,
+         std::shared_ptr<TranslationServiceBalancer> balancer, const std::string& userAgent);
     ~Impl() final;
+    // previous websocket is closed, [host] is index of the balancer host
+    void SetWebsocket(std::shared_ptr<Websocket> websocket,
+                      const std::optional<size_t>& host = std::nullopt);
+    WebsocketSendStats GetSendStats() const;
     void FinalizeMedia();
     void Open();
     void Close();
@@ -24,17 +72,43 @@ public:
     void SetConsumerLanguage(MediaLanguage language);
     void SetConsumerVoice(MediaVoice voice);
     void SetInput(const std::shared_ptr<ProducerInputMediaStreamer>& input);
-    void SetOutput(const std::weak_ptr<RtpPacketsCollector>& outputRef);
+    void AddOutput(TranslatorEndPointSink* output);
+    void RemoveOutput(TranslatorEndPointSink* output);
     uint32_t GetProducerInputSsrc() const;
+    MediaFrameFormat GetMediaFormat() const { return _mediaFormat.load(std::memory_order_relaxed); }
+    TranslationStats GetStats() const { return _player.GetStats(); }
+    TranslationEndPointLatencyStats GetLatencyStats(const WebsocketSendStats& sendStats) const;
     bool IsConnected() const { return _connected.load(std::memory_order_relaxed); }
     // impl. of WebsocketListener
     void OnStateChanged(uint64_t socketId, WebsocketState state) final;
+    void OnFailed(uint64_t socketId, FailureType type, std::string what) final;
     void OnTextMessageReceived(uint64_t socketId, std::string message) final;
     void OnBinaryMessageReceved(uint64_t socketId, const std::shared_ptr<MemoryBuffer>& message) final;
+    void OnSendQueueCongestion(uint64_t socketId, bool congested, const WebsocketSendStats& stats) final;
 private:
     bool IsWantsToOpen() const { return _wantsToOpen.load(std::memory_order_relaxed); }
+    bool IsInputPaused() const { return _inputPaused.load(std::memory_order_relaxed); }
+    std::shared_ptr<Websocket> GetWebsocket() const;
+    // callbacks of replaced websockets are ignored
+    bool IsCurrentWebsocket(uint64_t socketId) const;
+    std::optional<size_t> GetHost() const;
     void OpenWebsocket();
     void CloseWebsocket();
+    void OnConnected();
+    void OnDisconnected();
+    // periodic check of the connection while the session is wanted, balancer only
+    void PostFailoverCheck();
+    void ScheduleFailoverCheck();
+    void CheckFailover();
+    // moves the session from [websocket] to another host of the balancer
+    void Migrate(const std::shared_ptr<Websocket>& websocket);
+    // called once connected, read the answer of the service from handshake response
+    MediaFrameFormat NegotiateMediaFormat() const;
+    void ApplyDropPolicy(MediaFrameFormat format);
+    // subscribe or unsubscribe to the input according to the connection & congestion,
+    // called on [_context] because congestion is reported from inside of the input
+    void PostUpdateMediaInput();
+    void UpdateMediaInput();
     void InitializeMediaInput();
     void InitializeMediaInput(const std::shared_ptr<ProducerInputMediaStreamer>& input);
     void FinalizeMediaInput();
@@ -52,26 +126,107 @@ private:
                                 uint32_t rtpAbsSendtime) final;
     void EndWriteMediaPayload(uint32_t ssrc, bool ok) final;
     void Write(const std::shared_ptr<const MemoryBuffer>& buffer) final;
+    // impl. of WebMDeserializer::Listener
+    void OnMediaFrame(const RtpCodecMimeType& mime, uint64_t timestampMs,
+                      const std::shared_ptr<const MemoryBuffer>& payload) final;
+    // impl. of TranslatedMediaPlayer::Listener
+    void OnPlayFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                     bool newSequence, uint64_t nowMs) final;
+    // impl. of WriteCoalescer::Listener
+    void OnCoalescedWrite(const std::shared_ptr<const MemoryBuffer>& buffer, bool hasKeyFrame) final;
 private:
-    const std::weak_ptr<Websocket> _websocketRef;
+    // 5 seconds of 20 ms frames
+    static inline constexpr size_t _maxBufferedFrames = 256UL;
+    static inline constexpr std::chrono::seconds _failoverCheckInterval = std::chrono::seconds(1);
+    TimerWheel* const _timerWheel;
+    const MediaFrameFormat _preferredFormat;
+    const WebsocketDropPolicy _dropPolicy;
+    const std::shared_ptr<TranslationServiceBalancer> _balancer;
     const std::string _userAgent;
+    // owned here because the balancer replaces it on failover
+    ProtectedSharedPtr<Websocket> _websocket;
+    // host of [_websocket] in the balancer, guarded by lock of [_websocket]
+    std::optional<size_t> _host;
     std::atomic_bool _connected = false;
+    std::atomic<MediaFrameFormat> _mediaFormat = DefaultMediaFrameFormat();
     std::atomic<MediaLanguage> _consumerLanguage = DefaultOutputMediaLanguage();
     std::atomic<MediaVoice> _consumerVoice = DefaultMediaVoice();
     ProtectedOptional<MediaLanguage> _producerLanguage = DefaultInputMediaLanguage();
     ProtectedSharedPtr<ProducerInputMediaStreamer> _input;
-    ProtectedWeakPtr<RtpPacketsCollector> _outputRef;
+    // changed & read by play-out on the worker thread, so a removed sink isn't in use after RemoveOutput()
+    ProtectedSnapshot<OutputsSet> _outputs;
     std::atomic_bool _wantsToOpen = false;
+    // send queue is congested, input is unsubscribed until it's drained
+    std::atomic_bool _inputPaused = false;
+    asio::io_context* const _context;
+    // start of the oldest media which was not answered by translation yet, zero if none
+    std::atomic<uint64_t> _pendingRequestUs = 0ULL;
+    LatencyHistogram _firstResponse;
+    // start of the websocket opening, zero if not opening now
+    std::atomic<uint64_t> _openingUs = 0ULL;
+    LatencyHistogram _connect;
+    std::atomic<uint64_t> _receivedMessages = 0ULL;
+    std::atomic<uint64_t> _receivedBytes = 0ULL;
+    std::atomic<uint64_t> _connections = 0ULL;
+    std::atomic<uint64_t> _failovers = 0ULL;
+    // touched only on [_context]
+    asio::steady_timer _failoverTimer;
+    // media of the input, written by the serialization thread
+    const std::shared_ptr<WriteCoalescer> _coalescer;
+    // translated media, deserializer is touched only by websocket thread
+    const std::shared_ptr<MemoryBufferPool> _framesPool;
+    WebMDeserializer _deserializer;
+    TranslatedMediaPlayer _player;
 };
 
-TranslatorEndPoint::TranslatorEndPoint(const std::string& serviceUri,
+TranslatorEndPoint::TranslatorEndPoint(TimerWheel* timerWheel,
+                                       MediaFrameFormat preferredFormat,
+                                       const WriteCoalescingSettings& coalescing,
+                                       const WebsocketSendQueueSettings& sendQueue,
+                                       const std::string& serviceUri,
                                        const std::string& serviceUser,
                                        const std::string& servicePassword,
                                        const std::string& userAgent)
-    : _websocket(std::make_shared<Websocket>(serviceUri, serviceUser, servicePassword))
-    , _impl(std::make_shared<Impl>(_websocket, userAgent))
+    : TranslatorEndPoint(timerWheel, preferredFormat, coalescing, sendQueue,
+                         std::make_shared<Websocket>(serviceUri, serviceUser, servicePassword,
+                                                     GetHandshakeHeaders(preferredFormat), sendQueue),
+                         nullptr, userAgent)
 {
-    _websocket->SetListener(_impl);
+}
+
+TranslatorEndPoint::TranslatorEndPoint(TimerWheel* timerWheel,
+                                       MediaFrameFormat preferredFormat,
+                                       const WriteCoalescingSettings& coalescing,
+                                       const WebsocketSendQueueSettings& sendQueue,
+                                       const std::shared_ptr<Websocket::Pool>& pool)
+    : TranslatorEndPoint(timerWheel, preferredFormat, coalescing, sendQueue,
+                         std::make_shared<Websocket>(pool), nullptr, std::string())
+{
+}
+
+TranslatorEndPoint::TranslatorEndPoint(TimerWheel* timerWheel,
+                                       MediaFrameFormat preferredFormat,
+                                       const WriteCoalescingSettings& coalescing,
+                                       const WebsocketSendQueueSettings& sendQueue,
+                                       const std::shared_ptr<TranslationServiceBalancer>& balancer)
+    : TranslatorEndPoint(timerWheel, preferredFormat, coalescing, sendQueue, nullptr, balancer,
+                         balancer ? balancer->GetUserAgent() : std::string())
+{
+}
+
+TranslatorEndPoint::TranslatorEndPoint(TimerWheel* timerWheel,
+                                       MediaFrameFormat preferredFormat,
+                                       const WriteCoalescingSettings& coalescing,
+                                       const WebsocketSendQueueSettings& sendQueue,
+                                       std::shared_ptr<Websocket> websocket,
+                                       std::shared_ptr<TranslationServiceBalancer> balancer,
+                                       const std::string& userAgent)
+    : _impl(std::make_shared<Impl>(timerWheel, preferredFormat, coalescing,
+                                   sendQueue._dropPolicy, std::move(balancer), userAgent))
+{
+    if (websocket) {
+        _impl->SetWebsocket(std::move(websocket));
+    }
 }
 
 TranslatorEndPoint::~TranslatorEndPoint()
@@ -80,6 +235,31 @@ TranslatorEndPoint::~TranslatorEndPoint()
     _impl->FinalizeMedia();
 }
 
+std::shared_ptr<Websocket::Pool> TranslatorEndPoint::GetServicePool(const WebsocketPoolSettings& settings,
+                                                                     MediaFrameFormat preferredFormat,
+                                                                     const WebsocketSendQueueSettings& sendQueue,
+                                                                     const std::string& serviceUri,
+                                                                     const std::string& serviceUser,
+                                                                     const std::string& servicePassword,
+                                                                     const std::string& userAgent)
+{
+    return Websocket::GetPool(settings, serviceUri, serviceUser, servicePassword,
+                              GetHandshakeHeaders(preferredFormat), sendQueue, userAgent);
+}
+
+std::shared_ptr<TranslationServiceBalancer> TranslatorEndPoint::
+    CreateServiceBalancer(const std::vector<TranslationServiceHost>& hosts,
+                          const TranslationBalancingSettings& balancing,
+                          const WebsocketPoolSettings& poolSettings,
+                          MediaFrameFormat preferredFormat,
+                          const WebsocketSendQueueSettings& sendQueue,
+                          const std::string& userAgent)
+{
+    return TranslationServiceBalancer::Create(hosts, balancing, poolSettings,
+                                              GetHandshakeHeaders(preferredFormat),
+                                              sendQueue, userAgent);
+}
+
 void TranslatorEndPoint::Open()
 {
     _impl->Open();
@@ -110,9 +290,14 @@ void TranslatorEndPoint::SetInput(const std::shared_ptr<ProducerInputMediaStream
     _impl->SetInput(input);
 }
 
-void TranslatorEndPoint::SetOutput(const std::weak_ptr<RtpPacketsCollector>& outputRef)
+void TranslatorEndPoint::AddOutput(TranslatorEndPointSink* output)
 {
-    _impl->SetOutput(outputRef);
+    _impl->AddOutput(output);
+}
+
+void TranslatorEndPoint::RemoveOutput(TranslatorEndPointSink* output)
+{
+    _impl->RemoveOutput(output);
 }
 
 uint32_t TranslatorEndPoint::GetProducerInputSsrc() const
@@ -120,22 +305,93 @@ uint32_t TranslatorEndPoint::GetProducerInputSsrc() const
     return _impl->GetProducerInputSsrc();
 }
 
-TranslatorEndPoint::Impl::Impl(const std::weak_ptr<Websocket>& websocketRef, const std::string& userAgent)
-    : _websocketRef(websocketRef)
+MediaFrameFormat TranslatorEndPoint::GetMediaFormat() const
+{
+    return _impl->GetMediaFormat();
+}
+
+TranslationStats TranslatorEndPoint::GetStats() const
+{
+    auto stats = _impl->GetStats();
+    stats._uplink = GetSendStats();
+    stats._latency = _impl->GetLatencyStats(stats._uplink);
+    return stats;
+}
+
+WebsocketSendStats TranslatorEndPoint::GetSendStats() const
+{
+    return _impl->GetSendStats();
+}
+
+TranslationEndPointLatencyStats TranslatorEndPoint::GetLatencyStats() const
+{
+    return _impl->GetLatencyStats(GetSendStats());
+}
+
+TranslatorEndPoint::Impl::Impl(TimerWheel* timerWheel, MediaFrameFormat preferredFormat,
+                               const WriteCoalescingSettings& coalescing,
+                               WebsocketDropPolicy dropPolicy,
+                               std::shared_ptr<TranslationServiceBalancer> balancer,
+                               const std::string& userAgent)
+    : _timerWheel(timerWheel)
+    , _preferredFormat(preferredFormat)
+    , _dropPolicy(dropPolicy)
+    , _balancer(std::move(balancer))
     , _userAgent(userAgent)
+    , _context(IoContextPool::GetInstance().NextContext())
+    , _failoverTimer(*_context)
+    , _coalescer(std::make_shared<WriteCoalescer>(static_cast<WriteCoalescer::Listener*>(this), coalescing))
+    , _framesPool(std::make_shared<MemoryBufferPool>(_maxBufferedFrames))
+    , _deserializer(this, _framesPool)
+    , _player(this, _maxBufferedFrames)
 {
+    MS_ASSERT(_timerWheel, "timer wheel must not be null");
 }
 
 TranslatorEndPoint::Impl::~Impl()
 {
     FinalizeMedia();
+    // pending deadline of coalescer may outlive this instance
+    _coalescer->Stop();
+}
+
+void TranslatorEndPoint::Impl::SetWebsocket(std::shared_ptr<Websocket> websocket,
+                                            const std::optional<size_t>& host)
+{
+    if (websocket) {
+        websocket->SetListener(shared_from_this());
+    }
+    std::optional<size_t> previousHost;
+    {
+        LOCK_WRITE_PROTECTED_OBJ(_websocket);
+        websocket.swap(_websocket.Ref());
+        previousHost = std::exchange(_host, host);
+    }
+    // now it's the previous one, breaks the reference cycle with the listener
+    if (websocket) {
+        websocket->SetListener(nullptr);
+        websocket->Close();
+    }
+    if (previousHost && _balancer) {
+        _balancer->Release(previousHost.value());
+    }
+}
+
+WebsocketSendStats TranslatorEndPoint::Impl::GetSendStats() const
+{
+    if (const auto websocket = GetWebsocket()) {
+        return websocket->GetSendStats();
+    }
+    return WebsocketSendStats();
 }
 
 void TranslatorEndPoint::Impl::FinalizeMedia()
 {
     FinalizeMediaInput();
     SetInput(nullptr);
-    SetOutput(std::weak_ptr<RtpPacketsCollector>());
+    _player.Stop();
+    _outputs.Set(OutputsSet());
+    SetWebsocket(nullptr);
 }
 
 void TranslatorEndPoint::Impl::Open()
@@ -145,6 +401,7 @@ void TranslatorEndPoint::Impl::Open()
         if (_input.ConstRef()) {
             OpenWebsocket();
         }
+        PostFailoverCheck();
     }
 }
 
@@ -193,7 +450,7 @@ void TranslatorEndPoint::Impl::SetInput(const std::shared_ptr<ProducerInputMedia
             FinalizeMediaInput(_input.ConstRef());
             _input = input;
             changed = true;
-            if (input && IsConnected()) {
+            if (input && IsConnected() && !IsInputPaused()) {
                 InitializeMediaInput(input);
             }
         }
@@ -211,10 +468,46 @@ void TranslatorEndPoint::Impl::SetInput(const std::shared_ptr<ProducerInputMedia
     }
 }
 
-void TranslatorEndPoint::Impl::SetOutput(const std::weak_ptr<RtpPacketsCollector>& outputRef)
+void TranslatorEndPoint::Impl::AddOutput(TranslatorEndPointSink* output)
 {
-    LOCK_WRITE_PROTECTED_OBJ(_outputRef);
-    _outputRef = outputRef;
+    if (output) {
+        _outputs.Update([output](OutputsSet& outputs) {
+            return outputs.insert(output).second;
+        });
+        // play-out only while somebody listens
+        _player.Start(_timerWheel);
+    }
+}
+
+void TranslatorEndPoint::Impl::RemoveOutput(TranslatorEndPointSink* output)
+{
+    if (output) {
+        _outputs.Update([output](OutputsSet& outputs) {
+            return outputs.erase(output) > 0UL;
+        });
+        if (_outputs.Get()->empty()) {
+            _player.Stop();
+        }
+    }
+}
+
+TranslationEndPointLatencyStats TranslatorEndPoint::Impl::GetLatencyStats(const WebsocketSendStats& sendStats) const
+{
+    TranslationEndPointLatencyStats stats;
+    stats._languageTo = GetConsumerLanguage();
+    stats._voice = GetConsumerVoice();
+    stats._socketWrite = sendStats._writeLatencyHistogram;
+    stats._firstResponse = _firstResponse.GetSnapshot();
+    stats._sentMessages = sendStats._sentMessages;
+    stats._sentBytes = sendStats._sentBytes;
+    stats._droppedMessages = sendStats._droppedMessages;
+    stats._receivedMessages = _receivedMessages.load(std::memory_order_relaxed);
+    stats._receivedBytes = _receivedBytes.load(std::memory_order_relaxed);
+    const auto connections = _connections.load(std::memory_order_relaxed);
+    stats._reconnects = connections > 0ULL ? connections - 1ULL : 0ULL;
+    stats._connect = _connect.GetSnapshot();
+    stats._failovers = _failovers.load(std::memory_order_relaxed);
+    return stats;
 }
 
 uint32_t TranslatorEndPoint::Impl::GetProducerInputSsrc() const
@@ -229,19 +522,27 @@ uint32_t TranslatorEndPoint::Impl::GetProducerInputSsrc() const
 void TranslatorEndPoint::Impl::OnStateChanged(uint64_t socketId, WebsocketState state)
 {
     WebsocketListener::OnStateChanged(socketId, state);
-    switch (state) {
-        case WebsocketState::Connected:
-            _connected = true;
-            if (SendTranslationChanges()) {
-                InitializeMediaInput();
-            }
-            break;
-        case WebsocketState::Disconnected:
-            _connected = false;
-            FinalizeMediaInput();
-            break;
-        default:
-            break;
+    if (IsCurrentWebsocket(socketId)) {
+        switch (state) {
+            case WebsocketState::Connected:
+                OnConnected();
+                break;
+            case WebsocketState::Disconnected:
+                OnDisconnected();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void TranslatorEndPoint::Impl::OnFailed(uint64_t socketId, FailureType type, std::string what)
+{
+    WebsocketListener::OnFailed(socketId, type, std::move(what));
+    if (_balancer && IsCurrentWebsocket(socketId)) {
+        if (const auto host = GetHost()) {
+            _balancer->OnSessionFailed(host.value());
+        }
     }
 }
 
@@ -249,15 +550,70 @@ void TranslatorEndPoint::Impl::OnTextMessageReceived(uint64_t /*socketId*/, std:
 {
 }
 
-void TranslatorEndPoint::Impl::OnBinaryMessageReceved(uint64_t /*socketId*/,
-                                                      const std::shared_ptr<MemoryBuffer>& /*message*/)
+void TranslatorEndPoint::Impl::OnBinaryMessageReceved(uint64_t socketId,
+                                                      const std::shared_ptr<MemoryBuffer>& message)
+{
+    if (message && IsCurrentWebsocket(socketId)) {
+        _receivedMessages.fetch_add(1ULL, std::memory_order_relaxed);
+        _receivedBytes.fetch_add(message->GetSize(), std::memory_order_relaxed);
+        if (const auto startUs = _pendingRequestUs.exchange(0ULL)) {
+            _firstResponse.AddSince(startUs);
+        }
+        if (!_deserializer.AddBuffer(message)) {
+            MS_ERROR("failed to parse translated media from the service");
+        }
+    }
+}
+
+void TranslatorEndPoint::Impl::OnSendQueueCongestion(uint64_t socketId, bool congested,
+                                                    const WebsocketSendStats& stats)
+{
+    WebsocketListener::OnSendQueueCongestion(socketId, congested, stats);
+    if (!IsCurrentWebsocket(socketId)) {
+        return;
+    }
+    if (congested) {
+        MS_WARN_DEV("translation service is too slow, input is paused, %u bytes queued",
+                    stats._queuedBytes);
+    }
+    if (congested != _inputPaused.exchange(congested)) {
+        PostUpdateMediaInput();
+    }
+}
+
+std::shared_ptr<Websocket> TranslatorEndPoint::Impl::GetWebsocket() const
+{
+    LOCK_READ_PROTECTED_OBJ(_websocket);
+    return _websocket.ConstRef();
+}
+
+bool TranslatorEndPoint::Impl::IsCurrentWebsocket(uint64_t socketId) const
 {
+    const auto websocket = GetWebsocket();
+    return websocket && socketId == websocket->GetId();
+}
+
+std::optional<size_t> TranslatorEndPoint::Impl::GetHost() const
+{
+    LOCK_READ_PROTECTED_OBJ(_websocket);
+    return _host;
 }
 
 void TranslatorEndPoint::Impl::OpenWebsocket()
 {
-    if (const auto websocket = _websocketRef.lock()) {
+    auto websocket = GetWebsocket();
+    if (!websocket && _balancer) {
+        size_t host = 0UL;
+        if ((websocket = _balancer->Acquire(std::nullopt, host))) {
+            SetWebsocket(websocket, host);
+        }
+    }
+    if (websocket) {
+        if (WebsocketState::Disconnected == websocket->GetState()) {
+            _openingUs = LatencyHistogram::NowUs();
+        }
         if (!websocket->Open(_userAgent)) {
+            _openingUs = 0ULL;
             MS_ERROR("failed to open websocket");
         }
     }
@@ -265,8 +621,191 @@ void TranslatorEndPoint::Impl::OpenWebsocket()
 
 void TranslatorEndPoint::Impl::CloseWebsocket()
 {
-    if (const auto websocket = _websocketRef.lock()) {
+    if (const auto websocket = GetWebsocket()) {
+        // tail of media shouldn't be lost
+        _coalescer->Flush();
         websocket->Close();
+        if (_balancer) {
+            // the next session may go to another host
+            SetWebsocket(nullptr);
+        }
+    }
+}
+
+void TranslatorEndPoint::Impl::OnConnected()
+{
+    // translated media of the new connection starts from EBML header
+    _deserializer.Reset();
+    _coalescer->Reset();
+    _mediaFormat = NegotiateMediaFormat();
+    ApplyDropPolicy(GetMediaFormat());
+    _inputPaused = false;
+    _pendingRequestUs = 0ULL;
+    if (const auto openingUs = _openingUs.exchange(0ULL)) {
+        _connect.AddSince(openingUs);
+    }
+    _connections.fetch_add(1ULL, std::memory_order_relaxed);
+    if (_balancer) {
+        if (const auto host = GetHost()) {
+            _balancer->OnSessionConnected(host.value());
+        }
+    }
+    _connected = true;
+    // also replays languages & voice after failover
+    if (SendTranslationChanges()) {
+        InitializeMediaInput();
+    }
+}
+
+void TranslatorEndPoint::Impl::OnDisconnected()
+{
+    _connected = false;
+    FinalizeMediaInput();
+    _coalescer->Reset();
+    _pendingRequestUs = 0ULL;
+}
+
+void TranslatorEndPoint::Impl::PostFailoverCheck()
+{
+    if (_balancer) {
+        asio::post(*_context, [weakSelf = weak_from_this()]() {
+            if (const auto self = weakSelf.lock()) {
+                self->ScheduleFailoverCheck();
+            }
+        });
+    }
+}
+
+void TranslatorEndPoint::Impl::ScheduleFailoverCheck()
+{
+    if (IsWantsToOpen()) {
+        // previous wait is cancelled, so there is the single chain of checks
+        _failoverTimer.expires_after(_failoverCheckInterval);
+        _failoverTimer.async_wait([weakSelf = weak_from_this()](const asio::error_code& error) {
+            if (!error) {
+                if (const auto self = weakSelf.lock()) {
+                    self->CheckFailover();
+                    self->ScheduleFailoverCheck();
+                }
+            }
+        });
+    }
+}
+
+void TranslatorEndPoint::Impl::CheckFailover()
+{
+    if (!IsWantsToOpen()) {
+        return;
+    }
+    {
+        LOCK_READ_PROTECTED_OBJ(_input);
+        if (!_input.ConstRef()) {
+            return;
+        }
+    }
+    if (const auto websocket = GetWebsocket()) {
+        switch (websocket->GetState()) {
+            case WebsocketState::Disconnected:
+                MS_WARN_TAG(rtp, "connection with translation service is lost");
+                Migrate(websocket);
+                break;
+            case WebsocketState::Connected:
+                // the same host is chosen again if it's the single one, no reason to reconnect
+                if (const auto maxLatencyMs = _balancer->GetSettings()._failoverWriteLatencyMs;
+                    maxLatencyMs && _balancer->GetHostsCount() > 1UL) {
+                    const auto stats = websocket->GetSendStats();
+                    const auto latencyMs = std::max(stats._writeLatencyMs,
+                                                    static_cast<double>(stats._queueDelayMs));
+                    if (latencyMs > maxLatencyMs) {
+                        MS_WARN_TAG(rtp, "write latency of translation service is too high: %f ms",
+                                    latencyMs);
+                        Migrate(websocket);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    else {
+        OpenWebsocket();
+    }
+}
+
+void TranslatorEndPoint::Impl::Migrate(const std::shared_ptr<Websocket>& websocket)
+{
+    std::optional<size_t> host;
+    {
+        LOCK_READ_PROTECTED_OBJ(_websocket);
+        if (websocket != _websocket.ConstRef()) {
+            return; // already replaced
+        }
+        host = _host;
+    }
+    if (host) {
+        _balancer->OnSessionFailed(host.value());
+    }
+    size_t next = 0UL;
+    if (auto replacement = _balancer->Acquire(host, next)) {
+        MS_WARN_TAG(rtp, "translation session is migrated from %s to %s",
+                    host ? _balancer->GetHostUri(host.value()).c_str() : "",
+                    _balancer->GetHostUri(next).c_str());
+        // the previous websocket doesn't report disconnection after the replacement
+        SetWebsocket(std::move(replacement), next);
+        OnDisconnected();
+        _failovers.fetch_add(1ULL, std::memory_order_relaxed);
+        OpenWebsocket();
+    }
+}
+
+MediaFrameFormat TranslatorEndPoint::Impl::NegotiateMediaFormat() const
+{
+    if (DefaultMediaFrameFormat() != _preferredFormat) {
+        if (const auto websocket = GetWebsocket()) {
+            const auto answer = websocket->GetResponseHeader(g_mediaFormatAnswerHeader);
+            if (_preferredFormat == MediaFrameFormatFromString(answer)) {
+                return _preferredFormat;
+            }
+            MS_WARN_DEV("service doesn't support %s media format, fallback to %s",
+                        MediaFrameFormatToString(_preferredFormat).data(),
+                        MediaFrameFormatToString(DefaultMediaFrameFormat()).data());
+        }
+    }
+    return DefaultMediaFrameFormat();
+}
+
+void TranslatorEndPoint::Impl::ApplyDropPolicy(MediaFrameFormat format)
+{
+    if (const auto websocket = GetWebsocket()) {
+        // dropped messages break WebM container, so reconnection is the only option there,
+        // raw records are self-contained, Ogg pages too - reader resyncs on the next
+        // page and sees the gap of page sequence numbers
+        if (MediaFrameFormat::WebM == format) {
+            websocket->SetDropPolicy(WebsocketDropPolicy::Disconnect);
+        }
+        else {
+            websocket->SetDropPolicy(_dropPolicy);
+        }
+    }
+}
+
+void TranslatorEndPoint::Impl::PostUpdateMediaInput()
+{
+    asio::post(*_context, [weakSelf = weak_from_this()]() {
+        if (const auto self = weakSelf.lock()) {
+            self->UpdateMediaInput();
+        }
+    });
+}
+
+void TranslatorEndPoint::Impl::UpdateMediaInput()
+{
+    LOCK_READ_PROTECTED_OBJ(_input);
+    if (IsConnected() && !IsInputPaused()) {
+        InitializeMediaInput(_input.ConstRef());
+    }
+    else {
+        FinalizeMediaInput(_input.ConstRef());
     }
 }
 
@@ -279,7 +818,9 @@ void TranslatorEndPoint::Impl::InitializeMediaInput()
 void TranslatorEndPoint::Impl::InitializeMediaInput(const std::shared_ptr<ProducerInputMediaStreamer>& input)
 {
     if (input) {
-        if (!input->AddOutputDevice(this)) {
+        // referenced by the input until its serialization thread is done with this device
+        const std::shared_ptr<OutputDevice> outputDevice(shared_from_this(), static_cast<OutputDevice*>(this));
+        if (!input->AddOutputDevice(outputDevice, GetMediaFormat())) {
             MS_ERROR("failed subscribe to input media stream");
         }
     }
@@ -311,7 +852,7 @@ bool TranslatorEndPoint::Impl::SendTranslationChanges()
 bool TranslatorEndPoint::Impl::WriteJson(const nlohmann::json& data)
 {
     bool ok = false;
-    if (const auto websocket = _websocketRef.lock()) {
+    if (const auto websocket = GetWebsocket()) {
         const auto jsonAsText = to_string(data);
         ok = websocket->WriteText(jsonAsText);
         if (!ok) {
@@ -335,6 +876,8 @@ void TranslatorEndPoint::Impl::BeginWriteMediaPayload(uint32_t ssrc, bool isKeyF
 {
     if (IsConnected()) {
         // TODO: send JSON command
+        _coalescer->BeginWriteMediaPayload(ssrc, isKeyFrame, codecMimeType,
+                                           rtpSequenceNumber, rtpTimestamp, rtpAbsSendtime);
     }
 }
 
@@ -342,18 +885,47 @@ void TranslatorEndPoint::Impl::EndWriteMediaPayload(uint32_t ssrc, bool ok)
 {
     if (IsConnected()) {
         // TODO: send JSON command
+        _coalescer->EndWriteMediaPayload(ssrc, ok);
     }
 }
 
 void TranslatorEndPoint::Impl::Write(const std::shared_ptr<const MemoryBuffer>& buffer)
 {
     if (buffer && IsConnected()) {
-        if (const auto websocket = _websocketRef.lock()) {
-            if (!websocket->WriteBinary(buffer)) {
+        if (!_pendingRequestUs.load(std::memory_order_relaxed)) {
+            uint64_t expected = 0ULL;
+            _pendingRequestUs.compare_exchange_strong(expected, LatencyHistogram::NowUs());
+        }
+        _coalescer->Write(buffer);
+    }
+}
+
+void TranslatorEndPoint::Impl::OnCoalescedWrite(const std::shared_ptr<const MemoryBuffer>& buffer,
+                                                bool hasKeyFrame)
+{
+    if (IsConnected()) {
+        if (const auto websocket = GetWebsocket()) {
+            if (!websocket->WriteBinary(buffer, hasKeyFrame)) {
                 MS_ERROR("failed write binary buffer into into translation service");
             }
         }
     }
 }
 
+void TranslatorEndPoint::Impl::OnMediaFrame(const RtpCodecMimeType& /*mime*/, uint64_t timestampMs,
+                                            const std::shared_ptr<const MemoryBuffer>& payload)
+{
+    _player.Push(payload, timestampMs);
+}
+
+void TranslatorEndPoint::Impl::OnPlayFrame(const std::shared_ptr<const MemoryBuffer>& frame,
+                                           bool newSequence, uint64_t nowMs)
+{
+    if (const auto outputs = _outputs.Get()) {
+        for (const auto output : *outputs) {
+            output->OnTranslatedFrame(frame, newSequence, nowMs);
+        }
+    }
+}
+
 } // namespace RTC
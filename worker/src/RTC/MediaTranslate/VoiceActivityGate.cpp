@@ -0,0 +1,90 @@
+#include "RTC/MediaTranslate/VoiceActivityGate.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "MemoryBuffer.hpp"
+
+namespace RTC
+{
+
+VoiceActivityGate::VoiceActivityGate(const VoiceActivitySettings& settings)
+    : _settings(settings)
+{
+}
+
+void VoiceActivityGate::Push(const std::shared_ptr<RtpMediaFrame>& frame,
+                             const std::optional<AudioLevel>& audioLevel, Frames& output)
+{
+    if (!frame) {
+        return;
+    }
+    if (!_settings._enabled) {
+        output.push_back(frame);
+        return;
+    }
+    const auto timestamp = frame->GetTimestamp();
+    const auto sampleRate = frame->GetSampleRate();
+    if (IsSpeech(*frame, audioLevel)) {
+        _lastSpeechTimestamp = timestamp;
+        if (!_open) {
+            _open = true;
+            _speechSegments.fetch_add(1ULL, std::memory_order_relaxed);
+            output.insert(output.end(), _preRoll.begin(), _preRoll.end());
+            _preRoll.clear();
+        }
+        output.push_back(frame);
+    }
+    else if (_open && GetElapsedMs(_lastSpeechTimestamp, timestamp, sampleRate) <= _settings._hangoverMs) {
+        output.push_back(frame);
+    }
+    else {
+        _open = false;
+        _preRoll.push_back(frame);
+        while (!_preRoll.empty() &&
+               GetElapsedMs(_preRoll.front()->GetTimestamp(), timestamp, sampleRate) >= _settings._preRollMs) {
+            Gate(_preRoll.front());
+            _preRoll.pop_front();
+        }
+    }
+}
+
+void VoiceActivityGate::Reset()
+{
+    for (const auto& frame : _preRoll) {
+        Gate(frame);
+    }
+    _preRoll.clear();
+    _open = false;
+}
+
+bool VoiceActivityGate::IsSpeech(const RtpMediaFrame& frame,
+                                 const std::optional<AudioLevel>& audioLevel) const
+{
+    const auto& payload = frame.GetPayload();
+    if (!payload || payload->GetSize() <= _settings._maxSilenceFrameSize) {
+        return false;
+    }
+    if (audioLevel) {
+        // V flag is set by senders with own VAD, level is the fallback
+        return audioLevel->_voice || audioLevel->_level <= _settings._speechLevel;
+    }
+    return true;
+}
+
+uint64_t VoiceActivityGate::GetElapsedMs(uint32_t fromTimestamp, uint32_t toTimestamp, uint32_t sampleRate)
+{
+    // RTP timestamps wrap around
+    const auto diff = static_cast<int32_t>(toTimestamp - fromTimestamp);
+    if (diff > 0 && sampleRate) {
+        return static_cast<uint64_t>(diff) * 1000ULL / sampleRate;
+    }
+    return 0ULL;
+}
+
+void VoiceActivityGate::Gate(const std::shared_ptr<RtpMediaFrame>& frame)
+{
+    _gatedFrames.fetch_add(1ULL, std::memory_order_relaxed);
+    if (const auto& payload = frame->GetPayload()) {
+        _gatedBytes.fetch_add(payload->GetSize(), std::memory_order_relaxed);
+    }
+}
+
+} // namespace RTC
@@ -0,0 +1,300 @@
+#define MS_CLASS "RTC::WebMDeserializer"
+#include "RTC/MediaTranslate/WebMDeserializer.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "Logger.hpp"
+#include <webm/callback.h>
+#include <webm/reader.h>
+#include <webm/status.h>
+#include <webm/webm_parser.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <optional>
+
+namespace {
+
+inline webm::Status MakeStatus(std::int32_t code) {
+    return webm::Status(code);
+}
+
+}
+
+namespace RTC
+{
+
+// non-blocking reader over received chunks, returns kWouldBlock if input is exhausted,
+// so the parser suspends and resumes from the same point when the next chunk arrives
+class WebMDeserializer::Reader : public webm::Reader
+{
+public:
+    Reader() = default;
+    void Append(const std::shared_ptr<const MemoryBuffer>& buffer);
+    void Clear();
+    bool IsEmpty() const { return _buffers.empty(); }
+    // impl. of webm::Reader
+    webm::Status Read(std::size_t numToRead, std::uint8_t* buffer,
+                      std::uint64_t* numActuallyRead) final;
+    webm::Status Skip(std::uint64_t numToSkip, std::uint64_t* numActuallySkipped) final;
+    std::uint64_t Position() const final { return _position; }
+private:
+    // copy (if [buffer] is not null) or skip up to [len] bytes
+    std::uint64_t Consume(std::uint64_t len, std::uint8_t* buffer);
+private:
+    std::deque<std::shared_ptr<const MemoryBuffer>> _buffers;
+    // offset in the front buffer
+    size_t _offset = 0UL;
+    std::uint64_t _position = 0ULL;
+};
+
+class WebMDeserializer::Callback : public webm::Callback
+{
+public:
+    Callback(Listener* listener, const std::shared_ptr<MemoryBufferPool>& buffersPool);
+    void Reset();
+    // impl. of webm::Callback
+    webm::Status OnInfo(const webm::ElementMetadata& metadata, const webm::Info& info) final;
+    webm::Status OnTrackEntry(const webm::ElementMetadata& metadata,
+                              const webm::TrackEntry& trackEntry) final;
+    webm::Status OnClusterBegin(const webm::ElementMetadata& metadata,
+                                const webm::Cluster& cluster, webm::Action* action) final;
+    webm::Status OnSimpleBlockBegin(const webm::ElementMetadata& metadata,
+                                    const webm::SimpleBlock& simpleBlock,
+                                    webm::Action* action) final;
+    webm::Status OnBlockBegin(const webm::ElementMetadata& metadata,
+                              const webm::Block& block, webm::Action* action) final;
+    webm::Status OnFrame(const webm::FrameMetadata& metadata, webm::Reader* reader,
+                         std::uint64_t* bytesRemaining) final;
+private:
+    webm::Action BeginBlock(const webm::Block& block);
+    std::shared_ptr<SimpleMemoryBuffer> AllocateFrame(size_t size) const;
+private:
+    static inline const RtpCodecMimeType _opusMime = {RtpCodecMimeType::Type::AUDIO,
+                                                      RtpCodecMimeType::Subtype::OPUS};
+    Listener* const _listener;
+    const std::shared_ptr<MemoryBufferPool> _buffersPool;
+    // nanoseconds per timecode unit
+    std::uint64_t _timecodeScale = 1000000ULL;
+    std::optional<std::uint64_t> _trackNumber;
+    std::uint64_t _clusterTimecode = 0ULL;
+    std::uint64_t _blockTimestampMs = 0ULL;
+    // partially read frame
+    std::shared_ptr<SimpleMemoryBuffer> _frame;
+};
+
+WebMDeserializer::WebMDeserializer(Listener* listener,
+                                   const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : _reader(std::make_unique<Reader>())
+    , _callback(std::make_unique<Callback>(listener, buffersPool))
+    , _parser(std::make_unique<webm::WebmParser>())
+{
+    MS_ASSERT(listener, "listener must not be null");
+}
+
+WebMDeserializer::~WebMDeserializer()
+{
+}
+
+bool WebMDeserializer::AddBuffer(const std::shared_ptr<const MemoryBuffer>& buffer)
+{
+    if (buffer && !buffer->IsEmpty()) {
+        _reader->Append(buffer);
+        while (true) {
+            const auto status = _parser->Feed(_callback.get(), _reader.get());
+            if (webm::Status::kWouldBlock == status.code) {
+                break;
+            }
+            if (!status.completed_ok()) {
+                MS_ERROR("WebM parsing failed, status code: %d", static_cast<int>(status.code));
+                Reset();
+                return false;
+            }
+            // end of stream, the next one may follow in the same chunk
+            _parser = std::make_unique<webm::WebmParser>();
+            _callback->Reset();
+            if (_reader->IsEmpty()) {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+void WebMDeserializer::Reset()
+{
+    _reader->Clear();
+    _callback->Reset();
+    _parser = std::make_unique<webm::WebmParser>();
+}
+
+void WebMDeserializer::Reader::Append(const std::shared_ptr<const MemoryBuffer>& buffer)
+{
+    if (buffer && !buffer->IsEmpty()) {
+        _buffers.push_back(buffer);
+    }
+}
+
+void WebMDeserializer::Reader::Clear()
+{
+    _buffers.clear();
+    _offset = 0UL;
+    _position = 0ULL;
+}
+
+webm::Status WebMDeserializer::Reader::Read(std::size_t numToRead, std::uint8_t* buffer,
+                                            std::uint64_t* numActuallyRead)
+{
+    *numActuallyRead = Consume(numToRead, buffer);
+    if (*numActuallyRead == numToRead) {
+        return MakeStatus(webm::Status::kOkCompleted);
+    }
+    return MakeStatus(*numActuallyRead ? webm::Status::kOkPartial : webm::Status::kWouldBlock);
+}
+
+webm::Status WebMDeserializer::Reader::Skip(std::uint64_t numToSkip,
+                                            std::uint64_t* numActuallySkipped)
+{
+    *numActuallySkipped = Consume(numToSkip, nullptr);
+    if (*numActuallySkipped == numToSkip) {
+        return MakeStatus(webm::Status::kOkCompleted);
+    }
+    return MakeStatus(*numActuallySkipped ? webm::Status::kOkPartial : webm::Status::kWouldBlock);
+}
+
+std::uint64_t WebMDeserializer::Reader::Consume(std::uint64_t len, std::uint8_t* buffer)
+{
+    std::uint64_t consumed = 0ULL;
+    while (consumed < len && !_buffers.empty()) {
+        const auto& front = _buffers.front();
+        const auto available = front->GetSize() - _offset;
+        const auto size = static_cast<size_t>(std::min<std::uint64_t>(len - consumed, available));
+        if (buffer) {
+            std::memcpy(buffer + consumed, front->GetData() + _offset, size);
+        }
+        consumed += size;
+        if (size == available) {
+            _buffers.pop_front();
+            _offset = 0UL;
+        }
+        else {
+            _offset += size;
+        }
+    }
+    _position += consumed;
+    return consumed;
+}
+
+WebMDeserializer::Callback::Callback(Listener* listener,
+                                     const std::shared_ptr<MemoryBufferPool>& buffersPool)
+    : _listener(listener)
+    , _buffersPool(buffersPool)
+{
+}
+
+void WebMDeserializer::Callback::Reset()
+{
+    _timecodeScale = 1000000ULL;
+    _trackNumber.reset();
+    _clusterTimecode = _blockTimestampMs = 0ULL;
+    _frame.reset();
+}
+
+webm::Status WebMDeserializer::Callback::OnInfo(const webm::ElementMetadata& /*metadata*/,
+                                                const webm::Info& info)
+{
+    if (info.timecode_scale.is_present() && info.timecode_scale.value()) {
+        _timecodeScale = info.timecode_scale.value();
+    }
+    return MakeStatus(webm::Status::kOkCompleted);
+}
+
+webm::Status WebMDeserializer::Callback::OnTrackEntry(const webm::ElementMetadata& /*metadata*/,
+                                                      const webm::TrackEntry& trackEntry)
+{
+    if (!_trackNumber.has_value() && webm::TrackType::kAudio == trackEntry.track_type.value()) {
+        if ("A_OPUS" == trackEntry.codec_id.value()) {
+            _trackNumber = trackEntry.track_number.value();
+        }
+        else {
+            MS_WARN_DEV("unsupported audio codec %s", trackEntry.codec_id.value().c_str());
+        }
+    }
+    return MakeStatus(webm::Status::kOkCompleted);
+}
+
+webm::Status WebMDeserializer::Callback::OnClusterBegin(const webm::ElementMetadata& /*metadata*/,
+                                                        const webm::Cluster& cluster,
+                                                        webm::Action* action)
+{
+    _clusterTimecode = cluster.timecode.value();
+    *action = webm::Action::kRead;
+    return MakeStatus(webm::Status::kOkCompleted);
+}
+
+webm::Status WebMDeserializer::Callback::OnSimpleBlockBegin(const webm::ElementMetadata& /*metadata*/,
+                                                            const webm::SimpleBlock& simpleBlock,
+                                                            webm::Action* action)
+{
+    *action = BeginBlock(simpleBlock);
+    return MakeStatus(webm::Status::kOkCompleted);
+}
+
+webm::Status WebMDeserializer::Callback::OnBlockBegin(const webm::ElementMetadata& /*metadata*/,
+                                                      const webm::Block& block,
+                                                      webm::Action* action)
+{
+    *action = BeginBlock(block);
+    return MakeStatus(webm::Status::kOkCompleted);
+}
+
+webm::Status WebMDeserializer::Callback::OnFrame(const webm::FrameMetadata& metadata,
+                                                 webm::Reader* reader,
+                                                 std::uint64_t* bytesRemaining)
+{
+    if (!_frame) {
+        _frame = AllocateFrame(static_cast<size_t>(metadata.size));
+        _frame->Resize(static_cast<size_t>(metadata.size));
+    }
+    webm::Status status = MakeStatus(webm::Status::kOkCompleted);
+    while (*bytesRemaining) {
+        const auto offset = static_cast<size_t>(metadata.size - *bytesRemaining);
+        std::uint64_t read = 0ULL;
+        status = reader->Read(static_cast<std::size_t>(*bytesRemaining),
+                              _frame->GetData() + offset, &read);
+        *bytesRemaining -= read;
+        if (webm::Status::kOkPartial != status.code) {
+            break;
+        }
+    }
+    if (0ULL == *bytesRemaining) {
+        const std::shared_ptr<const MemoryBuffer> frame = std::move(_frame);
+        _listener->OnMediaFrame(_opusMime, _blockTimestampMs, frame);
+        return MakeStatus(webm::Status::kOkCompleted);
+    }
+    return status;
+}
+
+webm::Action WebMDeserializer::Callback::BeginBlock(const webm::Block& block)
+{
+    if (_trackNumber.has_value() && block.track_number == _trackNumber.value()) {
+        // block timecode is signed and relative to the cluster
+        const auto timecode = static_cast<std::int64_t>(_clusterTimecode) + block.timecode;
+        const auto timestampNs = static_cast<std::uint64_t>(std::max<std::int64_t>(0LL, timecode)) * _timecodeScale;
+        _blockTimestampMs = timestampNs / 1000000ULL;
+        return webm::Action::kRead;
+    }
+    return webm::Action::kSkip;
+}
+
+std::shared_ptr<SimpleMemoryBuffer> WebMDeserializer::Callback::AllocateFrame(size_t size) const
+{
+    if (_buffersPool) {
+        return _buffersPool->Allocate(size);
+    }
+    auto frame = std::make_shared<SimpleMemoryBuffer>();
+    frame->Reserve(size);
+    return frame;
+}
+
+} // namespace RTC
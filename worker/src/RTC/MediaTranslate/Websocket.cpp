@@ -1,31 +1,37 @@
 #define MS_CLASS "Websocket"
 #include "RTC/MediaTranslate/Websocket.hpp"
 #include "RTC/MediaTranslate/WebsocketListener.hpp"
+#include "RTC/MediaTranslate/WebsocketMessagePool.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueue.hpp"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
 #include "Logger.hpp"
+#include "Settings.hpp"
 #include "Utils.hpp"
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
 #include <websocketpp/close.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace {
 
-class StringMemoryBuffer : public RTC::MemoryBuffer
-{
-public:
-    StringMemoryBuffer(std::string payload);
-    size_t GetSize() const final { return _payload.size(); }
-    uint8_t* GetData() final;
-    const uint8_t* GetData() const final;
-private:
-    std::string _payload;
-};
+// received & sent messages are reused by connection, see WebsocketMessagePool
+using TlsClientConfig = RTC::WebsocketPooledConfig<websocketpp::config::asio_tls_client>;
+using NoTlsClientConfig = RTC::WebsocketPooledConfig<websocketpp::config::asio_client>;
 
 class LogStreamBuf : public std::streambuf
 {
 public:
-    LogStreamBuf(uint64_t socketId, LogLevel level);
+    // [socketId] is changed when a warm session of pool is taken
+    LogStreamBuf(const std::atomic<uint64_t>& socketId, LogLevel level);
     static bool IsAccepted(LogLevel level);
     static void Write(LogLevel level, std::string message);
     static void Write(LogLevel level, uint64_t socketId, std::string message);
@@ -35,7 +41,7 @@ protected:
     std::streamsize xsputn(const char* s, std::streamsize count) final;
     int sync() final;
 private:
-    const uint64_t _socketId;
+    const std::atomic<uint64_t>& _socketId;
     const LogLevel _level;
     std::string _buffer;
 };
@@ -60,6 +66,11 @@ inline std::string ToString(RTC::WebsocketListener::FailureType failure) {
     return "unknown";
 }
 
+inline uint64_t GetSteadyTimeMs() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
 inline std::string ToString(RTC::WebsocketState state) {
     switch (state) {
         case RTC::WebsocketState::Invalid:
@@ -81,10 +92,6 @@ inline std::string ToString(RTC::WebsocketState state) {
 namespace RTC
 {
 
-using websocketpp::lib::placeholders::_1;
-using websocketpp::lib::placeholders::_2;
-using websocketpp::lib::bind;
-
 class Websocket::Config
 {
 public:
@@ -92,12 +99,14 @@ public:
                                                         const std::string& user,
                                                         const std::string& password,
                                                         std::unordered_map<std::string, std::string> headers,
+                                                        const WebsocketSendQueueSettings& sendQueueSettings,
                                                         std::string tlsTrustStore,
                                                         std::string tlsKeyStore,
                                                         std::string tlsPrivateKey,
                                                         std::string tlsPrivateKeyPassword);
     Config(const std::shared_ptr<websocketpp::uri>& uri,
            std::unordered_map<std::string, std::string> headers,
+           const WebsocketSendQueueSettings& sendQueueSettings,
            std::string tlsTrustStore,
            std::string tlsKeyStore,
            std::string tlsPrivateKey,
@@ -105,17 +114,43 @@ public:
     bool IsSecure() const { return _uri->get_secure(); }
     const std::shared_ptr<websocketpp::uri>& GetUri() const { return _uri; }
     const std::unordered_map<std::string, std::string>& GetHeaders() const { return _headers; }
+    const WebsocketSendQueueSettings& GetSendQueueSettings() const { return _sendQueueSettings; }
     const std::string& GetTlsTrustStore() const { return _tlsTrustStore; }
     const std::string& GetTlsKeyStore() const { return _tlsKeyStore; }
     const std::string& GetTlsPrivateKey() const { return _tlsPrivateKey; }
     const std::string& GetTlsPrivateKeyPassword() const { return _tlsPrivateKeyPassword; }
+    // created on first call and shared by all connections of this config, null for insecure URI,
+    // [error] is set if TLS options were not applied
+    std::shared_ptr<TlsContext> GetTlsContext(std::string& error) const;
+private:
+    std::shared_ptr<TlsContext> CreateTlsContext(std::string& error) const;
 private:
     const std::shared_ptr<websocketpp::uri> _uri;
     const std::unordered_map<std::string, std::string> _headers;
+    const WebsocketSendQueueSettings _sendQueueSettings;
     const std::string _tlsTrustStore;
     const std::string _tlsKeyStore;
     const std::string _tlsPrivateKey;
     const std::string _tlsPrivateKeyPassword;
+    mutable std::once_flag _tlsContextOnce;
+    mutable std::shared_ptr<TlsContext> _tlsContext;
+    mutable std::string _tlsContextError;
+};
+
+// OpenSSL doesn't resume client sessions by itself, so the last session (ticket)
+// given by the service is applied to new connections, the service falls back
+// to full handshake if it doesn't accept it
+class Websocket::TlsContext : public asio::ssl::context
+{
+public:
+    TlsContext();
+    ~TlsContext();
+    void ResumeSession(SSL* ssl) const;
+private:
+    static int OnNewSession(SSL* ssl, SSL_SESSION* session);
+private:
+    mutable std::mutex _sessionMutex;
+    SSL_SESSION* _session = nullptr;
 };
 
 class Websocket::Socket
@@ -123,43 +158,69 @@ class Websocket::Socket
 public:
     virtual ~Socket() = default;
     virtual WebsocketState GetState() = 0;
-    virtual void Run() = 0;
     virtual bool Open(const std::string& userAgent) = 0;
     virtual void Close() = 0;
-    virtual bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer) = 0;
+    virtual bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer, bool isKeyFrame) = 0;
     virtual bool WriteText(const std::string& text) = 0;
+    virtual std::string GetResponseHeader(const std::string& name) = 0;
+    virtual WebsocketSendStats GetSendStats() const = 0;
+    virtual void SetDropPolicy(WebsocketDropPolicy policy) = 0;
     virtual void SetListener(const std::weak_ptr<WebsocketListener>& listener) = 0;
+    // ID is passed to the listener, changed when a warm session of pool is taken
+    virtual void SetId(uint64_t id) = 0;
+    // report connected state to the listener asynchronously if the connection is still opened,
+    // for sessions which were connected before assignment of the listener
+    virtual void ReportOpened() = 0;
     static std::shared_ptr<Socket> Create(uint64_t id, const std::shared_ptr<const Config>& config);
 };
 
 template<class TConfig>
-class Websocket::SocketImpl : public Socket
+class Websocket::SocketImpl : public Socket,
+                              public std::enable_shared_from_this<SocketImpl<TConfig>>
 {
     using Client = websocketpp::client<TConfig>;
     using MessagePtr = typename TConfig::message_type::ptr;
 public:
-    ~SocketImpl() override { Close(); }
+    ~SocketImpl() override;
+    // must be called after construction, handlers refers to weak pointer of this socket
+    virtual void Init();
     // impl. of Socket
     WebsocketState GetState() final;
-    void Run() final;
     bool Open(const std::string& userAgent) final;
     void Close() final;
-    bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer) final;
+    bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer, bool isKeyFrame) final;
     bool WriteText(const std::string& text) final;
+    std::string GetResponseHeader(const std::string& name) final;
+    WebsocketSendStats GetSendStats() const final;
+    void SetDropPolicy(WebsocketDropPolicy policy) final { _sendQueue.SetDropPolicy(policy); }
     void SetListener(const std::weak_ptr<WebsocketListener>& listener) final;
+    void SetId(uint64_t id) final { _id.store(id, std::memory_order_relaxed); }
+    void ReportOpened() final;
 protected:
     SocketImpl(uint64_t id, const std::shared_ptr<const Config>& config);
-    uint64_t GetId() const { return _id; }
+    uint64_t GetId() const { return _id.load(std::memory_order_relaxed); }
     const std::shared_ptr<const Config>& GetConfig() const { return _config; }
     const Client& GetClient() const { return _client; }
     Client& GetClient() { return _client; }
     std::shared_ptr<WebsocketListener> GetListener() const;
+    std::weak_ptr<SocketImpl> GetWeakRef() { return this->weak_from_this(); }
+    // called before connecting of transport
+    virtual void OnConnectionInit(websocketpp::connection_hdl /*hdl*/) {}
 private:
     void OnSocketInit(websocketpp::connection_hdl hdl);
     void OnFail(websocketpp::connection_hdl hdl);
     void OnOpen(websocketpp::connection_hdl hdl);
     void OnMessage(websocketpp::connection_hdl hdl, MessagePtr message);
     void OnClose(websocketpp::connection_hdl hdl);
+    // the client must outlive its connections: endpoint & transport handlers bind raw pointer
+    // of the client, so this socket keeps itself alive from connecting until termination
+    void Retain();
+    void Release();
+    // hand queued messages to the transport while its in-flight window allows
+    void Send();
+    // poll the transport until the queue is empty, [_sendMutex] must be locked
+    void ScheduleSend();
+    void OnSendQueueCongestion(bool congested);
     template<class Guard>
     void DropHdl(std::unique_ptr<Guard> droppedGuard);
     // return true if state changed
@@ -170,7 +231,8 @@ private:
     static std::shared_ptr<MemoryBuffer> ToBinary(const MessagePtr& message);
 private:
     static inline constexpr uint16_t _closeCode = websocketpp::close::status::going_away;
-    const uint64_t _id;
+    static inline constexpr long _sendPollIntervalMs = 5L;
+    std::atomic<uint64_t> _id;
     const std::shared_ptr<const Config> _config;
     LogStreamBuf _debugStreamBuf;
     LogStreamBuf _errorStreamBuf;
@@ -180,56 +242,113 @@ private:
     ProtectedObj<websocketpp::connection_hdl> _hdl;
     ProtectedWeakPtr<WebsocketListener> _listener;
     std::atomic_bool _opened = false;
+    WebsocketSendQueue _sendQueue;
+    // serializes hand-off of messages, guards the timer
+    std::mutex _sendMutex;
+    typename Client::timer_ptr _sendTimer;
+    // reference to itself while there are not terminated connections
+    std::mutex _selfRefMutex;
+    std::shared_ptr<SocketImpl> _selfRef;
+    size_t _connections = 0UL;
 };
 
-class Websocket::SocketTls : public SocketImpl<websocketpp::config::asio_tls_client>
+class Websocket::SocketTls : public SocketImpl<TlsClientConfig>
 {
     using SslContextPtr = websocketpp::lib::shared_ptr<asio::ssl::context>;
 public:
     SocketTls(uint64_t id, const std::shared_ptr<const Config>& config);
+    // overrides of SocketImpl
+    void Init() final;
+protected:
+    void OnConnectionInit(websocketpp::connection_hdl hdl) final;
 private:
     SslContextPtr OnTlsInit(websocketpp::connection_hdl);
 };
 
-class Websocket::SocketNoTls : public SocketImpl<websocketpp::config::asio_client>
+class Websocket::SocketNoTls : public SocketImpl<NoTlsClientConfig>
 {
 public:
     SocketNoTls(uint64_t id, const std::shared_ptr<const Config>& config);
 };
 
-class Websocket::SocketWrapper : public Socket
+class Websocket::Pool
 {
+    class Session;
 public:
-    SocketWrapper(std::shared_ptr<Socket> impl);
-    ~SocketWrapper() final;
-    static std::unique_ptr<Socket> Create(uint64_t id, const std::shared_ptr<const Config>& config);
-    // impl. of Socket
-    WebsocketState GetState() final;
-    void Run() final;
-    bool Open(const std::string& userAgent) final;
-    void Close() final;
-    bool WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer) final;
-    bool WriteText(const std::string& text) final;
-    void SetListener(const std::weak_ptr<WebsocketListener>& listener) final;
+    Pool(const WebsocketPoolSettings& settings, const std::shared_ptr<const Config>& config,
+         const std::string& userAgent);
+    ~Pool();
+    const std::shared_ptr<const Config>& GetConfig() const { return _config; }
+    // connected socket without listener, null if no warm session is ready,
+    // the taken session is replaced by the new one
+    std::shared_ptr<Socket> Take();
+    static std::string MakeKey(const std::string& uri, const std::string& user,
+                               const std::string& password,
+                               const std::unordered_map<std::string, std::string>& headers,
+                               const WebsocketSendQueueSettings& sendQueueSettings,
+                               const std::string& userAgent);
+private:
+    const std::shared_ptr<const Config> _config;
+    std::vector<std::shared_ptr<Session>> _sessions;
+    // sessions are taken round-robin
+    std::atomic<size_t> _next = 0UL;
+};
+
+// keeps one connection opened, reconnects with jittered exponential backoff
+class Websocket::Pool::Session : public WebsocketListener,
+                                 public std::enable_shared_from_this<Websocket::Pool::Session>
+{
+public:
+    Session(const WebsocketPoolSettings& settings, const std::shared_ptr<const Config>& config,
+            const std::string& userAgent);
+    void Open();
+    void Close();
+    std::shared_ptr<Socket> Take();
+    // impl. of WebsocketListener
+    void OnStateChanged(uint64_t socketId, WebsocketState state) final;
+    void OnFailed(uint64_t socketId, FailureType type, std::string what) final;
 private:
-    std::shared_ptr<Socket> _impl;
-    std::thread _asioThread;
+    // [socketId] must be the current socket, [_mutex] must be locked
+    void ScheduleReconnect(uint64_t socketId);
+private:
+    // sockets of pool are numbered separately, ID is replaced by owner after taking
+    static inline std::atomic<uint64_t> _nextSocketId = 1ULL;
+    const WebsocketPoolSettings _settings;
+    const std::shared_ptr<const Config> _config;
+    const std::string _userAgent;
+    std::mutex _mutex;
+    asio::steady_timer _reconnectTimer;
+    std::shared_ptr<Socket> _socket;
+    uint64_t _socketId = 0ULL;
+    uint32_t _failures = 0U;
+    bool _closed = false;
+    std::mt19937 _random;
 };
 
 Websocket::Websocket(const std::string& uri,
                      const std::string& user,
                      const std::string& password,
                      std::unordered_map<std::string, std::string> headers,
+                     const WebsocketSendQueueSettings& sendQueueSettings,
                      std::string tlsTrustStore,
                      std::string tlsKeyStore,
                      std::string tlsPrivateKey,
                      std::string tlsPrivateKeyPassword)
     : _config(Config::VerifyAndParse(uri, user, password,
                                      std::move(headers),
+                                     sendQueueSettings,
                                      std::move(tlsTrustStore),
                                      std::move(tlsKeyStore),
                                      std::move(tlsPrivateKey),
                                      std::move(tlsPrivateKeyPassword)))
+    , _dropPolicy(sendQueueSettings._dropPolicy)
+{
+}
+
+Websocket::Websocket(const std::shared_ptr<Pool>& pool)
+    : _pool(pool)
+    , _config(pool ? pool->GetConfig() : nullptr)
+    , _dropPolicy(_config ? _config->GetSendQueueSettings()._dropPolicy : WebsocketSendQueueSettings()._dropPolicy)
 {
 }
 
@@ -238,18 +357,66 @@ Websocket::~Websocket()
     Close();
 }
 
+std::shared_ptr<Websocket::Pool> Websocket::GetPool(const WebsocketPoolSettings& settings,
+                                                    const std::string& uri,
+                                                    const std::string& user,
+                                                    const std::string& password,
+                                                    std::unordered_map<std::string, std::string> headers,
+                                                    const WebsocketSendQueueSettings& sendQueueSettings,
+                                                    const std::string& userAgent)
+{
+    if (settings.IsEnabled()) {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<Pool>> pools;
+        const auto key = Pool::MakeKey(uri, user, password, headers, sendQueueSettings, userAgent);
+        const std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = pools.begin(); it != pools.end();) {
+            if (it->second.expired()) {
+                it = pools.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        auto pool = pools[key].lock();
+        if (!pool) {
+            auto config = Config::VerifyAndParse(uri, user, password, std::move(headers),
+                                                 sendQueueSettings, std::string(), std::string(),
+                                                 std::string(), std::string());
+            if (config) {
+                pool = std::make_shared<Pool>(settings, config, userAgent);
+                pools[key] = pool;
+            }
+            else {
+                pools.erase(key);
+            }
+        }
+        return pool;
+    }
+    return nullptr;
+}
+
 bool Websocket::Open(const std::string& userAgent)
 {
     bool result = false;
     if (_config) {
         LOCK_WRITE_PROTECTED_OBJ(_socket);
         if (!_socket.ConstRef()) {
-            auto socket = SocketWrapper::Create(GetId(), _config);
+            auto socket = _pool ? _pool->Take() : nullptr;
             if (socket) {
+                // listener learns about connected state of warm session asynchronously
+                socket->SetId(GetId());
+                socket->SetListener(std::atomic_load(&_listener));
+                socket->SetDropPolicy(_dropPolicy.load());
+                socket->ReportOpened();
+                _socket = std::move(socket);
+                result = true;
+            }
+            else if ((socket = Socket::Create(GetId(), _config))) {
                 socket->SetListener(std::atomic_load(&_listener));
+                socket->SetDropPolicy(_dropPolicy.load());
                 result = socket->Open(userAgent);
                 if (result) {
-                    socket->Run();
                     _socket = std::move(socket);
                 }
             }
@@ -267,6 +434,7 @@ void Websocket::Close()
     if (auto socket = _socket.Take()) {
         const auto wasActive = WebsocketState::Disconnected != socket->GetState();
         socket->SetListener(std::weak_ptr<WebsocketListener>());
+        socket->Close();
         socket.reset();
         if (wasActive) {
             if (const auto listener = std::atomic_load(&_listener)) {
@@ -293,12 +461,12 @@ uint64_t Websocket::GetId() const
     return reinterpret_cast<uint64_t>(this);
 }
 
-bool Websocket::WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer)
+bool Websocket::WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer, bool isKeyFrame)
 {
     if (buffer) {
         LOCK_READ_PROTECTED_OBJ(_socket);
         if (const auto& socket = _socket.ConstRef()) {
-            return socket->WriteBinary(buffer);
+            return socket->WriteBinary(buffer, isKeyFrame);
         }
     }
     return false;
@@ -313,6 +481,34 @@ bool Websocket::WriteText(const std::string& text)
     return false;
 }
 
+std::string Websocket::GetResponseHeader(const std::string& name) const
+{
+    LOCK_READ_PROTECTED_OBJ(_socket);
+    if (const auto& socket = _socket.ConstRef()) {
+        return socket->GetResponseHeader(name);
+    }
+    return std::string();
+}
+
+WebsocketSendStats Websocket::GetSendStats() const
+{
+    LOCK_READ_PROTECTED_OBJ(_socket);
+    if (const auto& socket = _socket.ConstRef()) {
+        return socket->GetSendStats();
+    }
+    return WebsocketSendStats();
+}
+
+void Websocket::SetDropPolicy(WebsocketDropPolicy policy)
+{
+    if (policy != _dropPolicy.exchange(policy)) {
+        LOCK_READ_PROTECTED_OBJ(_socket);
+        if (const auto& socket = _socket.ConstRef()) {
+            socket->SetDropPolicy(policy);
+        }
+    }
+}
+
 void Websocket::SetListener(const std::shared_ptr<WebsocketListener>& listener)
 {
     if (_config) {
@@ -327,12 +523,14 @@ void Websocket::SetListener(const std::shared_ptr<WebsocketListener>& listener)
 
 Websocket::Config::Config(const std::shared_ptr<websocketpp::uri>& uri,
                           std::unordered_map<std::string, std::string> headers,
+                          const WebsocketSendQueueSettings& sendQueueSettings,
                           std::string tlsTrustStore,
                           std::string tlsKeyStore,
                           std::string tlsPrivateKey,
                           std::string tlsPrivateKeyPassword)
     : _uri(uri)
     , _headers(std::move(headers))
+    , _sendQueueSettings(sendQueueSettings)
     , _tlsTrustStore(std::move(tlsTrustStore))
     , _tlsKeyStore(std::move(tlsKeyStore))
     , _tlsPrivateKey(std::move(tlsPrivateKey))
@@ -344,6 +542,7 @@ std::shared_ptr<const Websocket::Config> Websocket::Config::VerifyAndParse(const
                                                                            const std::string& user,
                                                                            const std::string& password,
                                                                            std::unordered_map<std::string, std::string> headers,
+                                                                           const WebsocketSendQueueSettings& sendQueueSettings,
                                                                            std::string tlsTrustStore,
                                                                            std::string tlsKeyStore,
                                                                            std::string tlsPrivateKey,
@@ -357,6 +556,7 @@ std::shared_ptr<const Websocket::Config> Websocket::Config::VerifyAndParse(const
                 headers["Authorization"] = "Basic " + auth;
             }
             return std::make_shared<Config>(validUri, std::move(headers),
+                                            sendQueueSettings,
                                             std::move(tlsTrustStore),
                                             std::move(tlsKeyStore),
                                             std::move(tlsPrivateKey),
@@ -367,14 +567,109 @@ std::shared_ptr<const Websocket::Config> Websocket::Config::VerifyAndParse(const
     return nullptr;
 }
 
+std::shared_ptr<Websocket::TlsContext> Websocket::Config::GetTlsContext(std::string& error) const
+{
+    if (IsSecure()) {
+        std::call_once(_tlsContextOnce, [this]() {
+            _tlsContext = CreateTlsContext(_tlsContextError);
+        });
+        error = _tlsContextError;
+        return _tlsContext;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Websocket::TlsContext> Websocket::Config::CreateTlsContext(std::string& error) const
+{
+    auto ctx = std::make_shared<TlsContext>();
+    try {
+        const auto& tlsTrustStore = GetTlsTrustStore();
+        if (!tlsTrustStore.empty()) {
+            ctx->add_certificate_authority(asio::buffer(tlsTrustStore.data(), tlsTrustStore.size()));
+        }
+        const auto& tlsKeyStore = GetTlsKeyStore();
+        if (!tlsKeyStore.empty()) {
+            ctx->use_certificate_chain(asio::buffer(tlsKeyStore.data(), tlsKeyStore.size()));
+        }
+        const auto& tlsPrivateKey = GetTlsPrivateKey();
+        if (!tlsPrivateKey.empty()) {
+            // context may outlive this config in pending connections
+            ctx->set_password_callback([password = GetTlsPrivateKeyPassword()](std::size_t /*size*/,
+                                                                               asio::ssl::context_base::password_purpose /*purpose*/) {
+                return password;
+            });
+            ctx->use_private_key(asio::buffer(tlsPrivateKey.data(), tlsPrivateKey.size()),
+                                 asio::ssl::context::file_format::pem);
+        }
+        if (!tlsTrustStore.empty() || !tlsKeyStore.empty()) { // maybe 'and' (&&) ?
+            // Activates verification mode and rejects unverified peers
+            ctx->set_verify_mode(asio::ssl::context::verify_peer | asio::ssl::context::verify_fail_if_no_peer_cert);
+        }
+        ctx->set_options(asio::ssl::context::default_workarounds |
+                         asio::ssl::context::no_sslv2 |
+                         asio::ssl::context::no_sslv3 |
+                         asio::ssl::context::no_tlsv1 |
+                         asio::ssl::context::no_tlsv1_1 |
+                         asio::ssl::context::single_dh_use);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    return ctx;
+}
+
+Websocket::TlsContext::TlsContext()
+    : asio::ssl::context(asio::ssl::context::tlsv12_client)
+{
+    SSL_CTX_set_session_cache_mode(native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_set_app_data(native_handle(), this);
+    SSL_CTX_sess_set_new_cb(native_handle(), &TlsContext::OnNewSession);
+}
+
+Websocket::TlsContext::~TlsContext()
+{
+    if (_session) {
+        SSL_SESSION_free(_session);
+    }
+}
+
+void Websocket::TlsContext::ResumeSession(SSL* ssl) const
+{
+    if (ssl) {
+        const std::lock_guard<std::mutex> lock(_sessionMutex);
+        if (_session) {
+            SSL_set_session(ssl, _session);
+        }
+    }
+}
+
+int Websocket::TlsContext::OnNewSession(SSL* ssl, SSL_SESSION* session)
+{
+    if (ssl && session) {
+        if (const auto self = static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))) {
+            const std::lock_guard<std::mutex> lock(self->_sessionMutex);
+            if (self->_session) {
+                SSL_SESSION_free(self->_session);
+            }
+            // reference is owned by this context now
+            self->_session = session;
+            return 1;
+        }
+    }
+    return 0;
+}
+
 std::shared_ptr<Websocket::Socket> Websocket::Socket::Create(uint64_t id,
                                                              const std::shared_ptr<const Config>& config)
 {
     if (config) {
         if (config->IsSecure()) {
-            return std::make_shared<SocketTls>(id, config);
+            const auto socket = std::make_shared<SocketTls>(id, config);
+            socket->Init();
+            return socket;
         }
-        return std::make_shared<SocketNoTls>(id, config);
+        const auto socket = std::make_shared<SocketNoTls>(id, config);
+        socket->Init();
+        return socket;
     }
     return nullptr;
 }
@@ -383,22 +678,58 @@ template<class TConfig>
 Websocket::SocketImpl<TConfig>::SocketImpl(uint64_t id, const std::shared_ptr<const Config>& config)
     : _id(id)
     , _config(config)
-    , _debugStreamBuf(id, LogLevel::LOG_DEBUG)
-    , _errorStreamBuf(id, LogLevel::LOG_ERROR)
+    , _debugStreamBuf(_id, LogLevel::LOG_DEBUG)
+    , _errorStreamBuf(_id, LogLevel::LOG_ERROR)
     , _debugStream(&_debugStreamBuf)
     , _errorStream(&_errorStreamBuf)
+    , _sendQueue(config->GetSendQueueSettings())
 {
-    // Initialize ASIO
+    // Initialize ASIO, context is owned by the shared pool
     _client.get_alog().set_ostream(&_debugStream);
     _client.get_elog().set_ostream(&_errorStream);
-    _client.init_asio();
-    _client.start_perpetual();
-    // Register our handlers
-    _client.set_socket_init_handler(bind(&SocketImpl::OnSocketInit, this, _1));
-    _client.set_message_handler(bind(&SocketImpl::OnMessage, this, _1, _2));
-    _client.set_open_handler(bind(&SocketImpl::OnOpen, this, _1));
-    _client.set_close_handler(bind(&SocketImpl::OnClose, this, _1));
-    _client.set_fail_handler(bind(&SocketImpl::OnFail, this, _1));
+    _client.init_asio(IoContextPool::GetInstance().NextContext());
+}
+
+template<class TConfig>
+Websocket::SocketImpl<TConfig>::~SocketImpl()
+{
+    Close();
+    // connection may outlive this socket on the shared context,
+    // so detach it from our log streams
+    _client.clear_access_channels(websocketpp::log::alevel::all);
+    _client.clear_error_channels(websocketpp::log::elevel::all);
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::Init()
+{
+    // Register our handlers, they may be invoked after destruction of this socket
+    const auto weak = GetWeakRef();
+    _client.set_socket_init_handler([weak](websocketpp::connection_hdl hdl) {
+        if (const auto self = weak.lock()) {
+            self->OnSocketInit(std::move(hdl));
+        }
+    });
+    _client.set_message_handler([weak](websocketpp::connection_hdl hdl, MessagePtr message) {
+        if (const auto self = weak.lock()) {
+            self->OnMessage(std::move(hdl), std::move(message));
+        }
+    });
+    _client.set_open_handler([weak](websocketpp::connection_hdl hdl) {
+        if (const auto self = weak.lock()) {
+            self->OnOpen(std::move(hdl));
+        }
+    });
+    _client.set_close_handler([weak](websocketpp::connection_hdl hdl) {
+        if (const auto self = weak.lock()) {
+            self->OnClose(std::move(hdl));
+        }
+    });
+    _client.set_fail_handler([weak](websocketpp::connection_hdl hdl) {
+        if (const auto self = weak.lock()) {
+            self->OnFail(std::move(hdl));
+        }
+    });
 }
 
 template<class TConfig>
@@ -411,13 +742,6 @@ WebsocketState Websocket::SocketImpl<TConfig>::GetState()
     return WebsocketState::Connected;
 }
 
-template<class TConfig>
-void Websocket::SocketImpl<TConfig>::Run()
-{
-    _client.run();
-    SetOpened(false);
-}
-
 template<class TConfig>
 bool Websocket::SocketImpl<TConfig>::Open(const std::string& userAgent)
 {
@@ -446,6 +770,7 @@ bool Websocket::SocketImpl<TConfig>::Open(const std::string& userAgent)
         if (!userAgent.empty()) {
             _client.set_user_agent(userAgent);
         }
+        Retain();
         _client.connect(connection);
     }
     return !ec;
@@ -454,42 +779,62 @@ bool Websocket::SocketImpl<TConfig>::Open(const std::string& userAgent)
 template<class TConfig>
 void Websocket::SocketImpl<TConfig>::Close()
 {
+    {
+        const std::lock_guard<std::mutex> lock(_sendMutex);
+        if (_sendTimer) {
+            _sendTimer->cancel();
+            _sendTimer.reset();
+        }
+        _sendQueue.Clear();
+    }
     auto droppedGuard = std::make_unique<MutexWriteGuard>(_hdl);
     if (!_hdl->expired()) {
         websocketpp::lib::error_code ec;
+        // don't stop of client because ASIO context is shared between sockets
         _client.close(_hdl, _closeCode, websocketpp::close::status::get_string(_closeCode), ec);
-        _client.stop();
         if (ec) { // ignore of failures during closing
             _errorStreamBuf.Write(ec.message());
+            // handshake isn't completed, terminate the connection for the fail handler
+            if (const auto connection = _client.get_con_from_hdl(_hdl.ConstRef(), ec)) {
+                asio::post(_client.get_io_service(), [connection]() {
+                    if (websocketpp::session::state::connecting == connection->get_state()) {
+                        connection->terminate(websocketpp::lib::error_code());
+                    }
+                });
+            }
         }
         DropHdl(std::move(droppedGuard));
     }
 }
 
 template<class TConfig>
-bool Websocket::SocketImpl<TConfig>::WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer)
+bool Websocket::SocketImpl<TConfig>::WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer,
+                                                 bool isKeyFrame)
 {
-    bool ok = false;
-    if (buffer && IsOpened()) {
-        LOCK_READ_PROTECTED_OBJ(_hdl);
-        if (!_hdl->expired()) {
-            if (!buffer->IsEmpty()) {
-                websocketpp::lib::error_code ec;
-                // overhead - deep copy of input buffer,
-                // Websocketpp doesn't supports of buffers abstraction
-                _client.send(_hdl, buffer->GetData(), buffer->GetSize(), websocketpp::frame::opcode::binary, ec);
-                if (ec) {
-                    if (const auto listener = GetListener()) {
-                        listener->OnFailed(GetId(), WebsocketListener::FailureType::WriteBinary, ec.message());
-                    }
-                }
-                else {
-                    ok = true;
+    if (buffer && !buffer->IsEmpty() && IsOpened()) {
+        switch (_sendQueue.Push(buffer, isKeyFrame, GetSteadyTimeMs())) {
+            case WebsocketSendQueue::PushResult::Queued:
+                break;
+            case WebsocketSendQueue::PushResult::Congested:
+                OnSendQueueCongestion(true);
+                break;
+            case WebsocketSendQueue::PushResult::Overflow:
+                if (const auto listener = GetListener()) {
+                    listener->OnFailed(GetId(), WebsocketListener::FailureType::WriteBinary,
+                                       "send queue overflow");
                 }
-            }
+                // the caller may hold locks which are needed for state change callbacks
+                asio::post(_client.get_io_service(), [weak = GetWeakRef()]() {
+                    if (const auto self = weak.lock()) {
+                        self->Close();
+                    }
+                });
+                return false;
         }
+        Send();
+        return true;
     }
-    return ok;
+    return false;
 }
 
 template<class TConfig>
@@ -514,6 +859,25 @@ bool Websocket::SocketImpl<TConfig>::WriteText(const std::string& text)
     return ok;
 }
 
+template<class TConfig>
+std::string Websocket::SocketImpl<TConfig>::GetResponseHeader(const std::string& name)
+{
+    LOCK_READ_PROTECTED_OBJ(_hdl);
+    if (!_hdl->expired()) {
+        websocketpp::lib::error_code ec;
+        if (const auto connection = _client.get_con_from_hdl(_hdl.ConstRef(), ec)) {
+            return connection->get_response_header(name);
+        }
+    }
+    return std::string();
+}
+
+template<class TConfig>
+WebsocketSendStats Websocket::SocketImpl<TConfig>::GetSendStats() const
+{
+    return _sendQueue.GetStats(GetSteadyTimeMs());
+}
+
 template<class TConfig>
 void Websocket::SocketImpl<TConfig>::SetListener(const std::weak_ptr<WebsocketListener>& listener)
 {
@@ -528,9 +892,26 @@ std::shared_ptr<WebsocketListener> Websocket::SocketImpl<TConfig>::GetListener()
     return _listener->lock();
 }
 
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::ReportOpened()
+{
+    // handlers of connection are serialized on the same context,
+    // so the report can't follow the report about disconnection
+    asio::post(_client.get_io_service(), [weak = GetWeakRef()]() {
+        if (const auto self = weak.lock()) {
+            if (self->IsOpened()) {
+                if (const auto listener = self->GetListener()) {
+                    listener->OnStateChanged(self->GetId(), WebsocketState::Connected);
+                }
+            }
+        }
+    });
+}
+
 template<class TConfig>
 void Websocket::SocketImpl<TConfig>::OnSocketInit(websocketpp::connection_hdl hdl)
 {
+    OnConnectionInit(hdl);
     {
         LOCK_WRITE_PROTECTED_OBJ(_hdl);
         _hdl = std::move(hdl);
@@ -558,6 +939,7 @@ void Websocket::SocketImpl<TConfig>::OnFail(websocketpp::connection_hdl hdl)
             listener->OnFailed(GetId(), WebsocketListener::FailureType::General, std::move(error));
         }
     }
+    Release();
 }
 
 template<class TConfig>
@@ -605,6 +987,99 @@ void Websocket::SocketImpl<TConfig>::OnClose(websocketpp::connection_hdl hdl)
         // report about close & reset state
         DropHdl(std::move(droppedGuard));
     }
+    Release();
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::Retain()
+{
+    const std::lock_guard<std::mutex> lock(_selfRefMutex);
+    if (0UL == _connections++) {
+        _selfRef = this->shared_from_this();
+    }
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::Release()
+{
+    std::shared_ptr<SocketImpl> selfRef;
+    {
+        const std::lock_guard<std::mutex> lock(_selfRefMutex);
+        if (_connections && 0UL == --_connections) {
+            selfRef = std::move(_selfRef);
+        }
+    }
+    if (selfRef) {
+        // termination handler of connection (remove_connection of the client) is called
+        // after close & fail handlers, handlers of cancelled resolve/connect are already
+        // queued, so the client is destroyed not earlier than on the next handler
+        asio::post(_client.get_io_service(), [selfRef = std::move(selfRef)]() mutable {
+            selfRef.reset();
+        });
+    }
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::Send()
+{
+    bool drained = false;
+    {
+        LOCK_READ_PROTECTED_OBJ(_hdl);
+        if (_hdl->expired()) {
+            return;
+        }
+        websocketpp::lib::error_code ec;
+        const auto connection = _client.get_con_from_hdl(_hdl.ConstRef(), ec);
+        if (!connection) {
+            return;
+        }
+        const std::lock_guard<std::mutex> lock(_sendMutex);
+        while (const auto buffer = _sendQueue.Pop(connection->get_buffered_amount(),
+                                                  GetSteadyTimeMs(), drained)) {
+            // overhead - deep copy of input buffer,
+            // Websocketpp doesn't supports of buffers abstraction
+            ec = connection->send(buffer->GetData(), buffer->GetSize(),
+                                  websocketpp::frame::opcode::binary);
+            if (ec) {
+                if (const auto listener = GetListener()) {
+                    listener->OnFailed(GetId(), WebsocketListener::FailureType::WriteBinary, ec.message());
+                }
+                break;
+            }
+        }
+        if (!_sendQueue.IsEmpty()) {
+            ScheduleSend();
+        }
+    }
+    if (drained) {
+        OnSendQueueCongestion(false);
+    }
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::ScheduleSend()
+{
+    if (!_sendTimer) {
+        _sendTimer = _client.set_timer(_sendPollIntervalMs, [weak = GetWeakRef()](const websocketpp::lib::error_code& ec) {
+            if (!ec) {
+                if (const auto self = weak.lock()) {
+                    {
+                        const std::lock_guard<std::mutex> lock(self->_sendMutex);
+                        self->_sendTimer.reset();
+                    }
+                    self->Send();
+                }
+            }
+        });
+    }
+}
+
+template<class TConfig>
+void Websocket::SocketImpl<TConfig>::OnSendQueueCongestion(bool congested)
+{
+    if (const auto listener = GetListener()) {
+        listener->OnSendQueueCongestion(GetId(), congested, GetSendStats());
+    }
 }
 
 template<class TConfig> template<class Guard>
@@ -631,7 +1106,8 @@ template<class TConfig>
 std::string Websocket::SocketImpl<TConfig>::ToText(const MessagePtr& message)
 {
     if (message) {
-        return std::move(message->get_raw_payload());
+        // payload isn't moved, its capacity is reused by the pool
+        return message->get_payload();
     }
     return std::string();
 }
@@ -639,138 +1115,221 @@ std::string Websocket::SocketImpl<TConfig>::ToText(const MessagePtr& message)
 template<class TConfig>
 std::shared_ptr<MemoryBuffer> Websocket::SocketImpl<TConfig>::ToBinary(const MessagePtr& message)
 {
-    if (message) {
-        return std::make_shared<StringMemoryBuffer>(std::move(message->get_raw_payload()));
-    }
-    return nullptr;
+    // pooled message is the view of own payload, it isn't reused while listener holds it
+    return message;
 }
 
 Websocket::SocketTls::SocketTls(uint64_t id, const std::shared_ptr<const Config>& config)
-    : SocketImpl<websocketpp::config::asio_tls_client>(id, config)
+    : SocketImpl<TlsClientConfig>(id, config)
 {
-    GetClient().set_tls_init_handler(bind(&SocketTls::OnTlsInit, this, _1));
 }
 
-Websocket::SocketTls::SslContextPtr Websocket::SocketTls::OnTlsInit(websocketpp::connection_hdl)
+void Websocket::SocketTls::Init()
 {
-    SslContextPtr ctx = websocketpp::lib::make_shared<asio::ssl::context>(asio::ssl::context::tlsv12_client);
-    try {
-        const auto& tlsTrustStore = GetConfig()->GetTlsTrustStore();
-        if (!tlsTrustStore.empty()) {
-            ctx->add_certificate_authority(asio::buffer(tlsTrustStore.data(), tlsTrustStore.size()));
+    SocketImpl<TlsClientConfig>::Init();
+    GetClient().set_tls_init_handler([weak = GetWeakRef()](websocketpp::connection_hdl hdl) {
+        if (const auto self = std::static_pointer_cast<SocketTls>(weak.lock())) {
+            return self->OnTlsInit(std::move(hdl));
         }
-        const auto& tlsKeyStore = GetConfig()->GetTlsTrustStore();
-        if (!tlsKeyStore.empty()) {
-            ctx->use_certificate_chain(asio::buffer(tlsKeyStore.data(), tlsKeyStore.size()));
-        }
-        const auto& tlsPrivateKey = GetConfig()->GetTlsPrivateKey();
-        if (!tlsPrivateKey.empty()) {
-            ctx->set_password_callback([config = GetConfig()](std::size_t /*size*/,
-                                                              asio::ssl::context_base::password_purpose /*purpose*/) {
-                return config->GetTlsPrivateKeyPassword();
-            });
-            ctx->use_private_key(asio::buffer(tlsPrivateKey.data(), tlsPrivateKey.size()),
-                                 asio::ssl::context::file_format::pem);
-        }
-        if (!tlsTrustStore.empty() || !tlsKeyStore.empty()) { // maybe 'and' (&&) ?
-            // Activates verification mode and rejects unverified peers
-            ctx->set_verify_mode(asio::ssl::context::verify_peer | asio::ssl::context::verify_fail_if_no_peer_cert);
-        }
-        ctx->set_options(asio::ssl::context::default_workarounds |
-                         asio::ssl::context::no_sslv2 |
-                         asio::ssl::context::no_sslv3 |
-                         asio::ssl::context::no_tlsv1 |
-                         asio::ssl::context::no_tlsv1_1 |
-                         asio::ssl::context::single_dh_use);
-    } catch (const std::exception& e) {
+        return SslContextPtr();
+    });
+}
+
+Websocket::SocketTls::SslContextPtr Websocket::SocketTls::OnTlsInit(websocketpp::connection_hdl)
+{
+    std::string error;
+    auto ctx = GetConfig()->GetTlsContext(error);
+    if (!error.empty()) {
         if (const auto listener = GetListener()) {
-            listener->OnFailed(GetId(), WebsocketListener::FailureType::TlsOptions, e.what());
+            listener->OnFailed(GetId(), WebsocketListener::FailureType::TlsOptions, std::move(error));
         }
     }
     return ctx;
 }
 
+void Websocket::SocketTls::OnConnectionInit(websocketpp::connection_hdl hdl)
+{
+    std::string error;
+    if (const auto ctx = GetConfig()->GetTlsContext(error)) {
+        websocketpp::lib::error_code ec;
+        if (const auto connection = GetClient().get_con_from_hdl(std::move(hdl), ec)) {
+            ctx->ResumeSession(connection->get_socket().native_handle());
+        }
+    }
+}
+
 Websocket::SocketNoTls::SocketNoTls(uint64_t id, const std::shared_ptr<const Config>& config)
-    : SocketImpl<websocketpp::config::asio_client>(id, config)
+    : SocketImpl<NoTlsClientConfig>(id, config)
 {
 }
 
-Websocket::SocketWrapper::SocketWrapper(std::shared_ptr<Socket> impl)
-    : _impl(std::move(impl))
+Websocket::Pool::Pool(const WebsocketPoolSettings& settings,
+                      const std::shared_ptr<const Config>& config,
+                      const std::string& userAgent)
+    : _config(config)
 {
+    _sessions.reserve(settings._warmSessions);
+    for (uint32_t i = 0U; i < settings._warmSessions; ++i) {
+        _sessions.push_back(std::make_shared<Session>(settings, _config, userAgent));
+        _sessions.back()->Open();
+    }
 }
 
-Websocket::SocketWrapper::~SocketWrapper()
+Websocket::Pool::~Pool()
 {
-    if (auto socket = std::atomic_exchange(&_impl, std::shared_ptr<Socket>())) {
-        socket->Close();
-        _asioThread.detach();
+    for (const auto& session : _sessions) {
+        session->Close();
     }
 }
 
-std::unique_ptr<Websocket::Socket> Websocket::SocketWrapper::Create(uint64_t id,
-                                                                    const std::shared_ptr<const Config>& config)
+std::shared_ptr<Websocket::Socket> Websocket::Pool::Take()
 {
-    if (auto impl = Socket::Create(id, config)) {
-        return std::make_unique<SocketWrapper>(std::move(impl));
+    const auto first = _next.fetch_add(1UL, std::memory_order_relaxed);
+    for (size_t i = 0UL; i < _sessions.size(); ++i) {
+        if (auto socket = _sessions[(first + i) % _sessions.size()]->Take()) {
+            return socket;
+        }
     }
     return nullptr;
 }
 
-WebsocketState Websocket::SocketWrapper::GetState()
+std::string Websocket::Pool::MakeKey(const std::string& uri, const std::string& user,
+                                     const std::string& password,
+                                     const std::unordered_map<std::string, std::string>& headers,
+                                     const WebsocketSendQueueSettings& sendQueueSettings,
+                                     const std::string& userAgent)
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        return impl->GetState();
+    std::string key = uri + "\n" + user + "\n" + password + "\n" + userAgent;
+    // order of unordered map isn't stable
+    for (const auto& [name, value] : std::map<std::string, std::string>(headers.begin(), headers.end())) {
+        key += "\n" + name + ": " + value;
     }
-    return WebsocketState::Disconnected;
+    key += "\n" + std::to_string(sendQueueSettings._maxBytes);
+    key += " " + std::to_string(sendQueueSettings._maxDelayMs);
+    key += " " + std::to_string(sendQueueSettings._maxInFlightBytes);
+    key += " " + std::to_string(static_cast<int>(sendQueueSettings._dropPolicy));
+    return key;
 }
 
-void Websocket::SocketWrapper::Run()
+Websocket::Pool::Session::Session(const WebsocketPoolSettings& settings,
+                                  const std::shared_ptr<const Config>& config,
+                                  const std::string& userAgent)
+    : _settings(settings)
+    , _config(config)
+    , _userAgent(userAgent)
+    , _reconnectTimer(*IoContextPool::GetInstance().NextContext())
+    , _random(std::random_device()())
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        _asioThread = std::thread([implRef = std::weak_ptr<Socket>(impl)]() {
-            if (const auto impl = implRef.lock()) {
-                impl->Run();
+}
+
+void Websocket::Pool::Session::Open()
+{
+    const auto socketId = _nextSocketId.fetch_add(1ULL, std::memory_order_relaxed);
+    const auto socket = Socket::Create(socketId, _config);
+    if (socket) {
+        std::shared_ptr<Socket> previous;
+        socket->SetListener(weak_from_this());
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed) {
+                return;
             }
-        });
+            previous = std::move(_socket);
+            _socket = socket;
+            _socketId = socketId;
+        }
+        if (previous) {
+            previous->SetListener(std::weak_ptr<WebsocketListener>());
+            previous->Close();
+        }
+        if (!socket->Open(_userAgent)) {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            ScheduleReconnect(socketId);
+        }
     }
 }
 
-bool Websocket::SocketWrapper::Open(const std::string& userAgent)
+void Websocket::Pool::Session::Close()
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        return impl->Open(userAgent);
+    std::shared_ptr<Socket> socket;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _reconnectTimer.cancel();
+        socket = std::move(_socket);
+        _socketId = 0ULL;
+    }
+    if (socket) {
+        socket->SetListener(std::weak_ptr<WebsocketListener>());
+        socket->Close();
     }
-    return false;
 }
 
-void Websocket::SocketWrapper::Close()
+std::shared_ptr<Websocket::Socket> Websocket::Pool::Session::Take()
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        impl->Close();
+    std::shared_ptr<Socket> socket;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        if (!_closed && _socket && WebsocketState::Connected == _socket->GetState()) {
+            socket = std::move(_socket);
+            _socketId = 0ULL;
+        }
     }
+    if (socket) {
+        socket->SetListener(std::weak_ptr<WebsocketListener>());
+        // warm up the replacement
+        Open();
+    }
+    return socket;
 }
 
-bool Websocket::SocketWrapper::WriteBinary(const std::shared_ptr<const MemoryBuffer>& buffer)
+void Websocket::Pool::Session::OnStateChanged(uint64_t socketId, WebsocketState state)
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        return impl->WriteBinary(buffer);
+    WebsocketListener::OnStateChanged(socketId, state);
+    const std::lock_guard<std::mutex> lock(_mutex);
+    switch (state) {
+        case WebsocketState::Connected:
+            if (socketId == _socketId) {
+                _failures = 0U;
+            }
+            break;
+        case WebsocketState::Disconnected:
+            ScheduleReconnect(socketId);
+            break;
+        default:
+            break;
     }
-    return false;
 }
 
-bool Websocket::SocketWrapper::WriteText(const std::string& text)
+void Websocket::Pool::Session::OnFailed(uint64_t socketId, FailureType type, std::string what)
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        return impl->WriteText(text);
-    }
-    return false;
+    WebsocketListener::OnFailed(socketId, type, std::move(what));
+    const std::lock_guard<std::mutex> lock(_mutex);
+    ScheduleReconnect(socketId);
 }
 
-void Websocket::SocketWrapper::SetListener(const std::weak_ptr<WebsocketListener>& listener)
+void Websocket::Pool::Session::ScheduleReconnect(uint64_t socketId)
 {
-    if (const auto impl = std::atomic_load(&_impl)) {
-        impl->SetListener(listener);
+    if (!_closed && socketId && socketId == _socketId) {
+        // socket is destroyed by the caller or on the next opening
+        _socketId = 0ULL;
+        const auto maxDelayMs = std::max(_settings._minBackoffMs, _settings._maxBackoffMs);
+        uint64_t delayMs = _settings._minBackoffMs;
+        for (uint32_t i = 0U; i < _failures && delayMs < maxDelayMs; ++i) {
+            delayMs *= 2ULL;
+        }
+        delayMs = std::min<uint64_t>(delayMs, maxDelayMs);
+        ++_failures;
+        // spread reconnections of many sessions when the service comes back
+        delayMs = std::uniform_int_distribution<uint64_t>(delayMs / 2ULL, delayMs)(_random);
+        _reconnectTimer.expires_after(std::chrono::milliseconds(delayMs));
+        _reconnectTimer.async_wait([weak = weak_from_this()](const asio::error_code& error) {
+            if (!error) {
+                if (const auto self = weak.lock()) {
+                    self->Open();
+                }
+            }
+        });
     }
 }
 
@@ -781,6 +1340,16 @@ void WebsocketListener::OnStateChanged(uint64_t socketId, WebsocketState state)
     }
 }
 
+void WebsocketListener::OnSendQueueCongestion(uint64_t socketId, bool congested,
+                                              const WebsocketSendStats& stats)
+{
+    if (LogStreamBuf::IsAccepted(LogLevel::LOG_DEBUG)) {
+        std::string message = congested ? "send queue is congested" : "send queue is drained";
+        message += ", dropped " + std::to_string(stats._droppedMessages) + " messages";
+        LogStreamBuf::Write(LogLevel::LOG_DEBUG, socketId, std::move(message));
+    }
+}
+
 void WebsocketListener::OnFailed(uint64_t socketId, FailureType type, std::string what)
 {
     if (LogStreamBuf::IsAccepted(LogLevel::LOG_ERROR)) {
@@ -796,22 +1365,7 @@ void WebsocketListener::OnFailed(uint64_t socketId, FailureType type, std::strin
 
 namespace {
 
-StringMemoryBuffer::StringMemoryBuffer(std::string payload)
-    : _payload(std::move(payload))
-{
-}
-
-uint8_t* StringMemoryBuffer::GetData()
-{
-    return reinterpret_cast<uint8_t*>(_payload.data());
-}
-
-const uint8_t* StringMemoryBuffer::GetData() const
-{
-    return reinterpret_cast<const uint8_t*>(_payload.data());
-}
-
-LogStreamBuf::LogStreamBuf(uint64_t socketId, LogLevel level)
+LogStreamBuf::LogStreamBuf(const std::atomic<uint64_t>& socketId, LogLevel level)
     : _socketId(socketId)
     , _level(level)
 {
@@ -876,7 +1430,7 @@ void LogStreamBuf::Write(LogLevel level, uint64_t socketId, std::string message)
 
 void LogStreamBuf::Write(std::string message) const
 {
-    Write(_level, _socketId, std::move(message));
+    Write(_level, _socketId.load(std::memory_order_relaxed), std::move(message));
 }
 
 }
@@ -0,0 +1,159 @@
+#define MS_CLASS "RTC::WebsocketSendQueue"
+#include "RTC/MediaTranslate/WebsocketSendQueue.hpp"
+#include "MemoryBuffer.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+
+namespace RTC
+{
+
+struct WebsocketSendQueue::Message
+{
+    std::shared_ptr<const MemoryBuffer> _buffer;
+    bool _isKeyFrame = false;
+    uint64_t _queuedMs = 0ULL;
+};
+
+WebsocketSendQueue::WebsocketSendQueue(const WebsocketSendQueueSettings& settings)
+    : _settings(settings)
+    , _dropPolicy(settings._dropPolicy)
+{
+}
+
+WebsocketSendQueue::~WebsocketSendQueue()
+{
+}
+
+WebsocketSendQueue::PushResult WebsocketSendQueue::Push(const std::shared_ptr<const MemoryBuffer>& buffer,
+                                                        bool isKeyFrame, uint64_t nowMs)
+{
+    PushResult result = PushResult::Queued;
+    if (buffer && !buffer->IsEmpty()) {
+        const auto policy = GetDropPolicy();
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _messages.push_back({buffer, isKeyFrame, nowMs});
+        _queuedBytes += buffer->GetSize();
+        if (IsOverLimits(nowMs)) {
+            if (WebsocketDropPolicy::Disconnect == policy) {
+                while (!_messages.empty()) {
+                    Drop(_messages.begin());
+                }
+                return PushResult::Overflow;
+            }
+            while (IsOverLimits(nowMs) && ApplyDropPolicy(policy)) {
+            }
+            if (!_stats._congested) {
+                _stats._congested = true;
+                ++_stats._congestions;
+                result = PushResult::Congested;
+            }
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const MemoryBuffer> WebsocketSendQueue::Pop(size_t inFlightBytes, uint64_t nowMs,
+                                                            bool& drained)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    if (!_messages.empty()) {
+        auto& message = _messages.front();
+        const auto size = message._buffer->GetSize();
+        // single message larger than window is passed if the transport is idle
+        if (inFlightBytes > 0UL && inFlightBytes + size > _settings._maxInFlightBytes) {
+            return nullptr;
+        }
+        auto buffer = std::move(message._buffer);
+        const auto latencyMs = static_cast<uint32_t>(nowMs - std::min(nowMs, message._queuedMs));
+        _messages.pop_front();
+        _queuedBytes -= size;
+        // like RTP jitter (RFC 3550, section 6.4.1)
+        _stats._writeLatencyMs += (latencyMs - _stats._writeLatencyMs) / 16.;
+        _stats._maxWriteLatencyMs = std::max(_stats._maxWriteLatencyMs, latencyMs);
+        _writeLatency.Add(latencyMs * 1000ULL);
+        ++_stats._sentMessages;
+        _stats._sentBytes += size;
+        if (_messages.empty() && _stats._congested) {
+            _stats._congested = false;
+            drained = true;
+        }
+        return buffer;
+    }
+    return nullptr;
+}
+
+void WebsocketSendQueue::Clear()
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _messages.clear();
+    _queuedBytes = 0UL;
+    _stats._congested = false;
+}
+
+bool WebsocketSendQueue::IsEmpty() const
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _messages.empty();
+}
+
+WebsocketSendStats WebsocketSendQueue::GetStats(uint64_t nowMs) const
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    auto stats = _stats;
+    stats._writeLatencyHistogram = _writeLatency.GetSnapshot();
+    stats._queuedMessages = static_cast<uint32_t>(_messages.size());
+    stats._queuedBytes = static_cast<uint32_t>(std::min<size_t>(_queuedBytes, UINT32_MAX));
+    if (!_messages.empty()) {
+        stats._queueDelayMs = static_cast<uint32_t>(nowMs - std::min(nowMs, _messages.front()._queuedMs));
+    }
+    return stats;
+}
+
+bool WebsocketSendQueue::IsOverLimits(uint64_t nowMs) const
+{
+    if (_settings._maxBytes && _queuedBytes > _settings._maxBytes) {
+        return true;
+    }
+    if (_settings._maxDelayMs && !_messages.empty()) {
+        return nowMs > _messages.front()._queuedMs + _settings._maxDelayMs;
+    }
+    return false;
+}
+
+bool WebsocketSendQueue::ApplyDropPolicy(WebsocketDropPolicy policy)
+{
+    // the last message is the new one
+    if (!_messages.empty()) {
+        switch (policy) {
+            case WebsocketDropPolicy::DropOldestNonKeyFrame:
+                if (_messages.size() > 1UL) {
+                    const auto last = std::prev(_messages.end());
+                    auto it = std::find_if(_messages.begin(), last, [](const Message& message) {
+                        return !message._isKeyFrame;
+                    });
+                    Drop(it != last ? it : _messages.begin());
+                    return true;
+                }
+                break;
+            case WebsocketDropPolicy::DropNewest:
+                Drop(std::prev(_messages.end()));
+                // limits are exceeded by old messages, wait for the transport
+                return false;
+            default:
+                MS_ASSERT(false, "unexpected drop policy");
+                break;
+        }
+    }
+    return false;
+}
+
+void WebsocketSendQueue::Drop(std::deque<Message>::iterator it)
+{
+    const auto size = it->_buffer->GetSize();
+    _messages.erase(it);
+    _queuedBytes -= size;
+    ++_stats._droppedMessages;
+    _stats._droppedBytes += size;
+}
+
+} // namespace RTC
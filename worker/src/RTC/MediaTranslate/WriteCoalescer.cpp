@@ -0,0 +1,171 @@
+#define MS_CLASS "RTC::WriteCoalescer"
+#include "RTC/MediaTranslate/WriteCoalescer.hpp"
+#include "RTC/MediaTranslate/IoContextPool.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "Logger.hpp"
+#include <asio/steady_timer.hpp>
+
+namespace RTC
+{
+
+class WriteCoalescer::Timer
+{
+public:
+    Timer() : _timer(*IoContextPool::GetInstance().NextContext()) {}
+    template <class Handler>
+    void Start(std::chrono::milliseconds delay, Handler handler) {
+        _timer.expires_after(delay);
+        _timer.async_wait([handler = std::move(handler)](const asio::error_code& error) {
+            if (!error) {
+                handler();
+            }
+        });
+    }
+    void Cancel() { _timer.cancel(); }
+private:
+    asio::steady_timer _timer;
+};
+
+WriteCoalescer::WriteCoalescer(Listener* listener, const WriteCoalescingSettings& settings)
+    : _settings(settings)
+    , _timer(settings.IsEnabled() ? std::make_unique<Timer>() : nullptr)
+    , _buffersPool(settings.IsEnabled() ? std::make_shared<MemoryBufferPool>(4UL) : nullptr)
+    , _listener(listener)
+{
+    MS_ASSERT(_listener, "listener must not be null");
+}
+
+WriteCoalescer::~WriteCoalescer()
+{
+    Stop();
+}
+
+void WriteCoalescer::Flush()
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    ApplyReset();
+    FlushPending();
+}
+
+void WriteCoalescer::Reset()
+{
+    _resetRequested = true;
+}
+
+void WriteCoalescer::Stop()
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    _listener = nullptr;
+    _pending.reset();
+    if (_timer) {
+        _timer->Cancel();
+    }
+}
+
+void WriteCoalescer::BeginWriteMediaPayload(uint32_t /*ssrc*/, bool isKeyFrame,
+                                            const RtpCodecMimeType& /*codecMimeType*/,
+                                            uint16_t /*rtpSequenceNumber*/,
+                                            uint32_t /*rtpTimestamp*/,
+                                            uint32_t /*rtpAbsSendtime*/)
+{
+    if (_settings.IsEnabled()) {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        ApplyReset();
+        _inFrame = true;
+        _keyFrame = isKeyFrame;
+    }
+}
+
+void WriteCoalescer::EndWriteMediaPayload(uint32_t /*ssrc*/, bool /*ok*/)
+{
+    if (_settings.IsEnabled()) {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _inFrame = false;
+        ApplyReset();
+        // key frame must reach the service without delay, decoding of the whole GOP depends on it
+        if (_pending && (_keyFrame || _pending->GetSize() >= _settings._maxSize || IsExpired())) {
+            FlushPending(_keyFrame);
+        }
+        _keyFrame = false;
+    }
+}
+
+void WriteCoalescer::Write(const std::shared_ptr<const MemoryBuffer>& buffer)
+{
+    if (buffer && !buffer->IsEmpty()) {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        ApplyReset();
+        if (_listener) {
+            if (!_settings.IsEnabled() || (!_pending && buffer->GetSize() >= _settings._maxSize)) {
+                // nothing to coalesce, avoid of copying
+                _listener->OnCoalescedWrite(buffer, _inFrame && _keyFrame);
+                return;
+            }
+            if (!_pending) {
+                _pending = _buffersPool->Allocate(_settings._maxSize);
+                if (!_pending) {
+                    MS_ERROR("failed to allocate buffer for coalesced writes");
+                    _listener->OnCoalescedWrite(buffer, _inFrame && _keyFrame);
+                    return;
+                }
+                _pendingSince = std::chrono::steady_clock::now();
+                _timer->Start(std::chrono::milliseconds(_settings._maxDelayMs),
+                              [weakSelf = weak_from_this(), batch = _batch]() {
+                    if (const auto self = weakSelf.lock()) {
+                        self->OnDeadline(batch);
+                    }
+                });
+            }
+            _pending->Append(buffer->GetData(), buffer->GetSize());
+            // frames are checked at the end of payload, other data (i.e. container headers)
+            // are sent together with the next frame
+            if (!_inFrame && _pending->GetSize() >= _settings._maxSize) {
+                FlushPending();
+            }
+        }
+    }
+}
+
+void WriteCoalescer::ApplyReset()
+{
+    // partially written frame is dropped at its end
+    if (!_inFrame && _resetRequested.exchange(false)) {
+        if (_pending) {
+            ++_batch;
+            _pending.reset();
+            _timer->Cancel();
+        }
+        _keyFrame = false;
+    }
+}
+
+bool WriteCoalescer::IsExpired() const
+{
+    const auto age = std::chrono::steady_clock::now() - _pendingSince;
+    return age >= std::chrono::milliseconds(_settings._maxDelayMs);
+}
+
+void WriteCoalescer::FlushPending(bool hasKeyFrame)
+{
+    if (_pending) {
+        ++_batch;
+        _timer->Cancel();
+        const std::shared_ptr<const MemoryBuffer> buffer = std::move(_pending);
+        if (_listener) {
+            _listener->OnCoalescedWrite(buffer, hasKeyFrame);
+        }
+    }
+}
+
+void WriteCoalescer::OnDeadline(uint64_t batch)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    ApplyReset();
+    // frame in progress will be flushed by EndWriteMediaPayload
+    if (batch == _batch && !_inFrame) {
+        FlushPending();
+    }
+}
+
+} // namespace RTC
@@ -464,13 +464,20 @@ namespace RTC
 		return this->tuple;
 	}
 
+	std::vector<const UdpSocketHandle*> PipeTransport::GetUdpSockets() const
+	{
+		MS_TRACE();
+
+		return { this->udpSocket };
+	}
+
 	inline bool PipeTransport::HasSrtp() const
 	{
 		return !this->srtpKey.empty();
 	}
 
 	void PipeTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
 	{
 		MS_TRACE();
 
@@ -488,7 +495,12 @@ namespace RTC
 		const uint8_t* data = packet->GetData();
 		auto len            = packet->GetSize();
 
-		if (HasSrtp() && !this->srtpSendSession->EncryptRtp(&data, &len))
+		if (!HasSrtp())
+		{
+			RTC::Transport::UpdateMid(consumer, packet);
+		}
+		else if (!this->srtpSendSession->EncryptRtp(
+		           packet, RTC::Transport::GetHeaderRewrite(consumer), &data, &len))
 		{
 			if (cb)
 			{
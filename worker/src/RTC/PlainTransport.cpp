@@ -739,6 +739,13 @@ namespace RTC
 		return this->tuple;
 	}
 
+	std::vector<const UdpSocketHandle*> PlainTransport::GetUdpSockets() const
+	{
+		MS_TRACE();
+
+		return { this->udpSocket };
+	}
+
 	inline bool PlainTransport::HasSrtp() const
 	{
 		return !this->srtpKey.empty();
@@ -750,7 +757,7 @@ namespace RTC
 	}
 
 	void PlainTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
 	{
 		MS_TRACE();
 
@@ -768,7 +775,12 @@ namespace RTC
 		const uint8_t* data = packet->GetData();
 		auto len            = packet->GetSize();
 
-		if (HasSrtp() && !this->srtpSendSession->EncryptRtp(&data, &len))
+		if (!HasSrtp())
+		{
+			RTC::Transport::UpdateMid(consumer, packet);
+		}
+		else if (!this->srtpSendSession->EncryptRtp(
+		           packet, RTC::Transport::GetHeaderRewrite(consumer), &data, &len))
 		{
 			if (cb)
 			{
@@ -314,6 +314,28 @@ namespace RTC
 			traceEventTypes.emplace_back(FBS::Producer::TraceEventType::FIR);
 		}
 
+		// Add send queue stats of the translation service connections, if any.
+		std::optional<RTC::WebsocketSendStats> uplinkStats;
+
+		this->listener->OnProducerNeedTranslationUplinkStats(this, uplinkStats);
+
+		flatbuffers::Offset<FBS::Producer::TranslationUplinkStats> uplinkStatsOffset;
+
+		if (uplinkStats.has_value())
+		{
+			uplinkStatsOffset = FBS::Producer::CreateTranslationUplinkStats(
+			  builder,
+			  uplinkStats->_queuedMessages,
+			  uplinkStats->_queuedBytes,
+			  uplinkStats->_queueDelayMs,
+			  uplinkStats->_droppedMessages,
+			  uplinkStats->_droppedBytes,
+			  static_cast<float>(uplinkStats->_writeLatencyMs),
+			  uplinkStats->_maxWriteLatencyMs,
+			  uplinkStats->_congestions,
+			  uplinkStats->_congested);
+		}
+
 		return FBS::Producer::CreateDumpResponseDirect(
 		  builder,
 		  this->id.c_str(),
@@ -324,7 +346,8 @@ namespace RTC
 		  rtpMapping,
 		  &rtpStreams,
 		  &traceEventTypes,
-		  this->paused);
+		  this->paused,
+		  uplinkStatsOffset);
 	}
 
 	flatbuffers::Offset<FBS::Producer::GetStatsResponse> Producer::FillBufferStats(
@@ -344,7 +367,29 @@ namespace RTC
 			rtpStreams.emplace_back(rtpStream->FillBufferStats(builder));
 		}
 
-		return FBS::Producer::CreateGetStatsResponseDirect(builder, &rtpStreams);
+		// Add latencies of the translation pipeline, if any.
+		RTC::ProducerTranslationLatencyStats translationStats;
+
+		this->listener->OnProducerNeedTranslationLatencyStats(this, translationStats);
+
+		std::vector<flatbuffers::Offset<FBS::Producer::TranslationStreamLatency>> translationStreams;
+		std::vector<flatbuffers::Offset<FBS::Producer::TranslationEndPointLatency>> translationEndPoints;
+
+		translationStreams.reserve(translationStats._streams.size());
+		translationEndPoints.reserve(translationStats._endPoints.size());
+
+		for (const auto& stream : translationStats._streams)
+		{
+			translationStreams.emplace_back(stream.FillBuffer(builder));
+		}
+
+		for (const auto& endPoint : translationStats._endPoints)
+		{
+			translationEndPoints.emplace_back(endPoint.FillBuffer(builder));
+		}
+
+		return FBS::Producer::CreateGetStatsResponseDirect(
+		  builder, &rtpStreams, &translationStreams, &translationEndPoints);
 	}
 
 	void Producer::HandleRequest(Channel::ChannelRequest* request)
@@ -497,6 +542,52 @@ namespace RTC
 				break;
 			}
 
+			case Channel::ChannelRequest::Method::PRODUCER_SET_RECORDING:
+			{
+				const auto* body = request->data->body_as<FBS::Producer::SetRecordingRequest>();
+
+				std::optional<RTC::RecordingSettings> settings;
+
+				// Empty or missing directory disables recording.
+				if (flatbuffers::IsFieldPresent(body, FBS::Producer::SetRecordingRequest::VT_DIRECTORY) &&
+				    body->directory()->size() > 0)
+				{
+					settings.emplace();
+					settings->_directory       = body->directory()->str();
+					settings->_flushIntervalMs = body->flush_interval_ms();
+					settings->_flushSize       = body->flush_size();
+					settings->_maxPendingSize  = body->max_pending_size();
+
+					switch (body->sync_policy())
+					{
+						case FBS::Producer::RecordingSyncPolicy::NONE:
+						{
+							settings->_syncPolicy = RTC::RecordingSyncPolicy::None;
+
+							break;
+						}
+						case FBS::Producer::RecordingSyncPolicy::ON_FLUSH:
+						{
+							settings->_syncPolicy = RTC::RecordingSyncPolicy::OnFlush;
+
+							break;
+						}
+						case FBS::Producer::RecordingSyncPolicy::ON_CLOSE:
+						{
+							settings->_syncPolicy = RTC::RecordingSyncPolicy::OnClose;
+
+							break;
+						}
+					}
+				}
+
+				this->listener->OnProducerRecordingChanged(this, settings);
+
+				request->Accept();
+
+				break;
+			}
+
 			default:
 			{
 				MS_THROW_ERROR("unknown method '%s'", request->methodCStr);
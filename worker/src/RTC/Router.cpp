@@ -15,6 +15,7 @@
 #include "RTC/WebRtcTransport.hpp"
 #include "RTC/MediaTranslate/MediaTranslatorsManager.hpp"
 #include "RTC/MediaTranslate/ConsumerTranslator.hpp"
+#include "handles/UdpSocketHandle.hpp"
 
 namespace RTC
 {
@@ -22,7 +23,10 @@ namespace RTC
 
 	Router::Router(RTC::Shared* shared, const std::string& id, Listener* listener)
 	  : id(id), shared(shared), listener(listener),
-      _translatorsManager(std::make_shared<MediaTranslatorsManager>(this, _tsUri, _tsUser, _tsUserPassword))
+      _translatorsManager(std::make_shared<MediaTranslatorsManager>(this, _tsServices,
+                                                                    _tsMediaFormat, _tsWriteCoalescing, _tsSendQueue,
+                                                                    _tsVoiceActivity, _tsServicePool,
+                                                                    _tsServiceBalancing))
 	{
 		MS_TRACE();
 
@@ -672,17 +676,23 @@ namespace RTC
 			DepLibUring::SetActive();
 #endif
 
-			for (auto* consumer : consumers)
+			// Coalesce datagrams to the same destination (consumers sharing a
+			// transport or a WebRtcServer socket).
 			{
-				// Update MID RTP extension value.
-				const auto& mid = consumer->GetRtpParameters().mid;
+				const UdpSocketHandle::SendBatch sendBatch;
 
-				if (!mid.empty())
+				for (auto* consumer : consumers)
 				{
-					packet->UpdateMid(mid);
+					// Translated media is injected instead of the original one.
+					if (consumer->IsMediaReplaced())
+					{
+						continue;
+					}
+
+					// NOTE: MID RTP extension value is written by the transport of the
+					// consumer when copying the packet for sending.
+					consumer->SendRtpPacket(packet, sharedPacket);
 				}
-
-				consumer->SendRtpPacket(packet, sharedPacket);
 			}
 
 #ifdef MS_LIBURING_SUPPORTED
@@ -720,6 +730,46 @@ namespace RTC
 		}
 	}
 
+	inline void Router::OnTransportProducerRecordingChanged(
+	  RTC::Transport* /*transport*/,
+	  RTC::Producer* /*producer*/,
+	  const std::optional<RTC::RecordingSettings>& /*settings*/)
+	{
+		MS_TRACE();
+
+		// Recording is handled by the media translators manager.
+	}
+
+	inline void Router::OnTransportProducerNeedTranslationUplinkStats(
+	  RTC::Transport* /*transport*/,
+	  const RTC::Producer* /*producer*/,
+	  std::optional<RTC::WebsocketSendStats>& /*stats*/)
+	{
+		MS_TRACE();
+
+		// Translation is handled by the media translators manager.
+	}
+
+	inline void Router::OnTransportProducerNeedTranslationLatencyStats(
+	  RTC::Transport* /*transport*/,
+	  const RTC::Producer* /*producer*/,
+	  RTC::ProducerTranslationLatencyStats& /*stats*/)
+	{
+		MS_TRACE();
+
+		// Translation is handled by the media translators manager.
+	}
+
+	inline void Router::OnTransportConsumerNeedTranslationStats(
+	  RTC::Transport* /*transport*/,
+	  const RTC::Consumer* /*consumer*/,
+	  std::optional<RTC::TranslationStats>& /*stats*/)
+	{
+		MS_TRACE();
+
+		// Translation is handled by the media translators manager.
+	}
+
 	inline void Router::OnTransportNewConsumer(
 	  RTC::Transport* /*transport*/, RTC::Consumer* consumer, const std::string& producerId)
 	{
@@ -934,9 +984,13 @@ namespace RTC
 			DepLibUring::SetActive();
 #endif
 
-			for (auto* dataConsumer : dataConsumers)
 			{
-				dataConsumer->SendMessage(msg, len, ppid, subchannels, requiredSubchannel);
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				for (auto* dataConsumer : dataConsumers)
+				{
+					dataConsumer->SendMessage(msg, len, ppid, subchannels, requiredSubchannel);
+				}
 			}
 
 #ifdef MS_LIBURING_SUPPORTED
@@ -749,6 +749,132 @@ namespace RTC
 		return packet;
 	}
 
+	/**
+	 * Same as Clone() but into the given packet, which must be created by
+	 * Clone() so it owns a buffer. The buffer is reused, so packets can be
+	 * recycled without heap allocations. Returns false (and the given packet
+	 * is not modified) if it doesn't own a buffer or this packet doesn't fit
+	 * into it.
+	 */
+	bool RtpPacket::CloneInto(RtpPacket* packet) const
+	{
+		MS_TRACE();
+
+		if (!packet || !packet->buffer)
+		{
+			MS_WARN_DEV("packet doesn't own a buffer");
+
+			return false;
+		}
+
+		if (this->size > MtuSize + 100)
+		{
+			MS_WARN_DEV("packet too big [size:%zu]", this->size);
+
+			return false;
+		}
+
+		auto* buffer     = packet->buffer;
+		const auto* data = GetData();
+
+		std::memcpy(buffer, data, this->size);
+
+		packet->header   = reinterpret_cast<Header*>(buffer);
+		packet->csrcList = this->csrcList ? buffer + (this->csrcList - data) : nullptr;
+		packet->headerExtension =
+		  this->headerExtension
+		    ? reinterpret_cast<HeaderExtension*>(
+		        buffer + (reinterpret_cast<const uint8_t*>(this->headerExtension) - data))
+		    : nullptr;
+		packet->payload        = buffer + (this->payload - data);
+		packet->payloadLength  = this->payloadLength;
+		packet->payloadPadding = this->payloadPadding;
+		packet->size           = this->size;
+
+		// Keep already set extension ids.
+		packet->midExtensionId               = this->midExtensionId;
+		packet->ridExtensionId               = this->ridExtensionId;
+		packet->rridExtensionId              = this->rridExtensionId;
+		packet->absSendTimeExtensionId       = this->absSendTimeExtensionId;
+		packet->transportWideCc01ExtensionId = this->transportWideCc01ExtensionId;
+		packet->frameMarking07ExtensionId    = this->frameMarking07ExtensionId; // Remove once RFC.
+		packet->frameMarkingExtensionId      = this->frameMarkingExtensionId;
+		packet->ssrcAudioLevelExtensionId    = this->ssrcAudioLevelExtensionId;
+		packet->videoOrientationExtensionId  = this->videoOrientationExtensionId;
+		// Assign the payload descriptor handler.
+		packet->payloadDescriptorHandler = this->payloadDescriptorHandler;
+
+		// Extension elements point into the buffer, parse them again.
+		std::fill(std::begin(packet->oneByteExtensions), std::end(packet->oneByteExtensions), nullptr);
+		packet->mapTwoBytesExtensions.clear();
+		packet->ParseExtensions();
+
+		return true;
+	}
+
+	/**
+	 * Writes the packet into the given buffer with the MID of the given rewrite,
+	 * leaving this packet untouched. The caller is responsible of the buffer
+	 * having space for GetSize() bytes.
+	 */
+	size_t RtpPacket::Write(uint8_t* buffer, const HeaderRewrite& rewrite) const
+	{
+		MS_TRACE();
+
+		std::memcpy(buffer, GetData(), this->size);
+
+		if (!rewrite.mid || rewrite.mid->empty())
+		{
+			return this->size;
+		}
+
+		uint8_t extenLen;
+		uint8_t* extenValue = GetExtension(this->midExtensionId, extenLen);
+
+		if (!extenValue)
+		{
+			return this->size;
+		}
+
+		const auto midLen = static_cast<uint8_t>(rewrite.mid->length());
+
+		// Here we assume that there is MidMaxLength available bytes, even if now
+		// they are padding bytes (same as in UpdateMid()).
+		if (rewrite.mid->length() > RTC::MidMaxLength)
+		{
+			MS_ERROR(
+			  "no enough space for MID value [MidMaxLength:%" PRIu8 ", mid:'%s']",
+			  RTC::MidMaxLength,
+			  rewrite.mid->c_str());
+
+			return this->size;
+		}
+
+		// Same offset in the given buffer.
+		auto* newExtenValue = buffer + (extenValue - GetData());
+
+		std::memcpy(newExtenValue, rewrite.mid->c_str(), midLen);
+
+		// Fill with 0's if new length is minor.
+		if (midLen < extenLen)
+		{
+			std::memset(newExtenValue + midLen, 0, extenLen - midLen);
+		}
+
+		// Rewrite the length, which precedes the value in both extension formats.
+		if (HasOneByteExtensions())
+		{
+			// In One-Byte extensions value length 0 means 1.
+			*(newExtenValue - 1) = static_cast<uint8_t>((this->midExtensionId << 4) | (midLen - 1));
+		}
+		else
+		{
+			*(newExtenValue - 1) = midLen;
+		}
+
+		return this->size;
+	}
+
 	// NOTE: The caller must ensure that the buffer/memmory of the packet has
 	// space enough for adding 2 extra bytes.
 	void RtpPacket::RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq)
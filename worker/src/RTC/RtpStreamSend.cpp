@@ -8,6 +8,7 @@
 #include "Logger.hpp"
 #include "Utils.hpp"
 #include "RTC/RtpDictionaries.hpp"
+#include "handles/UdpSocketHandle.hpp"
 
 namespace RTC
 {
@@ -132,42 +133,47 @@ namespace RTC
 		DepLibUring::SetActive();
 #endif
 
-		for (auto it = nackPacket->Begin(); it != nackPacket->End(); ++it)
+		// Coalesce retransmissions, all of them go to the same destination.
 		{
-			RTC::RTCP::FeedbackRtpNackItem* item = *it;
+			const UdpSocketHandle::SendBatch sendBatch;
 
-			this->nackPacketCount += item->CountRequestedPackets();
+			for (auto it = nackPacket->Begin(); it != nackPacket->End(); ++it)
+			{
+				RTC::RTCP::FeedbackRtpNackItem* item = *it;
 
-			FillRetransmissionContainer(item->GetPacketId(), item->GetLostPacketBitmask());
+				this->nackPacketCount += item->CountRequestedPackets();
 
-			for (auto* item : RetransmissionContainer)
-			{
-				if (!item)
+				FillRetransmissionContainer(item->GetPacketId(), item->GetLostPacketBitmask());
+
+				for (auto* item : RetransmissionContainer)
 				{
-					break;
-				}
+					if (!item)
+					{
+						break;
+					}
 
-				// Note that this is an already RTX encoded packet if RTX is used
-				// (FillRetransmissionContainer() did it).
-				auto packet = item->packet;
+					// Note that this is an already RTX encoded packet if RTX is used
+					// (FillRetransmissionContainer() did it).
+					auto packet = item->packet;
 
-				// Retransmit the packet.
-				static_cast<RTC::RtpStreamSend::Listener*>(this->listener)
-				  ->OnRtpStreamRetransmitRtpPacket(this, packet.get());
+					// Retransmit the packet.
+					static_cast<RTC::RtpStreamSend::Listener*>(this->listener)
+					  ->OnRtpStreamRetransmitRtpPacket(this, packet.get());
 
-				// Mark the packet as retransmitted.
-				RTC::RtpStream::PacketRetransmitted(packet.get());
+					// Mark the packet as retransmitted.
+					RTC::RtpStream::PacketRetransmitted(packet.get());
 
-				// Mark the packet as repaired (only if this is the first retransmission).
-				if (item->sentTimes == 1)
-				{
-					RTC::RtpStream::PacketRepaired(packet.get());
-				}
+					// Mark the packet as repaired (only if this is the first retransmission).
+					if (item->sentTimes == 1)
+					{
+						RTC::RtpStream::PacketRepaired(packet.get());
+					}
 
-				if (HasRtx())
-				{
-					// Restore the packet.
-					packet->RtxDecode(RtpStream::GetPayloadType(), item->ssrc);
+					if (HasRtx())
+					{
+						// Restore the packet.
+						packet->RtxDecode(RtpStream::GetPayloadType(), item->ssrc);
+					}
 				}
 			}
 		}
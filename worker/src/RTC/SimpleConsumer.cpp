@@ -78,7 +78,53 @@ namespace RTC
 		std::vector<flatbuffers::Offset<FBS::RtpStream::Dump>> rtpStreams;
 		rtpStreams.emplace_back(this->rtpStream->FillBuffer(builder));
 
-		auto dump = FBS::Consumer::CreateConsumerDumpDirect(builder, base, &rtpStreams);
+		// Add play-out stats of translated media, if any.
+		std::optional<RTC::TranslationStats> translationStats;
+
+		this->listener->OnConsumerNeedTranslationStats(this, translationStats);
+
+		flatbuffers::Offset<FBS::Consumer::TranslationStats> translationStatsOffset;
+
+		if (translationStats.has_value())
+		{
+			const auto& uplink = translationStats->_uplink;
+
+			auto uplinkStatsOffset = FBS::Producer::CreateTranslationUplinkStats(
+			  builder,
+			  uplink._queuedMessages,
+			  uplink._queuedBytes,
+			  uplink._queueDelayMs,
+			  uplink._droppedMessages,
+			  uplink._droppedBytes,
+			  static_cast<float>(uplink._writeLatencyMs),
+			  uplink._maxWriteLatencyMs,
+			  uplink._congestions,
+			  uplink._congested);
+
+			translationStatsOffset = FBS::Consumer::CreateTranslationStats(
+			  builder,
+			  translationStats->_playedFrames,
+			  translationStats->_lateFrames,
+			  translationStats->_droppedFrames,
+			  translationStats->_bufferedFrames,
+			  static_cast<float>(translationStats->_jitterMs),
+			  static_cast<float>(translationStats->_bufferDelayMs),
+			  translationStats->_maxBufferDelayMs,
+			  translationStats->_sentPackets,
+			  uplinkStatsOffset);
+		}
+
+		auto dump = FBS::Consumer::CreateConsumerDumpDirect(
+		  builder,
+		  base,
+		  &rtpStreams,
+		  flatbuffers::nullopt,
+		  flatbuffers::nullopt,
+		  flatbuffers::nullopt,
+		  flatbuffers::nullopt,
+		  flatbuffers::nullopt,
+		  flatbuffers::nullopt,
+		  translationStatsOffset);
 
 		return FBS::Consumer::CreateDumpResponse(builder, dump);
 	}
@@ -99,7 +145,19 @@ namespace RTC
 			rtpStreams.emplace_back(this->producerRtpStream->FillBufferStats(builder));
 		}
 
-		return FBS::Consumer::CreateGetStatsResponseDirect(builder, &rtpStreams);
+		// Add latencies of the translation service, if any.
+		std::optional<RTC::TranslationStats> translationStats;
+
+		this->listener->OnConsumerNeedTranslationStats(this, translationStats);
+
+		flatbuffers::Offset<FBS::Producer::TranslationEndPointLatency> translationLatencyOffset;
+
+		if (translationStats.has_value())
+		{
+			translationLatencyOffset = translationStats->_latency.FillBuffer(builder);
+		}
+
+		return FBS::Consumer::CreateGetStatsResponseDirect(builder, &rtpStreams, translationLatencyOffset);
 	}
 
 	flatbuffers::Offset<FBS::Consumer::ConsumerScore> SimpleConsumer::FillBufferScore(
@@ -606,6 +664,14 @@ namespace RTC
 		}
 	}
 
+	void SimpleConsumer::UserOnMediaReplaced()
+	{
+		MS_TRACE();
+
+		// Original and translated media have independent sequence numbers.
+		this->syncRequired = true;
+	}
+
 	void SimpleConsumer::CreateRtpStream()
 	{
 		MS_TRACE();
@@ -189,25 +189,15 @@ namespace RTC
 		}
 	}
 
-	bool SrtpSession::EncryptRtp(const uint8_t** data, size_t* len)
+	uint8_t* SrtpSession::GetEncryptBuffer()
 	{
 		MS_TRACE();
 
-		// Ensure that the resulting SRTP packet fits into the encrypt buffer.
-		if (*len + SRTP_MAX_TRAILER_LEN > EncryptBufferSize)
-		{
-			MS_WARN_TAG(srtp, "cannot encrypt RTP packet, size too big (%zu bytes)", *len);
-
-			return false;
-		}
-
-		uint8_t* encryptBuffer = EncryptBuffer;
-
 #ifdef MS_LIBURING_SUPPORTED
 		{
 			if (!DepLibUring::IsActive())
 			{
-				goto protect;
+				goto encryptBuffer;
 			}
 
 			// Use a preallocated buffer, if available.
@@ -215,14 +205,19 @@ namespace RTC
 
 			if (sendBuffer)
 			{
-				encryptBuffer = sendBuffer;
+				return sendBuffer;
 			}
 		}
 
-	protect:
+	encryptBuffer:
 #endif
 
-		std::memcpy(encryptBuffer, *data, *len);
+		return EncryptBuffer;
+	}
+
+	bool SrtpSession::ProtectRtp(uint8_t* encryptBuffer, const uint8_t** data, size_t* len)
+	{
+		MS_TRACE();
 
 		const srtp_err_status_t err = srtp_protect(this->session, encryptBuffer, len);
 
@@ -239,6 +234,54 @@ namespace RTC
 		return true;
 	}
 
+	bool SrtpSession::EncryptRtp(const uint8_t** data, size_t* len)
+	{
+		MS_TRACE();
+
+		// Ensure that the resulting SRTP packet fits into the encrypt buffer.
+		if (*len + SRTP_MAX_TRAILER_LEN > EncryptBufferSize)
+		{
+			MS_WARN_TAG(srtp, "cannot encrypt RTP packet, size too big (%zu bytes)", *len);
+
+			return false;
+		}
+
+		uint8_t* encryptBuffer = GetEncryptBuffer();
+
+		std::memcpy(encryptBuffer, *data, *len);
+
+		return ProtectRtp(encryptBuffer, data, len);
+	}
+
+	/**
+	 * Same as above but the packet is written into the encrypt buffer with the
+	 * given MID, so the per-consumer copy of the packet is the one
+	 * needed for encryption anyway and the packet is not modified.
+	 */
+	bool SrtpSession::EncryptRtp(
+	  const RTC::RtpPacket* packet,
+	  const RTC::RtpPacket::HeaderRewrite& rewrite,
+	  const uint8_t** data,
+	  size_t* len)
+	{
+		MS_TRACE();
+
+		// Ensure that the resulting SRTP packet fits into the encrypt buffer.
+		if (packet->GetSize() + SRTP_MAX_TRAILER_LEN > EncryptBufferSize)
+		{
+			MS_WARN_TAG(
+			  srtp, "cannot encrypt RTP packet, size too big (%zu bytes)", packet->GetSize());
+
+			return false;
+		}
+
+		uint8_t* encryptBuffer = GetEncryptBuffer();
+
+		*len = packet->Write(encryptBuffer, rewrite);
+
+		return ProtectRtp(encryptBuffer, data, len);
+	}
+
 	bool SrtpSession::DecryptSrtp(uint8_t* data, size_t* len)
 	{
 		MS_TRACE();
@@ -24,6 +24,7 @@
 #include "RTC/SimulcastConsumer.hpp"
 #include "RTC/SvcConsumer.hpp"
 #include "RTC/TransportListener.hpp"
+#include "handles/UdpSocketHandle.hpp"
 #include <libwebrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h> // webrtc::RtpPacketSendInfo
 #include <iterator>                                              // std::ostream_iterator
 #include <map>                                                   // std::multimap
@@ -451,6 +452,39 @@ namespace RTC
 			}
 		}
 
+		// Add udpSocketStats.
+		flatbuffers::Offset<FBS::Transport::UdpSocketStats> udpSocketStats;
+		const auto udpSockets = GetUdpSockets();
+
+		if (!udpSockets.empty())
+		{
+			uint64_t recvDatagrams{ 0u };
+			uint64_t recvBatches{ 0u };
+			uint64_t sendGsoCount{ 0u };
+			uint64_t sendGsoSegments{ 0u };
+			uint64_t sendMmsgCount{ 0u };
+			uint64_t sendMmsgDatagrams{ 0u };
+
+			for (const auto* udpSocket : udpSockets)
+			{
+				recvDatagrams += udpSocket->GetRecvDatagrams();
+				recvBatches += udpSocket->GetRecvBatches();
+				sendGsoCount += udpSocket->GetSendGsoCount();
+				sendGsoSegments += udpSocket->GetSendGsoSegments();
+				sendMmsgCount += udpSocket->GetSendMmsgCount();
+				sendMmsgDatagrams += udpSocket->GetSendMmsgDatagrams();
+			}
+
+			udpSocketStats = FBS::Transport::CreateUdpSocketStats(
+			  builder,
+			  recvDatagrams,
+			  recvBatches,
+			  sendGsoCount,
+			  sendGsoSegments,
+			  sendMmsgCount,
+			  sendMmsgDatagrams);
+		}
+
 		return FBS::Transport::CreateStatsDirect(
 		  builder,
 		  // transportId.
@@ -508,7 +542,9 @@ namespace RTC
 		                  : flatbuffers::nullopt,
 		  // packetLossSent.
 		  this->tccClient ? flatbuffers::Optional<double>(this->tccClient->GetPacketLoss())
-		                  : flatbuffers::nullopt);
+		                  : flatbuffers::nullopt,
+		  // udpSocketStats.
+		  udpSocketStats);
 	}
 
 	void Transport::HandleRequest(Channel::ChannelRequest* request)
@@ -2163,48 +2199,52 @@ namespace RTC
 		DepLibUring::SetActive();
 #endif
 
-		for (auto& kv : this->mapConsumers)
 		{
-			auto* consumer = kv.second;
-			auto rtcpAdded = consumer->GetRtcp(packet.get(), nowMs);
+			const UdpSocketHandle::SendBatch sendBatch;
 
-			// RTCP data couldn't be added because the Compound packet is full.
-			// Send the RTCP compound packet and request for RTCP again.
-			if (!rtcpAdded)
+			for (auto& kv : this->mapConsumers)
 			{
-				SendRtcpCompoundPacket(packet.get());
+				auto* consumer = kv.second;
+				auto rtcpAdded = consumer->GetRtcp(packet.get(), nowMs);
 
-				// Create a new compount packet.
-				packet.reset(new RTC::RTCP::CompoundPacket());
+				// RTCP data couldn't be added because the Compound packet is full.
+				// Send the RTCP compound packet and request for RTCP again.
+				if (!rtcpAdded)
+				{
+					SendRtcpCompoundPacket(packet.get());
 
-				// Retrieve the RTCP again.
-				consumer->GetRtcp(packet.get(), nowMs);
-			}
-		}
+					// Create a new compount packet.
+					packet.reset(new RTC::RTCP::CompoundPacket());
 
-		for (auto& kv : this->mapProducers)
-		{
-			auto* producer = kv.second;
-			auto rtcpAdded = producer->GetRtcp(packet.get(), nowMs);
+					// Retrieve the RTCP again.
+					consumer->GetRtcp(packet.get(), nowMs);
+				}
+			}
 
-			// RTCP data couldn't be added because the Compound packet is full.
-			// Send the RTCP compound packet and request for RTCP again.
-			if (!rtcpAdded)
+			for (auto& kv : this->mapProducers)
 			{
-				SendRtcpCompoundPacket(packet.get());
+				auto* producer = kv.second;
+				auto rtcpAdded = producer->GetRtcp(packet.get(), nowMs);
+
+				// RTCP data couldn't be added because the Compound packet is full.
+				// Send the RTCP compound packet and request for RTCP again.
+				if (!rtcpAdded)
+				{
+					SendRtcpCompoundPacket(packet.get());
 
-				// Create a new compount packet.
-				packet.reset(new RTC::RTCP::CompoundPacket());
+					// Create a new compount packet.
+					packet.reset(new RTC::RTCP::CompoundPacket());
 
-				// Retrieve the RTCP again.
-				producer->GetRtcp(packet.get(), nowMs);
+					// Retrieve the RTCP again.
+					producer->GetRtcp(packet.get(), nowMs);
+				}
 			}
-		}
 
-		// Send the RTCP compound packet if there is any sender or receiver report.
-		if (packet->GetReceiverReportCount() > 0u || packet->GetSenderReportCount() > 0u)
-		{
-			SendRtcpCompoundPacket(packet.get());
+			// Send the RTCP compound packet if there is any sender or receiver report.
+			if (packet->GetReceiverReportCount() > 0u || packet->GetSenderReportCount() > 0u)
+			{
+				SendRtcpCompoundPacket(packet.get());
+			}
 		}
 
 #ifdef MS_LIBURING_SUPPORTED
@@ -2443,6 +2483,30 @@ namespace RTC
 		  this, producer, mappedSsrc, worstRemoteFractionLost);
 	}
 
+	inline void Transport::OnProducerRecordingChanged(
+	  RTC::Producer* producer, const std::optional<RTC::RecordingSettings>& settings)
+	{
+		MS_TRACE();
+
+		this->listener->OnTransportProducerRecordingChanged(this, producer, settings);
+	}
+
+	inline void Transport::OnProducerNeedTranslationUplinkStats(
+	  const RTC::Producer* producer, std::optional<RTC::WebsocketSendStats>& stats)
+	{
+		MS_TRACE();
+
+		this->listener->OnTransportProducerNeedTranslationUplinkStats(this, producer, stats);
+	}
+
+	inline void Transport::OnProducerNeedTranslationLatencyStats(
+	  const RTC::Producer* producer, RTC::ProducerTranslationLatencyStats& stats)
+	{
+		MS_TRACE();
+
+		this->listener->OnTransportProducerNeedTranslationLatencyStats(this, producer, stats);
+	}
+
 	inline void Transport::OnConsumerSendRtpPacket(RTC::Consumer* consumer, RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
@@ -2667,6 +2731,14 @@ namespace RTC
 		ComputeOutgoingDesiredBitrate(/*forceBitrate*/ true);
 	}
 
+	inline void Transport::OnConsumerNeedTranslationStats(
+	  const RTC::Consumer* consumer, std::optional<RTC::TranslationStats>& stats)
+	{
+		MS_TRACE();
+
+		this->listener->OnTransportConsumerNeedTranslationStats(this, consumer, stats);
+	}
+
 	inline void Transport::OnConsumerProducerClosed(RTC::Consumer* consumer)
 	{
 		MS_TRACE();
@@ -5,6 +5,7 @@
 #include "RTC/TransportCongestionControlClient.hpp"
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
+#include "handles/UdpSocketHandle.hpp"
 #include <libwebrtc/api/transport/network_types.h> // webrtc::TargetRateConstraints
 #include <limits>
 
@@ -566,7 +567,13 @@ namespace RTC
 			this->rtpTransportControllerSend->Process();
 
 			// Time to call PacedSender::Process().
-			this->rtpTransportControllerSend->packet_sender()->Process();
+			// NOTE: Probation packets of a cluster have mostly the same size, so
+			// coalesce them.
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				this->rtpTransportControllerSend->packet_sender()->Process();
+			}
 
 			/* clang-format off */
 			this->processTimer->Start(std::min<uint64_t>(
@@ -602,6 +602,23 @@ namespace RTC
 		// clang-format on
 	}
 
+	// NOTE: Sockets of a WebRtcServer are shared with other transports.
+	std::vector<const UdpSocketHandle*> WebRtcTransport::GetUdpSockets() const
+	{
+		MS_TRACE();
+
+		std::vector<const UdpSocketHandle*> udpSockets;
+
+		udpSockets.reserve(this->udpSockets.size());
+
+		for (const auto& kv : this->udpSockets)
+		{
+			udpSockets.push_back(kv.first);
+		}
+
+		return udpSockets;
+	}
+
 	void WebRtcTransport::MayRunDtlsTransport()
 	{
 		MS_TRACE();
@@ -683,7 +700,7 @@ namespace RTC
 	}
 
 	void WebRtcTransport::SendRtpPacket(
-	  RTC::Consumer* /*consumer*/, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, RTC::Transport::onSendCallback* cb)
 	{
 		MS_TRACE();
 
@@ -712,10 +729,11 @@ namespace RTC
 			return;
 		}
 
-		const uint8_t* data = packet->GetData();
-		auto len            = packet->GetSize();
+		const uint8_t* data{ nullptr };
+		size_t len{ 0u };
 
-		if (!this->srtpSendSession->EncryptRtp(&data, &len))
+		if (!this->srtpSendSession->EncryptRtp(
+		      packet, RTC::Transport::GetHeaderRewrite(consumer), &data, &len))
 		{
 			if (cb)
 			{
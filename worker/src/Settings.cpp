@@ -5,6 +5,7 @@
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
+#include "handles/UdpSocketHandle.hpp"
 #include <flatbuffers/flatbuffers.h>
 #include <cctype>   // isprint()
 #include <iterator> // std::ostream_iterator
@@ -60,6 +61,9 @@ void Settings::SetConfiguration(int argc, char* argv[])
 		{ "dtlsCertificateFile",  optional_argument, nullptr, 'c' },
 		{ "dtlsPrivateKeyFile",   optional_argument, nullptr, 'p' },
 		{ "libwebrtcFieldTrials", optional_argument, nullptr, 'W' },
+		{ "translationThreads",   optional_argument, nullptr, 'T' },
+		{ "udpRecvBatchSize",     optional_argument, nullptr, 'B' },
+		{ "liburingRecv",         no_argument,       nullptr, 'R' },
 		{ nullptr, 0, nullptr, 0 }
 	};
 	// clang-format on
@@ -158,6 +162,49 @@ void Settings::SetConfiguration(int argc, char* argv[])
 				break;
 			}
 
+			case 'T':
+			{
+				try
+				{
+					Settings::configuration.translationThreads = static_cast<uint32_t>(std::stoul(optarg));
+				}
+				catch (const std::exception& error)
+				{
+					MS_THROW_TYPE_ERROR("%s", error.what());
+				}
+
+				break;
+			}
+
+			case 'B':
+			{
+				try
+				{
+					Settings::configuration.udpRecvBatchSize = static_cast<uint32_t>(std::stoul(optarg));
+				}
+				catch (const std::exception& error)
+				{
+					MS_THROW_TYPE_ERROR("%s", error.what());
+				}
+
+				if (
+				  Settings::configuration.udpRecvBatchSize == 0u ||
+				  Settings::configuration.udpRecvBatchSize > UdpSocketHandle::MaxRecvBatchSize)
+				{
+					MS_THROW_TYPE_ERROR(
+					  "udpRecvBatchSize must be between 1 and %zu", UdpSocketHandle::MaxRecvBatchSize);
+				}
+
+				break;
+			}
+
+			case 'R':
+			{
+				Settings::configuration.liburingRecv = true;
+
+				break;
+			}
+
 			// Invalid option.
 			case '?':
 			{
@@ -288,6 +335,10 @@ void Settings::PrintConfiguration()
 		MS_DEBUG_TAG(
 		  info, "  libwebrtcFieldTrials: %s", Settings::configuration.libwebrtcFieldTrials.c_str());
 	}
+	MS_DEBUG_TAG(info, "  translationThreads: %" PRIu32, Settings::configuration.translationThreads);
+	MS_DEBUG_TAG(info, "  udpRecvBatchSize: %" PRIu32, Settings::configuration.udpRecvBatchSize);
+	MS_DEBUG_TAG(
+	  info, "  liburingRecv: %s", Settings::configuration.liburingRecv ? "true" : "false");
 
 	MS_DEBUG_TAG(info, "</configuration>");
 }
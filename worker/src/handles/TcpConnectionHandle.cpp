@@ -9,7 +9,8 @@
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
-#include <cstring> // std::memcpy()
+#include <algorithm> // std::min()
+#include <cstring>   // std::memcpy()
 
 /* Static methods for UV callbacks. */
 
@@ -33,6 +34,16 @@ inline static void onRead(uv_stream_t* handle, ssize_t nread, const uv_buf_t* bu
 	}
 }
 
+#ifdef MS_LIBURING_SUPPORTED
+inline static size_t onUringRecv(
+  void* data, const uint8_t* buf, ssize_t nread, const struct sockaddr* /*addr*/)
+{
+	auto* connection = static_cast<TcpConnectionHandle*>(data);
+
+	return connection->OnUringRecv(buf, nread);
+}
+#endif
+
 inline static void onWrite(uv_write_t* req, int status)
 {
 	auto* writeData  = static_cast<TcpConnectionHandle::UvWriteData*>(req->data);
@@ -112,6 +123,13 @@ void TcpConnectionHandle::Close()
 	// Tell the UV handle that the TcpConnectionHandle has been closed.
 	this->uvHandle->data = nullptr;
 
+#ifdef MS_LIBURING_SUPPORTED
+	if (this->uringRecv)
+	{
+		DepLibUring::StopRecv(this->fd);
+	}
+#endif
+
 	// Don't read more.
 	err = uv_read_stop(reinterpret_cast<uv_stream_t*>(this->uvHandle));
 
@@ -187,17 +205,6 @@ void TcpConnectionHandle::Start()
 		return;
 	}
 
-	// NOLINTNEXTLINE(misc-const-correctness)
-	int err = uv_read_start(
-	  reinterpret_cast<uv_stream_t*>(this->uvHandle),
-	  static_cast<uv_alloc_cb>(onAlloc),
-	  static_cast<uv_read_cb>(onRead));
-
-	if (err != 0)
-	{
-		MS_THROW_ERROR("uv_read_start() failed: %s", uv_strerror(err));
-	}
-
 	// Get the peer address.
 	if (!SetPeerAddress())
 	{
@@ -205,13 +212,26 @@ void TcpConnectionHandle::Start()
 	}
 
 #ifdef MS_LIBURING_SUPPORTED
-	err = uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(this->fd));
+	const int err = uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(this->fd));
 
 	if (err != 0)
 	{
 		MS_THROW_ERROR("uv_fileno() failed: %s", uv_strerror(err));
 	}
+
+	// Receive with multishot recv() over io_uring, so no syscall is needed per
+	// read. Otherwise (not enabled, not supported or no free entry) fall back to
+	// libuv.
+	this->uringRecv =
+	  DepLibUring::StartRecv(this->fd, static_cast<DepLibUring::onRecvCallback>(onUringRecv), this);
+
+	if (this->uringRecv)
+	{
+		return;
+	}
 #endif
+
+	StartReadLibUv();
 }
 
 void TcpConnectionHandle::Write(
@@ -371,6 +391,21 @@ void TcpConnectionHandle::ErrorReceiving()
 	this->listener->OnTcpConnectionClosed(this);
 }
 
+void TcpConnectionHandle::StartReadLibUv()
+{
+	MS_TRACE();
+
+	const int err = uv_read_start(
+	  reinterpret_cast<uv_stream_t*>(this->uvHandle),
+	  static_cast<uv_alloc_cb>(onAlloc),
+	  static_cast<uv_read_cb>(onRead));
+
+	if (err != 0)
+	{
+		MS_THROW_ERROR("uv_read_start() failed: %s", uv_strerror(err));
+	}
+}
+
 bool TcpConnectionHandle::SetPeerAddress()
 {
 	MS_TRACE();
@@ -502,3 +537,74 @@ inline void TcpConnectionHandle::OnUvWrite(int status, TcpConnectionHandle::onSe
 		this->listener->OnTcpConnectionClosed(this);
 	}
 }
+
+#ifdef MS_LIBURING_SUPPORTED
+inline size_t TcpConnectionHandle::OnUringRecv(const uint8_t* data, ssize_t nread)
+{
+	MS_TRACE();
+
+	// Receiving over io_uring is not possible for this connection, go on with libuv.
+	if (nread == -EINVAL || nread == -EOPNOTSUPP || nread == -ENOBUFS)
+	{
+		MS_WARN_TAG(
+		  info, "io_uring receive stopped, falling back to libuv: %s", std::strerror(-nread));
+
+		this->uringRecv = false;
+
+		const int err = uv_read_start(
+		  reinterpret_cast<uv_stream_t*>(this->uvHandle),
+		  static_cast<uv_alloc_cb>(onAlloc),
+		  static_cast<uv_read_cb>(onRead));
+
+		if (err != 0)
+		{
+			MS_WARN_DEV("uv_read_start() failed, closing the connection: %s", uv_strerror(err));
+
+			this->hasError = true;
+
+			Close();
+
+			this->listener->OnTcpConnectionClosed(this);
+		}
+
+		return 0u;
+	}
+
+	// EOF and errors, libuv errors are negated errno values too.
+	if (nread <= 0)
+	{
+		this->uringRecv = false;
+
+		OnUvRead(nread == 0 ? static_cast<ssize_t>(UV_EOF) : nread, nullptr);
+
+		return 0u;
+	}
+
+	// If this is the first read then allocate the receiving buffer now.
+	if (!this->buffer)
+	{
+		this->buffer = new uint8_t[this->bufferSize];
+	}
+
+	// Data was already received, so take as much as fits after the last data
+	// byte in the buffer, the rest is given again once the subclass made room.
+	const size_t len = std::min(static_cast<size_t>(nread), this->bufferSize - this->bufferDataLen);
+
+	// Like libuv reading into an empty buffer.
+	if (len == 0)
+	{
+		MS_WARN_DEV("no available space in the buffer");
+
+		OnUvRead(UV_ENOBUFS, nullptr);
+
+		return 0u;
+	}
+
+	std::memcpy(this->buffer + this->bufferDataLen, data, len);
+
+	// NOTE: This may close and delete the connection.
+	OnUvRead(static_cast<ssize_t>(len), nullptr);
+
+	return len;
+}
+#endif
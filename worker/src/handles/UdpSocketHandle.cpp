@@ -7,13 +7,33 @@
 #endif
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
 #include "Utils.hpp"
-#include <cstring> // std::memcpy()
+#include <algorithm> // std::clamp(), std::find()
+#include <cstring>   // std::memcpy()
+#include <vector>
+#ifdef __linux__
+#include <netinet/udp.h> // UDP_SEGMENT
+#include <sys/socket.h>  // sendmsg(), sendmmsg()
+#endif
 
 /* Static. */
 
+// Slot of a single datagram, libuv splits the read buffer into slots of this size.
 static constexpr size_t ReadBufferSize{ 65536 };
-thread_local static uint8_t ReadBuffer[ReadBufferSize];
+// Shared by all sockets of the thread, grows up to the largest batch.
+thread_local static std::vector<uint8_t> ReadBuffer;
+// Nesting depth of send batches, datagrams are queued while greater than 0.
+thread_local static size_t SendBatchDepth{ 0u };
+// Sockets with queued datagrams.
+thread_local static std::vector<UdpSocketHandle*> SendBatchSockets;
+// Queued datagrams of a socket not sent with GSO.
+thread_local static std::vector<UdpSocketHandle::QueuedDatagram> SendBatchDatagrams;
+#ifdef __linux__
+// Headers for sendmmsg().
+thread_local static std::vector<struct mmsghdr> SendMmsgHeaders;
+thread_local static std::vector<struct iovec> SendMmsgIovecs;
+#endif
 
 /* Static methods for UV callbacks. */
 
@@ -38,6 +58,18 @@ inline static void onRecv(
 	}
 }
 
+#ifdef MS_LIBURING_SUPPORTED
+inline static size_t onUringRecv(
+  void* data, const uint8_t* buf, ssize_t nread, const struct sockaddr* addr)
+{
+	auto* socket = static_cast<UdpSocketHandle*>(data);
+
+	socket->OnUringRecv(buf, nread, addr);
+
+	return nread > 0 ? static_cast<size_t>(nread) : 0u;
+}
+#endif
+
 inline static void onSend(uv_udp_send_t* req, int status)
 {
 	auto* sendData = static_cast<UdpSocketHandle::UvSendData*>(req->data);
@@ -59,25 +91,44 @@ inline static void onCloseUdp(uv_handle_t* handle)
 	delete reinterpret_cast<uv_udp_t*>(handle);
 }
 
-/* Instance methods. */
+/* SendBatch. */
 
-// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-UdpSocketHandle::UdpSocketHandle(uv_udp_t* uvHandle) : uvHandle(uvHandle)
+UdpSocketHandle::SendBatch::SendBatch()
 {
 	MS_TRACE();
 
-	this->uvHandle->data = static_cast<void*>(this);
+	++SendBatchDepth;
+}
 
-	// NOLINTNEXTLINE(misc-const-correctness)
-	int err = uv_udp_recv_start(
-	  this->uvHandle, static_cast<uv_alloc_cb>(onAlloc), static_cast<uv_udp_recv_cb>(onRecv));
+UdpSocketHandle::SendBatch::~SendBatch()
+{
+	MS_TRACE();
 
-	if (err != 0)
+	if (--SendBatchDepth > 0u)
 	{
-		uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onCloseUdp));
+		return;
+	}
 
-		MS_THROW_ERROR("uv_udp_recv_start() failed: %s", uv_strerror(err));
+	// NOTE: A closed socket sends its datagrams and leaves the list.
+	while (!SendBatchSockets.empty())
+	{
+		auto* socket = SendBatchSockets.back();
+
+		SendBatchSockets.pop_back();
+		socket->SendQueuedDatagrams();
 	}
+}
+
+/* Instance methods. */
+
+// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+UdpSocketHandle::UdpSocketHandle(uv_udp_t* uvHandle)
+  : uvHandle(uvHandle),
+    recvBatchSize(std::clamp<size_t>(Settings::configuration.udpRecvBatchSize, 1u, MaxRecvBatchSize))
+{
+	MS_TRACE();
+
+	this->uvHandle->data = static_cast<void*>(this);
 
 	// Set local address.
 	if (!SetLocalAddress())
@@ -88,13 +139,28 @@ UdpSocketHandle::UdpSocketHandle(uv_udp_t* uvHandle) : uvHandle(uvHandle)
 	}
 
 #ifdef MS_LIBURING_SUPPORTED
-	err = uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(this->fd));
+	const int err = uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(this->fd));
 
 	if (err != 0)
 	{
+		uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onCloseUdp));
+
 		MS_THROW_ERROR("uv_fileno() failed: %s", uv_strerror(err));
 	}
+
+	// Receive with multishot recvmsg() over io_uring, so no syscall is needed
+	// per datagram. Otherwise (not enabled, not supported or no free entry) fall
+	// back to libuv.
+	this->uringRecv =
+	  DepLibUring::StartRecvMsg(this->fd, static_cast<DepLibUring::onRecvCallback>(onUringRecv), this);
+
+	if (this->uringRecv)
+	{
+		return;
+	}
 #endif
+
+	StartRecvLibUv();
 }
 
 UdpSocketHandle::~UdpSocketHandle()
@@ -116,11 +182,31 @@ void UdpSocketHandle::Close()
 		return;
 	}
 
+	// Send datagrams queued in the current batch.
+	if (this->sendQueuesCount > 0u)
+	{
+		auto it = std::find(SendBatchSockets.begin(), SendBatchSockets.end(), this);
+
+		if (it != SendBatchSockets.end())
+		{
+			SendBatchSockets.erase(it);
+		}
+
+		SendQueuedDatagrams();
+	}
+
 	this->closed = true;
 
 	// Tell the UV handle that the UdpSocketHandle has been closed.
 	this->uvHandle->data = nullptr;
 
+#ifdef MS_LIBURING_SUPPORTED
+	if (this->uringRecv)
+	{
+		DepLibUring::StopRecv(this->fd);
+	}
+#endif
+
 	// Don't read more.
 	const int err = uv_udp_recv_stop(this->uvHandle);
 
@@ -138,6 +224,20 @@ void UdpSocketHandle::Dump() const
 	MS_DUMP("  localIp: %s", this->localIp.c_str());
 	MS_DUMP("  localPort: %" PRIu16, static_cast<uint16_t>(this->localPort));
 	MS_DUMP("  closed: %s", this->closed ? "yes" : "no");
+#ifdef MS_LIBURING_SUPPORTED
+	MS_DUMP("  uringRecv: %s", this->uringRecv ? "yes" : "no");
+#endif
+	MS_DUMP("  recvBatchSize: %zu", this->recvBatchSize);
+	MS_DUMP(
+	  "  recvDatagramsPerBatch: %.2f",
+	  this->recvBatches ? static_cast<double>(this->recvDatagrams) / this->recvBatches : 0.);
+	MS_DUMP("  sendGsoEnabled: %s", this->sendGsoEnabled ? "yes" : "no");
+	MS_DUMP(
+	  "  sendSegmentsPerGsoSend: %.2f",
+	  this->sendGsoCount ? static_cast<double>(this->sendGsoSegments) / this->sendGsoCount : 0.);
+	MS_DUMP(
+	  "  sendDatagramsPerMmsgSend: %.2f",
+	  this->sendMmsgCount ? static_cast<double>(this->sendMmsgDatagrams) / this->sendMmsgCount : 0.);
 	MS_DUMP("</UdpSocketHandle>");
 }
 
@@ -168,6 +268,45 @@ void UdpSocketHandle::Send(
 		return;
 	}
 
+#ifdef __linux__
+	// Gather it with other datagrams to the same destination, they are sent at
+	// the end of the batch.
+	if (SendBatchDepth > 0u && len <= MaxSendGsoSize && CanSendBatched())
+	{
+		QueueDatagram(data, len, addr, cb);
+
+		return;
+	}
+#endif
+
+	SendDatagram(data, len, addr, cb);
+}
+
+bool UdpSocketHandle::CanSendBatched() const
+{
+	MS_TRACE();
+
+#ifdef MS_LIBURING_SUPPORTED
+	// Without GSO queued datagrams would become SQEs one by one, so they would be
+	// copied twice for nothing. Send them via liburing right away instead.
+	if (DepLibUring::IsActive())
+	{
+#ifdef UDP_SEGMENT
+		return this->sendGsoEnabled;
+#else
+		return false;
+#endif
+	}
+#endif
+
+	return true;
+}
+
+void UdpSocketHandle::SendDatagram(
+  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandle::onSendCallback* cb)
+{
+	MS_TRACE();
+
 #ifdef MS_LIBURING_SUPPORTED
 	{
 		if (!DepLibUring::IsActive())
@@ -266,6 +405,316 @@ send_libuv:
 	}
 }
 
+void UdpSocketHandle::QueueDatagram(
+  const uint8_t* data, size_t len, const struct sockaddr* addr, UdpSocketHandle::onSendCallback* cb)
+{
+	MS_TRACE();
+
+	SendQueue* queue{ nullptr };
+
+	// There are few destinations per socket and batch, unless it is shared by
+	// many transports.
+	for (size_t i{ 0u }; i < this->sendQueuesCount; ++i)
+	{
+		if (Utils::IP::CompareAddresses(
+		      reinterpret_cast<const struct sockaddr*>(&this->sendQueues[i].addr), addr))
+		{
+			queue = std::addressof(this->sendQueues[i]);
+
+			break;
+		}
+	}
+
+	if (!queue)
+	{
+		if (this->sendQueuesCount == 0u)
+		{
+			SendBatchSockets.push_back(this);
+		}
+
+		// Queues are kept once allocated.
+		if (this->sendQueuesCount == this->sendQueues.size())
+		{
+			this->sendQueues.emplace_back();
+		}
+
+		queue       = std::addressof(this->sendQueues[this->sendQueuesCount++]);
+		queue->addr = Utils::IP::CopyAddress(addr);
+	}
+
+	queue->data.insert(queue->data.end(), data, data + len);
+	queue->lens.push_back(len);
+	queue->cbs.push_back(cb);
+}
+
+void UdpSocketHandle::SendQueuedDatagrams()
+{
+	MS_TRACE();
+
+	for (size_t q{ 0u }; q < this->sendQueuesCount; ++q)
+	{
+		auto& queue      = this->sendQueues[q];
+		const auto* addr = reinterpret_cast<const struct sockaddr*>(&queue.addr);
+		const auto count = queue.lens.size();
+		size_t offset{ 0u };
+
+		for (size_t i{ 0u }; i < count;)
+		{
+			// Segments of a GSO send have the same size, but the last one may be
+			// shorter.
+			const size_t segmentSize = queue.lens[i];
+			size_t segments{ 1u };
+			size_t len{ segmentSize };
+
+			while (i + segments < count && segments < MaxSendSegments)
+			{
+				const size_t nextLen = queue.lens[i + segments];
+
+				if (nextLen > segmentSize || len + nextLen > MaxSendGsoSize)
+				{
+					break;
+				}
+
+				len += nextLen;
+				++segments;
+
+				if (nextLen < segmentSize)
+				{
+					break;
+				}
+			}
+
+			bool sentGso{ false };
+
+			if (segments > 1u && this->sendGsoEnabled)
+			{
+				// Datagrams queued before must not be overtaken.
+				if (!SendBatchDatagrams.empty())
+				{
+					SendDatagrams(SendBatchDatagrams);
+					SendBatchDatagrams.clear();
+				}
+
+				sentGso = SendGso(queue.data.data() + offset, len, segmentSize, addr);
+			}
+
+			if (sentGso)
+			{
+				// Update sent bytes.
+				this->sentBytes += len;
+
+				++this->sendGsoCount;
+				this->sendGsoSegments += segments;
+
+				for (size_t j{ i }; j < i + segments; ++j)
+				{
+					auto* cb = queue.cbs[j];
+
+					if (cb)
+					{
+						(*cb)(true);
+						delete cb;
+					}
+				}
+			}
+			// Mixed sizes or GSO failed, send them together with sendmmsg().
+			else
+			{
+				size_t datagramOffset{ offset };
+
+				for (size_t j{ i }; j < i + segments; ++j)
+				{
+					SendBatchDatagrams.push_back(
+					  { queue.data.data() + datagramOffset, queue.lens[j], addr, queue.cbs[j] });
+
+					datagramOffset += queue.lens[j];
+				}
+			}
+
+			offset += len;
+			i += segments;
+		}
+	}
+
+	SendDatagrams(SendBatchDatagrams);
+	SendBatchDatagrams.clear();
+
+	for (size_t q{ 0u }; q < this->sendQueuesCount; ++q)
+	{
+		auto& queue = this->sendQueues[q];
+
+		queue.data.clear();
+		queue.lens.clear();
+		queue.cbs.clear();
+	}
+
+	this->sendQueuesCount = 0u;
+}
+
+void UdpSocketHandle::SendDatagrams(const std::vector<QueuedDatagram>& datagrams)
+{
+	MS_TRACE();
+
+	size_t sent{ 0u };
+
+#ifdef MS_LIBURING_SUPPORTED
+	// They become SQEs of the current liburing batch.
+	if (DepLibUring::IsActive())
+	{
+		goto send_one_by_one;
+	}
+#endif
+
+#ifdef __linux__
+	if (datagrams.size() > 1u)
+	{
+		uv_os_fd_t fd;
+
+		if (uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(fd)) != 0)
+		{
+			goto send_one_by_one;
+		}
+
+		SendMmsgHeaders.resize(datagrams.size());
+		SendMmsgIovecs.resize(datagrams.size());
+
+		for (size_t i{ 0u }; i < datagrams.size(); ++i)
+		{
+			const auto& datagram = datagrams[i];
+			auto& iov            = SendMmsgIovecs[i];
+			auto& msg            = SendMmsgHeaders[i];
+
+			iov.iov_base = const_cast<uint8_t*>(datagram.data);
+			iov.iov_len  = datagram.len;
+
+			msg                     = {};
+			msg.msg_hdr.msg_name    = const_cast<struct sockaddr*>(datagram.addr);
+			msg.msg_hdr.msg_namelen = Utils::IP::GetAddressLen(datagram.addr);
+			msg.msg_hdr.msg_iov     = std::addressof(iov);
+			msg.msg_hdr.msg_iovlen  = 1;
+		}
+
+		const int ret =
+		  sendmmsg(fd, SendMmsgHeaders.data(), static_cast<unsigned int>(datagrams.size()), 0);
+
+		if (ret > 0)
+		{
+			sent = static_cast<size_t>(ret);
+
+			++this->sendMmsgCount;
+			this->sendMmsgDatagrams += sent;
+
+			for (size_t i{ 0u }; i < sent; ++i)
+			{
+				auto* cb = datagrams[i].cb;
+
+				// Update sent bytes.
+				this->sentBytes += SendMmsgHeaders[i].msg_len;
+
+				if (cb)
+				{
+					(*cb)(true);
+					delete cb;
+				}
+			}
+		}
+		else if (ret < 0)
+		{
+			MS_DEBUG_DEV("sendmmsg() failed: %s", std::strerror(errno));
+		}
+	}
+#endif
+
+#if defined(MS_LIBURING_SUPPORTED) || defined(__linux__)
+send_one_by_one:
+#endif
+
+	// Not sent ones (i.e. EAGAIN or an error in the middle) are sent one by one,
+	// which queues them in libuv or reports the error to their callbacks.
+	for (size_t i{ sent }; i < datagrams.size(); ++i)
+	{
+		const auto& datagram = datagrams[i];
+
+		SendDatagram(datagram.data, datagram.len, datagram.addr, datagram.cb);
+	}
+}
+
+bool UdpSocketHandle::SendGso(
+  const uint8_t* data, size_t len, size_t segmentSize, const struct sockaddr* addr)
+{
+	MS_TRACE();
+
+#ifdef UDP_SEGMENT
+	if (!this->sendGsoEnabled)
+	{
+		return false;
+	}
+
+	uv_os_fd_t fd;
+
+	if (uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), std::addressof(fd)) != 0)
+	{
+		return false;
+	}
+
+	struct iovec iov
+	{
+	};
+	struct msghdr msg
+	{
+	};
+	alignas(struct cmsghdr) uint8_t control[CMSG_SPACE(sizeof(uint16_t))] = {};
+	const auto gsoSize = static_cast<uint16_t>(segmentSize);
+
+	iov.iov_base = const_cast<uint8_t*>(data);
+	iov.iov_len  = len;
+
+	msg.msg_name       = const_cast<struct sockaddr*>(addr);
+	msg.msg_namelen    = Utils::IP::GetAddressLen(addr);
+	msg.msg_iov        = std::addressof(iov);
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = control;
+	msg.msg_controllen = sizeof(control);
+
+	// The kernel splits the buffer into datagrams of gsoSize bytes.
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(std::addressof(msg));
+
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type  = UDP_SEGMENT;
+	cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+	std::memcpy(CMSG_DATA(cmsg), std::addressof(gsoSize), sizeof(gsoSize));
+
+	const ssize_t sent = sendmsg(fd, std::addressof(msg), 0);
+
+	if (sent == static_cast<ssize_t>(len))
+	{
+		return true;
+	}
+
+	if (sent < 0)
+	{
+		const int error = errno;
+
+		// No GSO in the kernel or no checksum offload in the device, don't try again.
+		if (error == ENOPROTOOPT || error == EOPNOTSUPP || error == EIO)
+		{
+			MS_WARN_TAG(info, "UDP GSO not supported, disabling it: %s", std::strerror(error));
+
+			this->sendGsoEnabled = false;
+		}
+		// Others (i.e. EAGAIN or segments larger than MTU) are left to single sends.
+		else
+		{
+			MS_DEBUG_DEV("sendmsg() with UDP_SEGMENT failed: %s", std::strerror(error));
+		}
+	}
+
+	return false;
+#else
+	return false;
+#endif
+}
+
 uint32_t UdpSocketHandle::GetSendBufferSize() const
 {
 	MS_TRACE();
@@ -363,15 +812,39 @@ bool UdpSocketHandle::SetLocalAddress()
 	return true;
 }
 
+void UdpSocketHandle::StartRecvLibUv()
+{
+	MS_TRACE();
+
+	const int err = uv_udp_recv_start(
+	  this->uvHandle, static_cast<uv_alloc_cb>(onAlloc), static_cast<uv_udp_recv_cb>(onRecv));
+
+	if (err != 0)
+	{
+		uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onCloseUdp));
+
+		MS_THROW_ERROR("uv_udp_recv_start() failed: %s", uv_strerror(err));
+	}
+}
+
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 inline void UdpSocketHandle::OnUvRecvAlloc(size_t /*suggestedSize*/, uv_buf_t* buf)
 {
 	MS_TRACE();
 
+	// With UV_UDP_RECVMMSG libuv receives one datagram per slot with a single
+	// recvmmsg() call, so give it a slot for each datagram of the batch.
+	const size_t size = ReadBufferSize * this->recvBatchSize;
+
+	if (ReadBuffer.size() < size)
+	{
+		ReadBuffer.resize(size);
+	}
+
 	// Tell UV to write into the static buffer.
-	buf->base = reinterpret_cast<char*>(ReadBuffer);
+	buf->base = reinterpret_cast<char*>(ReadBuffer.data());
 	// Give UV all the buffer space.
-	buf->len = ReadBufferSize;
+	buf->len = size;
 }
 
 inline void UdpSocketHandle::OnUvRecv(
@@ -379,6 +852,14 @@ inline void UdpSocketHandle::OnUvRecv(
 {
 	MS_TRACE();
 
+	// End of batch received by recvmmsg(), all its datagrams were dispatched in order.
+	if ((flags & UV_UDP_MMSG_FREE) != 0u)
+	{
+		++this->recvBatches;
+
+		return;
+	}
+
 	// NOTE: Ignore if there is nothing to read or if it was an empty datagram.
 	if (nread == 0)
 	{
@@ -398,6 +879,13 @@ inline void UdpSocketHandle::OnUvRecv(
 	{
 		// Update received bytes.
 		this->recvBytes += nread;
+		++this->recvDatagrams;
+
+		// Datagram received by recvmsg() is a batch of one.
+		if ((flags & UV_UDP_MMSG_CHUNK) == 0u)
+		{
+			++this->recvBatches;
+		}
 
 		// Notify the subclass.
 		UserOnUdpDatagramReceived(reinterpret_cast<uint8_t*>(buf->base), nread, addr);
@@ -435,3 +923,44 @@ inline void UdpSocketHandle::OnUvSend(int status, UdpSocketHandle::onSendCallbac
 		}
 	}
 }
+
+#ifdef MS_LIBURING_SUPPORTED
+inline void UdpSocketHandle::OnUringRecv(
+  const uint8_t* data, ssize_t nread, const struct sockaddr* addr)
+{
+	MS_TRACE();
+
+	// Receiving over io_uring was stopped, go on with libuv.
+	if (nread < 0)
+	{
+		MS_WARN_TAG(
+		  info, "io_uring receive stopped, falling back to libuv: %s", std::strerror(-nread));
+
+		this->uringRecv = false;
+
+		const int err = uv_udp_recv_start(
+		  this->uvHandle, static_cast<uv_alloc_cb>(onAlloc), static_cast<uv_udp_recv_cb>(onRecv));
+
+		if (err != 0)
+		{
+			MS_ERROR("uv_udp_recv_start() failed: %s", uv_strerror(err));
+		}
+
+		return;
+	}
+
+	// NOTE: Ignore if it was an empty datagram.
+	if (nread == 0)
+	{
+		return;
+	}
+
+	// Update received bytes.
+	// NOTE: Receive batches are not counted since no syscall is involved.
+	this->recvBytes += nread;
+	++this->recvDatagrams;
+
+	// Notify the subclass.
+	UserOnUdpDatagramReceived(data, nread, addr);
+}
+#endif
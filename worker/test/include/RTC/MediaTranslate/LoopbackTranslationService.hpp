@@ -0,0 +1,81 @@
+#ifndef MS_TEST_RTC_LOOPBACK_TRANSLATION_SERVICE_HPP
+#define MS_TEST_RTC_LOOPBACK_TRANSLATION_SERVICE_HPP
+
+#include "common.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace RTC
+{
+	// In-process stand-in of the translation service for tests and load tests.
+	// Translation commands (JSON text) are accepted and recorded, media (binary) is
+	// echoed back in order after configurable delay, so the echoed WebM stream is a
+	// valid "translation" for TranslatorEndPoint. Served on the loopback interface by
+	// its own thread.
+	class LoopbackTranslationService
+	{
+	private:
+		class Server;
+		template<class TConfig>
+		class ServerImpl;
+
+	public:
+		struct Options
+		{
+			bool tls{ false };
+			// Echo delay which emulates translation time, each message is shifted
+			// by uniformly distributed [-jitterMs, +jitterMs] but order is kept.
+			uint32_t delayMs{ 0u };
+			uint32_t jitterMs{ 0u };
+			// PEM, for TLS only.
+			std::string certificate;
+			std::string privateKey;
+		};
+
+		struct Stats
+		{
+			uint64_t connections{ 0u };
+			uint64_t commands{ 0u };
+			uint64_t receivedMessages{ 0u };
+			uint64_t receivedBytes{ 0u };
+			uint64_t echoedMessages{ 0u };
+		};
+
+	public:
+		explicit LoopbackTranslationService(Options options);
+		~LoopbackTranslationService();
+
+	public:
+		// Zero [port] binds to an ephemeral port.
+		bool Start(uint16_t port = 0u);
+		void Stop();
+		// ws:// or wss:// URI of the running service, empty if not started.
+		std::string GetUri() const;
+		Stats GetStats() const;
+		std::string GetLastCommand() const;
+		// Reads PEM files of test/data.
+		static Options CreateTlsOptions(uint32_t delayMs = 0u, uint32_t jitterMs = 0u);
+
+	private:
+		void OnConnection();
+		void OnCommand(const std::string& command);
+		void OnMedia(size_t size);
+		void OnEcho();
+
+	private:
+		const Options options;
+		std::unique_ptr<Server> server;
+		uint16_t port{ 0u };
+		std::atomic<uint64_t> connections{ 0u };
+		std::atomic<uint64_t> commands{ 0u };
+		std::atomic<uint64_t> receivedMessages{ 0u };
+		std::atomic<uint64_t> receivedBytes{ 0u };
+		std::atomic<uint64_t> echoedMessages{ 0u };
+		mutable std::mutex lastCommandMutex;
+		std::string lastCommand;
+	};
+} // namespace RTC
+
+#endif
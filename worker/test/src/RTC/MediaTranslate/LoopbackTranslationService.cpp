@@ -0,0 +1,368 @@
+#include "RTC/MediaTranslate/LoopbackTranslationService.hpp"
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <websocketpp/config/asio.hpp>
+#include <websocketpp/server.hpp>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace
+{
+	std::string ReadTextFile(const std::string& file)
+	{
+		std::ifstream in("test/" + file);
+		std::stringstream content;
+
+		content << in.rdbuf();
+
+		return content.str();
+	}
+} // namespace
+
+namespace RTC
+{
+	class LoopbackTranslationService::Server
+	{
+	public:
+		virtual ~Server() = default;
+
+	public:
+		// Return the bound port, zero on failure.
+		virtual uint16_t Start(uint16_t port) = 0;
+		virtual void Stop()                   = 0;
+	};
+
+	template<class TConfig>
+	class LoopbackTranslationService::ServerImpl : public LoopbackTranslationService::Server
+	{
+		using EndPoint   = websocketpp::server<TConfig>;
+		using MessagePtr = typename EndPoint::message_ptr;
+		using Clock      = std::chrono::steady_clock;
+
+	public:
+		explicit ServerImpl(LoopbackTranslationService* service);
+		~ServerImpl() override;
+
+	public:
+		uint16_t Start(uint16_t port) override;
+		void Stop() override;
+
+	private:
+		void OnOpen(websocketpp::connection_hdl hdl);
+		void OnClose(websocketpp::connection_hdl hdl);
+		void OnMessage(websocketpp::connection_hdl hdl, MessagePtr message);
+		void Echo(websocketpp::connection_hdl hdl, std::string payload);
+		Clock::duration GetDelay();
+
+	private:
+		LoopbackTranslationService* const service;
+		asio::io_context context;
+		EndPoint server;
+		std::thread thread;
+		std::mt19937 random;
+		// Send time of the last echoed message of each connection, keeps the order.
+		std::map<websocketpp::connection_hdl, Clock::time_point, std::owner_less<websocketpp::connection_hdl>>
+		  lastEchoes;
+	};
+
+	template<class TConfig>
+	LoopbackTranslationService::ServerImpl<TConfig>::ServerImpl(LoopbackTranslationService* service)
+	  : service(service), random(std::random_device()())
+	{
+		this->server.clear_access_channels(websocketpp::log::alevel::all);
+		this->server.clear_error_channels(websocketpp::log::elevel::all);
+		this->server.init_asio(&this->context);
+		this->server.set_reuse_addr(true);
+		this->server.set_open_handler([this](websocketpp::connection_hdl hdl) { OnOpen(std::move(hdl)); });
+		this->server.set_close_handler([this](websocketpp::connection_hdl hdl) { OnClose(std::move(hdl)); });
+		this->server.set_message_handler(
+		  [this](websocketpp::connection_hdl hdl, MessagePtr message)
+		  { OnMessage(std::move(hdl), std::move(message)); });
+
+		if constexpr (std::is_same_v<TConfig, websocketpp::config::asio_tls>)
+		{
+			this->server.set_tls_init_handler(
+			  [this](websocketpp::connection_hdl /*hdl*/)
+			  {
+				  auto ctx = websocketpp::lib::make_shared<asio::ssl::context>(asio::ssl::context::tlsv12_server);
+				  const auto& options = this->service->options;
+
+				  ctx->set_options(
+				    asio::ssl::context::default_workarounds | asio::ssl::context::no_sslv2 |
+				    asio::ssl::context::no_sslv3 | asio::ssl::context::single_dh_use);
+				  ctx->use_certificate_chain(
+				    asio::buffer(options.certificate.data(), options.certificate.size()));
+				  ctx->use_private_key(
+				    asio::buffer(options.privateKey.data(), options.privateKey.size()),
+				    asio::ssl::context::file_format::pem);
+
+				  return ctx;
+			  });
+		}
+	}
+
+	template<class TConfig>
+	LoopbackTranslationService::ServerImpl<TConfig>::~ServerImpl()
+	{
+		Stop();
+	}
+
+	template<class TConfig>
+	uint16_t LoopbackTranslationService::ServerImpl<TConfig>::Start(uint16_t port)
+	{
+		websocketpp::lib::error_code ec;
+
+		this->server.listen(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port), ec);
+
+		if (!ec)
+		{
+			this->server.start_accept(ec);
+		}
+
+		if (!ec)
+		{
+			const auto endpoint = this->server.get_local_endpoint(ec);
+
+			if (!ec)
+			{
+				this->thread = std::thread([this]() { this->context.run(); });
+
+				return endpoint.port();
+			}
+		}
+
+		return 0u;
+	}
+
+	template<class TConfig>
+	void LoopbackTranslationService::ServerImpl<TConfig>::Stop()
+	{
+		if (this->thread.joinable())
+		{
+			asio::post(
+			  this->context,
+			  [this]()
+			  {
+				  websocketpp::lib::error_code ec;
+
+				  this->server.stop_listening(ec);
+
+				  const auto lastEchoes = std::move(this->lastEchoes);
+
+				  for (const auto& [hdl, lastEcho] : lastEchoes)
+				  {
+					  this->server.close(hdl, websocketpp::close::status::going_away, "", ec);
+				  }
+			  });
+
+			// The context runs out of work once connections are closed and pending
+			// echoes are expired.
+			this->thread.join();
+		}
+	}
+
+	template<class TConfig>
+	void LoopbackTranslationService::ServerImpl<TConfig>::OnOpen(websocketpp::connection_hdl hdl)
+	{
+		this->lastEchoes[hdl] = Clock::now();
+		this->service->OnConnection();
+	}
+
+	template<class TConfig>
+	void LoopbackTranslationService::ServerImpl<TConfig>::OnClose(websocketpp::connection_hdl hdl)
+	{
+		this->lastEchoes.erase(hdl);
+	}
+
+	template<class TConfig>
+	void LoopbackTranslationService::ServerImpl<TConfig>::OnMessage(
+	  websocketpp::connection_hdl hdl, MessagePtr message)
+	{
+		switch (message->get_opcode())
+		{
+			case websocketpp::frame::opcode::text:
+			{
+				this->service->OnCommand(message->get_payload());
+
+				break;
+			}
+
+			case websocketpp::frame::opcode::binary:
+			{
+				this->service->OnMedia(message->get_payload().size());
+				Echo(std::move(hdl), std::move(message->get_raw_payload()));
+
+				break;
+			}
+
+			default:;
+		}
+	}
+
+	template<class TConfig>
+	void LoopbackTranslationService::ServerImpl<TConfig>::Echo(
+	  websocketpp::connection_hdl hdl, std::string payload)
+	{
+		const auto it = this->lastEchoes.find(hdl);
+
+		if (it == this->lastEchoes.end())
+		{
+			return;
+		}
+
+		const auto sendTime = std::max(it->second, Clock::now() + GetDelay());
+		auto timer          = std::make_shared<asio::steady_timer>(this->context, sendTime);
+
+		it->second = sendTime;
+
+		timer->async_wait(
+		  [this, timer, hdl = std::move(hdl), payload = std::move(payload)](const asio::error_code& error)
+		  {
+			  if (!error)
+			  {
+				  websocketpp::lib::error_code ec;
+
+				  this->server.send(hdl, payload, websocketpp::frame::opcode::binary, ec);
+
+				  if (!ec)
+				  {
+					  this->service->OnEcho();
+				  }
+			  }
+		  });
+	}
+
+	template<class TConfig>
+	typename LoopbackTranslationService::ServerImpl<TConfig>::Clock::duration LoopbackTranslationService::
+	  ServerImpl<TConfig>::GetDelay()
+	{
+		const auto& options = this->service->options;
+		auto delayMs        = static_cast<int64_t>(options.delayMs);
+
+		if (options.jitterMs > 0u)
+		{
+			const auto jitterMs = static_cast<int64_t>(options.jitterMs);
+
+			delayMs += std::uniform_int_distribution<int64_t>(-jitterMs, jitterMs)(this->random);
+		}
+
+		return std::chrono::milliseconds(std::max<int64_t>(0, delayMs));
+	}
+
+	LoopbackTranslationService::LoopbackTranslationService(Options options) : options(std::move(options))
+	{
+	}
+
+	LoopbackTranslationService::~LoopbackTranslationService()
+	{
+		Stop();
+	}
+
+	bool LoopbackTranslationService::Start(uint16_t port)
+	{
+		if (!this->server)
+		{
+			if (this->options.tls)
+			{
+				this->server = std::make_unique<ServerImpl<websocketpp::config::asio_tls>>(this);
+			}
+			else
+			{
+				this->server = std::make_unique<ServerImpl<websocketpp::config::asio>>(this);
+			}
+
+			this->port = this->server->Start(port);
+
+			if (0u == this->port)
+			{
+				this->server.reset();
+			}
+		}
+
+		return nullptr != this->server;
+	}
+
+	void LoopbackTranslationService::Stop()
+	{
+		if (this->server)
+		{
+			this->server->Stop();
+			this->server.reset();
+			this->port = 0u;
+		}
+	}
+
+	std::string LoopbackTranslationService::GetUri() const
+	{
+		if (0u == this->port)
+		{
+			return std::string();
+		}
+
+		return std::string(this->options.tls ? "wss" : "ws") + "://127.0.0.1:" + std::to_string(this->port);
+	}
+
+	LoopbackTranslationService::Stats LoopbackTranslationService::GetStats() const
+	{
+		Stats stats;
+
+		stats.connections      = this->connections.load();
+		stats.commands         = this->commands.load();
+		stats.receivedMessages = this->receivedMessages.load();
+		stats.receivedBytes    = this->receivedBytes.load();
+		stats.echoedMessages   = this->echoedMessages.load();
+
+		return stats;
+	}
+
+	std::string LoopbackTranslationService::GetLastCommand() const
+	{
+		const std::lock_guard<std::mutex> lock(this->lastCommandMutex);
+
+		return this->lastCommand;
+	}
+
+	LoopbackTranslationService::Options LoopbackTranslationService::CreateTlsOptions(
+	  uint32_t delayMs, uint32_t jitterMs)
+	{
+		Options options;
+
+		options.tls         = true;
+		options.delayMs     = delayMs;
+		options.jitterMs    = jitterMs;
+		options.certificate = ReadTextFile("data/loopback-cert.pem");
+		options.privateKey  = ReadTextFile("data/loopback-key.pem");
+
+		return options;
+	}
+
+	void LoopbackTranslationService::OnConnection()
+	{
+		++this->connections;
+	}
+
+	void LoopbackTranslationService::OnCommand(const std::string& command)
+	{
+		++this->commands;
+
+		const std::lock_guard<std::mutex> lock(this->lastCommandMutex);
+
+		this->lastCommand = command;
+	}
+
+	void LoopbackTranslationService::OnMedia(size_t size)
+	{
+		++this->receivedMessages;
+		this->receivedBytes += size;
+	}
+
+	void LoopbackTranslationService::OnEcho()
+	{
+		++this->echoedMessages;
+	}
+} // namespace RTC
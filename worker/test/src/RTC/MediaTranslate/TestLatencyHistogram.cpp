@@ -0,0 +1,98 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+using namespace RTC;
+
+SCENARIO("latency histogram", "[mediatranslate][histogram]")
+{
+	SECTION("samples are placed into buckets by upper bound")
+	{
+		LatencyHistogram histogram;
+
+		histogram.Add(0u);
+		histogram.Add(100u);
+		histogram.Add(101u);
+		histogram.Add(30000u);
+		histogram.Add(20000000u);
+
+		const auto snapshot = histogram.GetSnapshot();
+
+		REQUIRE(snapshot._count == 5u);
+		REQUIRE(snapshot._sumUs == 20030201u);
+		REQUIRE(snapshot._maxUs == 20000000u);
+		REQUIRE(snapshot._buckets[0] == 2u);
+		REQUIRE(snapshot._buckets[1] == 1u);
+		REQUIRE(snapshot._buckets[8] == 1u);
+		REQUIRE(snapshot._buckets.back() == 1u);
+	}
+
+	SECTION("percentiles are estimated by bucket bounds")
+	{
+		LatencyHistogram histogram;
+
+		for (int i = 0; i < 90; ++i)
+		{
+			histogram.Add(800u);
+		}
+
+		for (int i = 0; i < 10; ++i)
+		{
+			histogram.Add(7000u);
+		}
+
+		const auto snapshot = histogram.GetSnapshot();
+
+		REQUIRE(snapshot.GetPercentileUs(50.) == 1000u);
+		REQUIRE(snapshot.GetPercentileUs(90.) == 1000u);
+		REQUIRE(snapshot.GetPercentileUs(99.) == 7000u);
+		REQUIRE(LatencyHistogram::Snapshot().GetPercentileUs(50.) == 0u);
+	}
+
+	SECTION("snapshots are merged")
+	{
+		LatencyHistogram first, second;
+
+		first.Add(50u);
+		second.Add(5000u);
+
+		auto snapshot = first.GetSnapshot();
+
+		snapshot.Merge(second.GetSnapshot());
+
+		REQUIRE(snapshot._count == 2u);
+		REQUIRE(snapshot._sumUs == 5050u);
+		REQUIRE(snapshot._maxUs == 5000u);
+		REQUIRE(snapshot._buckets[0] == 1u);
+		REQUIRE(snapshot._buckets[5] == 1u);
+	}
+
+	SECTION("samples are added concurrently")
+	{
+		LatencyHistogram histogram;
+		std::vector<std::thread> threads;
+
+		for (uint64_t t = 1u; t <= 4u; ++t)
+		{
+			threads.emplace_back([&histogram, t]() {
+				for (int i = 0; i < 10000; ++i)
+				{
+					histogram.Add(t * 1000u);
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		const auto snapshot = histogram.GetSnapshot();
+
+		REQUIRE(snapshot._count == 40000u);
+		REQUIRE(snapshot._sumUs == 100000000u);
+		REQUIRE(snapshot._maxUs == 4000u);
+	}
+}
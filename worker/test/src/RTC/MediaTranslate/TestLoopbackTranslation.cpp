@@ -0,0 +1,606 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "helpers.hpp"
+#include "RTC/MediaTranslate/LatencyHistogram.hpp"
+#include "RTC/MediaTranslate/LoopbackTranslationService.hpp"
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/ProducerInputMediaStreamer.hpp"
+#include "RTC/MediaTranslate/RtpDepacketizer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include "RTC/MediaTranslate/RtpPacketizerOpus.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/TimerWheel.hpp"
+#include "RTC/MediaTranslate/TranslationServiceBalancer.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPoint.hpp"
+#include "RTC/MediaTranslate/TranslatorEndPointSink.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "handles/TimerHandle.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	// Producer stand-in: the recorded Opus frame is re-packetized in real-time cadence
+	// and passed through depacketizer and serializers like ProducerTranslator does.
+	class TestProducerInput : public ProducerInputMediaStreamer
+	{
+	public:
+		TestProducerInput(uint32_t ssrc, std::shared_ptr<const MemoryBuffer> opusFrame)
+		  : ssrc(ssrc), opusFrame(std::move(opusFrame)), packetizer(ssrc, 111u),
+		    depacketizer(RtpDepacketizer::create(
+		      RtpCodecMimeType(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS), 48000u))
+		{
+		}
+
+	public:
+		uint32_t GetSsrc() const override
+		{
+			return this->ssrc;
+		}
+		bool AddOutputDevice(const std::shared_ptr<OutputDevice>& outputDevice, MediaFrameFormat format) override
+		{
+			const std::lock_guard<std::mutex> lock(this->mutex);
+
+			if (!outputDevice || this->serializers.count(outputDevice.get()))
+			{
+				return false;
+			}
+
+			auto serializer = RtpMediaFrameSerializer::create(this->depacketizer->GetCodecMimeType(), format);
+
+			if (!serializer)
+			{
+				return false;
+			}
+
+			serializer->SetLiveMode(true);
+			serializer->SetOutputDevice(outputDevice.get());
+			this->serializers[outputDevice.get()] = std::move(serializer);
+
+			return true;
+		}
+		bool RemoveOutputDevice(OutputDevice* outputDevice) override
+		{
+			const std::lock_guard<std::mutex> lock(this->mutex);
+
+			return this->serializers.erase(outputDevice) > 0u;
+		}
+		void Feed(uint64_t nowMs)
+		{
+			const auto* packet = this->packetizer.Packetize(this->opusFrame, false, nowMs);
+
+			if (!packet)
+			{
+				return;
+			}
+
+			if (const auto frame = this->depacketizer->AddPacket(packet))
+			{
+				// Outputs are changed by websocket threads.
+				const std::lock_guard<std::mutex> lock(this->mutex);
+
+				for (const auto& [outputDevice, serializer] : this->serializers)
+				{
+					serializer->Push(frame);
+				}
+			}
+		}
+
+	private:
+		const uint32_t ssrc;
+		const std::shared_ptr<const MemoryBuffer> opusFrame;
+		RtpPacketizerOpus packetizer;
+		const std::unique_ptr<RtpDepacketizer> depacketizer;
+		std::mutex mutex;
+		std::map<OutputDevice*, std::unique_ptr<RtpMediaFrameSerializer>> serializers;
+	};
+
+	class TestConsumer : public TranslatorEndPointSink
+	{
+	public:
+		void OnTranslatedFrame(
+		  const std::shared_ptr<const MemoryBuffer>& frame, bool /*newSequence*/, uint64_t /*nowMs*/) override
+		{
+			++this->frames;
+			this->bytes += frame->GetSize();
+		}
+
+	public:
+		uint64_t frames{ 0u };
+		uint64_t bytes{ 0u };
+	};
+
+	class LoadRunner;
+
+	struct LoadOptions
+	{
+		size_t producers{ 1u };
+		size_t consumers{ 1u };
+		uint64_t durationMs{ 3000u };
+		// Connected sessions of the pool before start of end-points, zero disables the pool.
+		uint32_t warmSessions{ 0u };
+		// Called on the loop thread in the middle of the run.
+		std::function<void(const LoadRunner& runner)> onHalfway;
+	};
+
+	using EndPointFactory = std::function<std::unique_ptr<TranslatorEndPoint>(TimerWheel* timerWheel)>;
+
+	struct ProcessUsage
+	{
+		uint64_t cpuUs{ 0u };
+		uint64_t threads{ 0u };
+		uint64_t rssKb{ 0u };
+		uint64_t peakRssKb{ 0u };
+	};
+
+	// N producers are translated for M consumers, each consumer has its own end-point
+	// and listens to producer [consumer % N]. Runs the libuv loop for the whole duration.
+	class LoadRunner : public TimerHandle::Listener
+	{
+	public:
+		LoadRunner(const EndPointFactory& factory, const LoadOptions& options)
+		  : options(options), feedTimer(this), halfwayTimer(this), stopTimer(this)
+		{
+			const auto opusFrame = ReadRecordedOpusFrame();
+
+			REQUIRE(opusFrame);
+
+			this->frameDurationMs =
+			  RtpPacketizerOpus::GetSamplesCount(opusFrame->GetData(), opusFrame->GetSize()) / 48u;
+
+			REQUIRE(this->frameDurationMs > 0u);
+
+			for (size_t i = 0u; i < options.producers; ++i)
+			{
+				this->inputs.push_back(
+				  std::make_shared<TestProducerInput>(static_cast<uint32_t>(1000u + i), opusFrame));
+			}
+
+			for (size_t i = 0u; i < options.consumers; ++i)
+			{
+				auto consumer = std::make_unique<TestConsumer>();
+				auto endPoint = factory(&this->timerWheel);
+
+				endPoint->AddOutput(consumer.get());
+				endPoint->SetInput(this->inputs[i % this->inputs.size()]);
+				endPoint->Open();
+
+				this->consumers.push_back(std::move(consumer));
+				this->endPoints.push_back(std::move(endPoint));
+			}
+		}
+
+	public:
+		void Run()
+		{
+			this->feedTimer.Start(this->frameDurationMs, this->frameDurationMs);
+			this->stopTimer.Start(this->options.durationMs);
+
+			if (this->options.onHalfway)
+			{
+				this->halfwayTimer.Start(this->options.durationMs / 2u);
+			}
+
+			// Returns once all timers are stopped.
+			DepLibUV::RunLoop();
+		}
+		const std::vector<TranslationStats>& GetStats() const
+		{
+			return this->stats;
+		}
+		const std::vector<std::unique_ptr<TestConsumer>>& GetConsumers() const
+		{
+			return this->consumers;
+		}
+		uint64_t GetConsumedFrames() const
+		{
+			uint64_t frames{ 0u };
+
+			for (const auto& consumer : this->consumers)
+			{
+				frames += consumer->frames;
+			}
+
+			return frames;
+		}
+
+		/* Pure virtual methods inherited from TimerHandle::Listener. */
+	public:
+		void OnTimer(TimerHandle* timer) override
+		{
+			if (timer == &this->feedTimer)
+			{
+				const auto nowMs = DepLibUV::GetTimeMs();
+
+				for (const auto& input : this->inputs)
+				{
+					input->Feed(nowMs);
+				}
+			}
+			else if (timer == &this->halfwayTimer)
+			{
+				this->options.onHalfway(*this);
+			}
+			else if (timer == &this->stopTimer)
+			{
+				this->feedTimer.Stop();
+
+				for (const auto& endPoint : this->endPoints)
+				{
+					this->stats.push_back(endPoint->GetStats());
+				}
+
+				// End-points must be destroyed on the worker thread, players are
+				// removed from the timer wheel then.
+				this->endPoints.clear();
+			}
+		}
+
+	private:
+		static std::shared_ptr<const MemoryBuffer> ReadRecordedOpusFrame()
+		{
+			std::vector<uint8_t> buffer(65536u);
+			size_t len{ 0u };
+
+			if (!helpers::readBinaryFile("data/packet1.raw", buffer.data(), &len))
+			{
+				return nullptr;
+			}
+
+			const std::unique_ptr<RtpPacket> packet(RtpPacket::Parse(buffer.data(), len));
+
+			if (!packet)
+			{
+				return nullptr;
+			}
+
+			return SimpleMemoryBuffer::Create(packet->GetPayload(), packet->GetPayloadLength());
+		}
+
+	private:
+		const LoadOptions options;
+		TimerWheel timerWheel;
+		std::vector<std::shared_ptr<TestProducerInput>> inputs;
+		std::vector<std::unique_ptr<TestConsumer>> consumers;
+		std::vector<std::unique_ptr<TranslatorEndPoint>> endPoints;
+		std::vector<TranslationStats> stats;
+		TimerHandle feedTimer;
+		TimerHandle halfwayTimer;
+		TimerHandle stopTimer;
+		uint32_t frameDurationMs{ 0u };
+	};
+
+	ProcessUsage GetProcessUsage()
+	{
+		ProcessUsage usage;
+		struct rusage rusage;
+
+		if (0 == getrusage(RUSAGE_SELF, &rusage))
+		{
+			usage.cpuUs = (rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000u +
+			              rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+		}
+
+		std::ifstream status("/proc/self/status");
+		std::string line;
+
+		while (std::getline(status, line))
+		{
+			std::istringstream fields(line);
+			std::string name;
+			uint64_t value{ 0u };
+
+			fields >> name >> value;
+
+			if (name == "Threads:")
+			{
+				usage.threads = value;
+			}
+			else if (name == "VmRSS:")
+			{
+				usage.rssKb = value;
+			}
+			else if (name == "VmHWM:")
+			{
+				usage.peakRssKb = value;
+			}
+		}
+
+		return usage;
+	}
+
+	uint64_t GetEnvValue(const char* name, uint64_t defaultValue)
+	{
+		if (const auto* value = std::getenv(name))
+		{
+			return std::strtoull(value, nullptr, 10);
+		}
+
+		return defaultValue;
+	}
+
+	std::string FormatPercentiles(const LatencyHistogram::Snapshot& snapshot)
+	{
+		std::ostringstream text;
+
+		text << "p50 " << snapshot.GetPercentileUs(50.) / 1000. << " ms, p90 "
+		     << snapshot.GetPercentileUs(90.) / 1000. << " ms, p99 " << snapshot.GetPercentileUs(99.) / 1000.
+		     << " ms, max " << snapshot._maxUs / 1000. << " ms (" << snapshot._count << " samples)";
+
+		return text.str();
+	}
+
+	void RunTranslation(const LoopbackTranslationService::Options& serviceOptions, const LoadOptions& options)
+	{
+		LoopbackTranslationService service(serviceOptions);
+
+		REQUIRE(service.Start());
+
+		std::shared_ptr<Websocket::Pool> pool;
+
+		if (options.warmSessions > 0u)
+		{
+			WebsocketPoolSettings poolSettings;
+
+			poolSettings._warmSessions = options.warmSessions;
+
+			pool = TranslatorEndPoint::GetServicePool(
+			  poolSettings, MediaFrameFormat::WebM, WebsocketSendQueueSettings(), service.GetUri());
+
+			REQUIRE(pool);
+
+			// Sessions are connected in background.
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+			while (service.GetStats().connections < options.warmSessions &&
+			       std::chrono::steady_clock::now() < deadline)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+
+		const auto usageBefore = GetProcessUsage();
+		const auto startTime   = std::chrono::steady_clock::now();
+
+		{
+			LoadRunner runner(
+			  [&service, &pool](TimerWheel* timerWheel)
+			  {
+				  if (pool)
+				  {
+					  return std::make_unique<TranslatorEndPoint>(
+					    timerWheel, MediaFrameFormat::WebM, WriteCoalescingSettings(), WebsocketSendQueueSettings(), pool);
+				  }
+
+				  return std::make_unique<TranslatorEndPoint>(
+				    timerWheel,
+				    MediaFrameFormat::WebM,
+				    WriteCoalescingSettings(),
+				    WebsocketSendQueueSettings(),
+				    service.GetUri());
+			  },
+			  options);
+
+			runner.Run();
+
+			const auto wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+			                      std::chrono::steady_clock::now() - startTime)
+			                      .count();
+			const auto usageAfter = GetProcessUsage();
+			const auto serviceStats = service.GetStats();
+			LatencyHistogram::Snapshot firstResponse;
+			LatencyHistogram::Snapshot socketWrite;
+			LatencyHistogram::Snapshot connect;
+			uint64_t playedFrames{ 0u };
+			uint64_t lateFrames{ 0u };
+			uint64_t droppedFrames{ 0u };
+			const auto consumedFrames = runner.GetConsumedFrames();
+
+			for (const auto& stats : runner.GetStats())
+			{
+				firstResponse.Merge(stats._latency._firstResponse);
+				socketWrite.Merge(stats._latency._socketWrite);
+				connect.Merge(stats._latency._connect);
+				playedFrames += stats._playedFrames;
+				lateFrames += stats._lateFrames;
+				droppedFrames += stats._droppedFrames;
+			}
+
+			WARN(
+			  options.producers << " producers, " << options.consumers << " consumers, "
+			                    << (serviceOptions.tls ? "TLS" : "plain") << ", " << options.warmSessions
+			                    << " warm sessions, " << wallUs / 1000 << " ms");
+			WARN(
+			  "CPU " << 100. * (usageAfter.cpuUs - usageBefore.cpuUs) / wallUs << "% of one core, threads "
+			         << usageAfter.threads << ", RSS " << usageAfter.rssKb / 1024. << " MB (peak "
+			         << usageAfter.peakRssKb / 1024. << " MB)");
+			WARN("connect: " << FormatPercentiles(connect));
+			WARN("first response: " << FormatPercentiles(firstResponse));
+			WARN("socket write: " << FormatPercentiles(socketWrite));
+			WARN(
+			  "frames played " << playedFrames << ", late " << lateFrames << ", dropped " << droppedFrames
+			                   << ", consumed " << consumedFrames);
+			WARN(
+			  "service: connections " << serviceStats.connections << ", commands " << serviceStats.commands
+			                          << ", received " << serviceStats.receivedMessages << " messages ("
+			                          << serviceStats.receivedBytes << " bytes), echoed "
+			                          << serviceStats.echoedMessages << " messages");
+
+			REQUIRE(serviceStats.connections >= options.consumers);
+			REQUIRE(serviceStats.commands >= options.consumers);
+			REQUIRE(serviceStats.receivedMessages > 0u);
+			REQUIRE(serviceStats.echoedMessages > 0u);
+			REQUIRE(!nlohmann::json::parse(service.GetLastCommand(), nullptr, false).is_discarded());
+			REQUIRE(firstResponse._count > 0u);
+			REQUIRE(consumedFrames > 0u);
+		}
+
+		pool.reset();
+
+		service.Stop();
+
+		// Must run the loop to wait for UV timers and close them.
+		DepLibUV::RunLoop();
+	}
+
+	// Sessions are balanced between two services, the first one is stopped in the middle
+	// of the run and its sessions must be migrated to the second one.
+	void RunFailover(const LoopbackTranslationService::Options& serviceOptions)
+	{
+		LoopbackTranslationService first(serviceOptions);
+		LoopbackTranslationService second(serviceOptions);
+
+		REQUIRE(first.Start());
+		REQUIRE(second.Start());
+
+		TranslationBalancingSettings balancing;
+
+		balancing._probeIntervalMs = 500u;
+
+		// Without warm sessions, so each session is a visible connection of the service.
+		auto balancer = TranslatorEndPoint::CreateServiceBalancer(
+		  { { first.GetUri() }, { second.GetUri() } },
+		  balancing,
+		  WebsocketPoolSettings{ 0u },
+		  MediaFrameFormat::WebM,
+		  WebsocketSendQueueSettings());
+
+		REQUIRE(balancer);
+		REQUIRE(balancer->GetHostsCount() == 2u);
+
+		LoadOptions options;
+		LoopbackTranslationService::Stats secondAtHalfway;
+		uint64_t consumedAtHalfway{ 0u };
+
+		options.consumers  = 4u;
+		options.durationMs = 6000u;
+		options.onHalfway  = [&](const LoadRunner& runner)
+		{
+			// Both services are in use before the failure.
+			REQUIRE(first.GetStats().echoedMessages > 0u);
+			REQUIRE(second.GetStats().echoedMessages > 0u);
+
+			consumedAtHalfway = runner.GetConsumedFrames();
+
+			first.Stop();
+
+			secondAtHalfway = second.GetStats();
+		};
+
+		{
+			LoadRunner runner(
+			  [&balancer](TimerWheel* timerWheel)
+			  {
+				  return std::make_unique<TranslatorEndPoint>(
+				    timerWheel, MediaFrameFormat::WebM, WriteCoalescingSettings(), WebsocketSendQueueSettings(), balancer);
+			  },
+			  options);
+
+			runner.Run();
+
+			const auto secondStats = second.GetStats();
+			uint64_t failovers{ 0u };
+
+			for (const auto& stats : runner.GetStats())
+			{
+				failovers += stats._latency._failovers;
+			}
+
+			WARN(
+			  "failovers " << failovers << ", second service: connections " << secondAtHalfway.connections
+			               << " -> " << secondStats.connections << ", echoed " << secondAtHalfway.echoedMessages
+			               << " -> " << secondStats.echoedMessages);
+
+			REQUIRE(failovers > 0u);
+			REQUIRE(secondStats.connections > secondAtHalfway.connections);
+			REQUIRE(secondStats.commands > secondAtHalfway.commands);
+			REQUIRE(secondStats.echoedMessages > secondAtHalfway.echoedMessages);
+			REQUIRE(runner.GetConsumedFrames() > consumedAtHalfway);
+		}
+
+		balancer.reset();
+
+		second.Stop();
+
+		// Must run the loop to wait for UV timers and close them.
+		DepLibUV::RunLoop();
+	}
+} // namespace
+
+// Hidden, requires loopback networking, run with: mediasoup-worker-test "[loopback]"
+SCENARIO("translation through loopback service", "[.][loopback][mediatranslate]")
+{
+	LoopbackTranslationService::Options options;
+
+	options.delayMs  = 50u;
+	options.jitterMs = 10u;
+
+	SECTION("plain websocket")
+	{
+		RunTranslation(options, LoadOptions());
+	}
+
+	SECTION("TLS websocket")
+	{
+		RunTranslation(
+		  LoopbackTranslationService::CreateTlsOptions(options.delayMs, options.jitterMs), LoadOptions());
+	}
+
+	SECTION("TLS websocket with warm sessions")
+	{
+		LoadOptions loadOptions;
+
+		loadOptions.consumers    = 4u;
+		loadOptions.warmSessions = 4u;
+
+		RunTranslation(
+		  LoopbackTranslationService::CreateTlsOptions(options.delayMs, options.jitterMs), loadOptions);
+	}
+
+	SECTION("balanced services with failover")
+	{
+		RunFailover(options);
+	}
+}
+
+// Hidden, run with: mediasoup-worker-test "[loadtest]", scale is set by
+// MS_LOADTEST_PRODUCERS, MS_LOADTEST_CONSUMERS, MS_LOADTEST_DURATION_MS,
+// MS_LOADTEST_DELAY_MS, MS_LOADTEST_JITTER_MS, MS_LOADTEST_TLS and MS_LOADTEST_WARM_SESSIONS.
+TEST_CASE("translation load test", "[.][loadtest][mediatranslate]")
+{
+	const auto delayMs  = static_cast<uint32_t>(GetEnvValue("MS_LOADTEST_DELAY_MS", 300u));
+	const auto jitterMs = static_cast<uint32_t>(GetEnvValue("MS_LOADTEST_JITTER_MS", 50u));
+	LoopbackTranslationService::Options serviceOptions;
+	LoadOptions options;
+
+	if (GetEnvValue("MS_LOADTEST_TLS", 0u))
+	{
+		serviceOptions = LoopbackTranslationService::CreateTlsOptions(delayMs, jitterMs);
+	}
+	else
+	{
+		serviceOptions.delayMs  = delayMs;
+		serviceOptions.jitterMs = jitterMs;
+	}
+
+	options.producers    = std::max<uint64_t>(1u, GetEnvValue("MS_LOADTEST_PRODUCERS", 10u));
+	options.consumers    = std::max<uint64_t>(1u, GetEnvValue("MS_LOADTEST_CONSUMERS", 50u));
+	options.durationMs   = GetEnvValue("MS_LOADTEST_DURATION_MS", 30000u);
+	options.warmSessions = static_cast<uint32_t>(GetEnvValue("MS_LOADTEST_WARM_SESSIONS", 0u));
+
+	RunTranslation(serviceOptions, options);
+}
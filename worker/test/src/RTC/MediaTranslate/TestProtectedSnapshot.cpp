@@ -0,0 +1,197 @@
+#include "common.hpp"
+#include "ProtectedObj.hpp"
+#include "ProtectedSnapshot.hpp"
+#include <absl/container/flat_hash_set.h>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	using IntSet = absl::flat_hash_set<int>;
+
+	constexpr auto BenchmarkDuration = std::chrono::milliseconds(300);
+
+	// Runs 1 writer and [readers] reader threads, returns reads per second.
+	template<class ReadFunc, class WriteFunc>
+	double RunContention(size_t readers, ReadFunc&& read, WriteFunc&& write)
+	{
+		std::atomic_bool stop{ false };
+		std::atomic<uint64_t> reads{ 0u };
+		std::vector<std::thread> threads;
+
+		for (size_t i = 0u; i < readers; ++i)
+		{
+			threads.emplace_back(
+			  [&]()
+			  {
+				  uint64_t count{ 0u };
+				  int64_t sum{ 0 };
+
+				  while (!stop.load(std::memory_order_relaxed))
+				  {
+					  sum += read();
+					  ++count;
+				  }
+
+				  reads.fetch_add(count + (sum == -1 ? 1u : 0u));
+			  });
+		}
+
+		threads.emplace_back(
+		  [&]()
+		  {
+			  for (int i = 0; !stop.load(std::memory_order_relaxed); ++i)
+			  {
+				  write(i);
+				  std::this_thread::sleep_for(std::chrono::microseconds(100));
+			  }
+		  });
+
+		std::this_thread::sleep_for(BenchmarkDuration);
+		stop = true;
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		return reads.load() / std::chrono::duration<double>(BenchmarkDuration).count();
+	}
+} // namespace
+
+SCENARIO("ProtectedSnapshot", "[protectedsnapshot]")
+{
+	SECTION("readers keep their snapshot while writer publishes a new one")
+	{
+		ProtectedSnapshot<IntSet> set;
+
+		REQUIRE(set.Get()->empty());
+
+		REQUIRE(set.Update([](IntSet& values) { return values.insert(1).second; }));
+		REQUIRE(!set.Update([](IntSet& values) { return values.insert(1).second; }));
+
+		const auto snapshot = set.Get();
+
+		REQUIRE(snapshot->count(1) == 1u);
+
+		// Writer doesn't wait for readers, even on the same thread.
+		REQUIRE(set.Update([](IntSet& values) { return values.insert(2).second; }));
+
+		REQUIRE(snapshot->size() == 1u);
+		REQUIRE(set.Get()->size() == 2u);
+	}
+
+	SECTION("removed item is released by the last reader")
+	{
+		using ItemsSet = absl::flat_hash_set<std::shared_ptr<int>>;
+
+		ProtectedSnapshot<ItemsSet> set;
+		auto item = std::make_shared<int>(1);
+		const std::weak_ptr<int> weakItem(item);
+
+		REQUIRE(set.Update([&item](ItemsSet& values) { return values.insert(item).second; }));
+
+		auto snapshot = set.Get();
+
+		REQUIRE(set.Update([&item](ItemsSet& values) { return values.erase(item) > 0u; }));
+
+		item.reset();
+
+		REQUIRE(set.Get()->empty());
+		REQUIRE(!weakItem.expired());
+
+		snapshot.reset();
+
+		REQUIRE(weakItem.expired());
+	}
+
+	SECTION("Set() replaces value")
+	{
+		ProtectedSnapshot<IntSet> set(IntSet{ 1, 2, 3 });
+
+		REQUIRE(set.Get()->size() == 3u);
+
+		set.Set(IntSet());
+
+		REQUIRE(set.Get()->empty());
+	}
+}
+
+// Hidden, run with: mediasoup-worker-test "[benchmark]"
+SCENARIO("ProtectedSnapshot vs ProtectedObj contention", "[.][benchmark][protectedsnapshot]")
+{
+	const IntSet initial{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	for (size_t readers : { 1u, 2u, 4u, 8u })
+	{
+		ProtectedObj<IntSet> locked(initial);
+		ProtectedSnapshot<IntSet> snapshot(initial);
+
+		const auto lockedRate = RunContention(
+		  readers,
+		  [&locked]()
+		  {
+			  int64_t sum{ 0 };
+			  LOCK_READ_PROTECTED_OBJ(locked);
+
+			  for (const auto value : locked.ConstRef())
+			  {
+				  sum += value;
+			  }
+
+			  return sum;
+		  },
+		  [&locked](int i)
+		  {
+			  LOCK_WRITE_PROTECTED_OBJ(locked);
+
+			  if (i % 2)
+			  {
+				  locked->erase(100);
+			  }
+			  else
+			  {
+				  locked->insert(100);
+			  }
+		  });
+
+		const auto snapshotRate = RunContention(
+		  readers,
+		  [&snapshot]()
+		  {
+			  int64_t sum{ 0 };
+			  const auto values = snapshot.Get();
+
+			  for (const auto value : *values)
+			  {
+				  sum += value;
+			  }
+
+			  return sum;
+		  },
+		  [&snapshot](int i)
+		  {
+			  snapshot.Update(
+			    [i](IntSet& values)
+			    {
+				    if (i % 2)
+				    {
+					    return values.erase(100) > 0u;
+				    }
+
+				    return values.insert(100).second;
+			    });
+		  });
+
+		WARN(
+		  "readers: " << readers << ", ProtectedObj: " << static_cast<uint64_t>(lockedRate)
+		              << " reads/s, ProtectedSnapshot: " << static_cast<uint64_t>(snapshotRate)
+		              << " reads/s");
+	}
+}
@@ -0,0 +1,120 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/RtpDepacketizer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstring> // std::memset()
+#include <memory>
+
+using namespace RTC;
+
+static uint8_t buffer[1500];
+
+static std::unique_ptr<RtpPacket> CreateOpusPacket(uint16_t seq, uint32_t timestamp, bool stereo)
+{
+	// clang-format off
+	uint8_t header[] =
+	{
+		0x80, 0x6f, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x05
+	};
+	// clang-format on
+
+	header[2] = static_cast<uint8_t>(seq >> 8);
+	header[3] = static_cast<uint8_t>(seq);
+	header[4] = static_cast<uint8_t>(timestamp >> 24);
+	header[5] = static_cast<uint8_t>(timestamp >> 16);
+	header[6] = static_cast<uint8_t>(timestamp >> 8);
+	header[7] = static_cast<uint8_t>(timestamp);
+
+	const size_t payloadLen = 80;
+
+	std::memcpy(buffer, header, sizeof(header));
+	std::memset(buffer + sizeof(header), 0xab, payloadLen);
+	// TOC byte: SILK-only 20 ms, 's' bit for stereo.
+	buffer[sizeof(header)] = stereo ? 0x0c : 0x08;
+
+	return std::unique_ptr<RtpPacket>(RtpPacket::Parse(buffer, sizeof(header) + payloadLen));
+}
+
+SCENARIO("Opus depacketizer", "[mediatranslate][opus]")
+{
+	const RtpCodecMimeType mime(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS);
+
+	SECTION("no heap allocations per packet in steady state")
+	{
+		auto pool         = std::make_shared<MemoryBufferPool>();
+		auto depacketizer = RtpDepacketizer::create(mime, 48000u, pool);
+
+		REQUIRE(depacketizer);
+
+		// Warm-up.
+		for (uint16_t seq = 0u; seq < 10u; ++seq)
+		{
+			auto packet = CreateOpusPacket(seq, seq * 960u, false);
+
+			REQUIRE(packet);
+			REQUIRE(depacketizer->AddPacket(packet.get()));
+		}
+
+		const auto allocations = depacketizer->GetAllocationsCount();
+
+		for (uint16_t seq = 10u; seq < 1000u; ++seq)
+		{
+			auto packet = CreateOpusPacket(seq, seq * 960u, false);
+			auto frame  = depacketizer->AddPacket(packet.get());
+
+			REQUIRE(frame);
+			REQUIRE(frame->GetSequenceNumber() == seq);
+			REQUIRE(frame->GetTimestamp() == seq * 960u);
+			REQUIRE(frame->GetPayload()->GetSize() == 80u);
+		}
+
+		REQUIRE(depacketizer->GetAllocationsCount() == allocations);
+		REQUIRE(pool->GetReusesCount() >= 990u);
+	}
+
+	SECTION("retained frames are not overwritten")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 48000u, std::make_shared<MemoryBufferPool>());
+		auto packet1      = CreateOpusPacket(1u, 960u, false);
+		auto frame1       = depacketizer->AddPacket(packet1.get());
+		auto packet2      = CreateOpusPacket(2u, 1920u, false);
+		auto frame2       = depacketizer->AddPacket(packet2.get());
+
+		REQUIRE(frame1);
+		REQUIRE(frame2);
+		REQUIRE(frame1 != frame2);
+		REQUIRE(frame1->GetPayload() != frame2->GetPayload());
+		REQUIRE(frame1->GetSequenceNumber() == 1u);
+		REQUIRE(frame2->GetSequenceNumber() == 2u);
+	}
+
+	SECTION("OpusHead is rebuilt only if channels count changed")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 48000u, std::make_shared<MemoryBufferPool>());
+		auto packet       = CreateOpusPacket(1u, 960u, false);
+		auto frame        = depacketizer->AddPacket(packet.get());
+
+		REQUIRE(frame->GetAudioConfig()->_channelCount == 1u);
+
+		const auto mono = frame->GetAudioConfig()->_codecSpecificData;
+
+		frame.reset();
+		packet = CreateOpusPacket(2u, 1920u, true);
+		frame  = depacketizer->AddPacket(packet.get());
+
+		REQUIRE(frame->GetAudioConfig()->_channelCount == 2u);
+		REQUIRE(frame->GetAudioConfig()->_codecSpecificData != mono);
+
+		const auto stereo = frame->GetAudioConfig()->_codecSpecificData;
+
+		frame.reset();
+		packet = CreateOpusPacket(3u, 2880u, true);
+		frame  = depacketizer->AddPacket(packet.get());
+
+		REQUIRE(frame->GetAudioConfig()->_codecSpecificData == stereo);
+	}
+}
@@ -0,0 +1,255 @@
+#include "common.hpp"
+#include "RTC/Codecs/VP8.hpp"
+#include "RTC/MediaTranslate/RtpDepacketizer.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm> // std::rotate()
+#include <cstring> // std::memset()
+#include <memory>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	constexpr size_t PacketPayloadLength{ 100u };
+	constexpr uint32_t FrameDuration{ 3000u }; // 30 fps at 90 kHz.
+
+	struct Vp8Packet
+	{
+		uint8_t buffer[1500];
+		std::unique_ptr<RtpPacket> packet;
+	};
+
+	// VP8 packet with extended payload descriptor (2 bytes), [fill] marks payload of the frame.
+	std::unique_ptr<Vp8Packet> CreateVp8Packet(
+	  uint16_t seq, uint32_t timestamp, bool start, bool marker, bool keyFrame, uint8_t fill)
+	{
+		// clang-format off
+		uint8_t header[] =
+		{
+			0x80, 0x60, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x07
+		};
+		// clang-format on
+
+		header[1] |= marker ? 0x80 : 0x00;
+		header[2] = static_cast<uint8_t>(seq >> 8);
+		header[3] = static_cast<uint8_t>(seq);
+		header[4] = static_cast<uint8_t>(timestamp >> 24);
+		header[5] = static_cast<uint8_t>(timestamp >> 16);
+		header[6] = static_cast<uint8_t>(timestamp >> 8);
+		header[7] = static_cast<uint8_t>(timestamp);
+
+		auto result    = std::make_unique<Vp8Packet>();
+		auto* payload  = result->buffer + sizeof(header);
+		const size_t descriptorLength{ 2u };
+
+		std::memcpy(result->buffer, header, sizeof(header));
+		std::memset(payload, fill, PacketPayloadLength);
+		payload[0] = start ? 0x90 : 0x80;
+		payload[1] = 0x00;
+
+		if (start)
+		{
+			// Frame tag, P bit is zero for key frame.
+			auto* frame = payload + descriptorLength;
+
+			frame[0] = keyFrame ? 0x00 : 0x01;
+
+			if (keyFrame)
+			{
+				// Start code, 640x480.
+				frame[3] = 0x9d;
+				frame[4] = 0x01;
+				frame[5] = 0x2a;
+				frame[6] = 0x80;
+				frame[7] = 0x02;
+				frame[8] = 0xe0;
+				frame[9] = 0x01;
+			}
+		}
+
+		result->packet.reset(RtpPacket::Parse(result->buffer, sizeof(header) + PacketPayloadLength));
+
+		if (result->packet)
+		{
+			Codecs::VP8::ProcessRtpPacket(result->packet.get());
+		}
+
+		return result;
+	}
+
+	// Packets of [framesCount] frames, [packetsPerFrame] each.
+	std::vector<std::unique_ptr<Vp8Packet>> CreateVp8Frames(
+	  size_t framesCount, size_t packetsPerFrame, size_t keyFrameInterval = 0u)
+	{
+		std::vector<std::unique_ptr<Vp8Packet>> packets;
+		uint16_t seq{ 1000u };
+
+		for (size_t i = 0u; i < framesCount; ++i)
+		{
+			const auto timestamp = static_cast<uint32_t>(FrameDuration * (i + 1u));
+			const bool keyFrame  = 0u == i || (keyFrameInterval && 0u == i % keyFrameInterval);
+
+			for (size_t j = 0u; j < packetsPerFrame; ++j)
+			{
+				packets.push_back(CreateVp8Packet(
+				  seq++,
+				  timestamp,
+				  0u == j,
+				  j + 1u == packetsPerFrame,
+				  keyFrame,
+				  static_cast<uint8_t>(i)));
+			}
+		}
+
+		return packets;
+	}
+
+	std::vector<std::shared_ptr<RtpMediaFrame>> AddPacket(RtpDepacketizer* depacketizer, const RtpPacket* packet)
+	{
+		std::vector<std::shared_ptr<RtpMediaFrame>> frames;
+
+		for (auto frame = depacketizer->AddPacket(packet); frame; frame = depacketizer->NextFrame())
+		{
+			frames.push_back(std::move(frame));
+		}
+
+		return frames;
+	}
+} // namespace
+
+SCENARIO("VP8 depacketizer", "[mediatranslate][vpx]")
+{
+	const RtpCodecMimeType mime(RtpCodecMimeType::Type::VIDEO, RtpCodecMimeType::Subtype::VP8);
+	const size_t frameLength{ 3u * (PacketPayloadLength - 2u) };
+
+	SECTION("frames are assembled from packets in order")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 90000u);
+		auto packets      = CreateVp8Frames(10u, 3u);
+		std::vector<std::shared_ptr<RtpMediaFrame>> frames;
+
+		for (const auto& packet : packets)
+		{
+			REQUIRE(packet->packet);
+
+			for (auto& frame : AddPacket(depacketizer.get(), packet->packet.get()))
+			{
+				frames.push_back(std::move(frame));
+			}
+		}
+
+		REQUIRE(frames.size() == 10u);
+		REQUIRE(frames[0]->IsKeyFrame());
+		REQUIRE(frames[0]->GetVideoConfig()->_width == 640);
+		REQUIRE(frames[0]->GetVideoConfig()->_height == 480);
+		REQUIRE(frames[9]->GetTimestamp() == 10u * FrameDuration);
+		REQUIRE(frames[9]->GetSequenceNumber() == 1029u);
+		REQUIRE(frames[9]->GetPayload()->GetSize() == frameLength);
+		REQUIRE(frames[9]->GetPayload()->GetData()[frameLength - 1u] == 9u);
+		REQUIRE(depacketizer->GetIncompleteFramesCount() == 0u);
+		REQUIRE(depacketizer->GetUndecodableFramesCount() == 0u);
+		REQUIRE(!depacketizer->TakeKeyFrameRequest());
+	}
+
+	SECTION("reordered packets are awaited")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 90000u);
+		auto packets      = CreateVp8Frames(3u, 3u);
+
+		// Start of the 2nd frame is the last one.
+		std::rotate(packets.begin() + 3, packets.begin() + 4, packets.end());
+		std::swap(packets[3], packets[4]);
+
+		std::vector<size_t> counts;
+
+		for (const auto& packet : packets)
+		{
+			counts.push_back(AddPacket(depacketizer.get(), packet->packet.get()).size());
+		}
+
+		// The 3rd frame is completed before the late start of the 2nd one.
+		REQUIRE(counts == std::vector<size_t>{ 0u, 0u, 1u, 0u, 0u, 0u, 0u, 0u, 2u });
+		REQUIRE(depacketizer->GetIncompleteFramesCount() == 0u);
+		REQUIRE(depacketizer->GetUndecodableFramesCount() == 0u);
+	}
+
+	SECTION("lost packet drops frames until the next key frame")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 90000u);
+		auto packets      = CreateVp8Frames(20u, 3u, 10u);
+		size_t framesCount{ 0u };
+		size_t keyFrameRequests{ 0u };
+		std::shared_ptr<RtpMediaFrame> firstFrameAfterLoss;
+
+		// The middle packet of the 3rd frame is lost.
+		packets.erase(packets.begin() + 7);
+
+		for (const auto& packet : packets)
+		{
+			for (const auto& frame : AddPacket(depacketizer.get(), packet->packet.get()))
+			{
+				if (2u == framesCount)
+				{
+					firstFrameAfterLoss = frame;
+				}
+
+				++framesCount;
+			}
+
+			if (depacketizer->TakeKeyFrameRequest())
+			{
+				++keyFrameRequests;
+			}
+		}
+
+		// Frames 3..10 are gone, decoding resumes at the key frame.
+		REQUIRE(framesCount == 12u);
+		REQUIRE(firstFrameAfterLoss->IsKeyFrame());
+		REQUIRE(firstFrameAfterLoss->GetTimestamp() == 11u * FrameDuration);
+		REQUIRE(depacketizer->GetIncompleteFramesCount() == 1u);
+		REQUIRE(depacketizer->GetUndecodableFramesCount() == 7u);
+		REQUIRE(keyFrameRequests == 1u);
+	}
+
+	SECTION("stream joined in the middle waits for key frame")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 90000u);
+		auto packets      = CreateVp8Frames(20u, 3u, 10u);
+		size_t framesCount{ 0u };
+
+		// Starts with the tail of the key frame.
+		for (size_t i = 1u; i < packets.size(); ++i)
+		{
+			framesCount += AddPacket(depacketizer.get(), packets[i]->packet.get()).size();
+		}
+
+		REQUIRE(framesCount == 10u);
+		REQUIRE(depacketizer->GetIncompleteFramesCount() == 1u);
+		REQUIRE(depacketizer->GetUndecodableFramesCount() == 9u);
+		REQUIRE(depacketizer->TakeKeyFrameRequest());
+		REQUIRE(!depacketizer->TakeKeyFrameRequest());
+	}
+
+	SECTION("late and duplicated packets are ignored")
+	{
+		auto depacketizer = RtpDepacketizer::create(mime, 90000u);
+		auto packets      = CreateVp8Frames(3u, 3u);
+		size_t framesCount{ 0u };
+
+		for (const auto& packet : packets)
+		{
+			framesCount += AddPacket(depacketizer.get(), packet->packet.get()).size();
+			framesCount += AddPacket(depacketizer.get(), packet->packet.get()).size();
+		}
+
+		framesCount += AddPacket(depacketizer.get(), packets[0]->packet.get()).size();
+
+		REQUIRE(framesCount == 3u);
+		REQUIRE(depacketizer->GetIncompleteFramesCount() == 0u);
+	}
+}
@@ -0,0 +1,717 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/MemoryBufferPool.hpp"
+#include "RTC/MediaTranslate/OutputDevice.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrameFanOut.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrameSerializer.hpp"
+#include "RTC/MediaTranslate/RtpOggOpusSerializer.hpp"
+#include "RTC/MediaTranslate/RtpRawFrameSerializer.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "Utils.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	class TestAudioFrame : public RtpMediaFrame
+	{
+	public:
+		TestAudioFrame(
+		  const std::shared_ptr<const MemoryBuffer>& payload,
+		  uint32_t timestamp,
+		  uint16_t sequenceNumber,
+		  const RtpAudioFrameConfig& config)
+		  : RtpMediaFrame(
+		      RtpCodecMimeType(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS),
+		      payload,
+		      false,
+		      timestamp,
+		      0x05u,
+		      sequenceNumber,
+		      48000u),
+		    config(config)
+		{
+		}
+		const RtpAudioFrameConfig* GetAudioConfig() const override
+		{
+			return &this->config;
+		}
+
+	private:
+		const RtpAudioFrameConfig config;
+	};
+
+	class TestVideoFrame : public RtpMediaFrame
+	{
+	public:
+		TestVideoFrame(
+		  const std::shared_ptr<const MemoryBuffer>& payload,
+		  bool isKeyFrame,
+		  uint32_t timestamp,
+		  uint16_t sequenceNumber,
+		  const RtpVideoFrameConfig& config)
+		  : RtpMediaFrame(
+		      RtpCodecMimeType(RtpCodecMimeType::Type::VIDEO, RtpCodecMimeType::Subtype::VP8),
+		      payload,
+		      isKeyFrame,
+		      timestamp,
+		      0x06u,
+		      sequenceNumber,
+		      90000u),
+		    config(config)
+		{
+		}
+		const RtpVideoFrameConfig* GetVideoConfig() const override
+		{
+			return &this->config;
+		}
+
+	private:
+		const RtpVideoFrameConfig config;
+	};
+
+	class TestOutputDevice : public OutputDevice
+	{
+	public:
+		void Write(const std::shared_ptr<const MemoryBuffer>& buffer) override
+		{
+			this->bytes += buffer->GetSize();
+
+			if (this->keepBuffers)
+			{
+				this->buffers.push_back(buffer);
+			}
+		}
+
+	public:
+		bool keepBuffers{ true };
+		size_t bytes{ 0u };
+		std::vector<std::shared_ptr<const MemoryBuffer>> buffers;
+	};
+
+	std::shared_ptr<const MemoryBuffer> CreatePayload(size_t len, uint8_t value)
+	{
+		return SimpleMemoryBuffer::Create(std::vector<uint8_t>(len, value));
+	}
+
+	// 20 ms Opus frames of variable size, like a speech at 32 kbps.
+	std::vector<std::shared_ptr<RtpMediaFrame>> CreateOpusTrace(size_t framesCount)
+	{
+		RtpAudioFrameConfig config;
+
+		config._channelCount      = 2u;
+		config._codecSpecificData = CreatePayload(19u, 0x4f);
+
+		std::vector<std::shared_ptr<RtpMediaFrame>> trace;
+
+		for (size_t i = 0u; i < framesCount; ++i)
+		{
+			const auto len = 60u + (i * 37u) % 100u;
+
+			trace.push_back(std::make_shared<TestAudioFrame>(
+			  CreatePayload(len, 0xab),
+			  static_cast<uint32_t>(960u * (i + 1u)),
+			  static_cast<uint16_t>(i),
+			  config));
+		}
+
+		return trace;
+	}
+
+	// 30 fps VP8 at ~600 kbps, key frame every 2 seconds.
+	std::vector<std::shared_ptr<RtpMediaFrame>> CreateVp8Trace(size_t framesCount)
+	{
+		RtpVideoFrameConfig config;
+
+		config._width     = 640;
+		config._height    = 480;
+		config._frameRate = 30.;
+
+		std::vector<std::shared_ptr<RtpMediaFrame>> trace;
+
+		for (size_t i = 0u; i < framesCount; ++i)
+		{
+			const bool isKeyFrame = 0u == i % 60u;
+			const auto len        = isKeyFrame ? 15000u : 1800u + (i * 131u) % 1000u;
+
+			trace.push_back(std::make_shared<TestVideoFrame>(
+			  CreatePayload(len, 0xcd),
+			  isKeyFrame,
+			  static_cast<uint32_t>(3000u * (i + 1u)),
+			  static_cast<uint16_t>(i),
+			  config));
+		}
+
+		return trace;
+	}
+
+	uint32_t GetLE4Bytes(const uint8_t* data, size_t i)
+	{
+		return data[i] | (data[i + 1u] << 8) | (data[i + 2u] << 16) | (static_cast<uint32_t>(data[i + 3u]) << 24);
+	}
+
+	uint64_t GetLE8Bytes(const uint8_t* data, size_t i)
+	{
+		return GetLE4Bytes(data, i) | (static_cast<uint64_t>(GetLE4Bytes(data, i + 4u)) << 32);
+	}
+
+	// Bitwise CRC of Ogg page, checksum field is zeroed.
+	uint32_t CalculatePageCrc(const MemoryBuffer* page)
+	{
+		std::vector<uint8_t> data(page->GetData(), page->GetData() + page->GetSize());
+		uint32_t crc{ 0u };
+
+		std::memset(data.data() + 22u, 0, 4u);
+
+		for (const auto byte : data)
+		{
+			crc ^= static_cast<uint32_t>(byte) << 24;
+
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04c11db7u : crc << 1;
+			}
+		}
+
+		return crc;
+	}
+
+	// Checks framing of Ogg page and returns its body.
+	std::vector<uint8_t> CheckOggPage(const MemoryBuffer* page, uint8_t flags, uint32_t sequenceNumber)
+	{
+		const auto* data = page->GetData();
+
+		REQUIRE(page->GetSize() >= RtpOggOpusSerializer::PageHeaderSize);
+		REQUIRE(std::memcmp(data, "OggS", 4u) == 0);
+		REQUIRE(data[4] == 0u);
+		REQUIRE(data[5] == flags);
+		REQUIRE(GetLE4Bytes(data, 14u) == 0x05u);
+		REQUIRE(GetLE4Bytes(data, 18u) == sequenceNumber);
+		REQUIRE(GetLE4Bytes(data, 22u) == CalculatePageCrc(page));
+
+		const size_t segmentsCount = data[26];
+		size_t bodySize{ 0u };
+
+		for (size_t i = 0u; i < segmentsCount; ++i)
+		{
+			bodySize += data[RtpOggOpusSerializer::PageHeaderSize + i];
+		}
+
+		const auto* body = data + RtpOggOpusSerializer::PageHeaderSize + segmentsCount;
+
+		REQUIRE(page->GetSize() == RtpOggOpusSerializer::PageHeaderSize + segmentsCount + bodySize);
+
+		return std::vector<uint8_t>(body, body + bodySize);
+	}
+
+	void RunBenchmark(
+	  const char* name,
+	  const std::vector<std::shared_ptr<RtpMediaFrame>>& trace,
+	  uint32_t frameDurationMs)
+	{
+		const auto& mime    = trace.front()->GetCodecMimeType();
+		const auto duration = static_cast<double>(trace.size() * frameDurationMs) / 1000.;
+
+		for (const auto format : { MediaFrameFormat::WebM, MediaFrameFormat::Raw, MediaFrameFormat::Ogg })
+		{
+			const std::string formatName(MediaFrameFormatToString(format));
+
+			// Ogg is audio only.
+			if (!RtpMediaFrameSerializer::create(mime, format))
+			{
+				continue;
+			}
+
+			// Bytes per second of media.
+			{
+				TestOutputDevice output;
+				auto serializer = RtpMediaFrameSerializer::create(mime, format);
+
+				REQUIRE(serializer);
+
+				output.keepBuffers = false;
+				serializer->SetOutputDevice(&output);
+
+				for (const auto& frame : trace)
+				{
+					serializer->Push(frame);
+				}
+
+				WARN(
+				  name << " " << formatName << ": " << static_cast<uint64_t>(output.bytes / duration)
+				       << " bytes per second");
+			}
+
+			// CPU per frame is the mean divided by frames count.
+			BENCHMARK_ADVANCED(std::string(name) + " " + formatName + ", " + std::to_string(trace.size()) + " frames")
+			(Catch::Benchmark::Chronometer meter)
+			{
+				TestOutputDevice output;
+				std::vector<std::unique_ptr<RtpMediaFrameSerializer>> serializers;
+
+				output.keepBuffers = false;
+
+				for (int i = 0; i < meter.runs(); ++i)
+				{
+					serializers.push_back(RtpMediaFrameSerializer::create(mime, format));
+					serializers.back()->SetOutputDevice(&output);
+				}
+
+				meter.measure(
+				  [&](int i)
+				  {
+					  for (const auto& frame : trace)
+					  {
+						  serializers[i]->Push(frame);
+					  }
+				  });
+			};
+		}
+	}
+} // namespace
+
+SCENARIO("raw media frame serializer", "[mediatranslate][serializer]")
+{
+	SECTION("configuration record precedes the first frame")
+	{
+		TestOutputDevice output;
+		RtpRawFrameSerializer serializer;
+		const auto trace = CreateOpusTrace(3u);
+
+		serializer.SetOutputDevice(&output);
+
+		for (const auto& frame : trace)
+		{
+			serializer.Push(frame);
+		}
+
+		REQUIRE(output.buffers.size() == 4u);
+
+		const auto& config = output.buffers[0];
+		const auto* data   = config->GetData();
+
+		REQUIRE(
+		  config->GetSize() ==
+		  RtpRawFrameSerializer::HeaderSize + RtpRawFrameSerializer::AudioConfigSize + 19u);
+		REQUIRE(Utils::Byte::Get4Bytes(data, 0u) == config->GetSize() - 4u);
+		REQUIRE(data[4] == static_cast<uint8_t>(RtpRawFrameSerializer::RecordType::Config));
+		REQUIRE(data[5] == static_cast<uint8_t>(RtpRawFrameSerializer::CodecId::Opus));
+		REQUIRE(Utils::Byte::Get4Bytes(data, RtpRawFrameSerializer::HeaderSize) == 48000u);
+		REQUIRE(data[RtpRawFrameSerializer::HeaderSize + 4u] == 2u);
+
+		for (size_t i = 0u; i < trace.size(); ++i)
+		{
+			const auto& record  = output.buffers[i + 1u];
+			const auto& payload = trace[i]->GetPayload();
+
+			data = record->GetData();
+
+			REQUIRE(record->GetSize() == RtpRawFrameSerializer::HeaderSize + payload->GetSize());
+			REQUIRE(Utils::Byte::Get4Bytes(data, 0u) == record->GetSize() - 4u);
+			REQUIRE(data[4] == static_cast<uint8_t>(RtpRawFrameSerializer::RecordType::Frame));
+			REQUIRE(data[6] == 0u);
+			REQUIRE(Utils::Byte::Get2Bytes(data, 8u) == trace[i]->GetSequenceNumber());
+			REQUIRE(Utils::Byte::Get4Bytes(data, 10u) == trace[i]->GetTimestamp());
+			REQUIRE(
+			  std::memcmp(
+			    data + RtpRawFrameSerializer::HeaderSize, payload->GetData(), payload->GetSize()) == 0);
+		}
+	}
+
+	SECTION("configuration is repeated for the new output")
+	{
+		TestOutputDevice output1;
+		TestOutputDevice output2;
+		RtpRawFrameSerializer serializer;
+		const auto trace = CreateOpusTrace(2u);
+
+		serializer.SetOutputDevice(&output1);
+		serializer.Push(trace[0]);
+		serializer.SetOutputDevice(&output2);
+		serializer.Push(trace[1]);
+
+		REQUIRE(output1.buffers.size() == 2u);
+		REQUIRE(output2.buffers.size() == 2u);
+		REQUIRE(
+		  output2.buffers[0]->GetData()[4] ==
+		  static_cast<uint8_t>(RtpRawFrameSerializer::RecordType::Config));
+	}
+
+	SECTION("key frames with the new resolution are preceded by configuration")
+	{
+		TestOutputDevice output;
+		RtpRawFrameSerializer serializer;
+		RtpVideoFrameConfig config;
+
+		config._width  = 640;
+		config._height = 480;
+
+		serializer.SetOutputDevice(&output);
+		serializer.Push(std::make_shared<TestVideoFrame>(CreatePayload(100u, 0u), true, 3000u, 1u, config));
+		serializer.Push(std::make_shared<TestVideoFrame>(CreatePayload(10u, 0u), false, 6000u, 2u, config));
+
+		config._width  = 1280;
+		config._height = 720;
+
+		serializer.Push(std::make_shared<TestVideoFrame>(CreatePayload(100u, 0u), true, 9000u, 3u, config));
+
+		REQUIRE(output.buffers.size() == 5u);
+
+		const auto* data = output.buffers[3]->GetData();
+
+		REQUIRE(data[4] == static_cast<uint8_t>(RtpRawFrameSerializer::RecordType::Config));
+		REQUIRE(data[5] == static_cast<uint8_t>(RtpRawFrameSerializer::CodecId::Vp8));
+		REQUIRE(data[6] == 1u);
+		REQUIRE(Utils::Byte::Get2Bytes(data, RtpRawFrameSerializer::HeaderSize + 4u) == 1280u);
+		REQUIRE(Utils::Byte::Get2Bytes(data, RtpRawFrameSerializer::HeaderSize + 6u) == 720u);
+	}
+
+	SECTION("output buffers are pooled")
+	{
+		auto pool = std::make_shared<MemoryBufferPool>();
+		TestOutputDevice output;
+		RtpRawFrameSerializer serializer(pool);
+		const auto trace = CreateOpusTrace(1000u);
+
+		output.keepBuffers = false;
+		serializer.SetOutputDevice(&output);
+
+		for (const auto& frame : trace)
+		{
+			serializer.Push(frame);
+		}
+
+		REQUIRE(pool->GetAllocationsCount() <= 2u);
+	}
+}
+
+SCENARIO("media frame fan-out", "[mediatranslate][serializer]")
+{
+	const RtpCodecMimeType opus(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS);
+
+	SECTION("device attached later receives configuration record")
+	{
+		auto output1 = std::make_shared<TestOutputDevice>();
+		auto output2 = std::make_shared<TestOutputDevice>();
+		RtpMediaFrameFanOut fanOut;
+		RtpMediaFrameFanOut::Outputs outputs;
+		const auto trace = CreateOpusTrace(3u);
+
+		outputs[output1.get()] = { output1, MediaFrameFormat::Raw };
+		fanOut.Update(opus, outputs);
+
+		REQUIRE(fanOut.Push(trace[0]));
+
+		outputs[output2.get()] = { output2, MediaFrameFormat::Raw };
+		fanOut.Update(opus, outputs);
+
+		REQUIRE(fanOut.GetSize() == 2u);
+		REQUIRE(fanOut.Push(trace[1]));
+		REQUIRE(fanOut.Push(trace[2]));
+
+		REQUIRE(output1->buffers.size() == 4u);
+		REQUIRE(output2->buffers.size() == 3u);
+		REQUIRE(
+		  output2->buffers[0]->GetData()[4] ==
+		  static_cast<uint8_t>(RtpRawFrameSerializer::RecordType::Config));
+		REQUIRE(Utils::Byte::Get2Bytes(output2->buffers[1]->GetData(), 8u) == trace[1]->GetSequenceNumber());
+	}
+
+	SECTION("device attached later receives WebM header")
+	{
+		auto output1 = std::make_shared<TestOutputDevice>();
+		auto output2 = std::make_shared<TestOutputDevice>();
+		RtpMediaFrameFanOut fanOut;
+		RtpMediaFrameFanOut::Outputs outputs;
+		const auto trace = CreateOpusTrace(2u);
+		// EBML element ID
+		const uint8_t ebml[] = { 0x1a, 0x45, 0xdf, 0xa3 };
+
+		outputs[output1.get()] = { output1, MediaFrameFormat::WebM };
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[0]);
+
+		outputs[output2.get()] = { output2, MediaFrameFormat::WebM };
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[1]);
+
+		REQUIRE(!output1->buffers.empty());
+		REQUIRE(!output2->buffers.empty());
+		REQUIRE(output1->buffers[0]->GetSize() > sizeof(ebml));
+		REQUIRE(std::memcmp(output1->buffers[0]->GetData(), ebml, sizeof(ebml)) == 0);
+		REQUIRE(output2->buffers[0]->GetSize() > sizeof(ebml));
+		REQUIRE(std::memcmp(output2->buffers[0]->GetData(), ebml, sizeof(ebml)) == 0);
+	}
+
+	SECTION("detached device is released and others keep their stream")
+	{
+		auto output1 = std::make_shared<TestOutputDevice>();
+		auto output2 = std::make_shared<TestOutputDevice>();
+		const std::weak_ptr<TestOutputDevice> weakOutput2(output2);
+		RtpMediaFrameFanOut fanOut;
+		RtpMediaFrameFanOut::Outputs outputs;
+		const auto trace = CreateOpusTrace(2u);
+
+		outputs[output1.get()] = { output1, MediaFrameFormat::Raw };
+		outputs[output2.get()] = { output2, MediaFrameFormat::Raw };
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[0]);
+
+		outputs.erase(output2.get());
+		output2.reset();
+
+		REQUIRE(!weakOutput2.expired());
+
+		fanOut.Update(opus, outputs);
+
+		REQUIRE(weakOutput2.expired());
+		REQUIRE(fanOut.Push(trace[1]));
+		// Configuration is not repeated.
+		REQUIRE(output1->buffers.size() == 3u);
+
+		fanOut.Update(opus, RtpMediaFrameFanOut::Outputs());
+
+		REQUIRE(fanOut.IsEmpty());
+		REQUIRE(!fanOut.Push(trace[1]));
+	}
+
+	SECTION("recording device doesn't switch live devices to file mode")
+	{
+		auto live     = std::make_shared<TestOutputDevice>();
+		auto recorder = std::make_shared<TestOutputDevice>();
+		RtpMediaFrameFanOut fanOut;
+		RtpMediaFrameFanOut::Outputs outputs;
+		const auto trace = CreateOpusTrace(4u);
+
+		outputs[live.get()]     = { live, MediaFrameFormat::Ogg };
+		outputs[recorder.get()] = { recorder, MediaFrameFormat::Ogg, false };
+		fanOut.Update(opus, outputs);
+
+		for (const auto& frame : trace)
+		{
+			REQUIRE(fanOut.Push(frame));
+		}
+
+		// Page per packet for live device, packets are collected for recording.
+		REQUIRE(live->buffers.size() == 6u);
+		REQUIRE(recorder->buffers.size() == 2u);
+
+		// Changed mode re-creates the serializer, collected packets are finalized.
+		outputs[recorder.get()]._liveMode = true;
+		fanOut.Update(opus, outputs);
+
+		REQUIRE(fanOut.GetSize() == 2u);
+		REQUIRE(recorder->buffers.size() == 3u);
+		REQUIRE(CheckOggPage(recorder->buffers[2].get(), RtpOggOpusSerializer::LastPage, 2u).size() > 0u);
+		REQUIRE(GetLE8Bytes(recorder->buffers[2]->GetData(), 6u) == 960u * 4u);
+		REQUIRE(live->buffers.size() == 6u);
+	}
+}
+
+SCENARIO("Ogg Opus serializer", "[mediatranslate][serializer]")
+{
+	SECTION("header pages precede the first packet")
+	{
+		TestOutputDevice output;
+		RtpOggOpusSerializer serializer;
+		const auto trace = CreateOpusTrace(3u);
+
+		serializer.SetOutputDevice(&output);
+
+		for (const auto& frame : trace)
+		{
+			serializer.Push(frame);
+		}
+
+		REQUIRE(output.buffers.size() == 5u);
+
+		const auto head = CheckOggPage(output.buffers[0].get(), RtpOggOpusSerializer::FirstPage, 0u);
+
+		REQUIRE(GetLE8Bytes(output.buffers[0]->GetData(), 6u) == 0u);
+		REQUIRE(head.size() == 19u);
+		REQUIRE(std::memcmp(head.data(), "OpusHead", 8u) == 0);
+		REQUIRE(head[8] == 1u);
+		REQUIRE(head[9] == 2u);
+		REQUIRE(GetLE4Bytes(head.data(), 12u) == 48000u);
+
+		const auto tags = CheckOggPage(output.buffers[1].get(), 0u, 1u);
+
+		REQUIRE(GetLE8Bytes(output.buffers[1]->GetData(), 6u) == 0u);
+		REQUIRE(std::memcmp(tags.data(), "OpusTags", 8u) == 0);
+
+		// One packet per page in live mode.
+		for (size_t i = 0u; i < trace.size(); ++i)
+		{
+			const auto& page    = output.buffers[i + 2u];
+			const auto& payload = trace[i]->GetPayload();
+			const auto body     = CheckOggPage(page.get(), 0u, static_cast<uint32_t>(i + 2u));
+
+			REQUIRE(GetLE8Bytes(page->GetData(), 6u) == 960u * (i + 1u));
+			REQUIRE(body.size() == payload->GetSize());
+			REQUIRE(std::memcmp(body.data(), payload->GetData(), payload->GetSize()) == 0);
+		}
+	}
+
+	SECTION("file mode collects packets into pages and ends the stream")
+	{
+		TestOutputDevice output;
+		RtpOggOpusSerializer serializer;
+		const auto trace = CreateOpusTrace(120u);
+
+		serializer.SetLiveMode(false);
+		serializer.SetOutputDevice(&output);
+
+		for (const auto& frame : trace)
+		{
+			serializer.Push(frame);
+		}
+
+		REQUIRE(output.buffers.size() == 4u);
+
+		serializer.SetOutputDevice(nullptr);
+
+		REQUIRE(output.buffers.size() == 5u);
+
+		const auto& last = output.buffers[4];
+
+		REQUIRE(CheckOggPage(output.buffers[2].get(), 0u, 2u).size() > 0u);
+		REQUIRE(output.buffers[2]->GetData()[26] == 50u);
+		REQUIRE(GetLE8Bytes(output.buffers[3]->GetData(), 6u) == 960u * 100u);
+		REQUIRE(CheckOggPage(last.get(), RtpOggOpusSerializer::LastPage, 4u).size() > 0u);
+		REQUIRE(last->GetData()[26] == 20u);
+		REQUIRE(GetLE8Bytes(last->GetData(), 6u) == 960u * 120u);
+	}
+
+	SECTION("granule position follows RTP timestamps")
+	{
+		TestOutputDevice output;
+		RtpOggOpusSerializer serializer;
+		RtpAudioFrameConfig config;
+
+		// TOC of 20 ms SILK frame and 2 x 10 ms CELT frames.
+		const auto silk = CreatePayload(40u, 0x08);
+		const auto celt = CreatePayload(40u, 0xf1);
+
+		serializer.SetOutputDevice(&output);
+		serializer.Push(std::make_shared<TestAudioFrame>(silk, 1000u, 1u, config));
+		// Silence of 200 ms.
+		serializer.Push(std::make_shared<TestAudioFrame>(silk, 1000u + 960u * 11u, 2u, config));
+		// Late packet doesn't move position back.
+		serializer.Push(std::make_shared<TestAudioFrame>(celt, 1000u + 960u * 10u, 3u, config));
+		serializer.Push(std::make_shared<TestAudioFrame>(celt, 1000u + 960u * 12u, 4u, config));
+
+		REQUIRE(output.buffers.size() == 6u);
+		REQUIRE(GetLE8Bytes(output.buffers[2]->GetData(), 6u) == 960u);
+		REQUIRE(GetLE8Bytes(output.buffers[3]->GetData(), 6u) == 960u * 12u);
+		REQUIRE(GetLE8Bytes(output.buffers[4]->GetData(), 6u) == 960u * 12u);
+		REQUIRE(GetLE8Bytes(output.buffers[5]->GetData(), 6u) == 960u * 13u);
+		// ID header is created from audio configuration.
+		REQUIRE(output.buffers[0]->GetData()[RtpOggOpusSerializer::PageHeaderSize + 1u + 9u] == 1u);
+	}
+
+	SECTION("headers are repeated for the new output")
+	{
+		TestOutputDevice output1;
+		TestOutputDevice output2;
+		RtpOggOpusSerializer serializer;
+		const auto trace = CreateOpusTrace(2u);
+
+		serializer.SetOutputDevice(&output1);
+		serializer.Push(trace[0]);
+		serializer.SetOutputDevice(&output2);
+		serializer.Push(trace[1]);
+
+		// Empty page ends the stream of the previous output.
+		REQUIRE(output1.buffers.size() == 4u);
+		REQUIRE(CheckOggPage(output1.buffers[3].get(), RtpOggOpusSerializer::LastPage, 3u).empty());
+		REQUIRE(output2.buffers.size() == 3u);
+		REQUIRE(CheckOggPage(output2.buffers[0].get(), RtpOggOpusSerializer::FirstPage, 0u).size() == 19u);
+	}
+
+	SECTION("each device attached at different time starts own logical stream")
+	{
+		const RtpCodecMimeType opus(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS);
+		auto output1 = std::make_shared<TestOutputDevice>();
+		auto output2 = std::make_shared<TestOutputDevice>();
+		RtpMediaFrameFanOut fanOut;
+		RtpMediaFrameFanOut::Outputs outputs;
+		const auto trace = CreateOpusTrace(4u);
+
+		outputs[output1.get()] = { output1, MediaFrameFormat::Ogg };
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[0]);
+		fanOut.Push(trace[1]);
+
+		outputs[output2.get()] = { output2, MediaFrameFormat::Ogg };
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[2]);
+
+		outputs.erase(output1.get());
+		fanOut.Update(opus, outputs);
+		fanOut.Push(trace[3]);
+
+		// Headers, 3 packets and the last page of the detached device.
+		REQUIRE(output1->buffers.size() == 6u);
+		REQUIRE(CheckOggPage(output1->buffers[0].get(), RtpOggOpusSerializer::FirstPage, 0u).size() == 19u);
+		REQUIRE(GetLE8Bytes(output1->buffers[4]->GetData(), 6u) == 960u * 3u);
+		REQUIRE(CheckOggPage(output1->buffers[5].get(), RtpOggOpusSerializer::LastPage, 5u).empty());
+
+		// Own headers and positions from the first packet of the device.
+		REQUIRE(output2->buffers.size() == 4u);
+
+		const auto head = CheckOggPage(output2->buffers[0].get(), RtpOggOpusSerializer::FirstPage, 0u);
+
+		REQUIRE(std::memcmp(head.data(), "OpusHead", 8u) == 0);
+
+		const auto tags = CheckOggPage(output2->buffers[1].get(), 0u, 1u);
+
+		REQUIRE(std::memcmp(tags.data(), "OpusTags", 8u) == 0);
+
+		for (size_t i = 0u; i < 2u; ++i)
+		{
+			const auto& page    = output2->buffers[i + 2u];
+			const auto& payload = trace[i + 2u]->GetPayload();
+			const auto body     = CheckOggPage(page.get(), 0u, static_cast<uint32_t>(i + 2u));
+
+			REQUIRE(GetLE8Bytes(page->GetData(), 6u) == 960u * (i + 1u));
+			REQUIRE(body.size() == payload->GetSize());
+		}
+	}
+
+	SECTION("output buffers are pooled")
+	{
+		auto pool = std::make_shared<MemoryBufferPool>();
+		TestOutputDevice output;
+		RtpOggOpusSerializer serializer(pool);
+		const auto trace = CreateOpusTrace(1000u);
+
+		output.keepBuffers = false;
+		serializer.SetOutputDevice(&output);
+
+		for (const auto& frame : trace)
+		{
+			serializer.Push(frame);
+		}
+
+		REQUIRE(pool->GetAllocationsCount() <= 3u);
+	}
+}
+
+// Hidden, run with: mediasoup-worker-test "[benchmark]"
+TEST_CASE("media frame serializers throughput", "[.][benchmark][mediatranslate]")
+{
+	SECTION("Opus")
+	{
+		RunBenchmark("Opus", CreateOpusTrace(3000u), 20u);
+	}
+
+	SECTION("VP8")
+	{
+		RunBenchmark("VP8", CreateVp8Trace(900u), 33u);
+	}
+}
@@ -0,0 +1,90 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/RtpPacketizerOpus.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+using namespace RTC;
+
+static std::shared_ptr<const MemoryBuffer> CreateOpusFrame(uint8_t toc, size_t len = 80u)
+{
+	std::vector<uint8_t> data(len, 0xab);
+
+	data[0] = toc;
+
+	return SimpleMemoryBuffer::Create(std::move(data));
+}
+
+SCENARIO("Opus packetizer", "[mediatranslate][opus]")
+{
+	// TOC byte: SILK-only 20 ms, one frame.
+	const uint8_t toc20ms{ 0x08 };
+
+	SECTION("duration of packets")
+	{
+		const uint8_t frame20ms[] = { toc20ms };
+		// SILK-only 10 ms, two frames of equal size.
+		const uint8_t frame2x10ms[] = { 0x01 };
+		// CELT-only 2.5 ms, arbitrary number of frames (4).
+		const uint8_t frame4x2_5ms[] = { 0x83, 0x04 };
+		// SILK-only 60 ms, arbitrary number of frames (3), longer than 120 ms.
+		const uint8_t frame3x60ms[] = { 0x1b, 0x03 };
+
+		REQUIRE(RtpPacketizerOpus::GetSamplesCount(frame20ms, sizeof(frame20ms)) == 960u);
+		REQUIRE(RtpPacketizerOpus::GetSamplesCount(frame2x10ms, sizeof(frame2x10ms)) == 960u);
+		REQUIRE(RtpPacketizerOpus::GetSamplesCount(frame4x2_5ms, sizeof(frame4x2_5ms)) == 480u);
+		REQUIRE(RtpPacketizerOpus::GetSamplesCount(frame3x60ms, sizeof(frame3x60ms)) == 0u);
+		REQUIRE(RtpPacketizerOpus::GetSamplesCount(nullptr, 0u) == 0u);
+	}
+
+	SECTION("continuous sequence numbers and timestamps")
+	{
+		RtpPacketizerOpus packetizer(0x05u, 111u, 65534u, 1000u);
+		const auto frame = CreateOpusFrame(toc20ms);
+
+		for (uint32_t i = 0u; i < 4u; ++i)
+		{
+			auto* packet = packetizer.Packetize(frame, i == 0u, 100u + i * 20u);
+
+			REQUIRE(packet);
+			REQUIRE(packet->GetSsrc() == 0x05u);
+			REQUIRE(packet->GetPayloadType() == 111u);
+			REQUIRE(packet->HasMarker() == (i == 0u));
+			REQUIRE(packet->GetSequenceNumber() == static_cast<uint16_t>(65534u + i));
+			REQUIRE(packet->GetTimestamp() == 1000u + i * 960u);
+			REQUIRE(packet->GetPayloadLength() == frame->GetSize());
+		}
+	}
+
+	SECTION("timestamp advances by wall-clock gap for a new sequence")
+	{
+		RtpPacketizerOpus packetizer(0x05u, 111u, 0u, 0u);
+		const auto frame = CreateOpusFrame(toc20ms);
+
+		REQUIRE(packetizer.Packetize(frame, true, 1000u));
+
+		// 500 ms of silence.
+		auto* packet = packetizer.Packetize(frame, true, 1500u);
+
+		REQUIRE(packet);
+		REQUIRE(packet->HasMarker());
+		REQUIRE(packet->GetSequenceNumber() == 1u);
+		REQUIRE(packet->GetTimestamp() == 500u * 48u);
+	}
+
+	SECTION("malformed frames are rejected")
+	{
+		RtpPacketizerOpus packetizer(0x05u, 111u, 0u, 0u);
+
+		REQUIRE(!packetizer.Packetize(nullptr, false, 0u));
+		REQUIRE(!packetizer.Packetize(CreateOpusFrame(toc20ms, 1500u), false, 0u));
+
+		// Sequence is not advanced by rejected frames.
+		auto* packet = packetizer.Packetize(CreateOpusFrame(toc20ms), false, 0u);
+
+		REQUIRE(packet);
+		REQUIRE(packet->GetSequenceNumber() == 0u);
+	}
+}
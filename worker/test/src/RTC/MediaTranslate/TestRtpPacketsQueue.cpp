@@ -0,0 +1,151 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/RtpPacketsQueue.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+SCENARIO("RTP packets queue", "[mediatranslate][rtppacketsqueue]")
+{
+	// clang-format off
+	uint8_t buffer[] =
+	{
+		0x90, 0x6f, 0x00, 0x01,
+		0x00, 0x00, 0x03, 0xc0,
+		0x00, 0x00, 0x00, 0x05,
+		0xbe, 0xde, 0x00, 0x01, // Header Extension
+		0x12, 0x61, 0x62, 0x63, // MID (id 1, len 3)
+		0x78, 0xab, 0xab, 0xab, // Payload
+		0xab, 0xab, 0xab, 0xab
+	};
+	// clang-format on
+
+	std::unique_ptr<RtpPacket> packet(RtpPacket::Parse(buffer, sizeof(buffer)));
+
+	REQUIRE(packet);
+
+	packet->SetMidExtensionId(1);
+
+	SECTION("packets are copied into recycled items without allocations")
+	{
+		RtpPacketsQueue<int> queue(4u);
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			packet->SetSequenceNumber(static_cast<uint16_t>(i));
+			packet->GetPayload()[1] = static_cast<uint8_t>(i);
+
+			REQUIRE(queue.Push(packet.get(), i));
+
+			auto item = queue.Pop();
+
+			REQUIRE(item);
+			REQUIRE(item->_info == i);
+			REQUIRE(item->_packet.get() != packet.get());
+			REQUIRE(item->_packet->GetData() != packet->GetData());
+			REQUIRE(item->_packet->GetSequenceNumber() == static_cast<uint16_t>(i));
+			REQUIRE(item->_packet->GetPayloadLength() == 8u);
+			REQUIRE(item->_packet->GetPayload()[1] == static_cast<uint8_t>(i));
+
+			std::string mid;
+
+			REQUIRE(item->_packet->ReadMid(mid));
+			REQUIRE(mid == "abc");
+
+			queue.Recycle(std::move(item));
+		}
+
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetAllocationsCount() == 1u);
+	}
+
+	SECTION("recycled packet is parsed again")
+	{
+		RtpPacketsQueue<int> queue(4u);
+
+		REQUIRE(queue.Push(packet.get(), 0));
+
+		queue.Recycle(queue.Pop());
+
+		// clang-format off
+		uint8_t buffer2[] =
+		{
+			0x80, 0x6f, 0x00, 0x02,
+			0x00, 0x00, 0x03, 0xc0,
+			0x00, 0x00, 0x00, 0x05,
+			0x11, 0x22, 0x33
+		};
+		// clang-format on
+
+		std::unique_ptr<RtpPacket> packet2(RtpPacket::Parse(buffer2, sizeof(buffer2)));
+
+		REQUIRE(packet2);
+
+		REQUIRE(queue.Push(packet2.get(), 1));
+
+		const auto item = queue.Pop();
+		std::string mid;
+
+		REQUIRE(item);
+		REQUIRE(queue.GetAllocationsCount() == 1u);
+		REQUIRE(item->_packet->GetSize() == sizeof(buffer2));
+		REQUIRE(item->_packet->GetSequenceNumber() == 2u);
+		REQUIRE(!item->_packet->HasHeaderExtension());
+		REQUIRE(!item->_packet->ReadMid(mid));
+		REQUIRE(item->_packet->GetPayloadLength() == 3u);
+		REQUIRE(item->_packet->GetPayload()[2] == 0x33);
+	}
+
+	SECTION("oversized packet is dropped instead of copied")
+	{
+		RtpPacketsQueue<int> queue(4u);
+		std::vector<uint8_t> buffer3(RtpPacketsQueue<int>::_maxPacketSize + 1u, 0xab);
+
+		std::memcpy(buffer3.data(), buffer, 12u);
+		// No header extension.
+		buffer3[0] = 0x80;
+
+		std::unique_ptr<RtpPacket> packet3(RtpPacket::Parse(buffer3.data(), buffer3.size()));
+
+		REQUIRE(packet3);
+
+		// While warming up, without recycled items.
+		REQUIRE(!queue.Push(packet3.get(), 0));
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetAllocationsCount() == 0u);
+
+		// In steady state, the recycled item is kept for the next packet.
+		REQUIRE(queue.Push(packet.get(), 1));
+
+		queue.Recycle(queue.Pop());
+
+		REQUIRE(!queue.Push(packet3.get(), 2));
+		REQUIRE(queue.IsEmpty());
+
+		std::unique_ptr<RtpPacket> clone(packet->Clone());
+
+		REQUIRE(!packet3->CloneInto(clone.get()));
+		REQUIRE(clone->GetSize() == packet->GetSize());
+
+		REQUIRE(queue.Push(packet.get(), 3));
+		REQUIRE(queue.Pop()->_info == 3);
+		REQUIRE(queue.GetAllocationsCount() == 1u);
+	}
+
+	SECTION("oldest packets are dropped on overflow")
+	{
+		RtpPacketsQueue<int> queue(2u);
+
+		REQUIRE(queue.Push(packet.get(), 0));
+		REQUIRE(queue.Push(packet.get(), 1));
+		REQUIRE(!queue.Push(packet.get(), 2));
+		REQUIRE(queue.GetDroppedCount() == 1u);
+		REQUIRE(queue.Pop()->_info == 1);
+		REQUIRE(queue.Pop()->_info == 2);
+		REQUIRE(!queue.Pop());
+	}
+}
@@ -0,0 +1,88 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/SpscQueue.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+
+using namespace RTC;
+
+SCENARIO("SPSC queue", "[mediatranslate][spscqueue]")
+{
+	SECTION("items are popped in FIFO order")
+	{
+		SpscQueue<int> queue(4u);
+
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(!queue.Pop());
+
+		for (int i = 0; i < 3; ++i)
+		{
+			REQUIRE(queue.Push(std::make_unique<int>(i)));
+		}
+
+		for (int i = 0; i < 3; ++i)
+		{
+			const auto item = queue.Pop();
+
+			REQUIRE(item);
+			REQUIRE(*item == i);
+		}
+
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetDroppedCount() == 0u);
+	}
+
+	SECTION("oldest items are dropped on overflow")
+	{
+		SpscQueue<int> queue(4u);
+
+		for (int i = 0; i < 10; ++i)
+		{
+			REQUIRE(queue.Push(std::make_unique<int>(i)) == (i < 4));
+		}
+
+		REQUIRE(queue.GetDroppedCount() == 6u);
+
+		for (int i = 6; i < 10; ++i)
+		{
+			const auto item = queue.Pop();
+
+			REQUIRE(item);
+			REQUIRE(*item == i);
+		}
+
+		REQUIRE(!queue.Pop());
+	}
+
+	SECTION("concurrent producer and consumer")
+	{
+		constexpr int count = 100000;
+		SpscQueue<int> queue(64u);
+		int received{ 0 };
+		int last{ -1 };
+		bool ordered{ true };
+
+		std::thread consumer(
+		  [&]()
+		  {
+			  while (last != count - 1)
+			  {
+				  if (const auto item = queue.Pop())
+				  {
+					  ordered = ordered && *item > last;
+					  last    = *item;
+					  ++received;
+				  }
+			  }
+		  });
+
+		for (int i = 0; i < count; ++i)
+		{
+			queue.Push(std::make_unique<int>(i));
+		}
+
+		consumer.join();
+
+		REQUIRE(ordered);
+		REQUIRE(received + queue.GetDroppedCount() == count);
+	}
+}
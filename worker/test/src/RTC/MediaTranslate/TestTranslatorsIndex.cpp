@@ -0,0 +1,246 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/TranslatorsIndex.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "RTC/RtpPacketsCollector.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	constexpr size_t ProducersCount{ 64u };
+	constexpr size_t PacketsCount{ 10000u };
+
+	struct TestProducer
+	{
+		std::string id;
+	};
+
+	// Idle ProducerTranslator stand-in: nobody consumes the translation.
+	class TestTranslator : public RtpPacketsCollector
+	{
+	public:
+		bool IsActive() const
+		{
+			return this->activeStreams.load(std::memory_order_relaxed) > 0u;
+		}
+		void AddPacket(const RtpPacket* packet) override
+		{
+			if (packet && IsActive())
+			{
+				++this->packets;
+			}
+		}
+
+	public:
+		std::atomic<uint32_t> activeStreams{ 0u };
+		size_t packets{ 0u };
+	};
+
+	// Router stand-in, the only work of the receive path when translation is disabled.
+	class TestRouter : public RtpPacketsCollector
+	{
+	public:
+		void AddPacket(const RtpPacket* packet) override
+		{
+			this->bytes += packet->GetPayloadLength();
+			this->lastSequenceNumber = packet->GetSequenceNumber();
+		}
+
+	public:
+		size_t bytes{ 0u };
+		uint16_t lastSequenceNumber{ 0u };
+	};
+
+	struct TestEnvironment
+	{
+		TestEnvironment()
+		{
+			for (size_t i = 0u; i < ProducersCount; ++i)
+			{
+				auto producer   = std::make_unique<TestProducer>();
+				auto translator = std::make_shared<TestTranslator>();
+
+				// UUID of producer.
+				producer->id = "a1b2c3d4-e5f6-4789-abcd-" + std::to_string(100000000000u + i);
+
+				translatorsById[producer->id] = translator;
+				translatorsIndex.Add(producer.get(), translator.get());
+
+				producers.push_back(std::move(producer));
+				translators.push_back(std::move(translator));
+			}
+
+			// clang-format off
+			uint8_t buffer[] =
+			{
+				0x80, 0x6f, 0x00, 0x01,
+				0x00, 0x00, 0x03, 0xc0,
+				0x00, 0x00, 0x00, 0x05,
+				0x78, 0xab, 0xab, 0xab
+			};
+			// clang-format on
+
+			std::memcpy(this->buffer, buffer, sizeof(buffer));
+			packet.reset(RtpPacket::Parse(this->buffer, sizeof(buffer)));
+			router = &this->testRouter;
+		}
+
+		// Packets of producers interleaved in bursts of 10, like from a few transports.
+		const TestProducer* GetProducer(size_t packetIndex) const
+		{
+			return producers[(packetIndex / 10u) % producers.size()].get();
+		}
+
+		std::vector<std::unique_ptr<TestProducer>> producers;
+		std::vector<std::shared_ptr<TestTranslator>> translators;
+		absl::flat_hash_map<std::string, std::shared_ptr<TestTranslator>> translatorsById;
+		TranslatorsIndex<TestProducer, TestTranslator> translatorsIndex;
+		TestRouter testRouter;
+		// Virtual call like of transport listener.
+		RtpPacketsCollector* router{ nullptr };
+		uint8_t buffer[64];
+		std::unique_ptr<RtpPacket> packet;
+	};
+} // namespace
+
+SCENARIO("translators index", "[mediatranslate][translatorsindex]")
+{
+	SECTION("translators are found by address of producer")
+	{
+		TestProducer producer1;
+		TestProducer producer2;
+		TestTranslator translator1;
+		TestTranslator translator2;
+		TranslatorsIndex<TestProducer, TestTranslator> index;
+
+		index.Add(&producer1, &translator1);
+		index.Add(&producer2, &translator2);
+
+		REQUIRE(index.GetSize() == 2u);
+		REQUIRE(index.Find(&producer1) == &translator1);
+		REQUIRE(index.Find(&producer2) == &translator2);
+		REQUIRE(index.Find(&producer1) == &translator1);
+		REQUIRE(index.Find(nullptr) == nullptr);
+	}
+
+	SECTION("removed translator isn't returned from cache")
+	{
+		TestProducer producer;
+		TestTranslator translator1;
+		TestTranslator translator2;
+		TranslatorsIndex<TestProducer, TestTranslator> index;
+
+		index.Add(&producer, &translator1);
+
+		REQUIRE(index.Find(&producer) == &translator1);
+
+		index.Remove(&producer);
+
+		REQUIRE(index.Find(&producer) == nullptr);
+		REQUIRE(index.IsEmpty());
+
+		index.Add(&producer, &translator1);
+
+		REQUIRE(index.Find(&producer) == &translator1);
+
+		// Replaced translator of the cached producer.
+		index.Add(&producer, &translator2);
+
+		REQUIRE(index.Find(&producer) == &translator2);
+	}
+
+	SECTION("idle translators don't receive packets")
+	{
+		TestEnvironment env;
+
+		for (size_t i = 0u; i < PacketsCount; ++i)
+		{
+			if (const auto translator = env.translatorsIndex.Find(env.GetProducer(i)))
+			{
+				translator->AddPacket(env.packet.get());
+			}
+		}
+
+		for (const auto& translator : env.translators)
+		{
+			REQUIRE(translator->packets == 0u);
+		}
+
+		env.translators.front()->activeStreams = 1u;
+
+		for (size_t i = 0u; i < 10u; ++i)
+		{
+			env.translatorsIndex.Find(env.GetProducer(i))->AddPacket(env.packet.get());
+		}
+
+		REQUIRE(env.translators.front()->packets == 10u);
+	}
+}
+
+// Per-packet cost of idle translation on the receive path, must be within noise
+// of the disabled one; router & translators are stand-ins.
+// Hidden, run with: mediasoup-worker-test "[benchmark]"
+TEST_CASE("idle translation dispatch", "[.][benchmark][mediatranslate]")
+{
+	TestEnvironment env;
+
+	REQUIRE(env.packet);
+
+	BENCHMARK("translation disabled, " + std::to_string(PacketsCount) + " packets")
+	{
+		for (size_t i = 0u; i < PacketsCount; ++i)
+		{
+			env.router->AddPacket(env.packet.get());
+		}
+
+		return env.testRouter.bytes;
+	};
+
+	// Former dispatch: lookup by producer ID & copy of shared pointer per packet.
+	BENCHMARK("lookup by ID, " + std::to_string(PacketsCount) + " packets")
+	{
+		for (size_t i = 0u; i < PacketsCount; ++i)
+		{
+			const auto* producer = env.GetProducer(i);
+
+			env.router->AddPacket(env.packet.get());
+
+			const auto it = env.translatorsById.find(producer->id);
+
+			if (it != env.translatorsById.end())
+			{
+				if (const auto translator = it->second)
+				{
+					translator->AddPacket(env.packet.get());
+				}
+			}
+		}
+
+		return env.testRouter.bytes;
+	};
+
+	BENCHMARK("lookup by address, " + std::to_string(PacketsCount) + " packets")
+	{
+		for (size_t i = 0u; i < PacketsCount; ++i)
+		{
+			const auto* producer = env.GetProducer(i);
+
+			env.router->AddPacket(env.packet.get());
+
+			if (const auto translator = env.translatorsIndex.Find(producer))
+			{
+				translator->AddPacket(env.packet.get());
+			}
+		}
+
+		return env.testRouter.bytes;
+	};
+}
@@ -0,0 +1,171 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/RtpMediaFrame.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/VoiceActivityGate.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	// 20 ms of 48 kHz audio.
+	constexpr uint32_t FrameDuration{ 960u };
+	constexpr size_t SpeechSize{ 80u };
+	constexpr size_t DtxSize{ 1u };
+
+	std::shared_ptr<RtpMediaFrame> CreateFrame(uint32_t index, size_t size)
+	{
+		std::vector<uint8_t> data(size, 0xab);
+
+		return std::make_shared<RtpMediaFrame>(
+		  RtpCodecMimeType(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS),
+		  SimpleMemoryBuffer::Create(std::move(data)),
+		  false,
+		  index * FrameDuration,
+		  0x05u,
+		  static_cast<uint16_t>(index),
+		  48000u);
+	}
+
+	VoiceActivityGate::AudioLevel Level(uint8_t level, bool voice = false)
+	{
+		VoiceActivityGate::AudioLevel audioLevel;
+
+		audioLevel._level = level;
+		audioLevel._voice = voice;
+
+		return audioLevel;
+	}
+} // namespace
+
+SCENARIO("voice activity gate", "[mediatranslate][vad]")
+{
+	VoiceActivitySettings settings;
+
+	settings._hangoverMs = 100u;
+	settings._preRollMs  = 60u;
+
+	SECTION("silence is held back")
+	{
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		for (uint32_t i = 0u; i < 50u; ++i)
+		{
+			gate.Push(CreateFrame(i, DtxSize), std::nullopt, output);
+		}
+
+		REQUIRE(output.empty());
+		REQUIRE(!gate.IsOpen());
+		// Pre-roll of 3 frames is still buffered.
+		REQUIRE(gate.GetGatedFrames() == 47u);
+		REQUIRE(gate.GetGatedBytes() == 47u * DtxSize);
+		REQUIRE(gate.GetSpeechSegments() == 0u);
+	}
+
+	SECTION("speech onset is preceded by pre-roll")
+	{
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		for (uint32_t i = 0u; i < 10u; ++i)
+		{
+			gate.Push(CreateFrame(i, SpeechSize), Level(100u), output);
+		}
+
+		REQUIRE(output.empty());
+
+		gate.Push(CreateFrame(10u, SpeechSize), Level(30u), output);
+
+		REQUIRE(gate.IsOpen());
+		REQUIRE(output.size() == 4u);
+
+		for (uint32_t i = 0u; i < output.size(); ++i)
+		{
+			REQUIRE(output[i]->GetTimestamp() == (7u + i) * FrameDuration);
+		}
+
+		REQUIRE(gate.GetGatedFrames() == 7u);
+		REQUIRE(gate.GetSpeechSegments() == 1u);
+	}
+
+	SECTION("gate is closed after hangover")
+	{
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		gate.Push(CreateFrame(0u, SpeechSize), std::nullopt, output);
+
+		// 100 ms of hangover.
+		for (uint32_t i = 1u; i <= 5u; ++i)
+		{
+			gate.Push(CreateFrame(i, DtxSize), std::nullopt, output);
+		}
+
+		REQUIRE(gate.IsOpen());
+		REQUIRE(output.size() == 6u);
+
+		gate.Push(CreateFrame(6u, DtxSize), std::nullopt, output);
+
+		REQUIRE(!gate.IsOpen());
+		REQUIRE(output.size() == 6u);
+	}
+
+	SECTION("voice flag and level of audio level extension")
+	{
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		gate.Push(CreateFrame(0u, SpeechSize), Level(90u, true), output);
+
+		REQUIRE(gate.IsOpen());
+		REQUIRE(output.size() == 1u);
+
+		gate.Reset();
+		output.clear();
+
+		// DTX frame is silence even with the voice flag.
+		gate.Push(CreateFrame(1u, DtxSize), Level(0u, true), output);
+
+		REQUIRE(!gate.IsOpen());
+		REQUIRE(output.empty());
+	}
+
+	SECTION("gap of silence is kept in timestamps")
+	{
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		gate.Push(CreateFrame(0u, SpeechSize), std::nullopt, output);
+
+		for (uint32_t i = 1u; i < 100u; ++i)
+		{
+			gate.Push(CreateFrame(i, DtxSize), std::nullopt, output);
+		}
+
+		gate.Push(CreateFrame(100u, SpeechSize), std::nullopt, output);
+
+		REQUIRE(gate.GetSpeechSegments() == 2u);
+		REQUIRE(output.back()->GetTimestamp() == 100u * FrameDuration);
+		REQUIRE(output.size() == 1u + 5u + 3u + 1u);
+	}
+
+	SECTION("disabled gate passes everything")
+	{
+		settings._enabled = false;
+
+		VoiceActivityGate gate(settings);
+		VoiceActivityGate::Frames output;
+
+		for (uint32_t i = 0u; i < 10u; ++i)
+		{
+			gate.Push(CreateFrame(i, DtxSize), std::nullopt, output);
+		}
+
+		REQUIRE(output.size() == 10u);
+		REQUIRE(gate.GetGatedFrames() == 0u);
+	}
+}
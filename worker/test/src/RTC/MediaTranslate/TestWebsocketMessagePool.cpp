@@ -0,0 +1,90 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/WebsocketMessagePool.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	using MessageManager = WebsocketMessageManager<WebsocketPooledMessage>;
+} // namespace
+
+SCENARIO("websocket message pool", "[mediatranslate][websocketmessagepool]")
+{
+	const std::string payload(1000u, 'x');
+
+	SECTION("released messages are reused without allocation")
+	{
+		const auto manager = std::make_shared<MessageManager>(4u);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			auto message = manager->get_message(websocketpp::frame::opcode::binary, payload.size());
+
+			REQUIRE(message);
+			REQUIRE(message->get_opcode() == websocketpp::frame::opcode::binary);
+			REQUIRE(message->get_payload().empty());
+			REQUIRE(!message->get_prepared());
+
+			message->append_payload(payload.data(), payload.size());
+			message->set_prepared(true);
+		}
+
+		REQUIRE(manager->GetAllocationsCount() == 1u);
+		REQUIRE(manager->GetReusesCount() == 99u);
+	}
+
+	SECTION("message held by listener is not reused")
+	{
+		const auto manager = std::make_shared<MessageManager>(4u);
+		auto message       = manager->get_message(websocketpp::frame::opcode::binary, payload.size());
+
+		message->append_payload(payload);
+
+		// Received binary message is passed to the listener as view of its payload.
+		const std::shared_ptr<MemoryBuffer> view = message;
+
+		message.reset();
+
+		const auto other = manager->get_message(websocketpp::frame::opcode::binary, payload.size());
+
+		REQUIRE(other.get() != view.get());
+		REQUIRE(manager->GetAllocationsCount() == 2u);
+		REQUIRE(view->GetSize() == payload.size());
+		REQUIRE(0 == std::memcmp(view->GetData(), payload.data(), payload.size()));
+	}
+
+	SECTION("messages above the limit are not pooled")
+	{
+		const auto manager = std::make_shared<MessageManager>(2u);
+		std::vector<MessageManager::message_ptr> messages;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			messages.push_back(manager->get_message(websocketpp::frame::opcode::text, 16u));
+		}
+
+		messages.clear();
+
+		for (int i = 0; i < 2; ++i)
+		{
+			messages.push_back(manager->get_message(websocketpp::frame::opcode::text, 16u));
+		}
+
+		REQUIRE(manager->GetAllocationsCount() == 4u);
+		REQUIRE(manager->GetReusesCount() == 2u);
+	}
+
+	SECTION("messages outlive the manager")
+	{
+		auto manager       = std::make_shared<MessageManager>();
+		const auto message = manager->get_message(websocketpp::frame::opcode::binary, 0u);
+
+		message->set_payload(payload);
+		manager.reset();
+
+		REQUIRE(message->GetSize() == payload.size());
+	}
+}
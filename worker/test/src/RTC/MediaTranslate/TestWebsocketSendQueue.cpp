@@ -0,0 +1,126 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/WebsocketSendQueue.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	std::shared_ptr<const MemoryBuffer> CreateMessage(size_t size, uint8_t tag = 0u)
+	{
+		return SimpleMemoryBuffer::Create(std::vector<uint8_t>(size, tag));
+	}
+
+	// tags of messages which may be sent through the idle transport
+	std::vector<uint8_t> PopAll(WebsocketSendQueue& queue, uint64_t nowMs, bool& drained)
+	{
+		std::vector<uint8_t> tags;
+
+		while (const auto message = queue.Pop(0u, nowMs, drained))
+		{
+			tags.push_back(message->GetData()[0]);
+		}
+
+		return tags;
+	}
+} // namespace
+
+SCENARIO("bounded send queue of websocket", "[mediatranslate][websocket]")
+{
+	WebsocketSendQueueSettings settings;
+
+	settings._maxBytes         = 1000u;
+	settings._maxDelayMs       = 0u;
+	settings._maxInFlightBytes = 500u;
+
+	SECTION("in-flight window limits messages handed to transport")
+	{
+		WebsocketSendQueue queue(settings);
+		bool drained = false;
+
+		REQUIRE(queue.Push(CreateMessage(300u), false, 0u) == WebsocketSendQueue::PushResult::Queued);
+		REQUIRE(queue.Push(CreateMessage(300u), false, 0u) == WebsocketSendQueue::PushResult::Queued);
+
+		REQUIRE(queue.Pop(300u, 0u, drained) == nullptr);
+		REQUIRE(queue.Pop(100u, 0u, drained) != nullptr);
+		// message larger than window is passed to the idle transport
+		REQUIRE(queue.Push(CreateMessage(600u), false, 0u) == WebsocketSendQueue::PushResult::Queued);
+		REQUIRE(queue.Pop(0u, 0u, drained) != nullptr);
+		REQUIRE(queue.Pop(0u, 0u, drained) != nullptr);
+		REQUIRE(queue.IsEmpty());
+		REQUIRE_FALSE(drained);
+	}
+
+	SECTION("oldest non key frames are dropped first")
+	{
+		WebsocketSendQueue queue(settings);
+		bool drained = false;
+
+		queue.Push(CreateMessage(300u, 1u), true, 0u);
+		queue.Push(CreateMessage(300u, 2u), false, 0u);
+		queue.Push(CreateMessage(300u, 3u), false, 0u);
+
+		REQUIRE(queue.Push(CreateMessage(300u, 4u), false, 0u) == WebsocketSendQueue::PushResult::Congested);
+		REQUIRE(queue.Push(CreateMessage(300u, 5u), true, 0u) == WebsocketSendQueue::PushResult::Queued);
+
+		const auto stats = queue.GetStats(0u);
+
+		REQUIRE(stats._congested);
+		REQUIRE(stats._congestions == 1u);
+		REQUIRE(stats._droppedMessages == 2u);
+		REQUIRE(stats._droppedBytes == 600u);
+		REQUIRE(stats._queuedMessages == 3u);
+		REQUIRE(stats._queuedBytes == 900u);
+
+		REQUIRE(PopAll(queue, 0u, drained) == std::vector<uint8_t>{ 1u, 4u, 5u });
+		REQUIRE(drained);
+		REQUIRE_FALSE(queue.GetStats(0u)._congested);
+	}
+
+	SECTION("newest message is rejected")
+	{
+		settings._dropPolicy = WebsocketDropPolicy::DropNewest;
+
+		WebsocketSendQueue queue(settings);
+		bool drained = false;
+
+		queue.Push(CreateMessage(600u, 1u), false, 0u);
+
+		REQUIRE(queue.Push(CreateMessage(600u, 2u), true, 0u) == WebsocketSendQueue::PushResult::Congested);
+		REQUIRE(queue.Push(CreateMessage(300u, 3u), false, 0u) == WebsocketSendQueue::PushResult::Queued);
+		REQUIRE(PopAll(queue, 0u, drained) == std::vector<uint8_t>{ 1u, 3u });
+		REQUIRE(queue.GetStats(0u)._droppedMessages == 1u);
+	}
+
+	SECTION("overflow with disconnect policy clears the queue")
+	{
+		WebsocketSendQueue queue(settings);
+
+		queue.SetDropPolicy(WebsocketDropPolicy::Disconnect);
+		queue.Push(CreateMessage(600u), true, 0u);
+
+		REQUIRE(queue.Push(CreateMessage(600u), false, 0u) == WebsocketSendQueue::PushResult::Overflow);
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetStats(0u)._droppedBytes == 1200u);
+	}
+
+	SECTION("age of the oldest message is limited")
+	{
+		settings._maxDelayMs = 100u;
+
+		WebsocketSendQueue queue(settings);
+		bool drained = false;
+
+		queue.Push(CreateMessage(10u, 1u), false, 0u);
+		queue.Push(CreateMessage(10u, 2u), false, 50u);
+
+		REQUIRE(queue.GetStats(80u)._queueDelayMs == 80u);
+		REQUIRE(queue.Push(CreateMessage(10u, 3u), false, 120u) == WebsocketSendQueue::PushResult::Congested);
+		REQUIRE(queue.GetStats(120u)._queueDelayMs == 70u);
+		REQUIRE(PopAll(queue, 130u, drained) == std::vector<uint8_t>{ 2u, 3u });
+		REQUIRE(queue.GetStats(130u)._maxWriteLatencyMs == 80u);
+		REQUIRE(drained);
+	}
+}
@@ -0,0 +1,154 @@
+#include "common.hpp"
+#include "RTC/MediaTranslate/SimpleMemoryBuffer.hpp"
+#include "RTC/MediaTranslate/WriteCoalescer.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace RTC;
+
+namespace
+{
+	class TestListener : public WriteCoalescer::Listener
+	{
+	public:
+		void OnCoalescedWrite(const std::shared_ptr<const MemoryBuffer>& buffer, bool hasKeyFrame) override
+		{
+			const std::lock_guard<std::mutex> lock(this->mutex);
+
+			this->sizes.push_back(buffer->GetSize());
+			this->keyFrames.push_back(hasKeyFrame);
+		}
+
+		std::vector<size_t> GetSizes()
+		{
+			const std::lock_guard<std::mutex> lock(this->mutex);
+
+			return this->sizes;
+		}
+
+		std::vector<bool> GetKeyFrames()
+		{
+			const std::lock_guard<std::mutex> lock(this->mutex);
+
+			return this->keyFrames;
+		}
+
+	private:
+		std::mutex mutex;
+		std::vector<size_t> sizes;
+		std::vector<bool> keyFrames;
+	};
+
+	const RtpCodecMimeType mime(RtpCodecMimeType::Type::AUDIO, RtpCodecMimeType::Subtype::OPUS);
+
+	void WriteFrame(WriteCoalescer& coalescer, size_t size, bool isKeyFrame = false)
+	{
+		coalescer.BeginWriteMediaPayload(1u, isKeyFrame, mime, 0u, 0u, 0u);
+		coalescer.Write(SimpleMemoryBuffer::Create(std::vector<uint8_t>(size, 0u)));
+		coalescer.EndWriteMediaPayload(1u, true);
+	}
+} // namespace
+
+SCENARIO("coalescing of media writes", "[mediatranslate][coalescer]")
+{
+	// deadline is far enough to not interfere
+	WriteCoalescingSettings settings;
+
+	settings._maxDelayMs = 60000u;
+	settings._maxSize    = 1000u;
+
+	SECTION("frames are batched up to max size")
+	{
+		TestListener listener;
+		auto coalescer = std::make_shared<WriteCoalescer>(&listener, settings);
+
+		for (int i = 0; i < 9; ++i)
+		{
+			WriteFrame(*coalescer, 100u);
+		}
+
+		REQUIRE(listener.GetSizes().empty());
+
+		WriteFrame(*coalescer, 100u);
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 1000u });
+
+		// large buffer without pending data is passed through
+		WriteFrame(*coalescer, 5000u);
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 1000u, 5000u });
+	}
+
+	SECTION("key frame and explicit flush are sent immediately")
+	{
+		TestListener listener;
+		auto coalescer = std::make_shared<WriteCoalescer>(&listener, settings);
+
+		WriteFrame(*coalescer, 100u);
+		WriteFrame(*coalescer, 200u, true);
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 300u });
+
+		WriteFrame(*coalescer, 50u);
+		coalescer->Flush();
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 300u, 50u });
+		REQUIRE(listener.GetKeyFrames() == std::vector<bool>{ true, false });
+	}
+
+	SECTION("pending data is dropped by reset and stop")
+	{
+		TestListener listener;
+		auto coalescer = std::make_shared<WriteCoalescer>(&listener, settings);
+
+		WriteFrame(*coalescer, 100u);
+		coalescer->Reset();
+		WriteFrame(*coalescer, 10u);
+		coalescer->Flush();
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 10u });
+
+		WriteFrame(*coalescer, 100u);
+		coalescer->Stop();
+		coalescer->Flush();
+		WriteFrame(*coalescer, 2000u);
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 10u });
+	}
+
+	SECTION("coalescing may be disabled")
+	{
+		TestListener listener;
+
+		settings._maxDelayMs = 0u;
+
+		auto coalescer = std::make_shared<WriteCoalescer>(&listener, settings);
+
+		WriteFrame(*coalescer, 100u);
+		WriteFrame(*coalescer, 100u);
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 100u, 100u });
+	}
+
+	SECTION("pending data is sent by deadline")
+	{
+		TestListener listener;
+
+		settings._maxDelayMs = 20u;
+
+		auto coalescer = std::make_shared<WriteCoalescer>(&listener, settings);
+
+		WriteFrame(*coalescer, 100u);
+
+		for (int i = 0; i < 100 && listener.GetSizes().empty(); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		REQUIRE(listener.GetSizes() == std::vector<size_t>{ 100u });
+	}
+}
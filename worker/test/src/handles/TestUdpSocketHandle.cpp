@@ -0,0 +1,494 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Settings.hpp"
+#include "handles/UdpSocketHandle.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <uv.h>
+#include <cstring> // std::memcpy()
+#include <optional>
+#include <vector>
+
+namespace
+{
+	constexpr size_t DatagramSize{ 200u };
+
+	uv_udp_t* CreateBoundUvHandle()
+	{
+		auto* uvHandle = new uv_udp_t;
+		struct sockaddr_in addr; // NOLINT(cppcoreguidelines-pro-type-member-init)
+
+		REQUIRE(uv_udp_init_ex(DepLibUV::GetLoop(), uvHandle, UV_UDP_RECVMMSG) == 0);
+		REQUIRE(uv_ip4_addr("127.0.0.1", 0, &addr) == 0);
+		REQUIRE(uv_udp_bind(uvHandle, reinterpret_cast<const struct sockaddr*>(&addr), 0) == 0);
+
+		return uvHandle;
+	}
+
+	class TestUdpSocket : public UdpSocketHandle
+	{
+	public:
+		// Batch size is taken from settings by the base class.
+		explicit TestUdpSocket(uint32_t recvBatchSize) : UdpSocketHandle(CreateUvHandle(recvBatchSize))
+		{
+		}
+
+	private:
+		static uv_udp_t* CreateUvHandle(uint32_t recvBatchSize)
+		{
+			Settings::configuration.udpRecvBatchSize = recvBatchSize;
+
+			return CreateBoundUvHandle();
+		}
+
+	protected:
+		void UserOnUdpDatagramReceived(
+		  const uint8_t* data, size_t len, const struct sockaddr* /*addr*/) override
+		{
+			uint32_t number{ 0u };
+
+			REQUIRE(len >= sizeof(number));
+
+			std::memcpy(&number, data, sizeof(number));
+			this->numbers.push_back(number);
+			this->lens.push_back(len);
+		}
+
+	public:
+		std::vector<uint32_t> numbers;
+		std::vector<size_t> lens;
+	};
+
+	class TestSender : public UdpSocketHandle
+	{
+	public:
+		TestSender() : UdpSocketHandle(CreateBoundUvHandle())
+		{
+		}
+
+		// Datagrams are numbered from [first], loopback doesn't drop them while socket
+		// buffer has room.
+		void SendDatagrams(
+		  const UdpSocketHandle& socket, uint32_t first, size_t count, size_t size = DatagramSize)
+		{
+			for (size_t i = 0u; i < count; ++i)
+			{
+				SendDatagram(socket, first + static_cast<uint32_t>(i), size);
+			}
+		}
+
+		void SendDatagram(const UdpSocketHandle& socket, uint32_t number, size_t size)
+		{
+			std::vector<uint8_t> datagram(size, 0u);
+
+			std::memcpy(datagram.data(), &number, sizeof(number));
+			Send(datagram.data(), datagram.size(), socket.GetLocalAddress(), nullptr);
+		}
+
+	protected:
+		void UserOnUdpDatagramReceived(
+		  const uint8_t* /*data*/, size_t /*len*/, const struct sockaddr* /*addr*/) override
+		{
+		}
+	};
+
+	void ReceiveDatagrams(const TestUdpSocket& socket, size_t count)
+	{
+		for (int i = 0; i < 1000 && socket.numbers.size() < count; ++i)
+		{
+			uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+		}
+
+		REQUIRE(socket.numbers.size() == count);
+	}
+
+	// Closed handles are freed by the loop.
+	void RunLoop()
+	{
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	}
+} // namespace
+
+SCENARIO("UDP socket handle", "[handles][udpsockethandle]")
+{
+	const auto recvBatchSize = Settings::configuration.udpRecvBatchSize;
+
+	SECTION("datagrams are received in batches and dispatched in order")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+
+			sender.SendDatagrams(socket, 0u, 100u);
+			ReceiveDatagrams(socket, 100u);
+
+			for (uint32_t i = 0u; i < 100u; ++i)
+			{
+				REQUIRE(socket.numbers[i] == i);
+			}
+
+			REQUIRE(socket.GetRecvBatchSize() == 16u);
+			REQUIRE(socket.GetRecvDatagrams() == 100u);
+			REQUIRE(socket.GetRecvBytes() == 100u * DatagramSize);
+			REQUIRE(socket.GetRecvBatches() >= 7u);
+			REQUIRE(socket.GetRecvBatches() < 100u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("batch of one datagram")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(1u);
+
+			sender.SendDatagrams(socket, 0u, 10u);
+			ReceiveDatagrams(socket, 10u);
+
+			REQUIRE(socket.GetRecvBatches() == 10u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("datagrams of a send batch are sent with GSO")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				sender.SendDatagrams(socket, 0u, 10u);
+
+				REQUIRE(sender.GetSentBytes() == 0u);
+			}
+
+			ReceiveDatagrams(socket, 10u);
+
+			for (uint32_t i = 0u; i < 10u; ++i)
+			{
+				REQUIRE(socket.numbers[i] == i);
+				REQUIRE(socket.lens[i] == DatagramSize);
+			}
+
+			REQUIRE(sender.GetSentBytes() == 10u * DatagramSize);
+			REQUIRE(sender.GetSendGsoCount() == 1u);
+			REQUIRE(sender.GetSendGsoSegments() == 10u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("last segment may be shorter, mixed sizes are sent one by one")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+			const std::vector<size_t> sizes{ 200u, 200u, 100u, 200u, 300u };
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				for (uint32_t i = 0u; i < sizes.size(); ++i)
+				{
+					sender.SendDatagram(socket, i, sizes[i]);
+				}
+			}
+
+			ReceiveDatagrams(socket, sizes.size());
+
+			for (uint32_t i = 0u; i < sizes.size(); ++i)
+			{
+				REQUIRE(socket.numbers[i] == i);
+				REQUIRE(socket.lens[i] == sizes[i]);
+			}
+
+			REQUIRE(sender.GetSendGsoCount() == 1u);
+			REQUIRE(sender.GetSendGsoSegments() == 3u);
+			REQUIRE(sender.GetSendMmsgCount() == 1u);
+			REQUIRE(sender.GetSendMmsgDatagrams() == 2u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("mixed sizes are sent with a single sendmmsg() per socket")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket1(16u);
+			TestUdpSocket socket2(16u);
+			const std::vector<size_t> sizes{ 100u, 200u, 300u, 400u };
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				for (uint32_t i = 0u; i < sizes.size(); ++i)
+				{
+					sender.SendDatagram(socket1, i, sizes[i]);
+					sender.SendDatagram(socket2, i, sizes[i]);
+				}
+			}
+
+			ReceiveDatagrams(socket1, sizes.size());
+			ReceiveDatagrams(socket2, sizes.size());
+
+			for (uint32_t i = 0u; i < sizes.size(); ++i)
+			{
+				REQUIRE(socket1.numbers[i] == i);
+				REQUIRE(socket1.lens[i] == sizes[i]);
+				REQUIRE(socket2.numbers[i] == i);
+				REQUIRE(socket2.lens[i] == sizes[i]);
+			}
+
+			REQUIRE(sender.GetSentBytes() == 2u * 1000u);
+			REQUIRE(sender.GetSendGsoCount() == 0u);
+			REQUIRE(sender.GetSendMmsgCount() == 1u);
+			REQUIRE(sender.GetSendMmsgDatagrams() == 8u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("GSO sends don't overtake datagrams queued before")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+			const std::vector<size_t> sizes{ 100u, 200u, 200u };
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				for (uint32_t i = 0u; i < sizes.size(); ++i)
+				{
+					sender.SendDatagram(socket, i, sizes[i]);
+				}
+			}
+
+			ReceiveDatagrams(socket, sizes.size());
+
+			for (uint32_t i = 0u; i < sizes.size(); ++i)
+			{
+				REQUIRE(socket.numbers[i] == i);
+			}
+
+			REQUIRE(sender.GetSendGsoCount() == 1u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("datagrams are coalesced per destination")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket1(16u);
+			TestUdpSocket socket2(16u);
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				for (uint32_t i = 0u; i < 5u; ++i)
+				{
+					sender.SendDatagram(socket1, i, DatagramSize);
+					sender.SendDatagram(socket2, i, DatagramSize);
+				}
+			}
+
+			ReceiveDatagrams(socket1, 5u);
+			ReceiveDatagrams(socket2, 5u);
+
+			for (uint32_t i = 0u; i < 5u; ++i)
+			{
+				REQUIRE(socket1.numbers[i] == i);
+				REQUIRE(socket2.numbers[i] == i);
+			}
+
+			REQUIRE(sender.GetSendGsoCount() == 2u);
+			REQUIRE(sender.GetSendGsoSegments() == 10u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("segments of a GSO send are limited")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				sender.SendDatagrams(socket, 0u, 100u);
+			}
+
+			ReceiveDatagrams(socket, 100u);
+
+			REQUIRE(sender.GetSendGsoCount() == 2u);
+			REQUIRE(sender.GetSendGsoSegments() == 100u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("nested send batches are sent at the end of the outermost one")
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(16u);
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				{
+					const UdpSocketHandle::SendBatch nestedSendBatch;
+
+					sender.SendDatagrams(socket, 0u, 5u);
+				}
+
+				REQUIRE(sender.GetSentBytes() == 0u);
+			}
+
+			ReceiveDatagrams(socket, 5u);
+
+			REQUIRE(sender.GetSendGsoCount() == 1u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("closed socket sends its queued datagrams")
+	{
+		{
+			TestUdpSocket socket(16u);
+
+			{
+				const UdpSocketHandle::SendBatch sendBatch;
+
+				{
+					TestSender sender;
+
+					sender.SendDatagrams(socket, 0u, 5u);
+				}
+			}
+
+			ReceiveDatagrams(socket, 5u);
+		}
+
+		RunLoop();
+	}
+
+	SECTION("batch size is limited")
+	{
+		{
+			TestUdpSocket socket(1000u);
+
+			REQUIRE(socket.GetRecvBatchSize() == UdpSocketHandle::MaxRecvBatchSize);
+		}
+
+		RunLoop();
+	}
+
+	Settings::configuration.udpRecvBatchSize = recvBatchSize;
+}
+
+// Receive syscalls per datagram and time of receiving a burst, batch of one is the
+// former single slot read buffer; sending is excluded from the time.
+// Hidden, run with: mediasoup-worker-test "[benchmark]"
+TEST_CASE("UDP socket handle receive throughput", "[.][benchmark][handles]")
+{
+	const auto recvBatchSize = Settings::configuration.udpRecvBatchSize;
+	constexpr size_t BurstSize{ 100u };
+	constexpr size_t BurstsCount{ 1000u };
+
+	for (const uint32_t batchSize : { 1u, 16u })
+	{
+		{
+			TestSender sender;
+			TestUdpSocket socket(batchSize);
+			uint64_t recvTimeNs{ 0u };
+
+			for (size_t i = 0u; i < BurstsCount; ++i)
+			{
+				socket.numbers.clear();
+				sender.SendDatagrams(socket, 0u, BurstSize);
+
+				const auto startNs = DepLibUV::GetTimeNs();
+
+				ReceiveDatagrams(socket, BurstSize);
+				recvTimeNs += DepLibUV::GetTimeNs() - startNs;
+			}
+
+			WARN(
+			  "batch size " << batchSize << ": "
+			                << static_cast<double>(socket.GetRecvBatches()) / socket.GetRecvDatagrams()
+			                << " syscalls per datagram, " << recvTimeNs / BurstsCount / 1000u
+			                << " us per burst of " << BurstSize << " datagrams");
+		}
+
+		RunLoop();
+	}
+
+	Settings::configuration.udpRecvBatchSize = recvBatchSize;
+}
+
+// Time of sending a burst of datagrams to the same destination, one by one and
+// by a send batch (GSO for same sizes, sendmmsg() for mixed ones); receiving is
+// excluded from the time.
+// Hidden, run with: mediasoup-worker-test "[benchmark]"
+TEST_CASE("UDP socket handle send throughput", "[.][benchmark][handles]")
+{
+	constexpr size_t BurstSize{ 50u };
+	constexpr size_t BurstsCount{ 1000u };
+	constexpr size_t Size{ 1000u };
+
+	for (const bool mixedSizes : { false, true })
+	{
+		for (const bool batch : { false, true })
+		{
+			{
+				TestSender sender;
+				TestUdpSocket socket(16u);
+				uint64_t sendTimeNs{ 0u };
+
+				for (size_t i = 0u; i < BurstsCount; ++i)
+				{
+					socket.numbers.clear();
+
+					const auto startNs = DepLibUV::GetTimeNs();
+
+					{
+						std::optional<UdpSocketHandle::SendBatch> sendBatch;
+
+						if (batch)
+						{
+							sendBatch.emplace();
+						}
+
+						for (size_t j = 0u; j < BurstSize; ++j)
+						{
+							sender.SendDatagram(
+							  socket, static_cast<uint32_t>(j), mixedSizes ? Size + j : Size);
+						}
+					}
+
+					sendTimeNs += DepLibUV::GetTimeNs() - startNs;
+
+					ReceiveDatagrams(socket, BurstSize);
+				}
+
+				WARN(
+				  (mixedSizes ? "mixed sizes, " : "same sizes, ")
+				  << (batch ? "send batch: " : "one by one: ") << sendTimeNs / BurstsCount / 1000u
+				  << " us per burst of " << BurstSize << " datagrams, " << sender.GetSendGsoCount()
+				  << " GSO sends, " << sender.GetSendMmsgCount() << " sendmmsg() calls");
+			}
+
+			RunLoop();
+		}
+	}
+}